@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: MIT
+// Benchmark: signs per second of a Coinbase ES256 JWT.
+//
+// Compares generate_coinbase_jwt as it was before JwtSigner (jwt-cpp with the
+// PEM re-parsed, a new random_device/mt19937 and a stringstream nonce on every
+// call) with JwtSigner::sign, which parses the key once and only encodes the
+// nonce, timestamps and uri per call. Both sign with a freshly generated P-256
+// key, so no credentials are needed.
+//
+// Build with -DBUILD_COINBASE_ADVANCED_BENCHMARKS=ON and run
+// ./benchmarks/jwt_sign_benchmark [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+
+#ifndef JWT_DISABLE_PICOJSON
+#define JWT_DISABLE_PICOJSON
+#endif
+#include <jwt-cpp/jwt.h>
+#include <jwt-cpp/traits/nlohmann-json/traits.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <coinbase/auth.hpp>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+using traits = jwt::traits::nlohmann_json;
+
+constexpr const char *KEY_NAME = "organizations/00000000-0000-0000-0000-000000000000/apiKeys/00000000-0000-0000-0000-000000000000";
+constexpr const char *URI = "POST api.coinbase.com/api/v3/brokerage/orders";
+
+std::string make_private_key() {
+    EVP_PKEY *key = nullptr;
+    auto *pctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+    EVP_PKEY_keygen_init(pctx);
+    EVP_PKEY_CTX_set_ec_paramgen_curve_nid(pctx, NID_X9_62_prime256v1);
+    EVP_PKEY_keygen(pctx, &key);
+    EVP_PKEY_CTX_free(pctx);
+
+    BIO *bio = BIO_new(BIO_s_mem());
+    PEM_write_bio_PrivateKey(bio, key, nullptr, nullptr, 0, nullptr, nullptr);
+    char *data = nullptr;
+    auto len = BIO_get_mem_data(bio, &data);
+    std::string pem(data, static_cast<std::size_t>(len));
+    BIO_free(bio);
+    EVP_PKEY_free(key);
+    return pem;
+}
+
+// generate_coinbase_jwt as it was before JwtSigner
+std::string legacy_generate_jwt(const std::string &api_key, const std::string &private_key, const char *uri) {
+    auto now = std::chrono::system_clock::now();
+    auto exp = now + std::chrono::minutes(2);
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<uint32_t> dis(0, 0xFFFFFFFF);
+    std::stringstream nonce_stream;
+    nonce_stream << std::hex << dis(gen) << dis(gen);
+    std::string nonce = nonce_stream.str();
+
+    auto jwt = jwt::create<traits>()
+        .set_type("JWT")
+        .set_issuer("cdp")
+        .set_subject(api_key)
+        .set_not_before(now)
+        .set_expires_at(exp)
+        .set_algorithm("ES256")
+        .set_header_claim("kid", jwt::basic_claim<traits>(api_key))
+        .set_header_claim("nonce", jwt::basic_claim<traits>(nonce));
+    if (uri) {
+        jwt.set_payload_claim("uri", jwt::basic_claim<traits>(std::string(uri)));
+    }
+    return jwt.sign(jwt::algorithm::es256("", private_key, "", ""));
+}
+
+template<typename F>
+double signs_per_second(int iterations, F &&f) {
+    f();    // warm up
+    auto start = clock_type::now();
+    for (int i = 0; i < iterations; ++i) {
+        f();
+    }
+    auto elapsed = std::chrono::duration<double>(clock_type::now() - start).count();
+    return iterations / elapsed;
+}
+
+volatile std::size_t sink = 0;
+
+}   // namespace
+
+int main(int argc, char **argv) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 20000;
+
+    std::string api_key = KEY_NAME;
+    auto private_key = make_private_key();
+    coinbase::JwtSigner signer(api_key, private_key);
+    if (!signer.isValid()) {
+        std::fprintf(stderr, "failed to load the generated key\n");
+        return 1;
+    }
+
+    auto legacy = signs_per_second(iterations, [&]() {
+        sink = legacy_generate_jwt(api_key, private_key, URI).size();
+    });
+    auto cached = signs_per_second(iterations, [&]() {
+        sink = signer.sign(URI).size();
+    });
+
+    std::printf("ES256 JWT signing, %d iterations\n", iterations);
+    std::printf("  %-44s %10.0f signs/s  %7.2f us/sign\n", "jwt-cpp, key parsed per call (previous)", legacy, 1e6 / legacy);
+    std::printf("  %-44s %10.0f signs/s  %7.2f us/sign  (%.2fx)\n", "JwtSigner", cached, 1e6 / cached, cached / legacy);
+    return 0;
+}
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: MIT
+// Benchmark: cost of decoding one Level2 update.
+//
+// Compares the number parsing used by the *_FROM_JSON macros before and after
+// the switch to parse_double (std::stod on the DOM string vs. the exact
+// allocation-free parser), and the full per-update decode cost of the DOM and
+// on-demand market data decoders.
+//
+// Build with -DBUILD_COINBASE_ADVANCED_BENCHMARKS=ON and run
+// ./benchmarks/l2_decode_benchmark [updates_per_frame] [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+#include <nlohmann/json.hpp>
+#include <coinbase/market_data.hpp>
+#include <coinbase/market_data_decoder.hpp>
+
+namespace {
+
+using json = nlohmann::json;
+using clock_type = std::chrono::steady_clock;
+
+// double_from_json as it was before parse_double
+double legacy_double_from_json(const json &j, std::string_view field) {
+    try {
+        const auto &v = j.at(field);
+        if (v.is_number()) {
+            return v.get<double>();
+        }
+        auto f = v.get<std::string_view>();
+        if (f.empty()) {
+            return 0.;
+        }
+        return std::stod(f.data());
+    }
+    catch (const std::exception &) {
+    }
+    return 0.;
+}
+
+std::string make_l2_frame(std::size_t updates) {
+    std::mt19937_64 rng(7);
+    std::string frame = R"({"channel":"l2_data","client_id":"","timestamp":"2026-03-05T09:05:32.483569449Z","sequence_num":229,"events":[{"type":"update","product_id":"BTC-USD","updates":[)";
+    char buf[256];
+    for (std::size_t i = 0; i < updates; ++i) {
+        auto cents = 7200000 + static_cast<long long>(rng() % 100000);
+        auto qty = static_cast<long long>(rng() % 100000000);
+        std::snprintf(buf, sizeof(buf),
+            R"(%s{"side":"%s","event_time":"2026-03-05T09:05:32.%06dZ","price_level":"%lld.%02lld","new_quantity":"%lld.%08lld"})",
+            i ? "," : "", (i & 1) ? "offer" : "bid", static_cast<int>(i % 1000000), cents / 100, cents % 100, qty / 100000000, qty % 100000000);
+        frame += buf;
+    }
+    frame += "]}]}";
+    return frame;
+}
+
+template<typename F>
+double ns_per_update(std::size_t updates, int iterations, F &&f) {
+    f();    // warm up
+    auto start = clock_type::now();
+    for (int i = 0; i < iterations; ++i) {
+        f();
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(clock_type::now() - start).count();
+    return elapsed / (static_cast<double>(updates) * iterations);
+}
+
+volatile double sink = 0.;
+
+}   // namespace
+
+int main(int argc, char **argv) {
+    std::size_t updates = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 2000;
+
+    auto frame = make_l2_frame(updates);
+    auto dom = json::parse(frame);
+    const auto &dom_updates = dom["events"][0]["updates"];
+
+    auto legacy_numbers = ns_per_update(updates, iterations, [&]() {
+        double total = 0.;
+        for (const auto &u : dom_updates) {
+            total += legacy_double_from_json(u, "price_level") + legacy_double_from_json(u, "new_quantity");
+        }
+        sink = total;
+    });
+    auto numbers = ns_per_update(updates, iterations, [&]() {
+        double total = 0.;
+        for (const auto &u : dom_updates) {
+            total += coinbase::double_from_json(u, "price_level") + coinbase::double_from_json(u, "new_quantity");
+        }
+        sink = total;
+    });
+
+    coinbase::Level2UpdateBatch batch;
+    auto dom_decode = ns_per_update(updates, iterations, [&]() {
+        auto j = json::parse(frame);
+        batch.updates.clear();
+        for (const auto &u : j["events"][0]["updates"]) {
+            from_json(u, batch.updates.emplace_back());
+        }
+        sink = batch.updates.back().price_level;
+    });
+    auto on_demand_decode = ns_per_update(updates, iterations, [&]() {
+        coinbase::MarketDataFrame f;
+        coinbase::scan_market_data_frame(frame.data(), frame.size(), f, [&](const coinbase::MarketDataFrame &, coinbase::JsonScanner &s) {
+            coinbase::decode_level2_events(s, batch, [&](std::string_view, const coinbase::Level2UpdateBatch &b) {
+                sink = b.updates.back().price_level;
+            });
+        });
+    });
+
+    std::printf("Level2 decode, %zu updates per frame, %d iterations\n", updates, iterations);
+    std::printf("  %-44s %8.1f ns/update\n", "price+size, std::stod (previous)", legacy_numbers);
+    std::printf("  %-44s %8.1f ns/update  (%.2fx)\n", "price+size, parse_double", numbers, legacy_numbers / numbers);
+    std::printf("  %-44s %8.1f ns/update\n", "full update, DOM decoder", dom_decode);
+    std::printf("  %-44s %8.1f ns/update  (%.2fx)\n", "full update, on-demand decoder", on_demand_decode, dom_decode / on_demand_decode);
+    return 0;
+}
@@ -4,7 +4,8 @@
 // The WebSocket I/O thread enqueues data into a lock-free buffer.
 // The user calls processData() from their own thread to drain the buffer
 // and invoke callbacks — no synchronisation needed inside the handlers.
-// This makes it safe to do heavier work (e.g. maintaining an order book).
+// The library maintains the L2 order books (WebSocketClient::addOrderBook) and
+// onOrderBookUpdate fires after each applied event.
 //
 // No API credentials are required for public market-data channels
 // (TICKER, LEVEL2, MARKET_TRADES).
@@ -15,7 +16,6 @@
 #include <format>
 #include <functional>
 #include <iostream>
-#include <map>
 #include <thread>
 
 #include <slick/net/logging.hpp>
@@ -40,32 +40,22 @@ public:
     void onUserDataConnected(coinbase::WebSocketClient*) override {}
     void onUserDataDisconnected(coinbase::WebSocketClient*) override {}
 
-    // --- level 2 order book (maintained on the user thread) ---
+    // --- level 2 (the books registered with addOrderBook() are already updated) ---
 
     void onLevel2Snapshot(coinbase::WebSocketClient*, uint64_t seq_num,
                           const coinbase::Level2UpdateBatch& snapshot) override {
-        bids_.clear();
-        asks_.clear();
-        for (const auto& u : snapshot.updates) {
-            if (u.side == coinbase::Side::BUY) {
-                bids_[u.price_level] = u.new_quantity;
-            } else {
-                asks_[u.price_level] = u.new_quantity;
-            }
-        }
-        LOG_INFO("[L2 snapshot] {} seq={} bids={} asks={}", snapshot.product_id, seq_num, bids_.size(), asks_.size());
+        LOG_INFO("[L2 snapshot] {} seq={} levels={}", snapshot.product_id, seq_num, snapshot.updates.size());
     }
 
     void onLevel2Updates(coinbase::WebSocketClient*, uint64_t /*seq_num*/,
-                         const coinbase::Level2UpdateBatch& updates) override {
-        for (const auto& u : updates.updates) {
-            if (u.side == coinbase::Side::BUY) {
-                if (u.new_quantity == 0.0) bids_.erase(u.price_level);
-                else bids_[u.price_level] = u.new_quantity;
-            } else {
-                if (u.new_quantity == 0.0) asks_.erase(u.price_level);
-                else asks_[u.price_level] = u.new_quantity;
-            }
+                         const coinbase::Level2UpdateBatch&) override {}
+
+    void onOrderBookUpdate(coinbase::WebSocketClient*, uint64_t /*seq_num*/,
+                           const coinbase::OrderBook& book) override {
+        auto bid = book.bestBid();
+        auto ask = book.bestAsk();
+        if (bid && ask && bid->price >= ask->price) {
+            LOG_WARN("[book] {} crossed bid={} ask={}", book.productId(), bid->price, ask->price);
         }
     }
 
@@ -138,25 +128,16 @@ public:
 
     // --- order book display (called from user thread) ---
 
-    void printOrderBook() const {
-        LOG_INFO("--- Order Book (top 5) ---");
-        int n = 0;
-        for (const auto& [price, qty] : bids_) {
-            LOG_INFO("  bid  {}  qty={}", price, qty);
-            if (++n >= 5) break;
+    static void printOrderBook(const coinbase::OrderBook& book) {
+        LOG_INFO("--- {} Order Book (top 5) ---", book.productId());
+        for (const auto& level : book.depth(coinbase::Side::BUY, 5)) {
+            LOG_INFO("  bid  {}  qty={}", level.price, level.quantity);
         }
-        n = 0;
-        for (const auto& [price, qty] : asks_) {
-            LOG_INFO("  ask  {}  qty={}", price, qty);
-            if (++n >= 5) break;
+        for (const auto& level : book.depth(coinbase::Side::SELL, 5)) {
+            LOG_INFO("  ask  {}  qty={}", level.price, level.quantity);
         }
         LOG_INFO("--------------------------");
     }
-
-private:
-    // bids sorted best (highest) first, asks sorted best (lowest) first
-    std::map<double, double, std::greater<double>> bids_;
-    std::map<double, double>                       asks_;
 };
 
 // ---------------------------------------------------------------------------
@@ -212,6 +193,10 @@ int main() {
     UserThreadCallbacks callbacks;
     coinbase::WebSocketClient ws(&callbacks);
 
+    // Let the library maintain the books; tick size comes from quote_increment.
+    ws.addOrderBook(product);
+    ws.addOrderBook(rest.get_public_product("ETH-USD"));
+
     ws.subscribe({"BTC-USD", "ETH-USD"}, {
         coinbase::WebSocketChannel::TICKER,
         coinbase::WebSocketChannel::LEVEL2,
@@ -227,7 +212,11 @@ int main() {
 
         auto now = std::chrono::steady_clock::now();
         if (now - last_print >= std::chrono::seconds(5)) {
-            callbacks.printOrderBook();
+            for (auto product_id : {"BTC-USD", "ETH-USD"}) {
+                if (auto* book = ws.orderBook(product_id)) {
+                    UserThreadCallbacks::printOrderBook(*book);
+                }
+            }
             last_print = now;
         }
 
@@ -12,6 +12,8 @@
 // The mux queue and MD_DATA producer buffers are placed in named shared
 // memory so a second process (multi_websockets_ws_callbacks_reader) can
 // attach and log the same raw JSON stream without an extra network connection.
+// Decoded events are also published as fixed-layout binary records for
+// normalized_records_reader.
 //
 // No API credentials are required for public market-data channels.
 
@@ -32,6 +34,13 @@ static constexpr const char* SHM_QUEUE_NAME = "coinbase_md_mux_queue";
 static constexpr const char* SHM_BTC_BUF    = "coinbase_btc_md_buf";
 static constexpr const char* SHM_ETH_BUF    = "coinbase_eth_md_buf";
 
+// Normalized records — must match normalized_records_reader.cpp. The producer
+// ids lie past both clients' producer ranges.
+static constexpr const char* SHM_BTC_RECORDS = "coinbase_btc_md_records";
+static constexpr const char* SHM_ETH_RECORDS = "coinbase_eth_md_records";
+static constexpr uint32_t BTC_RECORDS_ID = 2 * coinbase::ProducerType::_PRODUCER_TYPE_COUNT_;
+static constexpr uint32_t ETH_RECORDS_ID = BTC_RECORDS_ID + 1;
+
 // ---------------------------------------------------------------------------
 // Callback implementation — one instance per symbol
 // ---------------------------------------------------------------------------
@@ -181,6 +190,10 @@ int main() {
         1u << 26, 1u << 16, SHM_ETH_BUF   // MD_DATA buffer in shared memory
     );
 
+    // Decoded events as binary records in shared memory.
+    ws_btc.enableNormalizedRecords(BTC_RECORDS_ID, coinbase::NO_PRODUCER_ID, 1u << 24, 1u << 16, SHM_BTC_RECORDS);
+    ws_eth.enableNormalizedRecords(ETH_RECORDS_ID, coinbase::NO_PRODUCER_ID, 1u << 24, 1u << 16, SHM_ETH_RECORDS);
+
     ws_btc.subscribe({"BTC-USD"}, {
         coinbase::WebSocketChannel::TICKER,
         coinbase::WebSocketChannel::LEVEL2,
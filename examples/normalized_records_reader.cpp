@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: MIT
+// Reader of the normalized binary records published by
+// multi_websockets_ws_callbacks.
+//
+// The producer decodes each Coinbase frame once and, besides invoking its
+// callbacks, republishes the events as fixed-layout records (see
+// coinbase/normalized_records.hpp) into named shared-memory producer buffers.
+// This process attaches to the same mux and reads those records directly —
+// no JSON parsing and no extra network connection.
+//
+// Producer IDs opened here:
+//   BTC records: 2 * _PRODUCER_TYPE_COUNT_      → producer_id=8
+//   ETH records: 2 * _PRODUCER_TYPE_COUNT_ + 1  → producer_id=9
+// Records of other producers are skipped.
+//
+// Start multi_websockets_ws_callbacks first, then run this reader.
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include <slick/net/logging.hpp>
+#include <slick/stream_buffer_multiplexer.hpp>
+#include <coinbase/websocket.hpp>
+#include <coinbase/normalized_records.hpp>
+
+// Must match the constants in multi_websockets_ws_callbacks.cpp.
+static constexpr const char* SHM_QUEUE_NAME  = "coinbase_md_mux_queue";
+static constexpr const char* SHM_BTC_RECORDS = "coinbase_btc_md_records";
+static constexpr const char* SHM_ETH_RECORDS = "coinbase_eth_md_records";
+
+static constexpr uint32_t BTC_RECORDS_ID = 2 * coinbase::ProducerType::_PRODUCER_TYPE_COUNT_;
+static constexpr uint32_t ETH_RECORDS_ID = BTC_RECORDS_ID + 1;
+
+static std::atomic_bool g_running{true};
+
+static void handle_sigint(int) {
+    g_running.store(false, std::memory_order_relaxed);
+}
+
+static void print_record(const coinbase::RecordHeader &header) {
+    using namespace coinbase;
+    bool snapshot = header.flags & RecordFlags::SNAPSHOT;
+    switch (header.type) {
+        case RecordType::LEVEL2: {
+            auto &record = reinterpret_cast<const Level2Record&>(header);
+            LOG_INFO("[{}] L2 {} seq={} levels={}", record_string(record.product_id),
+                     snapshot ? "snapshot" : "update", header.seq_num, header.count);
+            break;
+        }
+        case RecordType::TICKER:
+            for (const auto &t : record_entries<TickerEntry>(header)) {
+                LOG_INFO("[{}] ticker seq={} price={} bid={} ask={}", record_string(t.product_id),
+                         header.seq_num, t.price, t.best_bid, t.best_ask);
+            }
+            break;
+        case RecordType::TRADE:
+            for (const auto &t : record_entries<TradeEntry>(header)) {
+                LOG_INFO("[{}] trade seq={} {} {} @ {}", record_string(t.product_id),
+                         header.seq_num, t.side == Side::BUY ? "BUY" : "SELL", t.size, t.price);
+            }
+            break;
+        default:
+            LOG_INFO("record type={} seq={} count={}", static_cast<int>(header.type), header.seq_num, header.count);
+            break;
+    }
+}
+
+int main() {
+    std::signal(SIGINT, handle_sigint);
+
+    slick::net::set_log_handler(
+        [](slick::net::LogLevel level, const char* fmt, std::format_args args) {
+            const char* prefix = "?????";
+            switch (level) {
+                case slick::net::LogLevel::Trace: prefix = "TRACE"; break;
+                case slick::net::LogLevel::Debug: prefix = "DEBUG"; break;
+                case slick::net::LogLevel::Info:  prefix = "INFO "; break;
+                case slick::net::LogLevel::Warn:  prefix = "WARN "; break;
+                case slick::net::LogLevel::Error: prefix = "ERROR"; break;
+                case slick::net::LogLevel::Fatal: prefix = "FATAL"; break;
+                default: break;
+            }
+            std::cout << '[' << prefix << "] " << std::vformat(fmt, args) << '\n';
+        },
+        []() { return slick::net::LogLevel::Debug; }
+    );
+
+    LOG_INFO("=== normalized_records_reader ===");
+    LOG_INFO("Reads binary records of BTC-USD (producer_id={}) and ETH-USD (producer_id={}).",
+             BTC_RECORDS_ID, ETH_RECORDS_ID);
+    LOG_INFO("Press Ctrl-C to exit.");
+
+    // Open the shared-memory fan-in queue — retry until the producer creates it.
+    std::unique_ptr<slick::stream_buffer_multiplexer> mux;
+    LOG_INFO("Waiting for shared queue '{}'...", SHM_QUEUE_NAME);
+    while (g_running.load(std::memory_order_relaxed) && !mux) {
+        try {
+            mux = std::make_unique<slick::stream_buffer_multiplexer>(SHM_QUEUE_NAME);
+        } catch (const std::exception&) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        }
+    }
+    if (!mux) return 0;
+
+    auto open_producer = [&](uint32_t pid, const char* shm_name) {
+        while (g_running.load(std::memory_order_relaxed)) {
+            try {
+                mux->add_producer(pid, shm_name);
+                LOG_INFO("Record buffer '{}' opened (producer_id={}).", shm_name, pid);
+                return;
+            } catch (const std::exception&) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            }
+        }
+    };
+
+    open_producer(BTC_RECORDS_ID, SHM_BTC_RECORDS);
+    open_producer(ETH_RECORDS_ID, SHM_ETH_RECORDS);
+    if (!g_running.load(std::memory_order_relaxed)) return 0;
+
+    uint64_t cursor = mux->initial_reading_index();
+    while (g_running.load(std::memory_order_relaxed)) {
+        auto rec = mux->read(cursor);
+        if (!rec) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            continue;
+        }
+        if (rec.producer_id != BTC_RECORDS_ID && rec.producer_id != ETH_RECORDS_ID) {
+            continue;
+        }
+        if (auto *header = coinbase::record_header(rec.data, rec.length)) {
+            print_record(*header);
+        }
+    }
+
+    LOG_INFO("Reader exiting.");
+}
@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#pragma once
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/ssl/context.hpp>
+#include <boost/beast/http/verb.hpp>
+#include <chrono>
+#include <string>
+#include <string_view>
+
+namespace asio = boost::asio;
+
+namespace coinbase {
+
+// Split the host and port out of a base url such as "https://api.coinbase.com";
+// the port defaults to 443.
+void parse_base_url(std::string_view url, std::string &host, std::string &port);
+
+// TLS client context of the HTTPS clients: default trust store, peer verified
+asio::ssl::context& tls_client_context();
+
+struct HttpResponse {
+    unsigned status = 0;
+    std::string result_text;
+    std::string reason;
+
+    bool is_ok() const noexcept { return status >= 200 && status < 300; }
+};
+
+// Coroutine-native HTTPS client used by CoinbaseAwaitableRestClient.
+//
+// Every step of a request (resolve, connect, TLS handshake, write, read) is
+// suspended on the awaiting coroutine's executor, so any number of requests can
+// be in flight on one io_context thread without blocking it. Each request uses
+// its own connection, closed as soon as the response is read. Network and TLS
+// failures are thrown as system_error.
+class AsyncHttpClient
+{
+public:
+    static constexpr std::chrono::seconds DEFAULT_TIMEOUT{30};
+
+    explicit AsyncHttpClient(std::string_view base_url = "https://api.coinbase.com");
+
+    void set_base_url(std::string_view url);
+    const std::string& host() const noexcept { return host_; }
+
+    // per-operation timeout
+    void set_timeout(std::chrono::milliseconds timeout) noexcept { timeout_ = timeout; }
+
+    // target is the path and query, e.g. "/api/v3/brokerage/time"
+    asio::awaitable<HttpResponse> get(std::string target, std::string authorization = {}) const {
+        return request(boost::beast::http::verb::get, std::move(target), {}, std::move(authorization));
+    }
+    asio::awaitable<HttpResponse> post(std::string target, std::string body, std::string authorization = {}) const {
+        return request(boost::beast::http::verb::post, std::move(target), std::move(body), std::move(authorization));
+    }
+    asio::awaitable<HttpResponse> put(std::string target, std::string body, std::string authorization = {}) const {
+        return request(boost::beast::http::verb::put, std::move(target), std::move(body), std::move(authorization));
+    }
+    asio::awaitable<HttpResponse> del(std::string target, std::string authorization = {}) const {
+        return request(boost::beast::http::verb::delete_, std::move(target), {}, std::move(authorization));
+    }
+
+    // authorization is the full header value, e.g. "Bearer <jwt>"; a non-empty
+    // body is sent as application/json
+    asio::awaitable<HttpResponse> request(boost::beast::http::verb method, std::string target, std::string body, std::string authorization) const;
+
+private:
+    std::string host_;
+    std::string port_;
+    std::chrono::milliseconds timeout_ = DEFAULT_TIMEOUT;
+};
+
+}   // end namespace coinbase
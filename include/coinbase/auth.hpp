@@ -4,14 +4,56 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 
 namespace coinbase {
 
 // Fix PEM format by removing quotes and replacing literal \n with newlines
 std::string fix_pem_format(std::string key);
 
-// Generate Coinbase JWT token for API authentication
+// Signs Coinbase ES256 JWTs with a key that is parsed once.
+//
+// The header and payload are written directly as JSON; their constant parts
+// (key name, issuer, algorithm) are base64url-encoded in the constructor, so
+// each sign() only encodes the nonce, the timestamps and the uri, and signs.
+// sign() is thread safe.
+class JwtSigner
+{
+public:
+    static constexpr int64_t LIFETIME_SECONDS = 120;
+
+    // key_name is the API key name (organizations/.../apiKeys/...), private_key
+    // the EC private key PEM
+    JwtSigner(std::string key_name, std::string_view private_key);
+    ~JwtSigner();
+
+    JwtSigner(const JwtSigner&) = delete;
+    JwtSigner& operator=(const JwtSigner&) = delete;
+
+    // false if the private key could not be loaded
+    bool isValid() const noexcept { return key_ != nullptr; }
+    const std::string& keyName() const noexcept { return key_name_; }
+
+    // JWT for uri, e.g. "GET api.coinbase.com/api/v3/brokerage/accounts"; an empty
+    // uri omits the claim (websocket subscriptions). now_seconds is the nbf claim,
+    // 0 for the current time. Returns an empty string if signing fails.
+    std::string sign(std::string_view uri = {}, int64_t now_seconds = 0) const;
+
+    // Signer for COINBASE_API_KEY / COINBASE_API_SECRET
+    static const JwtSigner& instance();
+
+private:
+    std::string key_name_;
+    void *key_ = nullptr;           // EVP_PKEY
+    std::string header_prefix_;     // base64url of the header up to the nonce
+    std::string header_tail_;       // header bytes not covered by header_prefix_
+    std::string payload_prefix_;    // base64url of the payload up to nbf
+    std::string payload_tail_;
+};
+
+// Generate Coinbase JWT token for API authentication; signs with JwtSigner::instance()
 std::string generate_coinbase_jwt(const char* uri = nullptr);
 
 }   // namespace coinbase
@@ -8,6 +8,7 @@
 #include <optional>
 #include <nlohmann/json.hpp>
 #include <coinbase/utils.hpp>
+#include <coinbase/common.hpp>
 
 using json = nlohmann::json;
 
@@ -21,6 +22,7 @@ struct Candle {
     double close;
     double volume;
     std::string product_id;
+    ProductHandle product_handle = INVALID_PRODUCT_HANDLE;
 };
 
 inline void from_json(const json &j, Candle &c) {
@@ -31,6 +33,43 @@ inline void from_json(const json &j, Candle &c) {
     DOUBLE_FROM_JSON(j, c, close);
     DOUBLE_FROM_JSON(j, c, volume);
     VARIABLE_FROM_JSON(j, c, product_id);
+    c.product_handle = intern_product_id(c.product_id);
+}
+
+inline void from_scanner(JsonScanner &s, Candle &c) {
+    std::string_view key, value;
+    if (!s.enterObject()) {
+        return;
+    }
+    while (s.nextKey(key)) {
+        if (key == "start") {
+            c.start = uint_from_scanner(s);
+        }
+        else if (key == "low") {
+            c.low = double_from_scanner(s);
+        }
+        else if (key == "high") {
+            c.high = double_from_scanner(s);
+        }
+        else if (key == "open") {
+            c.open = double_from_scanner(s);
+        }
+        else if (key == "close") {
+            c.close = double_from_scanner(s);
+        }
+        else if (key == "volume") {
+            c.volume = double_from_scanner(s);
+        }
+        else if (key == "product_id") {
+            if (s.readString(value)) {
+                c.product_id.assign(value);
+                c.product_handle = intern_product_id(value);
+            }
+        }
+        else {
+            s.skipValue();
+        }
+    }
 }
 
 enum class Granularity : uint8_t {
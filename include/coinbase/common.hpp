@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstdint>
+#include <limits>
 #include <string_view>
 #include <string>
 #include <nlohmann/json.hpp>
@@ -160,6 +161,16 @@ inline std::string to_string(OrderType ot) {
     return "UNKNOWN_ORDER_TYPE";
 }
 
+// Dense index of a product id, assigned by ProductCatalog on first sight and
+// stable for the lifetime of the process
+using ProductHandle = uint32_t;
+constexpr ProductHandle INVALID_PRODUCT_HANDLE = std::numeric_limits<ProductHandle>::max();
+
+// ProductCatalog::instance().intern(product_id) through a per-thread cache:
+// one string hash per call once an id has been seen on the calling thread.
+// INVALID_PRODUCT_HANDLE for an empty id.
+ProductHandle intern_product_id(std::string_view product_id);
+
 enum class ProductType : uint8_t {
     UNKNOWN_PRODUCT_TYPE,
     SPOT,
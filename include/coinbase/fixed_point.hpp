@@ -0,0 +1,261 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <coinbase/utils.hpp>
+#include <coinbase/product.hpp>
+
+namespace coinbase {
+
+// Integer amount expressed as a count of a product increment (quote_increment
+// for prices, base_increment for sizes). Equal decimal values always compare and
+// hash equal, which makes Price/Qty suitable as exact keys for books and maps.
+// The increment itself lives in a DecimalScale.
+template<typename Tag>
+struct FixedPoint {
+    int64_t value = 0;  // number of increments
+
+    constexpr FixedPoint() noexcept = default;
+    constexpr explicit FixedPoint(int64_t v) noexcept : value(v) {}
+
+    constexpr auto operator<=>(const FixedPoint&) const noexcept = default;
+
+    constexpr explicit operator bool() const noexcept { return value != 0; }
+
+    constexpr FixedPoint operator-() const noexcept { return FixedPoint(-value); }
+    constexpr FixedPoint operator+(FixedPoint o) const noexcept { return FixedPoint(value + o.value); }
+    constexpr FixedPoint operator-(FixedPoint o) const noexcept { return FixedPoint(value - o.value); }
+    constexpr FixedPoint operator*(int64_t n) const noexcept { return FixedPoint(value * n); }
+    constexpr FixedPoint& operator+=(FixedPoint o) noexcept { value += o.value; return *this; }
+    constexpr FixedPoint& operator-=(FixedPoint o) noexcept { value -= o.value; return *this; }
+};
+
+struct PriceTag {};
+struct QtyTag {};
+
+using Price = FixedPoint<PriceTag>;
+using Qty = FixedPoint<QtyTag>;
+
+// A decimal increment such as 0.01 or 0.00000001, held as units / 10^decimals
+// with integer units, plus exact conversions between FixedPoint amounts and
+// wire strings or doubles. The decimal count is computed once, unlike
+// to_string(value, min_increment).
+class DecimalScale {
+public:
+    static constexpr uint32_t MAX_DECIMALS = 18;
+
+    DecimalScale() noexcept = default;
+
+    explicit DecimalScale(double increment) noexcept
+        : decimals_(std::min<uint32_t>(compute_number_decimals(increment), MAX_DECIMALS))
+        , units_(std::max<int64_t>(std::llround(increment * static_cast<double>(pow10(decimals_))), 1))
+    {}
+
+    double increment() const noexcept { return static_cast<double>(units_) / static_cast<double>(pow10(decimals_)); }
+    uint32_t decimals() const noexcept { return decimals_; }
+    int64_t units() const noexcept { return units_; }
+
+    // Parse a decimal string ("72575.01", "-0.5") into a number of increments.
+    // Values off the increment grid are rounded to the nearest increment.
+    // Returns false if sv is not a plain decimal number or does not fit.
+    template<typename Tag>
+    bool parse(std::string_view sv, FixedPoint<Tag> &out) const noexcept {
+        int64_t scaled;
+        if (!parseScaled(sv, scaled)) {
+            return false;
+        }
+        out.value = divideRounded(scaled);
+        return true;
+    }
+
+    template<typename Tag = PriceTag>
+    FixedPoint<Tag> parse(std::string_view sv) const noexcept {
+        FixedPoint<Tag> v;
+        parse(sv, v);
+        return v;
+    }
+
+    enum class Rounding : uint8_t {
+        NEAREST,        // half away from zero, for prices
+        TOWARD_ZERO,    // for sizes, which must not exceed the amount asked for
+    };
+
+    // Convert v to a number of increments. Values within a few ulps of an
+    // increment are taken as that increment before rounding, so 0.29 is 29
+    // cents either way. Returns false if v is not finite or v * 10^decimals()
+    // does not fit int64_t.
+    template<typename Tag>
+    bool fromDouble(double v, FixedPoint<Tag> &out, Rounding rounding = Rounding::NEAREST) const noexcept {
+        auto scaled = v * static_cast<double>(pow10(decimals_));
+        if (!(std::fabs(scaled) < 0x1p63)) [[unlikely]] {
+            // also rejects NaN
+            return false;
+        }
+        auto increments = scaled / static_cast<double>(units_);
+        auto rounded = std::round(increments);
+        if (rounding == Rounding::TOWARD_ZERO
+            && std::fabs(increments - rounded) > 4 * std::numeric_limits<double>::epsilon() * std::max(1., std::fabs(increments))) {
+            rounded = std::trunc(increments);
+        }
+        out.value = static_cast<int64_t>(rounded);
+        return true;
+    }
+
+    // zero if v does not convert
+    template<typename Tag = PriceTag>
+    FixedPoint<Tag> fromDouble(double v, Rounding rounding = Rounding::NEAREST) const noexcept {
+        FixedPoint<Tag> out;
+        fromDouble(v, out, rounding);
+        return out;
+    }
+
+    // The double nearest to the decimal value, i.e. the same value the wire
+    // string parses to.
+    template<typename Tag>
+    double toDouble(FixedPoint<Tag> v) const noexcept {
+        return static_cast<double>(v.value * units_) / static_cast<double>(pow10(decimals_));
+    }
+
+    // Write v with exactly decimals() fraction digits. Returns the end of the
+    // written text; [first, last) must hold at least 22 characters.
+    template<typename Tag>
+    char* toChars(char *first, char *last, FixedPoint<Tag> v) const noexcept {
+        auto scaled = v.value * units_;
+        if (scaled < 0) {
+            *first++ = '-';
+            scaled = -scaled;
+        }
+        auto p = pow10(decimals_);
+        first = std::to_chars(first, last, scaled / p).ptr;
+        if (decimals_ > 0) {
+            *first++ = '.';
+            auto fraction = scaled % p;
+            for (auto i = decimals_; i > 0; --i) {
+                first[i - 1] = static_cast<char>('0' + fraction % 10);
+                fraction /= 10;
+            }
+            first += decimals_;
+        }
+        return first;
+    }
+
+    template<typename Tag>
+    std::string toString(FixedPoint<Tag> v) const {
+        char buf[32];
+        return std::string(buf, toChars(buf, buf + sizeof(buf), v));
+    }
+
+    bool operator==(const DecimalScale&) const noexcept = default;
+
+private:
+    static constexpr int64_t pow10(uint32_t n) noexcept {
+        constexpr int64_t table[] = {
+            1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL,
+            1000000000LL, 10000000000LL, 100000000000LL, 1000000000000LL, 10000000000000LL,
+            100000000000000LL, 1000000000000000LL, 10000000000000000LL, 100000000000000000LL,
+            1000000000000000000LL,
+        };
+        return table[n];
+    }
+
+    // value * 10^decimals_, rounded half away from zero
+    bool parseScaled(std::string_view sv, int64_t &out) const noexcept {
+        const char *p = sv.data();
+        const char *end = p + sv.size();
+        bool negative = false;
+        if (p != end && (*p == '-' || *p == '+')) {
+            negative = *p == '-';
+            ++p;
+        }
+        int64_t scaled = 0;
+        uint32_t digits = 0;
+        uint32_t significant = 0;
+        while (p != end && static_cast<unsigned char>(*p - '0') <= 9) {
+            if (significant == 18) [[unlikely]] {
+                // another digit does not fit int64_t
+                return false;
+            }
+            scaled = scaled * 10 + (*p - '0');
+            significant += scaled != 0;
+            ++digits;
+            ++p;
+        }
+        uint32_t fraction = 0;
+        bool round_up = false;
+        if (p != end && *p == '.') {
+            ++p;
+            while (p != end && static_cast<unsigned char>(*p - '0') <= 9) {
+                if (fraction < decimals_) {
+                    if (significant == 18) [[unlikely]] {
+                        return false;
+                    }
+                    scaled = scaled * 10 + (*p - '0');
+                    significant += scaled != 0;
+                    ++fraction;
+                }
+                else if (fraction == decimals_) {
+                    round_up = *p >= '5';
+                    ++fraction;
+                }
+                ++digits;
+                ++p;
+            }
+        }
+        if (p != end || digits == 0 || significant + (decimals_ - std::min(fraction, decimals_)) > 18) [[unlikely]] {
+            return false;
+        }
+        for (; fraction < decimals_; ++fraction) {
+            scaled *= 10;
+        }
+        scaled += round_up;
+        out = negative ? -scaled : scaled;
+        return true;
+    }
+
+    int64_t divideRounded(int64_t scaled) const noexcept {
+        if (units_ == 1) [[likely]] {
+            return scaled;
+        }
+        auto half = units_ / 2;
+        return scaled >= 0 ? (scaled + half) / units_ : -((-scaled + half) / units_);
+    }
+
+    uint32_t decimals_ = 0;
+    int64_t units_ = 1;
+};
+
+// Scale of prices of product (quote_increment)
+inline DecimalScale price_scale(const Product &product) noexcept {
+    return DecimalScale(product.quote_increment);
+}
+
+// Scale of sizes of product (base_increment)
+inline DecimalScale quantity_scale(const Product &product) noexcept {
+    return DecimalScale(product.base_increment);
+}
+
+// Like to_string(value, min_increment) with the increment decimals computed
+// once; value is rounded to the nearest increment.
+inline std::string to_string(double value, const DecimalScale &scale) {
+    return scale.toString(scale.fromDouble(value));
+}
+
+}   // end namespace coinbase
+
+template<typename Tag>
+struct std::hash<coinbase::FixedPoint<Tag>> {
+    std::size_t operator()(coinbase::FixedPoint<Tag> v) const noexcept {
+        return std::hash<int64_t>{}(v.value);
+    }
+};
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#pragma once
+
+#include <boost/beast/http/verb.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <coinbase/async_http.hpp>
+
+namespace coinbase {
+
+struct ConnectionPoolConfig {
+    std::size_t size = 2;                               // keep-alive connections kept open; 0 opens one per request
+    std::chrono::milliseconds ping_interval{15000};     // idle connections are pinged (and reconnected if dead) this often
+    std::chrono::milliseconds timeout{10000};           // per connect, handshake, write and read
+};
+
+// Blocking HTTPS client over a pool of keep-alive TLS connections to one host,
+// used by CoinbaseRestClient.
+//
+// size connections are opened in the background when the pool is created and
+// kept warm: a maintenance thread pings the ones that sat idle for
+// ping_interval with GET /api/v3/brokerage/time, replaces connections the
+// server closed, and tops the pool back up. A request takes an idle connection
+// (or opens one when all are busy) and returns it afterwards. A request that
+// finds its reused connection closed by the server is retried once on a fresh
+// one if it was not written in full, or if its method is idempotent (GET, PUT,
+// DELETE); a POST the server may have received is not resent. Thread safe.
+class HttpsConnectionPool
+{
+public:
+    explicit HttpsConnectionPool(std::string_view base_url, ConnectionPoolConfig config = {});
+    ~HttpsConnectionPool();
+
+    HttpsConnectionPool(const HttpsConnectionPool&) = delete;
+    HttpsConnectionPool& operator=(const HttpsConnectionPool&) = delete;
+
+    const std::string& host() const noexcept { return host_; }
+    const ConnectionPoolConfig& config() const noexcept { return config_; }
+
+    // number of open connections waiting for a request
+    std::size_t idle() const;
+
+    // target is the path and query, e.g. "/api/v3/brokerage/time"
+    HttpResponse get(std::string_view target, std::string_view authorization = {}) {
+        return request(boost::beast::http::verb::get, target, {}, authorization);
+    }
+    HttpResponse post(std::string_view target, std::string_view body, std::string_view authorization = {}) {
+        return request(boost::beast::http::verb::post, target, body, authorization);
+    }
+    HttpResponse put(std::string_view target, std::string_view body, std::string_view authorization = {}) {
+        return request(boost::beast::http::verb::put, target, body, authorization);
+    }
+    HttpResponse del(std::string_view target, std::string_view authorization = {}) {
+        return request(boost::beast::http::verb::delete_, target, {}, authorization);
+    }
+
+    // authorization is the full header value, e.g. "Bearer <jwt>"; a non-empty
+    // body is sent as application/json. Network and TLS failures are thrown as
+    // system_error.
+    HttpResponse request(boost::beast::http::verb method, std::string_view target, std::string_view body, std::string_view authorization);
+
+private:
+    struct Connection;
+
+    std::unique_ptr<Connection> connect();
+    std::unique_ptr<Connection> acquire();
+    void release(std::unique_ptr<Connection> conn);
+    HttpResponse exchange(Connection &conn, boost::beast::http::verb method, std::string_view target, std::string_view body, std::string_view authorization);
+    void maintain();
+
+    std::string host_;
+    std::string port_;
+    ConnectionPoolConfig config_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<std::unique_ptr<Connection>> idle_;
+    std::size_t open_ = 0;      // idle and in use
+    bool stopping_ = false;
+    std::thread maintenance_thread_;
+};
+
+}   // end namespace coinbase
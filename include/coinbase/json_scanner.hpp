@@ -0,0 +1,258 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace coinbase {
+
+// Forward-only, on-demand JSON reader over a raw frame.
+//
+// Values are consumed in document order without building a DOM. Strings are
+// returned as views into the frame with escape sequences left in place, which
+// is sufficient for the Coinbase market data fields (ids, sides, numbers and
+// timestamps). Any syntax error puts the scanner into a failed state in which
+// every subsequent call returns false.
+//
+// Usage:
+//   JsonScanner s(data, size);
+//   std::string_view key;
+//   if (s.enterObject()) {
+//       while (s.nextKey(key)) {
+//           if (key == "channel") s.readString(channel);
+//           else s.skipValue();
+//       }
+//   }
+class JsonScanner {
+public:
+    JsonScanner(const char *data, std::size_t size) noexcept
+        : begin_(data)
+        , cur_(data)
+        , end_(data + size)
+    {}
+
+    bool ok() const noexcept { return !failed_; }
+    const char* position() const noexcept { return cur_; }
+    const char* end() const noexcept { return end_; }
+
+    // Reposition the scanner, e.g. to revisit a value recorded with position().
+    void seek(const char *pos) noexcept {
+        cur_ = pos;
+    }
+
+    // Consume '{'.
+    bool enterObject() noexcept {
+        return expect('{');
+    }
+
+    // Consume '['.
+    bool enterArray() noexcept {
+        return expect('[');
+    }
+
+    // Read the next object key and its ':' separator. Returns false and consumes
+    // the closing '}' at the end of the object.
+    bool nextKey(std::string_view &key) noexcept {
+        skipWhitespace();
+        if (cur_ >= end_) [[unlikely]] {
+            return fail();
+        }
+        if (*cur_ == '}') {
+            ++cur_;
+            return false;
+        }
+        if (*cur_ == ',') {
+            ++cur_;
+        }
+        if (!readString(key)) {
+            return false;
+        }
+        return expect(':');
+    }
+
+    // Position on the next array element. Returns false and consumes the
+    // closing ']' at the end of the array.
+    bool nextElement() noexcept {
+        skipWhitespace();
+        if (cur_ >= end_) [[unlikely]] {
+            return fail();
+        }
+        if (*cur_ == ']') {
+            ++cur_;
+            return false;
+        }
+        if (*cur_ == ',') {
+            ++cur_;
+        }
+        return true;
+    }
+
+    // Read a string value. The view excludes the quotes; escapes are not decoded.
+    bool readString(std::string_view &out) noexcept {
+        skipWhitespace();
+        if (cur_ >= end_ || *cur_ != '"') [[unlikely]] {
+            return fail();
+        }
+        const char *start = ++cur_;
+        const char *close = findClosingQuote(start);
+        if (!close) [[unlikely]] {
+            return fail();
+        }
+        out = std::string_view(start, static_cast<std::size_t>(close - start));
+        cur_ = close + 1;
+        return true;
+    }
+
+    // Read a string or a bare number/literal token. Useful for numeric fields
+    // that Coinbase sends either quoted ("72575.5") or unquoted.
+    bool readScalar(std::string_view &out) noexcept {
+        skipWhitespace();
+        if (cur_ < end_ && *cur_ == '"') {
+            return readString(out);
+        }
+        const char *start = cur_;
+        while (cur_ < end_ && !isDelimiter(*cur_)) {
+            ++cur_;
+        }
+        if (cur_ == start) [[unlikely]] {
+            return fail();
+        }
+        out = std::string_view(start, static_cast<std::size_t>(cur_ - start));
+        return true;
+    }
+
+    // Read an unsigned integer number token.
+    bool readUInt(uint64_t &out) noexcept {
+        skipWhitespace();
+        const char *start = cur_;
+        uint64_t v = 0;
+        while (cur_ < end_ && static_cast<unsigned char>(*cur_ - '0') <= 9) {
+            v = v * 10 + static_cast<uint64_t>(*cur_ - '0');
+            ++cur_;
+        }
+        if (cur_ == start) [[unlikely]] {
+            return fail();
+        }
+        out = v;
+        return true;
+    }
+
+    // Consume a null literal if one is next.
+    bool readNull() noexcept {
+        skipWhitespace();
+        if (end_ - cur_ >= 4 && std::memcmp(cur_, "null", 4) == 0) {
+            cur_ += 4;
+            return true;
+        }
+        return false;
+    }
+
+    // Skip over the next value of any type.
+    bool skipValue() noexcept {
+        skipWhitespace();
+        if (cur_ >= end_) [[unlikely]] {
+            return fail();
+        }
+        switch (*cur_) {
+        case '"': {
+            const char *close = findClosingQuote(cur_ + 1);
+            if (!close) [[unlikely]] {
+                return fail();
+            }
+            cur_ = close + 1;
+            return true;
+        }
+        case '{':
+        case '[':
+            return skipContainer();
+        default:
+            while (cur_ < end_ && !isDelimiter(*cur_)) {
+                ++cur_;
+            }
+            return true;
+        }
+    }
+
+private:
+    static bool isDelimiter(char c) noexcept {
+        return c == ',' || c == '}' || c == ']' || c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    void skipWhitespace() noexcept {
+        while (cur_ < end_ && (*cur_ == ' ' || *cur_ == '\n' || *cur_ == '\r' || *cur_ == '\t')) {
+            ++cur_;
+        }
+    }
+
+    bool expect(char c) noexcept {
+        skipWhitespace();
+        if (cur_ >= end_ || *cur_ != c) [[unlikely]] {
+            return fail();
+        }
+        ++cur_;
+        return true;
+    }
+
+    bool fail() noexcept {
+        failed_ = true;
+        cur_ = end_;
+        return false;
+    }
+
+    // Find the quote terminating a string whose contents start at p.
+    const char* findClosingQuote(const char *p) const noexcept {
+        while (p < end_) {
+            auto q = static_cast<const char*>(std::memchr(p, '"', static_cast<std::size_t>(end_ - p)));
+            if (!q) {
+                return nullptr;
+            }
+            // an odd number of preceding backslashes means the quote is escaped
+            const char *b = q;
+            while (b > begin_ && *(b - 1) == '\\') {
+                --b;
+            }
+            if (((q - b) & 1) == 0) {
+                return q;
+            }
+            p = q + 1;
+        }
+        return nullptr;
+    }
+
+    bool skipContainer() noexcept {
+        uint32_t depth = 0;
+        while (cur_ < end_) {
+            char c = *cur_;
+            if (c == '"') {
+                const char *close = findClosingQuote(cur_ + 1);
+                if (!close) [[unlikely]] {
+                    return fail();
+                }
+                cur_ = close + 1;
+                continue;
+            }
+            ++cur_;
+            if (c == '{' || c == '[') {
+                ++depth;
+            }
+            else if (c == '}' || c == ']') {
+                if (--depth == 0) {
+                    return true;
+                }
+            }
+        }
+        return fail();
+    }
+
+private:
+    const char *begin_;
+    const char *cur_;
+    const char *end_;
+    bool failed_ = false;
+};
+
+}   // end namespace coinbase
@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <coinbase/auth.hpp>
+
+namespace coinbase {
+
+// Pre-signed JWTs for a fixed set of request uris (method + host + path, e.g.
+// "POST api.coinbase.com/api/v3/brokerage/orders").
+//
+// A token is valid for JwtSigner::LIFETIME_SECONDS, so one signature can serve
+// every request to its uri for a while. Tokens are signed when a uri is added
+// and re-signed by a background thread every refresh_interval, which keeps
+// signing off the request path. authorization() signs inline only for uris
+// that were not added or whose token is close to expiry (the refresh thread
+// fell behind). Thread safe.
+class JwtTokenCache
+{
+public:
+    // refresh_interval must leave a margin before the token expires; tokens with
+    // less than MIN_REMAINING left are never served
+    static constexpr std::chrono::seconds MIN_REMAINING{15};
+
+    explicit JwtTokenCache(const JwtSigner &signer, std::chrono::milliseconds refresh_interval = std::chrono::seconds(60));
+    ~JwtTokenCache();
+
+    JwtTokenCache(const JwtTokenCache&) = delete;
+    JwtTokenCache& operator=(const JwtTokenCache&) = delete;
+
+    // Sign uri now and keep it refreshed. Throws std::runtime_error if signing fails.
+    void add(std::string uri);
+
+    // "Bearer <jwt>" for uri. Throws std::runtime_error if a token has to be
+    // signed inline and signing fails.
+    std::string authorization(std::string_view uri) const;
+
+    std::size_t size() const;
+
+private:
+    struct Entry {
+        std::string uri;
+        std::string authorization;
+        int64_t not_before = 0;     // seconds since epoch, the token's nbf
+    };
+
+    std::string sign(std::string_view uri, int64_t now_seconds) const;
+    void refresh();
+
+    const JwtSigner &signer_;
+    std::chrono::milliseconds refresh_interval_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<Entry> entries_;
+    bool stopping_ = false;
+    std::thread refresh_thread_;
+};
+
+}   // end namespace coinbase
@@ -24,13 +24,41 @@ inline void from_json(const json &j, Level2Update &l) {
     DOUBLE_FROM_JSON(j, l, new_quantity);
 }
 
+inline void from_scanner(JsonScanner &s, Level2Update &l) {
+    std::string_view key, value;
+    if (!s.enterObject()) {
+        return;
+    }
+    while (s.nextKey(key)) {
+        if (key == "price_level") {
+            l.price_level = double_from_scanner(s);
+        }
+        else if (key == "new_quantity") {
+            l.new_quantity = double_from_scanner(s);
+        }
+        else if (key == "side") {
+            if (s.readString(value)) {
+                l.side = to_side(value);
+            }
+        }
+        else if (key == "event_time") {
+            l.event_time = nanoseconds_from_scanner(s);
+        }
+        else {
+            s.skipValue();
+        }
+    }
+}
+
 struct Level2UpdateBatch {
     std::string product_id;
     std::vector<Level2Update> updates;
+    ProductHandle product_handle = INVALID_PRODUCT_HANDLE;
 };
 
 inline void from_json(const json &j, Level2UpdateBatch &l) {
     j.at("product_id").get_to(l.product_id);
+    l.product_handle = intern_product_id(l.product_id);
     l.updates.reserve(j.at("updates").size());
     l.updates = j["updates"];
 }
@@ -48,10 +76,12 @@ struct Ticker {
     double best_bid_quantity;
     double best_ask;
     double best_ask_quantity;
+    ProductHandle product_handle = INVALID_PRODUCT_HANDLE;
 };
 
 inline void from_json(const json &j, Ticker &t) {
     VARIABLE_FROM_JSON(j, t, product_id);
+    t.product_handle = intern_product_id(t.product_id);
     DOUBLE_FROM_JSON(j, t, price);
     DOUBLE_FROM_JSON(j, t, volume_24_h);
     DOUBLE_FROM_JSON(j, t, low_24_h);
@@ -65,6 +95,85 @@ inline void from_json(const json &j, Ticker &t) {
     DOUBLE_FROM_JSON(j, t, best_ask_quantity);
 }
 
+// Ticker fields, used as a bit mask to select which fields the on-demand
+// decoder reads. product_id and product_handle are always decoded.
+struct TickerField {
+    enum : uint32_t {
+        PRICE = 1u << 0,
+        VOLUME_24_H = 1u << 1,
+        LOW_24_H = 1u << 2,
+        HIGH_24_H = 1u << 3,
+        LOW_52_W = 1u << 4,
+        HIGH_52_W = 1u << 5,
+        PRICE_PERCENT_CHG_24_H = 1u << 6,
+        BEST_BID = 1u << 7,
+        BEST_BID_QUANTITY = 1u << 8,
+        BEST_ASK = 1u << 9,
+        BEST_ASK_QUANTITY = 1u << 10,
+        ALL = ~0u,
+    };
+};
+
+// Fields not in `fields` are skipped without parsing and left untouched.
+inline void from_scanner(JsonScanner &s, Ticker &t, uint32_t fields = TickerField::ALL) {
+    std::string_view key, value;
+    if (!s.enterObject()) {
+        return;
+    }
+    auto read = [&](uint32_t field, double &out) {
+        if (fields & field) {
+            out = double_from_scanner(s);
+        }
+        else {
+            s.skipValue();
+        }
+    };
+    while (s.nextKey(key)) {
+        if (key == "product_id") {
+            if (s.readString(value)) {
+                t.product_id.assign(value);
+                t.product_handle = intern_product_id(value);
+            }
+        }
+        else if (key == "price") {
+            read(TickerField::PRICE, t.price);
+        }
+        else if (key == "volume_24_h") {
+            read(TickerField::VOLUME_24_H, t.volume_24_h);
+        }
+        else if (key == "low_24_h") {
+            read(TickerField::LOW_24_H, t.low_24_h);
+        }
+        else if (key == "high_24_h") {
+            read(TickerField::HIGH_24_H, t.high_24_h);
+        }
+        else if (key == "low_52_w") {
+            read(TickerField::LOW_52_W, t.low_52_w);
+        }
+        else if (key == "high_52_w") {
+            read(TickerField::HIGH_52_W, t.high_52_w);
+        }
+        else if (key == "price_percent_chg_24_h") {
+            read(TickerField::PRICE_PERCENT_CHG_24_H, t.price_percent_chg_24_h);
+        }
+        else if (key == "best_bid") {
+            read(TickerField::BEST_BID, t.best_bid);
+        }
+        else if (key == "best_bid_quantity") {
+            read(TickerField::BEST_BID_QUANTITY, t.best_bid_quantity);
+        }
+        else if (key == "best_ask") {
+            read(TickerField::BEST_ASK, t.best_ask);
+        }
+        else if (key == "best_ask_quantity") {
+            read(TickerField::BEST_ASK_QUANTITY, t.best_ask_quantity);
+        }
+        else {
+            s.skipValue();
+        }
+    }
+}
+
 struct MarketTrade {
     std::string trade_id;
     std::string product_id;
@@ -72,17 +181,56 @@ struct MarketTrade {
     double price;
     double size;
     Side side;
+    ProductHandle product_handle = INVALID_PRODUCT_HANDLE;
 };
 
 inline void from_json(const json &j, MarketTrade &m) {
     VARIABLE_FROM_JSON(j, m, trade_id);
     VARIABLE_FROM_JSON(j, m, product_id);
+    m.product_handle = intern_product_id(m.product_id);
     TIMESTAMP_FROM_JSON(j, m, time);
     DOUBLE_FROM_JSON(j, m, price);
     DOUBLE_FROM_JSON(j, m, size);
     ENUM_FROM_JSON(j, m, side);
 }
 
+inline void from_scanner(JsonScanner &s, MarketTrade &m) {
+    std::string_view key, value;
+    if (!s.enterObject()) {
+        return;
+    }
+    while (s.nextKey(key)) {
+        if (key == "trade_id") {
+            if (s.readString(value)) {
+                m.trade_id.assign(value);
+            }
+        }
+        else if (key == "product_id") {
+            if (s.readString(value)) {
+                m.product_id.assign(value);
+                m.product_handle = intern_product_id(value);
+            }
+        }
+        else if (key == "time") {
+            m.time = nanoseconds_from_scanner(s);
+        }
+        else if (key == "price") {
+            m.price = double_from_scanner(s);
+        }
+        else if (key == "size") {
+            m.size = double_from_scanner(s);
+        }
+        else if (key == "side") {
+            if (s.readString(value)) {
+                m.side = to_side(value);
+            }
+        }
+        else {
+            s.skipValue();
+        }
+    }
+}
+
 struct Status {
     ProductType product_type;
     std::string id;
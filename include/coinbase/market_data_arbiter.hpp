@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace coinbase {
+
+struct MarketDataRedundancyConfig {
+    uint32_t standby_connections = 1;           // in addition to the primary market data websocket
+    uint32_t dedup_window = 16384;              // recent events remembered across connections
+    uint32_t read_buffer_size = 1u << 26;       // per standby connection
+    uint32_t record_size = 1u << 16;
+    uint32_t write_buffer_size = 1u << 20;
+};
+
+struct MarketDataConnectionStats {
+    uint64_t frames = 0;        // frames received
+    uint64_t forwarded = 0;     // first copies, handed to the data handler
+    uint64_t duplicates = 0;    // copies another connection delivered first
+    uint64_t filtered = 0;      // forwarded without the events another connection delivered first
+    uint64_t gaps = 0;          // sequence gaps of this connection
+    uint64_t snapshots = 0;     // snapshots dropped, another connection serves the books
+    bool connected = false;
+};
+
+// Arbitrates between market data connections subscribed to the same products:
+// the first copy of an event is forwarded, later copies are dropped, so the
+// data handler sees the fastest path and a stalled connection simply stops
+// winning.
+//
+// Coinbase numbers frames per connection, so sequence_num cannot identify the
+// copies, and connections may batch the same events into frames differently.
+// Events are therefore matched one by one: a market_trades trade on
+// (product_id, trade_id), an l2_data update on (product_id, side, price_level,
+// event_time), anything else (tickers, candles, heartbeats) on its text. A
+// frame whose events were all delivered is dropped; one mixing delivered and
+// new events is forwarded as a copy holding only the new ones. The keys of
+// the last dedup_window events are kept in a 4-way set-associative table.
+// Sequence numbers are checked per connection; a gap only loses data when no
+// other connection was up to deliver the frames.
+//
+// Snapshots differ per connection, so they are never dropped as copies; instead
+// only the snapshot source's are forwarded. That is the first connection up,
+// a connection taking over when the source goes down, or the one a resync was
+// requested on. A connection joining while another is up would otherwise
+// reset the books to its own snapshot, which may be older than the deltas
+// already applied, and its copies of the newer deltas would then be dropped.
+//
+// accept() must be called by one thread at a time; the other methods may be
+// called from any thread.
+class MarketDataArbiter
+{
+public:
+    static constexpr uint32_t WAYS = 4;
+    static constexpr uint32_t NO_CONNECTION = std::numeric_limits<uint32_t>::max();
+
+    explicit MarketDataArbiter(uint32_t connections, uint32_t dedup_window = 16384);
+
+    MarketDataArbiter(const MarketDataArbiter&) = delete;
+    MarketDataArbiter& operator=(const MarketDataArbiter&) = delete;
+
+    uint32_t connections() const noexcept { return count_; }
+
+    // A frame received on connection. Returns true if it carries events no
+    // other connection delivered first; frame is then the frame to process,
+    // data itself or a copy without the delivered events that stays valid
+    // until the next accept(). gap is set if connection skipped sequence
+    // numbers while no other connection was connected.
+    bool accept(uint32_t connection, const char* data, std::size_t size, bool &gap, std::string_view &frame);
+
+    bool accept(uint32_t connection, const char* data, std::size_t size, bool &gap) {
+        std::string_view frame;
+        return accept(connection, data, size, gap, frame);
+    }
+
+    void connected(uint32_t connection) noexcept;
+    void disconnected(uint32_t connection) noexcept;
+    uint32_t connectedCount() const noexcept;
+
+    // Forward the snapshots of connection from now on, e.g. the one a resync
+    // is requested on
+    void setSnapshotSource(uint32_t connection) noexcept;
+    uint32_t snapshotSource() const noexcept { return snapshot_source_.load(std::memory_order_acquire); }
+
+    MarketDataConnectionStats stats(uint32_t connection) const noexcept;
+
+    // true if the first event of the frame is a snapshot
+    static bool isSnapshot(const char* data, std::size_t size) noexcept;
+
+private:
+    struct Connection {
+        std::atomic<int64_t> last_seq_num{-1};
+        std::atomic<bool> connected{false};
+        std::atomic<uint64_t> frames{0};
+        std::atomic<uint64_t> forwarded{0};
+        std::atomic<uint64_t> duplicates{0};
+        std::atomic<uint64_t> filtered{0};
+        std::atomic<uint64_t> gaps{0};
+        std::atomic<uint64_t> snapshots{0};
+    };
+
+    // An event of the frame being arbitrated, or one element of its item
+    // array (trades, updates, tickers, ...)
+    struct Item {
+        const char* begin;
+        const char* end;
+        uint64_t key;
+        bool fresh;
+    };
+    struct Event {
+        const char* begin;
+        const char* end;
+        const char* items_begin;    // after the '[' of its item array, nullptr if it is an item itself
+        const char* items_end;      // at the ']' of its item array
+        uint32_t first_item;
+        uint32_t item_count;
+    };
+
+    bool othersConnected(uint32_t connection) const noexcept;
+    // Fill events_ and items_; false if the frame has no events array
+    bool scanEvents(const char* data, std::size_t size);
+    bool known(uint64_t key) const noexcept;
+    void remember(uint64_t key) noexcept;
+    // The frame without the items that are not fresh, in filtered_
+    std::string_view filter(const char* data, std::size_t size);
+
+    uint32_t count_;
+    std::unique_ptr<Connection[]> connections_;
+    std::atomic<uint32_t> snapshot_source_{NO_CONNECTION};
+    std::vector<uint64_t> keys_;        // buckets of WAYS keys
+    std::vector<uint8_t> next_;         // round-robin replacement per bucket
+    uint64_t bucket_mask_;
+    // scratch of accept()
+    std::vector<Event> events_;
+    std::vector<Item> items_;
+    const char* events_begin_ = nullptr;    // after the '[' of the events array
+    const char* events_end_ = nullptr;      // at its ']'
+    std::string filtered_;
+};
+
+}   // end namespace coinbase
@@ -0,0 +1,205 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include <coinbase/json_scanner.hpp>
+#include <coinbase/market_data.hpp>
+#include <coinbase/candle.hpp>
+
+namespace coinbase {
+
+// Selects how DataHandler decodes market data frames.
+enum class MarketDataDecoder : uint8_t {
+    DOM,        // nlohmann::json DOM (default)
+    ON_DEMAND,  // single pass over the raw frame with JsonScanner, no DOM
+};
+
+// Top-level fields of a market data frame.
+struct MarketDataFrame {
+    std::string_view channel;
+    std::string_view type;
+    std::string_view timestamp;
+    uint64_t sequence_num = 0;
+    bool has_sequence_num = false;
+};
+
+// Scan the top-level object of a market data frame.
+//
+// on_events(const MarketDataFrame&, JsonScanner&) is invoked with the scanner
+// positioned on the "events" array and must consume that array completely
+// (decode it or skipValue()). Coinbase sends channel, timestamp and
+// sequence_num ahead of events, in which case the events are decoded in the
+// same pass; otherwise the array is skipped and revisited once the whole
+// object has been scanned.
+//
+// Returns false if the frame is malformed.
+template<typename OnEvents>
+bool scan_market_data_frame(const char *data, std::size_t size, MarketDataFrame &frame, OnEvents &&on_events) {
+    JsonScanner s(data, size);
+    std::string_view key;
+    const char *events = nullptr;
+    bool has_timestamp = false;
+    bool events_done = false;
+    if (!s.enterObject()) {
+        return false;
+    }
+    while (s.nextKey(key)) {
+        if (key == "channel") {
+            s.readString(frame.channel);
+        }
+        else if (key == "timestamp") {
+            has_timestamp = s.readString(frame.timestamp);
+        }
+        else if (key == "sequence_num") {
+            frame.has_sequence_num = s.readUInt(frame.sequence_num);
+        }
+        else if (key == "type") {
+            s.readString(frame.type);
+        }
+        else if (key == "events") {
+            if (!frame.channel.empty() && has_timestamp && frame.has_sequence_num) {
+                on_events(static_cast<const MarketDataFrame&>(frame), s);
+                events_done = true;
+            }
+            else {
+                events = s.position();
+                s.skipValue();
+            }
+        }
+        else {
+            s.skipValue();
+        }
+    }
+    if (!s.ok()) {
+        return false;
+    }
+    if (events && !events_done) {
+        s.seek(events);
+        on_events(static_cast<const MarketDataFrame&>(frame), s);
+    }
+    return s.ok();
+}
+
+// Read channel, type and sequence_num from the top of a frame without touching
+// the events. Stops as soon as channel and sequence_num are known, which for
+// Coinbase frames is before "events". timestamp is not filled in.
+//
+// Returns false if the frame is malformed.
+inline bool peek_market_data_frame(const char *data, std::size_t size, MarketDataFrame &frame) {
+    JsonScanner s(data, size);
+    std::string_view key;
+    if (!s.enterObject()) {
+        return false;
+    }
+    while (s.nextKey(key)) {
+        if (key == "channel") {
+            s.readString(frame.channel);
+        }
+        else if (key == "sequence_num") {
+            frame.has_sequence_num = s.readUInt(frame.sequence_num);
+        }
+        else if (key == "type") {
+            s.readString(frame.type);
+        }
+        else {
+            s.skipValue();
+        }
+        if (!frame.channel.empty() && frame.has_sequence_num) {
+            break;
+        }
+    }
+    return s.ok();
+}
+
+// Decode the events of an l2_data frame. batch is reused for every event and
+// sink(std::string_view event_type, const Level2UpdateBatch&) is invoked once
+// per event.
+template<typename Sink>
+void decode_level2_events(JsonScanner &s, Level2UpdateBatch &batch, Sink &&sink) {
+    std::string_view key, value, type;
+    if (!s.enterArray()) {
+        return;
+    }
+    while (s.nextElement()) {
+        if (!s.enterObject()) {
+            return;
+        }
+        type = {};
+        batch.product_id.clear();
+        batch.product_handle = INVALID_PRODUCT_HANDLE;
+        batch.updates.clear();
+        while (s.nextKey(key)) {
+            if (key == "type") {
+                s.readString(type);
+            }
+            else if (key == "product_id") {
+                if (s.readString(value)) {
+                    batch.product_id.assign(value);
+                    batch.product_handle = intern_product_id(value);
+                }
+            }
+            else if (key == "updates") {
+                if (!s.enterArray()) {
+                    return;
+                }
+                while (s.nextElement()) {
+                    from_scanner(s, batch.updates.emplace_back());
+                }
+            }
+            else {
+                s.skipValue();
+            }
+        }
+        if (!s.ok()) {
+            return;
+        }
+        sink(type, static_cast<const Level2UpdateBatch&>(batch));
+    }
+}
+
+// Decode the events of a frame whose events carry a single array of T under
+// `field` (market_trades: "trades", ticker: "tickers", candles: "candles").
+// items is reused for every event and sink(std::string_view event_type,
+// const std::vector<T>&) is invoked once per event. args are passed on to
+// from_scanner(s, item, args...), e.g. a TickerField mask.
+template<typename T, typename Sink, typename... Args>
+void decode_events(JsonScanner &s, std::string_view field, std::vector<T> &items, Sink &&sink, const Args&... args) {
+    std::string_view key, type;
+    if (!s.enterArray()) {
+        return;
+    }
+    while (s.nextElement()) {
+        if (!s.enterObject()) {
+            return;
+        }
+        type = {};
+        items.clear();
+        while (s.nextKey(key)) {
+            if (key == "type") {
+                s.readString(type);
+            }
+            else if (key == field) {
+                if (!s.enterArray()) {
+                    return;
+                }
+                while (s.nextElement()) {
+                    from_scanner(s, items.emplace_back(), args...);
+                }
+            }
+            else {
+                s.skipValue();
+            }
+        }
+        if (!s.ok()) {
+            return;
+        }
+        sink(type, static_cast<const std::vector<T>&>(items));
+    }
+}
+
+}   // end namespace coinbase
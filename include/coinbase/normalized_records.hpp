@@ -0,0 +1,201 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+#include <slick/stream_buffer_multiplexer.hpp>
+#include <coinbase/market_data.hpp>
+#include <coinbase/candle.hpp>
+#include <coinbase/order.hpp>
+
+namespace coinbase {
+
+// Fixed-layout binary records published by WebSocketClient::enableNormalizedRecords().
+//
+// Every record starts with a RecordHeader followed by header.count entries of
+// the type's entry struct, so a reader in another process can use the bytes of
+// a multiplexer record directly without parsing. Strings are NUL-padded fixed
+// arrays, prices and sizes are doubles, times are nanoseconds since the epoch
+// unless noted.
+// Record sizes are multiples of 8 bytes.
+
+constexpr uint32_t NO_PRODUCER_ID = std::numeric_limits<uint32_t>::max();
+constexpr std::size_t RECORD_PRODUCT_ID_SIZE = 24;
+
+enum class RecordType : uint8_t {
+    LEVEL2 = 1,
+    TRADE,
+    TICKER,
+    CANDLE,
+    ORDER,
+};
+
+struct RecordFlags {
+    enum : uint8_t {
+        SNAPSHOT = 1u << 0,     // entries belong to a snapshot event
+        FIRST = 1u << 1,        // first record of the event
+        LAST = 1u << 2,         // last record of the event
+    };
+};
+
+// An event too large for one multiplexer record is split over several records
+// of the same seq_num; FIRST and LAST mark the ends. A Level2 record carrying
+// SNAPSHOT | FIRST replaces the book.
+struct RecordHeader {
+    RecordType type;
+    uint8_t flags;
+    uint16_t count;         // number of entries
+    uint32_t size;          // record size in bytes
+    uint64_t seq_num;
+    uint64_t timestamp;     // frame timestamp
+};
+static_assert(sizeof(RecordHeader) == 24);
+
+// RecordType::LEVEL2: one record per l2_data event, Level2Entry[count] follow.
+struct Level2Record {
+    RecordHeader header;
+    char product_id[RECORD_PRODUCT_ID_SIZE];
+};
+static_assert(sizeof(Level2Record) == 48);
+
+struct Level2Entry {
+    static constexpr RecordType TYPE = RecordType::LEVEL2;
+    static constexpr std::size_t OFFSET = sizeof(Level2Record);
+
+    uint64_t event_time;
+    double price_level;
+    double new_quantity;
+    Side side;
+    uint8_t reserved[7];
+};
+static_assert(sizeof(Level2Entry) == 32);
+
+struct TradeEntry {
+    static constexpr RecordType TYPE = RecordType::TRADE;
+    static constexpr std::size_t OFFSET = sizeof(RecordHeader);
+
+    char product_id[RECORD_PRODUCT_ID_SIZE];
+    char trade_id[RECORD_PRODUCT_ID_SIZE];
+    uint64_t time;
+    double price;
+    double size;
+    Side side;
+    uint8_t reserved[7];
+};
+static_assert(sizeof(TradeEntry) == 80);
+
+struct TickerEntry {
+    static constexpr RecordType TYPE = RecordType::TICKER;
+    static constexpr std::size_t OFFSET = sizeof(RecordHeader);
+
+    char product_id[RECORD_PRODUCT_ID_SIZE];
+    double price;
+    double volume_24_h;
+    double low_24_h;
+    double high_24_h;
+    double low_52_w;
+    double high_52_w;
+    double price_percent_chg_24_h;
+    double best_bid;
+    double best_bid_quantity;
+    double best_ask;
+    double best_ask_quantity;
+};
+static_assert(sizeof(TickerEntry) == 112);
+
+struct CandleEntry {
+    static constexpr RecordType TYPE = RecordType::CANDLE;
+    static constexpr std::size_t OFFSET = sizeof(RecordHeader);
+
+    char product_id[RECORD_PRODUCT_ID_SIZE];
+    uint64_t start;         // unix seconds, as sent
+    double open;
+    double high;
+    double low;
+    double close;
+    double volume;
+};
+static_assert(sizeof(CandleEntry) == 72);
+
+struct OrderEntry {
+    static constexpr RecordType TYPE = RecordType::ORDER;
+    static constexpr std::size_t OFFSET = sizeof(RecordHeader);
+
+    char product_id[RECORD_PRODUCT_ID_SIZE];
+    char order_id[40];
+    char client_order_id[40];
+    uint64_t created_time;
+    uint64_t last_fill_time;
+    double limit_price;
+    double avg_price;
+    double leaves_quantity;
+    double cumulative_quantity;
+    double filled_value;
+    double total_fees;
+    uint32_t number_of_fills;
+    Side side;
+    OrderStatus status;
+    OrderType order_type;
+    TimeInForce time_in_force;
+};
+static_assert(sizeof(OrderEntry) == 176);
+
+// Text of a fixed, NUL-padded string field.
+template<std::size_t N>
+std::string_view record_string(const char (&field)[N]) noexcept {
+    std::size_t n = 0;
+    while (n < N && field[n] != '\0') {
+        ++n;
+    }
+    return std::string_view(field, n);
+}
+
+// Header of a multiplexer record, nullptr if it is too short to be one.
+inline const RecordHeader* record_header(const uint8_t *data, uint32_t length) noexcept {
+    if (length < sizeof(RecordHeader)) {
+        return nullptr;
+    }
+    auto *header = reinterpret_cast<const RecordHeader*>(data);
+    return header->size <= length ? header : nullptr;
+}
+
+// Entries of a record, empty if header is not a record of Entry.
+template<typename Entry>
+std::span<const Entry> record_entries(const RecordHeader &header) noexcept {
+    if (header.type != Entry::TYPE || header.size < Entry::OFFSET + header.count * sizeof(Entry)) {
+        return {};
+    }
+    auto *base = reinterpret_cast<const uint8_t*>(&header);
+    return {reinterpret_cast<const Entry*>(base + Entry::OFFSET), header.count};
+}
+
+// Writes records into a producer buffer of a stream_buffer_multiplexer. Used
+// by the data handler on the thread that decodes the frames.
+class RecordWriter {
+public:
+    using ProducerBuffer = slick::stream_buffer_multiplexer::producer_buffer;
+
+    RecordWriter(std::shared_ptr<ProducerBuffer> buffer, uint32_t max_record_size);
+
+    void writeLevel2(uint64_t seq_num, uint64_t timestamp, bool snapshot, std::string_view product_id, std::span<const Level2Update> updates);
+    void writeTrades(uint64_t seq_num, uint64_t timestamp, bool snapshot, std::span<const MarketTrade> trades);
+    void writeTickers(uint64_t seq_num, uint64_t timestamp, bool snapshot, std::span<const Ticker> tickers);
+    void writeCandles(uint64_t seq_num, uint64_t timestamp, bool snapshot, std::span<const Candle> candles);
+    void writeOrders(uint64_t seq_num, uint64_t timestamp, bool snapshot, std::span<const Order> orders);
+
+private:
+    template<typename Entry, typename Item, typename Fill>
+    void write(uint64_t seq_num, uint64_t timestamp, bool snapshot, std::string_view product_id, std::span<const Item> items, Fill &&fill);
+
+    std::shared_ptr<ProducerBuffer> buffer_;
+    uint32_t max_record_size_;
+};
+
+}   // end namespace coinbase
@@ -507,6 +507,7 @@ struct Order {
     bool size_inclusive_of_fees = false;
     bool settled = false;
     bool is_liquidation = false;
+    ProductHandle product_handle = INVALID_PRODUCT_HANDLE;
 };
 
 inline void from_json(const json &j, Order &o) {
@@ -514,6 +515,7 @@ inline void from_json(const json &j, Order &o) {
         VARIABLE_FROM_JSON(j, o, client_order_id);
         VARIABLE_FROM_JSON(j, o, order_id);
         VARIABLE_FROM_JSON(j, o, product_id);
+        o.product_handle = intern_product_id(o.product_id);
         VARIABLE_FROM_JSON(j, o, trigger_status);
         VARIABLE_FROM_JSON(j, o, reject_Reason);
         VARIABLE_FROM_JSON(j, o, product_type);
@@ -568,6 +570,7 @@ inline void from_snapshot(const json &j, Order &o) {
     VARIABLE_FROM_JSON(j, o, client_order_id);
     VARIABLE_FROM_JSON(j, o, order_id);
     VARIABLE_FROM_JSON(j, o, product_id);
+    o.product_handle = intern_product_id(o.product_id);
     DOUBLE_FROM_JSON(j, o, limit_price);
     DOUBLE_FROM_JSON(j, o, avg_price);
     DOUBLE_FROM_JSON(j, o, completion_percentage);
@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <coinbase/common.hpp>
+#include <coinbase/fixed_point.hpp>
+#include <coinbase/market_data.hpp>
+#include <coinbase/product.hpp>
+
+namespace coinbase {
+
+struct BookLevel {
+    double price;
+    double quantity;
+};
+
+// Level 2 order book for one product.
+//
+// Prices are mapped to integer ticks of the product's quote_increment, the same
+// integers a Price holds under priceScale(). Each side keeps a flat quantity
+// array covering a window of ticks around its best price, so applying an update
+// is an index computation plus a store, and the best price is tracked
+// incrementally. Levels that fall outside the window are kept
+// in an ordered overflow map; the window is re-centred when the best price
+// moves out of it.
+//
+// A DataHandler feeds the book from l2_data events, see
+// WebSocketClient::addOrderBook().
+class OrderBook {
+public:
+    static constexpr uint32_t DEFAULT_WINDOW_TICKS = 1u << 14;
+
+    explicit OrderBook(const Product &product, uint32_t window_ticks = DEFAULT_WINDOW_TICKS);
+    OrderBook(std::string_view product_id, double tick_size, uint32_t window_ticks = DEFAULT_WINDOW_TICKS);
+
+    std::string_view productId() const noexcept { return product_id_; }
+    double tickSize() const noexcept { return tick_size_; }
+
+    // scale mapping Price ticks to and from decimal prices of this book
+    const DecimalScale& priceScale() const noexcept { return price_scale_; }
+
+    // sequence number of the last applied snapshot or update
+    uint64_t sequenceNum() const noexcept { return seq_num_; }
+
+    // event_time of the most recent level applied
+    uint64_t eventTime() const noexcept { return event_time_; }
+
+    void clear();
+
+    // Replace the book content with a snapshot.
+    void applySnapshot(std::span<const Level2Update> snapshot, uint64_t seq_num);
+
+    // Apply incremental updates. A zero new_quantity removes the level.
+    void applyUpdates(std::span<const Level2Update> updates, uint64_t seq_num);
+
+    void apply(const Level2Update &update);
+    void apply(Side side, Price price, double quantity) { ladder(side).set(price.value, quantity); }
+
+    bool empty(Side side) const noexcept { return ladder(side).size() == 0; }
+    std::size_t levelCount(Side side) const noexcept { return ladder(side).size(); }
+
+    std::optional<BookLevel> bestBid() const noexcept { return best(bids_); }
+    std::optional<BookLevel> bestAsk() const noexcept { return best(asks_); }
+
+    // Quantity resting at price, 0 if the level is empty.
+    double quantityAt(Side side, double price) const noexcept;
+    double quantityAt(Side side, Price price) const noexcept { return ladder(side).get(price.value); }
+
+    // Fill out with up to out.size() levels of side, best first. Returns the
+    // number of levels written.
+    std::size_t depth(Side side, std::span<BookLevel> out) const;
+
+    // Convenience overload returning up to n levels.
+    std::vector<BookLevel> depth(Side side, std::size_t n) const;
+
+private:
+    class Ladder {
+    public:
+        Ladder(bool is_bid, uint32_t window_ticks);
+
+        void clear();
+        void set(int64_t tick, double quantity);
+        double get(int64_t tick) const noexcept;
+        std::size_t size() const noexcept { return dense_count_ + overflow_.size(); }
+        bool hasBest() const noexcept { return size() > 0; }
+        int64_t bestTick() const noexcept { return best_; }
+        double bestQuantity() const noexcept { return qty_[index(best_)]; }
+
+        template<typename F>
+        void forEach(F &&f) const;
+
+    private:
+        bool inWindow(int64_t tick) const noexcept {
+            return tick >= base_ && tick < base_ + static_cast<int64_t>(qty_.size());
+        }
+        std::size_t index(int64_t tick) const noexcept { return static_cast<std::size_t>(tick - base_); }
+        bool better(int64_t a, int64_t b) const noexcept { return is_bid_ ? a > b : a < b; }
+        void recenter(int64_t best_tick);
+        void findBest();
+
+        bool is_bid_;
+        int64_t base_ = 0;                  // tick of qty_[0]
+        int64_t best_ = 0;                  // valid when size() > 0, always inside the window
+        std::size_t dense_count_ = 0;
+        std::vector<double> qty_;
+        std::map<int64_t, double> overflow_; // levels worse than the window
+    };
+
+    const Ladder& ladder(Side side) const noexcept { return side == Side::BUY ? bids_ : asks_; }
+    Ladder& ladder(Side side) noexcept { return side == Side::BUY ? bids_ : asks_; }
+
+    int64_t toTick(double price) const noexcept;
+    double toPrice(int64_t tick) const noexcept;
+    std::optional<BookLevel> best(const Ladder &l) const noexcept;
+
+    std::string product_id_;
+    double tick_size_;
+    DecimalScale price_scale_;
+    uint64_t seq_num_ = 0;
+    uint64_t event_time_ = 0;
+    Ladder bids_;
+    Ladder asks_;
+};
+
+template<typename F>
+void OrderBook::Ladder::forEach(F &&f) const {
+    if (dense_count_ > 0) {
+        auto n = static_cast<int64_t>(qty_.size());
+        int64_t step = is_bid_ ? -1 : 1;
+        int64_t end = is_bid_ ? -1 : n;
+        for (int64_t i = best_ - base_; i != end; i += step) {
+            if (qty_[static_cast<std::size_t>(i)] > 0.) {
+                if (!f(base_ + i, qty_[static_cast<std::size_t>(i)])) {
+                    return;
+                }
+            }
+        }
+    }
+    if (is_bid_) {
+        for (auto it = overflow_.rbegin(); it != overflow_.rend(); ++it) {
+            if (!f(it->first, it->second)) {
+                return;
+            }
+        }
+    }
+    else {
+        for (const auto &[tick, quantity] : overflow_) {
+            if (!f(tick, quantity)) {
+                return;
+            }
+        }
+    }
+}
+
+}   // end namespace coinbase
@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <coinbase/fixed_point.hpp>
+#include <coinbase/order.hpp>
+#include <coinbase/product.hpp>
+#include <coinbase/product_spec.hpp>
+
+using json = nlohmann::json;
+
+namespace coinbase {
+
+// Request bodies shared by CoinbaseRestClient and CoinbaseAwaitableRestClient.
+// Increments are taken from ProductCatalog::instance().
+
+// Writes the body of POST /api/v3/brokerage/orders straight into a reusable
+// buffer, without building a json DOM. Prices are formatted with the product's
+// quote_increment, base sizes with its base_increment and quote sizes with its
+// quote_increment, using the decimal scales precomputed in the catalog's
+// ProductSpec. Prices are rounded to the nearest increment and sizes toward
+// zero, so an order never exceeds the size asked for. Not thread safe; keep
+// one writer per thread.
+class OrderRequestWriter
+{
+public:
+    OrderRequestWriter() { buffer_.reserve(512); }
+
+    // Use product's increments instead of the ProductCatalog entry of product.product_id
+    void addProduct(const Product &product);
+
+    // Returns false, with rsp.error_response set, when the parameters do not
+    // form a valid order, including unknown products, sizes and prices that are not finite, do
+    // not fit the product's increments or, for sizes, round to zero. On
+    // success body() holds the request body.
+    bool writeCreateOrder(
+        CreateOrderResponse &rsp,
+        std::string_view client_order_id,
+        std::string_view product_id,
+        Side side,
+        OrderType order_type,
+        TimeInForce time_in_force,
+        double size,
+        double limit_price,
+        bool post_only,
+        bool size_in_quote,
+        const std::optional<double> &stop_price,
+        const std::optional<double> &take_profit_price,
+        const std::optional<uint64_t> &end_time,
+        const std::optional<uint64_t> &twap_start_time,
+        const std::optional<SorPreference> &sor_preference,
+        const std::optional<double> &leverage,
+        const std::optional<MarginType> &margin_type,
+        const std::optional<json> &attached_order_configuration,
+        std::optional<PredictionMetadata> &&prediction_metadata
+    );
+
+    std::string_view body() const noexcept { return buffer_; }
+
+private:
+    friend class OrderTemplate;
+
+    // written in place of the per-order values when building an OrderTemplate
+    static constexpr char CLIENT_ORDER_ID_PLACEHOLDER = '\x01';
+    static constexpr char SIZE_PLACEHOLDER = '\x02';
+    static constexpr char PRICE_PLACEHOLDER = '\x03';
+
+    struct StringHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+    };
+
+    // nullptr if product_id is neither added nor in the catalog
+    const ProductSpec* productSpec(std::string_view product_id);
+    void appendString(std::string_view s);
+    bool checkDecimals(CreateOrderResponse &rsp, const ProductSpec &spec, double size, double limit_price, bool size_in_quote,
+                       const std::optional<double> &stop_price, const std::optional<double> &take_profit_price);
+    void appendDecimal(const char *key, const DecimalScale &scale, double value, DecimalScale::Rounding rounding = DecimalScale::Rounding::NEAREST);
+    void appendSize(const ProductSpec &spec, double size, bool size_in_quote);
+    void appendLimitPrice(const ProductSpec &spec, double limit_price);
+    void appendTimestamp(const char *key, uint64_t timestamp_ms);
+
+    std::string buffer_;
+    std::unordered_map<std::string, ProductSpec, StringHash, std::equal_to<>> overrides_;  // addProduct()
+    ProductSpec spec_;      // of the order being written
+    bool placeholders_ = false;
+};
+
+// A create_order body of a fixed shape (product, side, order configuration,
+// flags), validated and serialized once. Sending an order only writes the
+// constant parts of the body around the client_order_id, size and limit price:
+// no OrderType / TimeInForce dispatch, product lookup or validation. Sizes and
+// prices are formatted with the product's increments as in OrderRequestWriter.
+// Immutable once built, so one template can be shared by threads.
+//
+//   OrderTemplate bid(CoinbaseRestClient::product("BTC-USD"), Side::BUY, OrderType::LIMIT, TimeInForce::GOOD_UNTIL_CANCELLED);
+//   client.create_order(bid, client_order_id, 0.01, 72575.01);
+class OrderTemplate
+{
+public:
+    OrderTemplate() = default;
+
+    // Same parameters as create_order without the per-order values. Check
+    // isValid(); error() says why the shape was rejected.
+    OrderTemplate(
+        const Product &product,
+        Side side,
+        OrderType order_type,
+        TimeInForce time_in_force,
+        bool post_only = true,
+        bool size_in_quote = false,
+        const std::optional<double> &stop_price = {},
+        const std::optional<double> &take_profit_price = {},
+        const std::optional<uint64_t> &end_time = {},
+        const std::optional<uint64_t> &twap_start_time = {},
+        const std::optional<SorPreference> &sor_preference = {},
+        const std::optional<double> &leverage = {},
+        const std::optional<MarginType> &margin_type = {},
+        const std::optional<json> &attached_order_configuration = {}
+    );
+
+    bool isValid() const noexcept { return !segments_.empty(); }
+    const std::string& error() const noexcept { return error_; }
+    const std::string& productId() const noexcept { return product_id_; }
+
+    // false for market orders and brackets with a take profit price, whose
+    // limit_price argument is ignored
+    bool usesLimitPrice() const noexcept { return uses_limit_price_; }
+
+    // Replace out with the body of one order. The template must be valid.
+    // Returns false, leaving out unspecified, if size or the used limit_price
+    // is rejected as by OrderRequestWriter::writeCreateOrder.
+    bool write(std::string &out, std::string_view client_order_id, double size, double limit_price) const;
+
+private:
+    struct Segment {
+        std::string text;           // constant JSON up to the placeholder
+        char placeholder = 0;       // OrderRequestWriter::*_PLACEHOLDER, 0 after the last segment
+    };
+
+    std::string product_id_;
+    std::string error_;
+    std::vector<Segment> segments_;
+    DecimalScale size_scale_;
+    DecimalScale price_scale_;
+    bool uses_limit_price_ = false;
+};
+
+// Body of POST /api/v3/brokerage/orders/edit
+json build_modify_order_body(
+    const std::string &order_id,
+    const std::string &product_id,
+    double price,
+    double size,
+    const std::optional<double> &stop_price,
+    const std::optional<double> &take_profit_price,
+    const std::optional<bool> &cancel_attached_order
+);
+
+}   // end namespace coinbase
@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <coinbase/common.hpp>
+
+namespace coinbase {
+
+// Market data activity of one product. sequence_num is per connection on
+// Coinbase, so last_seq_num is that of the last frame carrying the product.
+struct ProductActivity {
+    uint64_t last_event_time = 0;       // exchange timestamp of the last event, nanoseconds since the epoch
+    uint64_t last_receive_time = 0;     // steady clock nanoseconds when it was processed, 0 if never
+    uint64_t last_seq_num = 0;
+    uint64_t event_count = 0;
+    double event_rate = 0.;             // events per second over the last completed RATE_WINDOW
+};
+
+// Handle-indexed ProductActivity of every product a data handler has seen,
+// so a quiet or stale product can be told apart from a quiet venue.
+//
+// Written by one thread, the one running the data handler, with record() for
+// every decoded event. scan(), every staleAfter() / 4 at most, finds products
+// that just went quiet; it reads entries like get() and may run on another
+// thread (WebSocketClient runs it on a timer), one scan at a time. Any thread
+// reads a product with get(), age() and isStale(), lock-free (a seqlock per
+// entry, as in TopOfBookTable). Entries live in chunks of CHUNK_SIZE
+// allocated on first use, so the table only grows with the handles actually
+// seen.
+class ProductActivityTracker
+{
+public:
+    static constexpr uint32_t CHUNK_SIZE = 256;
+    static constexpr uint32_t MAX_CHUNKS = 1024;
+    static constexpr uint32_t MAX_HANDLES = CHUNK_SIZE * MAX_CHUNKS;
+    static constexpr uint64_t RATE_WINDOW = 1'000'000'000;     // nanoseconds
+
+    explicit ProductActivityTracker(std::chrono::nanoseconds stale_after = std::chrono::seconds(5));
+    ~ProductActivityTracker();
+
+    ProductActivityTracker(const ProductActivityTracker&) = delete;
+    ProductActivityTracker& operator=(const ProductActivityTracker&) = delete;
+
+    std::chrono::nanoseconds staleAfter() const noexcept { return std::chrono::nanoseconds(stale_after_); }
+    std::chrono::nanoseconds scanInterval() const noexcept { return std::chrono::nanoseconds(scan_interval_); }
+
+    // Steady clock nanoseconds, the time base of last_receive_time
+    static uint64_t now() noexcept {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // Writer: an event of handle carried by frame seq_num. Returns true if the
+    // product had been reported stale by scan() and is active again.
+    bool record(ProductHandle handle, uint64_t seq_num, uint64_t event_time, uint64_t now);
+
+    // Scanner: true once the last scan() is older than scanInterval()
+    bool scanDue(uint64_t now) const noexcept { return now >= next_scan_; }
+
+    // Scanner: call on_stale(handle, age) for every product that has been
+    // quiet for staleAfter() and was not reported yet. A product whose next
+    // event is recorded while it is being reported is reported active again
+    // by that event's record() or the next one.
+    template<typename F>
+    void scan(uint64_t now, F &&on_stale) {
+        next_scan_ = now + scan_interval_;
+        for (uint32_t c = 0; c < MAX_CHUNKS; ++c) {
+            auto *chunk = chunks_[c].load(std::memory_order_acquire);
+            if (!chunk) {
+                continue;
+            }
+            for (uint32_t i = 0; i < CHUNK_SIZE; ++i) {
+                auto handle = static_cast<ProductHandle>(c * CHUNK_SIZE + i);
+                ProductActivity activity;
+                if (!get(handle, activity) || now <= activity.last_receive_time || now - activity.last_receive_time < stale_after_) {
+                    continue;
+                }
+                auto &stale = chunk[i].stale;
+                if (!stale.load(std::memory_order_relaxed) && !stale.exchange(true, std::memory_order_acq_rel)) {
+                    on_stale(handle, std::chrono::nanoseconds(now - activity.last_receive_time));
+                }
+            }
+        }
+    }
+
+    // Copy the activity of handle into out; false if it has none
+    bool get(ProductHandle handle, ProductActivity &out) const noexcept {
+        auto *chunk = handle < MAX_HANDLES ? chunks_[handle / CHUNK_SIZE].load(std::memory_order_acquire) : nullptr;
+        if (!chunk) {
+            return false;
+        }
+        const auto &entry = chunk[handle % CHUNK_SIZE];
+        while (true) {
+            auto seq = entry.sequence.load(std::memory_order_acquire);
+            if (seq & 1u) [[unlikely]] {
+                continue;
+            }
+            out = entry.activity;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (entry.sequence.load(std::memory_order_relaxed) == seq) [[likely]] {
+                return out.last_receive_time != 0;
+            }
+        }
+    }
+
+    // Time since the last event of handle, nanoseconds::max() if it had none
+    std::chrono::nanoseconds age(ProductHandle handle, uint64_t now = ProductActivityTracker::now()) const noexcept {
+        ProductActivity activity;
+        if (!get(handle, activity)) {
+            return std::chrono::nanoseconds::max();
+        }
+        return std::chrono::nanoseconds(now > activity.last_receive_time ? now - activity.last_receive_time : 0);
+    }
+
+    bool isStale(ProductHandle handle, uint64_t now = ProductActivityTracker::now()) const noexcept {
+        return age(handle, now).count() >= static_cast<int64_t>(stale_after_);
+    }
+
+    // Handles recorded so far, in first-seen order. Writer thread only.
+    const std::vector<ProductHandle>& tracked() const noexcept { return tracked_; }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint32_t> sequence{0};
+        ProductActivity activity;
+        std::atomic<bool> stale{false};     // set by scan(), cleared by record()
+        // writer only
+        uint64_t window_start = 0;
+        uint32_t window_count = 0;
+    };
+
+    uint64_t stale_after_;
+    uint64_t scan_interval_;
+    uint64_t next_scan_ = 0;                        // scanner only
+    std::array<std::atomic<Slot*>, MAX_CHUNKS> chunks_{};
+    std::vector<std::unique_ptr<Slot[]>> storage_;
+    std::vector<ProductHandle> tracked_;
+};
+
+}   // end namespace coinbase
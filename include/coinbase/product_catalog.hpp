@@ -0,0 +1,191 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <deque>
+#include <coinbase/product.hpp>
+#include <coinbase/product_spec.hpp>
+#include <coinbase/market_data.hpp>
+
+namespace coinbase {
+
+// Process-wide table of products, used to format order prices and sizes.
+//
+// Nothing is loaded implicitly at construction. The catalog is filled by any of:
+//   - loadAsync(): list_public_products() on a background thread; the first
+//     CoinbaseRestClient starts it, so startup does not wait on the network
+//   - loadFromFile(): a saved /api/v3/brokerage/market/products response
+//   - loadSnapshot(): a binary snapshot written by saveSnapshot(), mapped and
+//     copied in one pass without any JSON parsing
+//   - get(): get_public_product() for a product that is not loaded yet; an id
+//     that cannot be fetched is not requested again for MISSING_RETRY_INTERVAL
+//   - update(): status channel updates, applied by every DataHandler
+//
+// Every product id gets a ProductHandle the first time it is stored or
+// interned; decoded market data and orders carry it as product_handle. Hot
+// paths resolve the id once with handle() and afterwards read the product's
+// ProductSpec from a contiguous, handle-indexed table (seqlock per entry, as
+// in TopOfBookTable); the full Product is the cold side, product(handle).
+//
+// Lookups read an immutable snapshot through an atomic shared_ptr and never
+// take the writers' mutex; writers copy the map and publish a new snapshot.
+// Products are never freed, so references returned by find() and get() stay
+// valid (though possibly outdated) for the lifetime of the catalog. instance()
+// is never destroyed, so that lifetime is the process and a load still running
+// at exit neither blocks it nor touches a destroyed catalog.
+class ProductCatalog
+{
+public:
+    static constexpr uint32_t SPEC_CHUNK_SIZE = 256;
+    static constexpr uint32_t MAX_SPEC_CHUNKS = 1024;
+    static constexpr uint32_t MAX_HANDLES = SPEC_CHUNK_SIZE * MAX_SPEC_CHUNKS;
+    static constexpr std::chrono::seconds MISSING_RETRY_INTERVAL{30};
+
+    static ProductCatalog& instance();
+
+    ProductCatalog() = default;
+    ~ProductCatalog();  // waits for a running loadAsync()
+    ProductCatalog(const ProductCatalog&) = delete;
+    ProductCatalog& operator=(const ProductCatalog&) = delete;
+
+    // nullptr if product_id is not loaded
+    const Product* find(std::string_view product_id) const;
+
+    // INVALID_PRODUCT_HANDLE if product_id has not been stored or interned
+    ProductHandle handle(std::string_view product_id) const;
+
+    // handle(), assigning a new handle to an id seen for the first time. An
+    // interned id has no spec or product until the product is loaded.
+    ProductHandle intern(std::string_view product_id);
+
+    // The interned id of handle, empty if it was never assigned
+    std::string_view productId(ProductHandle handle) const;
+
+    // Copy the current spec of handle into out; false if it has none.
+    // Lock-free and allocation-free.
+    bool spec(ProductHandle handle, ProductSpec &out) const noexcept {
+        auto *chunk = handle < MAX_HANDLES ? spec_chunks_[handle / SPEC_CHUNK_SIZE].load(std::memory_order_acquire) : nullptr;
+        if (!chunk) {
+            return false;
+        }
+        const auto &slot = chunk[handle % SPEC_CHUNK_SIZE];
+        while (true) {
+            auto seq = slot.sequence.load(std::memory_order_acquire);
+            if (seq & 1u) [[unlikely]] {
+                continue;
+            }
+            out = slot.spec;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == seq) [[likely]] {
+                return out.handle == handle;
+            }
+        }
+    }
+
+    // The full Product of handle, nullptr if it has none
+    const Product* product(ProductHandle handle) const;
+
+    // find(), or fetch product_id from base_url and add it. Blocking. Returns an
+    // empty product (zero increments) if it cannot be fetched; the failure is
+    // remembered, so get() returns the empty product without a request until
+    // MISSING_RETRY_INTERVAL has passed or the product is loaded otherwise.
+    const Product& get(std::string_view product_id);
+
+    std::size_t size() const;
+
+    // true once a full product list has been loaded
+    bool loaded() const noexcept { return loaded_.load(std::memory_order_acquire); }
+
+    // Incremented by every change; lets caches of derived values (decimal
+    // scales) notice updates with one atomic load.
+    uint64_t version() const noexcept { return version_.load(std::memory_order_acquire); }
+
+    // Host used by loadAsync() without arguments and by get()
+    void setBaseUrl(std::string base_url);
+    std::string baseUrl() const;
+
+    // Add or replace products. A full list marks the catalog loaded().
+    void load(std::vector<Product> products, bool full_list = true);
+    void add(Product product);
+
+    // Load a /api/v3/brokerage/market/products (or /products) response body
+    bool loadFromFile(const std::string &path);
+
+    // Load the full list from base_url on a background thread unless a load
+    // is already running or done. The future is true if products were loaded.
+    // The list is written to snapshotPath() when one is set.
+    std::shared_future<bool> loadAsync();
+    std::shared_future<bool> loadAsync(std::string base_url);
+
+    // Binary snapshot of the fields used for trading: ids, currencies, status,
+    // increments, size limits, trading flags and contract expiry/size. Product
+    // details strings are not kept. A snapshot is written to a temporary file
+    // and renamed into place, so a process starting concurrently never reads
+    // a partial one. Snapshots do not mark the catalog loaded(): loadAsync()
+    // still refreshes it from the REST API in the background. A snapshot only
+    // adds products the catalog does not have yet, so loading one after the
+    // REST list or status updates never reverts them.
+    bool saveSnapshot(const std::string &path) const;
+    bool loadSnapshot(const std::string &path);
+
+    // Warm start: load path if it exists and save every list loadAsync() fetches to it
+    bool useSnapshot(std::string path);
+    std::string snapshotPath() const;
+
+    // Apply status channel products: status, increments and minimum funds of
+    // known products are refreshed, unknown ones are added.
+    void update(const std::vector<Status> &status);
+
+private:
+    struct Map {
+        std::unordered_map<std::string_view, ProductHandle> handles;    // keys are interned ids
+        std::vector<std::string_view> ids;                              // by handle
+        std::vector<const Product*> products;                           // by handle, the cold side
+        std::size_t product_count = 0;                                  // non-null products
+    };
+
+    struct alignas(64) SpecSlot {
+        std::atomic<uint32_t> sequence{0};
+        ProductSpec spec;
+    };
+
+    std::shared_ptr<const Map> snapshot() const { return snapshot_.load(std::memory_order_acquire); }
+    ProductHandle assignHandle(std::string_view product_id, Map &map);
+    const Product* store(Product &&product, Map &map);
+    // add products, replacing stored ones unless keep_existing
+    void merge(std::vector<Product> &&products, bool keep_existing);
+    void writeSpec(const ProductSpec &spec);
+    void publish(std::shared_ptr<const Map> map);
+
+    std::atomic<std::shared_ptr<const Map>> snapshot_{std::make_shared<const Map>()};
+    std::array<std::atomic<SpecSlot*>, MAX_SPEC_CHUNKS> spec_chunks_{};
+    std::atomic<bool> loaded_{false};
+    std::atomic<uint64_t> version_{0};
+
+    mutable std::mutex mutex_;      // writers
+    std::vector<std::unique_ptr<const Product>> products_;    // every version ever published
+    std::deque<std::string> ids_;                               // interned ids, by handle
+    std::vector<std::unique_ptr<SpecSlot[]>> spec_storage_;
+    std::string base_url_ = "https://api.coinbase.com";
+    std::shared_future<bool> loading_;
+    std::thread loader_;    // loadAsync()
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> missing_;   // get() failures: id, retry time
+    std::string snapshot_path_;
+};
+
+}   // end namespace coinbase
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#pragma once
+
+#include <string_view>
+#include <type_traits>
+#include <coinbase/common.hpp>
+#include <coinbase/fixed_point.hpp>
+#include <coinbase/product.hpp>
+
+namespace coinbase {
+
+// The fields of a Product that order entry and price formatting read, with
+// the decimal scales precomputed. Trivially copyable and under two cache
+// lines, against well over a kilobyte of strings and detail structs in
+// Product. ProductCatalog keeps one per ProductHandle in a contiguous table;
+// the full Product stays available through ProductCatalog::product(handle).
+struct ProductSpec {
+    std::string_view product_id;    // interned by ProductCatalog, valid for the lifetime of the process
+    DecimalScale price;             // quote_increment
+    DecimalScale base_size;         // base_increment
+    DecimalScale quote_size;        // quote_increment, for sizes in quote currency
+    double base_min_size = 0.;
+    double base_max_size = 0.;
+    double quote_min_size = 0.;
+    double quote_max_size = 0.;
+    ProductHandle handle = INVALID_PRODUCT_HANDLE;
+    ProductType product_type = ProductType::UNKNOWN_PRODUCT_TYPE;
+    bool online = false;            // status "online"
+    bool trading_disabled = false;  // trading_disabled or is_disabled
+    bool cancel_only = false;
+    bool limit_only = false;
+    bool post_only = false;
+
+    // Coinbase accepts at most 8 decimals; an unknown (zero) increment falls back to that
+    static ProductSpec from(const Product &product, std::string_view product_id = {}, ProductHandle handle = INVALID_PRODUCT_HANDLE) noexcept {
+        auto scale = [](double increment) {
+            return increment > 0. ? DecimalScale(increment) : DecimalScale(1e-8);
+        };
+        ProductSpec spec;
+        spec.product_id = product_id;
+        spec.price = scale(product.quote_increment);
+        spec.base_size = scale(product.base_increment);
+        spec.quote_size = scale(product.quote_increment);
+        spec.base_min_size = product.base_min_size;
+        spec.base_max_size = product.base_max_size;
+        spec.quote_min_size = product.quote_min_size;
+        spec.quote_max_size = product.quote_max_size;
+        spec.handle = handle;
+        spec.product_type = product.product_type;
+        spec.online = product.status == "online";
+        spec.trading_disabled = product.trading_disabled || product.is_disabled;
+        spec.cancel_only = product.cancel_only;
+        spec.limit_only = product.limit_only;
+        spec.post_only = product.post_only;
+        return spec;
+    }
+};
+static_assert(std::is_trivially_copyable_v<ProductSpec>);
+
+}   // end namespace coinbase
@@ -6,6 +6,7 @@
 
 #include <cmath>
 #include <cstdint>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
@@ -13,6 +14,9 @@
 #include <unordered_map>
 #include <vector>
 #include <nlohmann/json.hpp>
+#include <coinbase/https_connection_pool.hpp>
+#include <coinbase/jwt_token_cache.hpp>
+#include <coinbase/order_request.hpp>
 #include <coinbase/product.hpp>
 #include <coinbase/account.hpp>
 #include <coinbase/order.hpp>
@@ -31,15 +35,29 @@ using json = nlohmann::json;
 
 namespace coinbase {
 
+// Requests share a pool of keep-alive TLS connections (see HttpsConnectionPool)
+// opened when the client is constructed, so latency-critical calls such as
+// create_order and cancel_orders skip the TCP and TLS handshakes. When API
+// credentials are set, the JWTs of create_order, modify_order and cancel_orders
+// are pre-signed on the first order entry call (or presign_order_tokens()) and
+// refreshed in the background (see JwtTokenCache), so later calls do not sign
+// either. Copies share the pool and the tokens.
 class CoinbaseRestClient
 {
 public:
-    CoinbaseRestClient(std::string base_url = "https://api.coinbase.com");
+    CoinbaseRestClient(std::string base_url = "https://api.coinbase.com", ConnectionPoolConfig pool_config = {});
     ~CoinbaseRestClient() = default;
 
+    // reopens the connection pool for the new host
     void set_base_url(std::string_view url);
     std::string_view base_url() const noexcept { return base_url_; }
 
+    HttpsConnectionPool& connection_pool() const noexcept { return *pool_; }
+
+    // Sign the order entry tokens now rather than on the first create_order,
+    // modify_order or cancel_orders. No-op without credentials.
+    void presign_order_tokens() const;
+
     std::vector<Account> list_accounts(const AccountQueryParams &params = {}) const;
     Account get_account(std::string_view account_uuid) const;
 
@@ -85,6 +103,10 @@ public:
         std::optional<PredictionMetadata> &&prediction_metadata = {}
     ) const;
 
+    // Send an order of order_template's shape; limit_price is ignored unless
+    // order_template.usesLimitPrice()
+    CreateOrderResponse create_order(const OrderTemplate &order_template, std::string_view client_order_id, double size, double limit_price = NAN) const;
+
     ModifyOrderResponse modify_order(
         std::string order_id,
         std::string product_id,
@@ -136,12 +158,20 @@ public:
     std::vector<PerpsPortfolioBalance> get_perps_portfolio_balances(std::string_view portfolio_uuid) const;
     bool opt_in_or_out_multi_asset_collateral(std::string_view portfolio_uuid, bool enabled) const;
 
+    // ProductCatalog::instance().get(product_id): fetched on first use if the
+    // catalog is not loaded yet, an empty product if it does not exist
     static const Product& product(std::string_view product_id);
 private:
+    struct OrderTokens;
+
+    // "Bearer <jwt>" for an order entry uri, pre-signed when possible
+    std::string order_authorization(const std::string &uri) const;
+
     std::string base_url_;
     std::string domain_;
-    static std::once_flag initialize_products_;
-    static std::unordered_map<std::string, Product> products_;
+    ConnectionPoolConfig pool_config_;
+    std::shared_ptr<HttpsConnectionPool> pool_;
+    std::shared_ptr<OrderTokens> order_tokens_;
 };
 
 }   // end namespace coinbase
@@ -13,9 +13,11 @@
 #include <string_view>
 #include <vector>
 #include <nlohmann/json.hpp>
+#include <coinbase/async_http.hpp>
 #include <coinbase/product.hpp>
 #include <coinbase/account.hpp>
 #include <coinbase/order.hpp>
+#include <coinbase/order_request.hpp>
 #include <coinbase/fill.hpp>
 #include <coinbase/price_book.hpp>
 #include <coinbase/trades.hpp>
@@ -32,8 +34,9 @@ namespace asio = boost::asio;
 
 namespace coinbase {
 
-class CoinbaseRestClient;
-
+// Coroutine counterpart of CoinbaseRestClient. Requests run on AsyncHttpClient,
+// so awaiting one suspends the calling coroutine instead of blocking the
+// io_context thread, and concurrent requests proceed in parallel.
 class CoinbaseAwaitableRestClient
 {
 public:
@@ -89,6 +92,9 @@ public:
         std::optional<PredictionMetadata> &&prediction_metadata = {}
     ) const;
 
+    // order_template is only read before the first suspension
+    asio::awaitable<CreateOrderResponse> create_order(const OrderTemplate &order_template, std::string client_order_id, double size, double limit_price = NAN) const;
+
     asio::awaitable<ModifyOrderResponse> modify_order(
         std::string order_id,
         std::string product_id,
@@ -142,9 +148,14 @@ public:
 
     static const Product& product(std::string_view product_id);
 private:
+    // true once product_id is in the ProductCatalog; a product that is not
+    // loaded yet is fetched with get_public_product() rather than the
+    // blocking ProductCatalog::get()
+    asio::awaitable<bool> load_product(std::string_view product_id) const;
+
     std::string base_url_;
     std::string domain_;
-    std::unique_ptr<CoinbaseRestClient> sync_client_;
+    AsyncHttpClient http_;
 };
 
 }   // end namespace coinbase
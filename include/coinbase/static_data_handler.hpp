@@ -0,0 +1,308 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#pragma once
+
+#include <coinbase/websocket.hpp>
+
+namespace coinbase {
+
+// Compile-time dispatched alternative to WebsocketCallbacks.
+//
+//   struct MyHandler : coinbase::StaticDataHandler<MyHandler> {
+//       void onTickers(WebSocketClient*, uint64_t seq_num, uint64_t timestamp, const std::vector<Ticker>& tickers);
+//   };
+//   MyHandler handler;
+//   WebSocketClient client(&handler);
+//
+// Derived implements any subset of the WebsocketCallbacks methods as public,
+// non-virtual members with the same signatures, except that Level2 events use
+// the span-based form:
+//
+//   void onLevel2Snapshot(WebSocketClient*, uint64_t seq_num, std::string_view product_id, std::span<const Level2Update> snapshot);
+//   void onLevel2Updates(WebSocketClient*, uint64_t seq_num, std::string_view product_id, std::span<const Level2Update> updates);
+//
+// Market data frames are scanned once with the on-demand decoder and each event
+// is delivered through a direct, inlinable call. Frames of channels without a
+// matching member are skipped after reading their header; l2_data is still
+// decoded when an order book is registered, and every channel is decoded while
+// the client publishes normalized records or a top-of-book table or tracks
+// product activity. The client's
+// MarketDataInterest narrows this further. Callbacks run on the websocket
+// threads, so use one handler per WebSocketClient.
+template<typename Derived>
+class StaticDataHandler : public StaticDataHandlerBase {
+public:
+    StaticDataHandler() {
+        callbacks_ = &forwarder_;
+    }
+
+    void processMarketData(WebSocketClient *ws_client, const char* data, std::size_t size) override;
+    void processUserData(WebSocketClient *ws_client, const char* data, std::size_t size) override;
+
+private:
+    Derived& self() noexcept { return static_cast<Derived&>(*this); }
+
+    static constexpr bool handlesLevel2() noexcept {
+        return requires(Derived &d, WebSocketClient *c, uint64_t n, std::string_view p, std::span<const Level2Update> u) { d.onLevel2Snapshot(c, n, p, u); }
+            || requires(Derived &d, WebSocketClient *c, uint64_t n, std::string_view p, std::span<const Level2Update> u) { d.onLevel2Updates(c, n, p, u); };
+    }
+    static constexpr bool handlesTickers() noexcept {
+        return requires(Derived &d, WebSocketClient *c, uint64_t n, const std::vector<Ticker> &t) { d.onTickerSnapshot(c, n, n, t); }
+            || requires(Derived &d, WebSocketClient *c, uint64_t n, const std::vector<Ticker> &t) { d.onTickers(c, n, n, t); };
+    }
+    static constexpr bool handlesMarketTrades() noexcept {
+        return requires(Derived &d, WebSocketClient *c, uint64_t n, const std::vector<MarketTrade> &t) { d.onMarketTradesSnapshot(c, n, t); }
+            || requires(Derived &d, WebSocketClient *c, uint64_t n, const std::vector<MarketTrade> &t) { d.onMarketTrades(c, n, t); };
+    }
+    static constexpr bool handlesCandles() noexcept {
+        return requires(Derived &d, WebSocketClient *c, uint64_t n, const std::vector<Candle> &v) { d.onCandlesSnapshot(c, n, n, v); }
+            || requires(Derived &d, WebSocketClient *c, uint64_t n, const std::vector<Candle> &v) { d.onCandles(c, n, n, v); };
+    }
+    static constexpr bool handlesUserEvents() noexcept {
+        return requires(Derived &d, WebSocketClient *c, uint64_t n, const std::vector<Order> &o) { d.onOrderUpdates(c, n, o); }
+            || requires(Derived &d, WebSocketClient *c, uint64_t n, const std::vector<Order> &o,
+                        const std::vector<PerpetualFuturePosition> &p, const std::vector<ExpiringFuturePosition> &e) { d.onUserDataSnapshot(c, n, o, p, e); };
+    }
+
+    // channel_mask() of the channels Derived has callbacks for
+    uint32_t handledChannels() const noexcept {
+        uint32_t channels = 0;
+        if (handlesLevel2() || !order_books_.empty()) {
+            channels |= channel_mask({LEVEL2});
+        }
+        if constexpr (handlesTickers()) {
+            channels |= channel_mask({TICKER, TICKER_BATCH});
+        }
+        if constexpr (handlesMarketTrades()) {
+            channels |= channel_mask({MARKET_TRADES});
+        }
+        if constexpr (handlesCandles()) {
+            channels |= channel_mask({CANDLES});
+        }
+        // status frames also refresh the ProductCatalog
+        channels |= channel_mask({STATUS});
+        return channels;
+    }
+
+    // decodeMarketData() sink: decodes the channels Derived handles, or all
+    // of them while publishing, and calls Derived directly
+    struct Sink {
+        StaticDataHandler *owner;
+        bool publishing;
+
+        bool decodes(WebSocketChannel channel) const noexcept;
+        void level2(WebSocketClient *ws_client, uint64_t seq_num, std::string_view product_id, bool snapshot, std::span<const Level2Update> updates, const OrderBook *book);
+        void tickers(WebSocketClient *ws_client, uint64_t seq_num, uint64_t timestamp, bool snapshot, const std::vector<Ticker> &tickers);
+        void trades(WebSocketClient *ws_client, uint64_t seq_num, bool snapshot, const std::vector<MarketTrade> &trades);
+        void candles(WebSocketClient *ws_client, uint64_t seq_num, uint64_t timestamp, bool snapshot, const std::vector<Candle> &candles);
+    };
+
+    // Serves the rare paths shared with DataHandler (sequence gaps, errors,
+    // status frames, connection events) by forwarding to whatever Derived
+    // implements.
+    struct Forwarder final : public WebsocketCallbacks {
+        explicit Forwarder(StaticDataHandler *owner) : owner_(owner) {}
+
+        void onMarketDataConnected(WebSocketClient* c) override {
+            if constexpr (requires { d().onMarketDataConnected(c); }) d().onMarketDataConnected(c);
+        }
+        void onUserDataConnected(WebSocketClient* c) override {
+            if constexpr (requires { d().onUserDataConnected(c); }) d().onUserDataConnected(c);
+        }
+        void onMarketDataDisconnected(WebSocketClient* c) override {
+            if constexpr (requires { d().onMarketDataDisconnected(c); }) d().onMarketDataDisconnected(c);
+        }
+        void onUserDataDisconnected(WebSocketClient* c) override {
+            if constexpr (requires { d().onUserDataDisconnected(c); }) d().onUserDataDisconnected(c);
+        }
+        void onLevel2Snapshot(WebSocketClient* c, uint64_t n, const Level2UpdateBatch& b) override {
+            onLevel2SnapshotView(c, n, b.product_id, b.updates);
+        }
+        void onLevel2Updates(WebSocketClient* c, uint64_t n, const Level2UpdateBatch& b) override {
+            onLevel2UpdatesView(c, n, b.product_id, b.updates);
+        }
+        void onLevel2SnapshotView(WebSocketClient* c, uint64_t n, std::string_view p, std::span<const Level2Update> u) override {
+            if constexpr (requires { d().onLevel2Snapshot(c, n, p, u); }) d().onLevel2Snapshot(c, n, p, u);
+        }
+        void onLevel2UpdatesView(WebSocketClient* c, uint64_t n, std::string_view p, std::span<const Level2Update> u) override {
+            if constexpr (requires { d().onLevel2Updates(c, n, p, u); }) d().onLevel2Updates(c, n, p, u);
+        }
+        void onOrderBookUpdate(WebSocketClient* c, uint64_t n, const OrderBook& b) override {
+            if constexpr (requires { d().onOrderBookUpdate(c, n, b); }) d().onOrderBookUpdate(c, n, b);
+        }
+        void onOrderBookRecovered(WebSocketClient* c, const OrderBook& b, std::chrono::nanoseconds t) override {
+            if constexpr (requires { d().onOrderBookRecovered(c, b, t); }) d().onOrderBookRecovered(c, b, t);
+        }
+        void onProductStale(WebSocketClient* c, ProductHandle h, std::chrono::nanoseconds t) override {
+            if constexpr (requires { d().onProductStale(c, h, t); }) d().onProductStale(c, h, t);
+        }
+        void onProductActive(WebSocketClient* c, ProductHandle h) override {
+            if constexpr (requires { d().onProductActive(c, h); }) d().onProductActive(c, h);
+        }
+        void onMarketTradesSnapshot(WebSocketClient* c, uint64_t n, const std::vector<MarketTrade>& t) override {
+            if constexpr (requires { d().onMarketTradesSnapshot(c, n, t); }) d().onMarketTradesSnapshot(c, n, t);
+        }
+        void onMarketTrades(WebSocketClient* c, uint64_t n, const std::vector<MarketTrade>& t) override {
+            if constexpr (requires { d().onMarketTrades(c, n, t); }) d().onMarketTrades(c, n, t);
+        }
+        void onTickerSnapshot(WebSocketClient* c, uint64_t n, uint64_t ts, const std::vector<Ticker>& t) override {
+            if constexpr (requires { d().onTickerSnapshot(c, n, ts, t); }) d().onTickerSnapshot(c, n, ts, t);
+        }
+        void onTickers(WebSocketClient* c, uint64_t n, uint64_t ts, const std::vector<Ticker>& t) override {
+            if constexpr (requires { d().onTickers(c, n, ts, t); }) d().onTickers(c, n, ts, t);
+        }
+        void onCandlesSnapshot(WebSocketClient* c, uint64_t n, uint64_t ts, const std::vector<Candle>& v) override {
+            if constexpr (requires { d().onCandlesSnapshot(c, n, ts, v); }) d().onCandlesSnapshot(c, n, ts, v);
+        }
+        void onCandles(WebSocketClient* c, uint64_t n, uint64_t ts, const std::vector<Candle>& v) override {
+            if constexpr (requires { d().onCandles(c, n, ts, v); }) d().onCandles(c, n, ts, v);
+        }
+        void onStatusSnapshot(WebSocketClient* c, uint64_t n, uint64_t ts, const std::vector<Status>& v) override {
+            if constexpr (requires { d().onStatusSnapshot(c, n, ts, v); }) d().onStatusSnapshot(c, n, ts, v);
+        }
+        void onStatus(WebSocketClient* c, uint64_t n, uint64_t ts, const std::vector<Status>& v) override {
+            if constexpr (requires { d().onStatus(c, n, ts, v); }) d().onStatus(c, n, ts, v);
+        }
+        void onMarketDataGap(WebSocketClient* c) override {
+            if constexpr (requires { d().onMarketDataGap(c); }) d().onMarketDataGap(c);
+        }
+        void onUserDataGap(WebSocketClient* c) override {
+            if constexpr (requires { d().onUserDataGap(c); }) d().onUserDataGap(c);
+        }
+        void onUserDataSnapshot(WebSocketClient* c, uint64_t n, const std::vector<Order>& o, const std::vector<PerpetualFuturePosition>& p, const std::vector<ExpiringFuturePosition>& e) override {
+            if constexpr (requires { d().onUserDataSnapshot(c, n, o, p, e); }) d().onUserDataSnapshot(c, n, o, p, e);
+        }
+        void onOrderUpdates(WebSocketClient* c, uint64_t n, const std::vector<Order>& o) override {
+            if constexpr (requires { d().onOrderUpdates(c, n, o); }) d().onOrderUpdates(c, n, o);
+        }
+        void onMarketDataError(WebSocketClient* c, std::string &&err) override {
+            if constexpr (requires { d().onMarketDataError(c, std::move(err)); }) d().onMarketDataError(c, std::move(err));
+            else LOG_ERROR("market data error: {}", err);
+        }
+        void onUserDataError(WebSocketClient* c, std::string &&err) override {
+            if constexpr (requires { d().onUserDataError(c, std::move(err)); }) d().onUserDataError(c, std::move(err));
+            else LOG_ERROR("user data error: {}", err);
+        }
+
+    private:
+        Derived& d() noexcept { return owner_->self(); }
+        StaticDataHandler *owner_;
+    };
+
+    Forwarder forwarder_{this};
+};
+
+template<typename Derived>
+void StaticDataHandler<Derived>::processMarketData(WebSocketClient *ws_client, const char* data, std::size_t size) {
+    auto interest = ws_client->marketDataInterest();
+    Sink sink{this, publishesMarketData(ws_client)};
+    if (skipMarketData(ws_client, data, size, sink.publishing ? interest.channels : interest.channels & handledChannels())) {
+        return;
+    }
+    decodeMarketData(ws_client, data, size, sink);
+}
+
+template<typename Derived>
+void StaticDataHandler<Derived>::processUserData(WebSocketClient *ws_client, const char* data, std::size_t size) {
+    if (handlesUserEvents() || ws_client->userDataRecordWriter()) {
+        DataHandler::processUserData(ws_client, data, size);
+    }
+    else {
+        // nobody consumes user events: keep the sequence check and surface errors
+        MarketDataFrame frame;
+        auto ok = scan_market_data_frame(data, size, frame, [&](const MarketDataFrame &f, JsonScanner &s) {
+            if (f.has_sequence_num) {
+                checkUserDataSequenceNumber(ws_client, f.sequence_num);
+            }
+            s.skipValue();
+        });
+        if (!ok || frame.type == "error") {
+            DataHandler::processUserData(ws_client, data, size);
+        }
+    }
+}
+
+template<typename Derived>
+bool StaticDataHandler<Derived>::Sink::decodes(WebSocketChannel channel) const noexcept {
+    switch (channel) {
+    case WebSocketChannel::LEVEL2:
+        return handlesLevel2() || !owner->order_books_.empty() || publishing;
+    case WebSocketChannel::TICKER:
+        return handlesTickers() || publishing;
+    case WebSocketChannel::MARKET_TRADES:
+        return handlesMarketTrades() || publishing;
+    case WebSocketChannel::CANDLES:
+        return handlesCandles() || publishing;
+    default:
+        return false;
+    }
+}
+
+template<typename Derived>
+void StaticDataHandler<Derived>::Sink::level2(WebSocketClient *ws_client, uint64_t seq_num, std::string_view product_id, bool snapshot, std::span<const Level2Update> updates, const OrderBook *book) {
+    auto &d = owner->self();
+    if (snapshot) {
+        if constexpr (requires { d.onLevel2Snapshot(ws_client, seq_num, product_id, updates); }) {
+            d.onLevel2Snapshot(ws_client, seq_num, product_id, updates);
+        }
+    }
+    else {
+        if constexpr (requires { d.onLevel2Updates(ws_client, seq_num, product_id, updates); }) {
+            d.onLevel2Updates(ws_client, seq_num, product_id, updates);
+        }
+    }
+    if constexpr (requires(const OrderBook &b) { d.onOrderBookUpdate(ws_client, seq_num, b); }) {
+        if (book) {
+            d.onOrderBookUpdate(ws_client, seq_num, *book);
+        }
+    }
+}
+
+template<typename Derived>
+void StaticDataHandler<Derived>::Sink::tickers(WebSocketClient *ws_client, uint64_t seq_num, uint64_t timestamp, bool snapshot, const std::vector<Ticker> &tickers) {
+    auto &d = owner->self();
+    if (snapshot) {
+        if constexpr (requires { d.onTickerSnapshot(ws_client, seq_num, timestamp, tickers); }) {
+            d.onTickerSnapshot(ws_client, seq_num, timestamp, tickers);
+        }
+    }
+    else {
+        if constexpr (requires { d.onTickers(ws_client, seq_num, timestamp, tickers); }) {
+            d.onTickers(ws_client, seq_num, timestamp, tickers);
+        }
+    }
+}
+
+template<typename Derived>
+void StaticDataHandler<Derived>::Sink::trades(WebSocketClient *ws_client, uint64_t seq_num, bool snapshot, const std::vector<MarketTrade> &trades) {
+    auto &d = owner->self();
+    if (snapshot) {
+        if constexpr (requires { d.onMarketTradesSnapshot(ws_client, seq_num, trades); }) {
+            d.onMarketTradesSnapshot(ws_client, seq_num, trades);
+        }
+    }
+    else {
+        if constexpr (requires { d.onMarketTrades(ws_client, seq_num, trades); }) {
+            d.onMarketTrades(ws_client, seq_num, trades);
+        }
+    }
+}
+
+template<typename Derived>
+void StaticDataHandler<Derived>::Sink::candles(WebSocketClient *ws_client, uint64_t seq_num, uint64_t timestamp, bool snapshot, const std::vector<Candle> &candles) {
+    auto &d = owner->self();
+    if (snapshot) {
+        if constexpr (requires { d.onCandlesSnapshot(ws_client, seq_num, timestamp, candles); }) {
+            d.onCandlesSnapshot(ws_client, seq_num, timestamp, candles);
+        }
+    }
+    else {
+        if constexpr (requires { d.onCandles(ws_client, seq_num, timestamp, candles); }) {
+            d.onCandles(ws_client, seq_num, timestamp, candles);
+        }
+    }
+}
+
+}   // end namespace coinbase
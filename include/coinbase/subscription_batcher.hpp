@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace coinbase {
+
+struct SubscriptionBatchConfig {
+    std::chrono::milliseconds window{20};       // requests arriving this close together are coalesced
+    uint32_t max_products_per_message = 100;    // larger requests are split
+    uint32_t max_messages_per_second = 8;       // Coinbase's websocket message rate limit per IP
+};
+
+// One subscribe or unsubscribe frame of a channel ("level2", "user", ...).
+// An empty product_ids applies to the whole channel (heartbeats, status).
+struct SubscriptionMessage {
+    std::string channel;
+    bool subscribe = true;
+    std::vector<std::string> product_ids;
+};
+
+// Coalesces the subscribe/unsubscribe requests of one websocket connection and
+// hands them to a sender at a paced rate, so a startup burst of per-product
+// calls becomes a few large frames instead of being throttled by Coinbase.
+//
+// A background thread waits for the first request, keeps collecting for
+// config.window and then drains everything pending: per channel, the last
+// request for a product wins (subscribe then unsubscribe cancel out), and
+// products are split into frames of at most max_products_per_message. Frames
+// go out through a token bucket of max_messages_per_second. flush() skips the
+// window. The sender runs on the batcher thread. Thread safe.
+class SubscriptionBatcher
+{
+public:
+    using Sender = std::function<void(const SubscriptionMessage &message)>;
+
+    SubscriptionBatcher(Sender sender, SubscriptionBatchConfig config = {});
+    ~SubscriptionBatcher();
+
+    SubscriptionBatcher(const SubscriptionBatcher&) = delete;
+    SubscriptionBatcher& operator=(const SubscriptionBatcher&) = delete;
+
+    const SubscriptionBatchConfig& config() const noexcept { return config_; }
+
+    void subscribe(const std::string &channel, const std::vector<std::string> &product_ids);
+    void unsubscribe(const std::string &channel, const std::vector<std::string> &product_ids);
+
+    // Send what is pending without waiting for the rest of the window
+    void flush();
+
+    // Drop pending requests, e.g. when the connection is lost
+    void clear();
+
+    // Number of channels with pending requests
+    std::size_t pending() const;
+
+    // Remove and return the pending requests as frames, unsubscribes before
+    // subscribes per channel, products sorted. Used by the batcher thread.
+    std::vector<SubscriptionMessage> drain();
+
+private:
+    struct Pending {
+        std::set<std::string> subscribe;
+        std::set<std::string> unsubscribe;
+        bool subscribe_channel = false;         // whole-channel requests
+        bool unsubscribe_channel = false;
+    };
+
+    std::vector<SubscriptionMessage> drainLocked();
+    void run();
+    void split(std::vector<SubscriptionMessage> &messages, const std::string &channel, bool subscribe, const std::set<std::string> &product_ids) const;
+
+    Sender sender_;
+    SubscriptionBatchConfig config_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::map<std::string, Pending> pending_;
+    bool flush_ = false;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+}   // end namespace coinbase
@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <coinbase/side.hpp>
+#include <coinbase/market_data.hpp>
+#include <coinbase/order_book.hpp>
+
+namespace coinbase {
+
+// Latest quote and trade of one product.
+struct TopOfBook {
+    double bid_price = 0.;
+    double bid_quantity = 0.;
+    double ask_price = 0.;
+    double ask_quantity = 0.;
+    double last_price = 0.;
+    double last_size = 0.;
+    uint64_t update_time = 0;       // nanoseconds since the epoch
+    Side last_side = Side::BUY;     // of the last trade
+};
+
+// One cache line per product, guarded by a seqlock: sequence is odd while the
+// writer is updating the slot.
+struct alignas(64) TopOfBookSlot {
+    std::atomic<uint32_t> sequence;
+    Side last_side;
+    uint8_t reserved[3];
+    double bid_price;
+    double bid_quantity;
+    double ask_price;
+    double ask_quantity;
+    double last_price;
+    double last_size;
+    uint64_t update_time;
+};
+static_assert(sizeof(TopOfBookSlot) == 64);
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+// Table of TopOfBookSlot in named shared memory, written by one process and
+// read by any number of local processes.
+//
+// Layout: a header, the product id of every claimed slot, then the slots. A
+// product keeps its slot for the lifetime of the table, so readers resolve the
+// id once with find() and read by slot index afterwards.
+class TopOfBookTable {
+public:
+    static constexpr uint32_t DEFAULT_CAPACITY = 256;
+    static constexpr uint32_t NO_SLOT = std::numeric_limits<uint32_t>::max();
+    static constexpr std::size_t PRODUCT_ID_SIZE = 24;
+
+    ~TopOfBookTable();
+
+    TopOfBookTable(const TopOfBookTable&) = delete;
+    TopOfBookTable& operator=(const TopOfBookTable&) = delete;
+
+    bool isOpen() const noexcept { return header_ != nullptr; }
+    uint32_t capacity() const noexcept;
+
+    // number of claimed slots
+    uint32_t size() const noexcept;
+
+    std::string_view productId(uint32_t slot) const noexcept;
+
+    // slot of product_id, NO_SLOT if it has none yet
+    uint32_t find(std::string_view product_id) const noexcept;
+
+    // Remove the named table. Mapped views stay valid; the table outlives its
+    // writer otherwise, so a restarted writer keeps the slot assignment.
+    static void remove(const char* shm_name);
+
+protected:
+    struct Header;
+
+    TopOfBookTable() = default;
+    bool map(const char* shm_name, uint32_t capacity, bool create);
+
+    Header *header_ = nullptr;
+    char (*product_ids_)[PRODUCT_ID_SIZE] = nullptr;
+    TopOfBookSlot *slots_ = nullptr;
+    std::size_t mapped_size_ = 0;
+    void *handle_ = nullptr;
+};
+
+// Creates (or reattaches to) the table and updates it from decoded market data.
+// Used by WebSocketClient::enableTopOfBook(); all updates must come from one thread.
+class TopOfBookWriter : public TopOfBookTable {
+public:
+    TopOfBookWriter(const char* shm_name, uint32_t capacity = DEFAULT_CAPACITY);
+
+    // slot of product_id, claimed on first use; NO_SLOT when the table is full
+    uint32_t slot(std::string_view product_id);
+
+    void updateQuote(std::string_view product_id, double bid_price, double bid_quantity, double ask_price, double ask_quantity, uint64_t update_time);
+    void updateTrade(std::string_view product_id, double price, double size, Side side, uint64_t update_time);
+
+    void update(const Ticker &ticker, uint64_t timestamp);
+    void update(const MarketTrade &trade);
+    void update(const OrderBook &book);
+
+private:
+    template<typename F>
+    void write(std::string_view product_id, F &&f);
+
+    struct StringHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+    };
+    std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>> slot_cache_;
+    std::vector<uint64_t> last_trade_time_;
+};
+
+// Read-only view of a table created by a TopOfBookWriter in another process.
+class TopOfBookReader : public TopOfBookTable {
+public:
+    // attempts of read() before it gives up on a slot that stays mid-write
+    static constexpr uint32_t READ_RETRIES = 4096;
+
+    explicit TopOfBookReader(const char* shm_name);
+
+    // Consistent copy of slot. Never blocks the writer; retries while the slot
+    // is being written, at most READ_RETRIES times. Returns false for an
+    // unclaimed slot, and for a torn slot: a writer that died mid-update
+    // leaves its sequence odd until the next writer attaches.
+    bool read(uint32_t slot, TopOfBook &out) const noexcept;
+    bool read(std::string_view product_id, TopOfBook &out) const noexcept {
+        return read(find(product_id), out);
+    }
+};
+
+}   // end namespace coinbase
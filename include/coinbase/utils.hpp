@@ -11,8 +11,13 @@
 #include <sstream>
 #include <ctime>
 #include <cstdio>
+#include <cstring>
+#include <charconv>
+#include <system_error>
+#include <string_view>
 #include <nlohmann/json.hpp>
 #include <coinbase/side.hpp>
+#include <coinbase/json_scanner.hpp>
 #include <slick/net/logging.hpp>
 
 using json = nlohmann::json;
@@ -26,62 +31,168 @@ std::string get_env(std::string_view name);
 std::string timestamp_to_string(uint64_t timestamp_ms);
 
 // Parse ISO 8601 string to milliseconds
-uint64_t to_milliseconds(const std::string &iso_str);
+uint64_t to_milliseconds(std::string_view iso_str);
 
 // Parse ISO 8601 string to microseconds
-uint64_t to_microseconds(const std::string &iso_str);
+uint64_t to_microseconds(std::string_view iso_str);
 
 // Parse ISO 8601 string to nanoseconds
-uint64_t to_nanoseconds(const std::string &iso_str);
+uint64_t to_nanoseconds(std::string_view iso_str);
 
 inline uint64_t milliseconds_from_json(const json &j, std::string_view field) {
-    return j.at(field).is_null() ? 0 : to_milliseconds(j.at(field).get<std::string>());
+    return j.at(field).is_null() ? 0 : to_milliseconds(j.at(field).get<std::string_view>());
 }
 
 inline uint64_t microseconds_from_json(const json &j, std::string_view field) {
-    return j.at(field).is_null() ? 0 : to_microseconds(j.at(field).get<std::string>());
+    return j.at(field).is_null() ? 0 : to_microseconds(j.at(field).get<std::string_view>());
 }
 
 inline uint64_t nanoseconds_from_json(const json &j, std::string_view field) {
-    return j.at(field).is_null() ? 0 : to_nanoseconds(j.at(field).get<std::string>());
+    return j.at(field).is_null() ? 0 : to_nanoseconds(j.at(field).get<std::string_view>());
+}
+
+// Slow path of parse_double: exponents, more than 19 significant digits or
+// values that cannot be computed exactly with one multiplication/division.
+bool parse_double_slow(std::string_view sv, double &out) noexcept;
+
+// Parse a decimal number such as "72575.01", "-0.5" or "1e-8" from a view that is
+// not necessarily NUL-terminated. Locale independent and correctly rounded, so
+// the result is the double nearest to the decimal string. Returns false if sv is
+// not a number.
+//
+// Prices and sizes (at most 19 significant digits, at most 22 fraction digits)
+// are computed exactly as an integer mantissa divided by a power of ten, both of
+// which are representable, with a single correctly rounded division.
+inline bool parse_double(std::string_view sv, double &out) noexcept {
+    static constexpr double pow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+    const char *p = sv.data();
+    const char *end = p + sv.size();
+    bool negative = false;
+    if (p != end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+
+    uint64_t mantissa = 0;
+    const char *digits_begin = p;
+    while (p != end && static_cast<unsigned char>(*p - '0') <= 9) {
+        mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+        ++p;
+    }
+    auto digits = p - digits_begin;
+    std::ptrdiff_t fraction = 0;
+    if (p != end && *p == '.') {
+        const char *fraction_begin = ++p;
+        while (p != end && static_cast<unsigned char>(*p - '0') <= 9) {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+            ++p;
+        }
+        fraction = p - fraction_begin;
+        digits += fraction;
+    }
+    if (digits == 0) [[unlikely]] {
+        return false;
+    }
+    if (p != end || digits > 19 || fraction > 22 || mantissa > (uint64_t(1) << 53)) [[unlikely]] {
+        return parse_double_slow(sv, out);
+    }
+    auto v = static_cast<double>(mantissa) / pow10[fraction];
+    out = negative ? -v : v;
+    return true;
+}
+
+// Parse a decimal number, 0 if sv is empty or not a number
+inline double to_double(std::string_view sv) noexcept {
+    double v;
+    return parse_double(sv, v) ? v : 0.;
+}
+
+// Parse a base 10 integer from a view, false if sv is not an integer
+template<typename T>
+inline bool parse_integer(std::string_view sv, T &out) noexcept {
+    const char *p = sv.data();
+    if (!sv.empty() && *p == '+') {
+        ++p;
+    }
+    auto [ptr, ec] = std::from_chars(p, sv.data() + sv.size(), out);
+    return ec == std::errc() && ptr == sv.data() + sv.size();
 }
 
 inline double double_from_json(const json &j, std::string_view field) {
-    try
-    {
-        const auto &v = j.at(field);
-        if (v.is_number()) {
-            return v.get<double>();
+    auto it = j.find(field);
+    if (it == j.end() || it->is_null()) {
+        return 0.;
+    }
+    if (it->is_string()) [[likely]] {
+        const auto &s = it->get_ref<const std::string&>();
+        double v;
+        if (parse_double(s, v)) [[likely]] {
+            return v;
         }
-        auto f = v.get<std::string_view>();
-        if (f.empty()) {
-            return 0.;
+        if (!s.empty()) {
+            LOG_ERROR("double_from_json invalid number. field: {} value: {}", field, s);
         }
-        return std::stod(f.data());
+        return 0.;
     }
-    catch(const std::exception& e)
-    {
-        LOG_ERROR("double_from_json exception: {}. field: {} {}", e.what(), field, j.dump());
+    if (it->is_number()) {
+        return it->get<double>();
     }
+    LOG_ERROR("double_from_json unexpected type. field: {} type: {}", field, it->type_name());
     return 0.;
 }
 
 inline int32_t int_from_json(const json &j, std::string_view field) {
-    try
-    {
-        auto v = j.at(field).get<std::string_view>();
-        if (v.empty()) {
-            return 0;
+    auto it = j.find(field);
+    if (it == j.end() || it->is_null()) {
+        return 0;
+    }
+    if (it->is_string()) [[likely]] {
+        const auto &s = it->get_ref<const std::string&>();
+        int32_t v;
+        if (parse_integer(s, v)) [[likely]] {
+            return v;
+        }
+        if (!s.empty()) {
+            LOG_ERROR("int_from_json invalid number. field: {} value: {}", field, s);
         }
-        return std::stoi(v.data());
+        return 0;
     }
-    catch(const std::exception& e)
-    {
-        LOG_ERROR("int_from_json exception: {}. field: {} {}", e.what(), field, j.dump());
+    if (it->is_number_integer()) {
+        return it->get<int32_t>();
     }
+    LOG_ERROR("int_from_json unexpected type. field: {} type: {}", field, it->type_name());
     return 0;
 }
 
+inline double double_from_scanner(JsonScanner &s) {
+    std::string_view v;
+    if (s.readNull() || !s.readScalar(v)) {
+        return 0.;
+    }
+    return to_double(v);
+}
+
+inline uint64_t uint_from_scanner(JsonScanner &s) {
+    std::string_view v;
+    if (s.readNull() || !s.readScalar(v)) {
+        return 0;
+    }
+    uint64_t r = 0;
+    parse_integer(v, r);
+    return r;
+}
+
+inline uint64_t nanoseconds_from_scanner(JsonScanner &s) {
+    std::string_view v;
+    if (s.readNull() || !s.readString(v)) {
+        return 0;
+    }
+    return to_nanoseconds(v);
+}
+
 constexpr double epsilon = 1e-9;
 constexpr double default_norm_factor = 1e8;
 
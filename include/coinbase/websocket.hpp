@@ -5,6 +5,9 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <span>
+#include <initializer_list>
 #include <unordered_set>
 #include <vector>
 #include <array>
@@ -14,6 +17,9 @@
 #include <thread>
 #include <unordered_map>
 #include <chrono>
+#include <mutex>
+#include <functional>
+#include <optional>
 #include <slick/net/websocket.hpp>
 #include <nlohmann/json.hpp>
 #include <coinbase/market_data.hpp>
@@ -21,6 +27,14 @@
 #include <coinbase/position.hpp>
 #include <coinbase/auth.hpp>
 #include <coinbase/candle.hpp>
+#include <coinbase/market_data_decoder.hpp>
+#include <coinbase/order_book.hpp>
+#include <coinbase/price_book.hpp>
+#include <coinbase/normalized_records.hpp>
+#include <coinbase/top_of_book.hpp>
+#include <coinbase/product_activity.hpp>
+#include <coinbase/market_data_arbiter.hpp>
+#include <coinbase/subscription_batcher.hpp>
 #include <slick/queue.h>
 #include <slick/stream_buffer_multiplexer.hpp>
 #include <slick/dynamic_buffer.hpp>
@@ -45,6 +59,43 @@ enum WebSocketChannel : uint8_t {
 
 std::string to_string(WebSocketChannel channel);
 
+// Channel of a received frame ("l2_data", "ticker", ...), _CHANNEL_COUNT_ if
+// the name is unknown.
+WebSocketChannel channel_from_frame(std::string_view channel) noexcept;
+
+constexpr uint32_t channel_mask(std::initializer_list<WebSocketChannel> channels) noexcept {
+    uint32_t mask = 0;
+    for (auto channel : channels) {
+        mask |= 1u << channel;
+    }
+    return mask;
+}
+
+// Channels and fields a WebSocketClient decodes. Market data frames of other
+// channels are only sequence checked; heartbeats and subscriptions
+// acknowledgements are never decoded. Ticker fields outside ticker_fields are
+// skipped by the on-demand decoder and left 0; the DOM decoder reads them all.
+struct MarketDataInterest {
+    static constexpr uint32_t ALL = ~0u;
+    // channels that carry market data; a mask covering all of them skips nothing
+    static constexpr uint32_t DATA_CHANNELS = channel_mask({LEVEL2, MARKET_TRADES, TICKER, TICKER_BATCH, CANDLES, STATUS});
+
+    uint32_t channels = ALL;                    // channel_mask() of decoded channels
+    uint32_t ticker_fields = TickerField::ALL;  // TickerField bits
+
+    static constexpr bool contains(uint32_t channels, WebSocketChannel channel) noexcept {
+        return channel >= _CHANNEL_COUNT_ || ((channels >> channel) & 1u);
+    }
+
+    constexpr bool wants(WebSocketChannel channel) const noexcept {
+        return contains(channels, channel);
+    }
+
+    static constexpr bool containsAll(uint32_t channels) noexcept {
+        return (channels & DATA_CHANNELS) == DATA_CHANNELS;
+    }
+};
+
 enum ProducerType : uint8_t {
     MD_DATA, 
     USER_DATA,
@@ -64,10 +115,42 @@ enum class MessageType : char {
     USER_ERROR = 'F',
     MARKET_DATA_GAP = 'G',
     USER_DATA_GAP = 'H',
+    PRODUCT_STALE = 'I',
 };
 
 class WebSocketClient;
 
+// How the order books registered with addOrderBook() are rebuilt after a
+// market data sequence gap (see WebSocketClient::enableLevel2Recovery())
+enum class Level2Recovery : uint8_t {
+    NONE,           // the books keep applying deltas; only onMarketDataGap fires
+    RESUBSCRIBE,    // resubscribe level2; the snapshot that follows replaces the book
+    REST_SNAPSHOT,  // fetch the book over REST and replay the deltas received meanwhile
+};
+
+struct Level2RecoveryConfig {
+    Level2Recovery mode = Level2Recovery::RESUBSCRIBE;
+
+    // REST_SNAPSHOT: fill book with the current book of product_id, e.g. from
+    // CoinbaseRestClient::get_product_book(). Called for one product at a
+    // time on a thread owned by the data handler, which waits for a running
+    // fetch when it is destroyed; captures must outlive the handler.
+    // Returning false (or throwing) falls back to RESUBSCRIBE.
+    std::function<bool(const std::string &product_id, PriceBook &book)> fetch_book;
+
+    // REST_SNAPSHOT: a fetch still running after this long falls back to
+    // RESUBSCRIBE, so the deltas held back meanwhile stay bounded
+    std::chrono::milliseconds fetch_timeout{5000};
+};
+
+// Time from losing a connection to its tracked subscriptions being sent again
+// on the next one (see WebSocketClient::reconnect()).
+struct ResubscribeStats {
+    uint64_t count = 0;                 // reconnects that replayed subscriptions
+    std::chrono::nanoseconds last{0};
+    std::chrono::nanoseconds max{0};
+};
+
 struct WebsocketCallbacks {
     virtual ~WebsocketCallbacks() = default;
     virtual void onMarketDataConnected(WebSocketClient* client) = 0;
@@ -90,15 +173,39 @@ struct WebsocketCallbacks {
     virtual void onOrderUpdates(WebSocketClient* client, uint64_t seq_num, const std::vector<Order>& orders) = 0;
     virtual void onMarketDataError(WebSocketClient* client, std::string &&err) = 0;
     virtual void onUserDataError(WebSocketClient* client, std::string &&err) = 0;
+
+    // Allocation-free variants of onLevel2Snapshot/onLevel2Updates. product_id and
+    // the updates point into a scratch buffer owned by the data handler and reused
+    // for the next event, so they are only valid for the duration of the call.
+    // The default implementations copy into a reusable Level2UpdateBatch and
+    // forward to onLevel2Snapshot/onLevel2Updates; override these to avoid the copy.
+    virtual void onLevel2SnapshotView(WebSocketClient* client, uint64_t seq_num, std::string_view product_id, std::span<const Level2Update> snapshot);
+    virtual void onLevel2UpdatesView(WebSocketClient* client, uint64_t seq_num, std::string_view product_id, std::span<const Level2Update> updates);
+
+    // Invoked after an l2_data event has been applied to a book registered with
+    // WebSocketClient::addOrderBook().
+    virtual void onOrderBookUpdate([[maybe_unused]] WebSocketClient* client, [[maybe_unused]] uint64_t seq_num, [[maybe_unused]] const OrderBook& book) {}
+
+    // Invoked once a book that was recovering from a sequence gap has been
+    // rebuilt, before its onOrderBookUpdate(). duration runs from the gap.
+    virtual void onOrderBookRecovered([[maybe_unused]] WebSocketClient* client, [[maybe_unused]] const OrderBook& book, [[maybe_unused]] std::chrono::nanoseconds duration) {}
+
+    // With WebSocketClient::enableProductActivity(): a product has had no market
+    // data for the tracker's staleAfter(), and its first event after that.
+    // Without UserThreadWebsocketCallbacks, onProductStale() runs on the
+    // client's activity timer thread, concurrently with the data callbacks.
+    virtual void onProductStale([[maybe_unused]] WebSocketClient* client, [[maybe_unused]] ProductHandle product_handle, [[maybe_unused]] std::chrono::nanoseconds age) {}
+    virtual void onProductActive([[maybe_unused]] WebSocketClient* client, [[maybe_unused]] ProductHandle product_handle) {}
 };
 
 struct DataHandler {
-    virtual ~DataHandler() = default;
+    DataHandler();
+    virtual ~DataHandler();
 
-    void processMarketData(WebSocketClient *ws_client, const char* data, std::size_t size);
-    void processUserData(WebSocketClient *ws_client, const char* data, std::size_t size);
-    void onMarketDataError(WebSocketClient *ws_client, std::string err);
-    void onUserDataError(WebSocketClient *ws_client, std::string err);
+    virtual void processMarketData(WebSocketClient *ws_client, const char* data, std::size_t size);
+    void processMarketDataDom(WebSocketClient *ws_client, const char* data, std::size_t size);
+    void processMarketDataOnDemand(WebSocketClient *ws_client, const char* data, std::size_t size);
+    virtual void processUserData(WebSocketClient *ws_client, const char* data, std::size_t size);
     void processLevel2Update(WebSocketClient *ws_client, const json& j);
     void processMarketTrades(WebSocketClient *ws_client, const json& j);
     void processCandles(WebSocketClient *ws_client, const json& j);
@@ -107,6 +214,15 @@ struct DataHandler {
     bool processHeartbeat(WebSocketClient *ws_client, const json& j);
     void processStatus(WebSocketClient *ws_client, const json& j);
     void processFuturesBalanceSummary(WebSocketClient *ws_client, const json& j);
+    void processLevel2Event(WebSocketClient *ws_client, uint64_t seq_num, std::string_view timestamp, std::string_view type, std::string_view product_id, ProductHandle product_handle, std::span<const Level2Update> updates);
+
+    // Returns true if the frame carries no data (heartbeats, subscriptions) or
+    // belongs to a channel outside channels (see MarketDataInterest), after
+    // checking its sequence number. The frame header is only peeked when
+    // channels excludes a data channel; otherwise the decoder handles
+    // heartbeats and subscriptions in its single pass. Runs for every market
+    // data frame, so it also polls pending REST book fetches.
+    bool skipMarketData(WebSocketClient *ws_client, const char* data, std::size_t size, uint32_t channels);
     
     virtual bool checkMarketDataSequenceNumber(WebSocketClient *ws_client, int64_t seq_num);
     virtual bool checkUserDataSequenceNumber(WebSocketClient *ws_client, int64_t seq_num);
@@ -117,11 +233,115 @@ struct DataHandler {
         last_user_seq_num_ = -1;
     }
 
+    // Maintain an order book for product from its l2_data events. Returns the
+    // existing book if one is already registered, nullptr if the product has no
+    // valid quote_increment.
+    OrderBook* addOrderBook(const Product &product, uint32_t window_ticks = OrderBook::DEFAULT_WINDOW_TICKS);
+    OrderBook* orderBook(std::string_view product_id) const noexcept;
+
+    // By the product_handle of decoded events: an array index
+    OrderBook* orderBook(ProductHandle product_handle) const noexcept {
+        return product_handle < books_by_handle_.size() ? books_by_handle_[product_handle] : nullptr;
+    }
+
+    // Apply an l2_data event to a registered book. While the book recovers
+    // from a sequence gap the event is held back instead and false is returned.
+    bool applyLevel2(WebSocketClient *ws_client, OrderBook &book, bool snapshot, uint64_t seq_num, std::span<const Level2Update> updates) {
+        if (recovering_books_ == 0) [[likely]] {
+            if (snapshot) {
+                book.applySnapshot(updates, seq_num);
+            }
+            else {
+                book.applyUpdates(updates, seq_num);
+            }
+            return true;
+        }
+        return applyLevel2Recovering(ws_client, book, snapshot, seq_num, updates);
+    }
+
+    bool isRecovering(const OrderBook &book) const noexcept;
+
 protected:
+    // Republish decoded events to the client's normalized records and
+    // top-of-book table, and record them in its product activity tracker,
+    // where enabled.
+    static bool publishesMarketData(const WebSocketClient *ws_client) noexcept;
+    void publishLevel2(WebSocketClient *ws_client, uint64_t seq_num, std::string_view timestamp, bool snapshot, std::string_view product_id, ProductHandle product_handle, std::span<const Level2Update> updates, const OrderBook *book);
+    void publishTickers(WebSocketClient *ws_client, uint64_t seq_num, uint64_t timestamp, bool snapshot, std::span<const Ticker> tickers);
+    void publishTrades(WebSocketClient *ws_client, uint64_t seq_num, std::string_view timestamp, bool snapshot, std::span<const MarketTrade> trades);
+    void publishCandles(WebSocketClient *ws_client, uint64_t seq_num, uint64_t timestamp, bool snapshot, std::span<const Candle> candles);
+    static void publishOrders(WebSocketClient *ws_client, uint64_t seq_num, std::string_view timestamp, bool snapshot, std::span<const Order> orders);
+
+    // The on-demand scan and decode loop shared by DataHandler and
+    // StaticDataHandler. Each event is sequence checked, applied to its order
+    // book and published, then handed to sink, which provides:
+    //
+    //   bool decodes(WebSocketChannel channel);     // false skips the channel's events
+    //   void level2(WebSocketClient*, uint64_t seq_num, std::string_view product_id, bool snapshot, std::span<const Level2Update> updates, const OrderBook *book);
+    //   void tickers(WebSocketClient*, uint64_t seq_num, uint64_t timestamp, bool snapshot, const std::vector<Ticker> &tickers);
+    //   void trades(WebSocketClient*, uint64_t seq_num, bool snapshot, const std::vector<MarketTrade> &trades);
+    //   void candles(WebSocketClient*, uint64_t seq_num, uint64_t timestamp, bool snapshot, const std::vector<Candle> &candles);
+    //
+    // Status and error frames go through processMarketDataDom().
+    template<typename Sink>
+    void decodeMarketData(WebSocketClient *ws_client, const char* data, std::size_t size, Sink &sink);
+    template<typename Sink>
+    void decodeLevel2Event(WebSocketClient *ws_client, uint64_t seq_num, std::string_view timestamp, std::string_view type, std::string_view product_id, ProductHandle product_handle, std::span<const Level2Update> updates, Sink &sink);
+
+    // Report a market data sequence gap: start recovering the registered books
+    // and invoke onMarketDataGap()
+    void marketDataGap(WebSocketClient *ws_client);
+
     friend class WebSocketClient;
     WebsocketCallbacks* callbacks_ = nullptr;
     int64_t last_md_seq_num_ = -1;
     int64_t last_user_seq_num_ = -1;
+
+    // scratch buffers reused across frames so steady-state decoding does not allocate
+    Level2UpdateBatch l2_scratch_;
+    std::vector<Ticker> ticker_scratch_;
+    std::vector<MarketTrade> trade_scratch_;
+    std::vector<Candle> candle_scratch_;
+
+    std::vector<std::unique_ptr<OrderBook>> order_books_;
+    std::vector<OrderBook*> books_by_handle_;
+
+private:
+    // A REST book fetch queued on the BookFetcher
+    struct BookFetch {
+        std::string product_id;
+        std::function<bool(const std::string &product_id, PriceBook &book)> fetch_book;
+        std::atomic<bool> cancelled{false};     // no longer wanted; skipped if not started
+        std::atomic<bool> done{false};
+        std::optional<PriceBook> book;
+    };
+
+    class BookFetcher;
+
+    struct BookRecovery {
+        bool active = false;
+        Level2Recovery mode = Level2Recovery::NONE;
+        std::chrono::steady_clock::time_point started{};
+        std::vector<Level2Update> buffered;         // REST_SNAPSHOT: deltas since the gap
+        std::shared_ptr<BookFetch> fetch;
+    };
+
+    void startLevel2Recovery(WebSocketClient *ws_client);
+    bool applyLevel2Recovering(WebSocketClient *ws_client, OrderBook &book, bool snapshot, uint64_t seq_num, std::span<const Level2Update> updates);
+    void finishLevel2Recovery(WebSocketClient *ws_client, OrderBook &book, BookRecovery &recovery);
+    // REST_SNAPSHOT: rebuild book i if its fetch finished, fall back to
+    // RESUBSCRIBE if the fetch failed or timed out. Returns true if rebuilt.
+    bool completeBookFetch(WebSocketClient *ws_client, std::size_t i, uint64_t seq_num, std::chrono::steady_clock::time_point now);
+    // completeBookFetch() for every book with a fetch pending, so quiet
+    // products recover without waiting for their next delta
+    void pollBookFetches(WebSocketClient *ws_client);
+    void recordActivity(WebSocketClient *ws_client, ProductActivityTracker &activity, ProductHandle product_handle, uint64_t seq_num, uint64_t event_time, uint64_t now);
+
+    void cancelBookFetch(BookRecovery &recovery);
+
+    std::vector<BookRecovery> recoveries_;      // by order_books_ index
+    uint32_t recovering_books_ = 0;
+    std::unique_ptr<BookFetcher> book_fetcher_; // started by the first REST_SNAPSHOT recovery
 };
 
 struct UserThreadWebsocketCallbacks : public DataHandler, public WebsocketCallbacks
@@ -146,6 +366,7 @@ private:
     friend class WebSocketClient;
     void addClient(slick::stream_buffer_multiplexer &mux, uint32_t producer_offset);
     void mapProducerType(uint32_t producer_id, ProducerType pt);
+    void addMarketDataStandby(WebSocketClient *client, uint32_t producer_id, uint32_t connection);
 private:
     slick::stream_buffer_multiplexer *mux_ = nullptr;
     uint64_t read_cursor_ = 0;
@@ -153,8 +374,16 @@ private:
     std::unordered_map<WebSocketClient*, std::atomic_int_fast64_t> user_seq_nums_;
     std::vector<WebSocketClient*> clients_;   // 0: md client, 1: user client
     std::vector<ProducerType> producer_types_;
+    std::vector<uint32_t> md_connections_;      // by producer id: the market data connection of a standby's MD_DATA producer
 };
 
+// Base of StaticDataHandler<Derived> (see static_data_handler.hpp). A
+// WebSocketClient constructed with a StaticDataHandlerBase hands frames to it
+// directly on the websocket threads.
+struct StaticDataHandlerBase : public DataHandler {
+protected:
+    StaticDataHandlerBase() = default;
+};
 
 class WebSocketClient {
 public:
@@ -187,6 +416,37 @@ public:
         uint32_t write_buffer_size = 1u << 20               // 1 MB write buffer
     );
 
+    // Dispatch to a StaticDataHandler<Derived>. The handler is not owned and must
+    // outlive the client.
+    WebSocketClient(
+        StaticDataHandlerBase *handler,
+        std::string_view market_data_url = "wss://advanced-trade-ws.coinbase.com",
+        std::string_view user_data_url = "wss://advanced-trade-ws-user.coinbase.com",
+        const char* mux_shm_name = nullptr,
+        uint32_t md_read_buffer_size = 1u << 26,            // 64 MB reading buffer
+        uint32_t md_record_size = 1u << 16,                 // 64K message records
+        const char* md_read_buffer_shm_name = nullptr,      // default not using shared memory
+        uint32_t user_read_buffer_size = 1u << 24,          // 16 MB buffer
+        uint32_t user_record_size = 1u << 16,               // 64K message records
+        const char* user_read_buffer_shm_name = nullptr,    // default not using shared memory
+        uint32_t write_buffer_size = 1u << 20               // 1 MB write buffer
+    );
+
+    WebSocketClient(
+        StaticDataHandlerBase *handler,
+        slick::stream_buffer_multiplexer &mux,
+        std::string_view market_data_url = "wss://advanced-trade-ws.coinbase.com",
+        std::string_view user_data_url = "wss://advanced-trade-ws-user.coinbase.com",
+        uint32_t producer_offset = 0,
+        uint32_t md_read_buffer_size = 1u << 26,            // 64 MB reading buffer
+        uint32_t md_record_size = 1u << 16,                 // 64K message records
+        const char* md_read_buffer_shm_name = nullptr,      // default not using shared memory
+        uint32_t user_read_buffer_size = 1u << 24,          // 16 MB buffer
+        uint32_t user_record_size = 1u << 16,               // 64K message records
+        const char* user_read_buffer_shm_name = nullptr,    // default not using shared memory
+        uint32_t write_buffer_size = 1u << 20               // 1 MB write buffer
+    );
+
     ~WebSocketClient();
 
     WebSocketClient(WebSocketClient&&) = delete;
@@ -205,20 +465,181 @@ public:
 
     void stop();
 
+    // true while any market data websocket is connected, see enableMarketDataRedundancy()
     bool isMarketDataConnected() const {
-        return market_data_websocket_ && market_data_websocket_->status() == Websocket::Status::CONNECTED;
+        for (uint32_t i = 0; i < marketDataConnectionCount(); ++i) {
+            auto *websocket = marketDataWebsocket(i);
+            if (websocket && websocket->status() == Websocket::Status::CONNECTED) {
+                return true;
+            }
+        }
+        return false;
     }
     bool isUserDataConnected() const {
         return user_data_websocket_ && user_data_websocket_->status() == Websocket::Status::CONNECTED;
     }
+    // The client keeps the live subscription set of every channel: subscribe()
+    // adds to it, unsubscribe() removes from it and stop() clears it. Whenever a
+    // websocket connects, the set of its channels is sent again (user channel
+    // subscriptions with a fresh JWT), so a dropped connection is restored by
+    // reopening it, e.g. with reconnect().
     void subscribe(const std::vector<std::string> &product_ids, const std::vector<WebSocketChannel> &channels);
     void unsubscribe(const std::vector<std::string> &product_ids, const std::vector<WebSocketChannel> &channels);
+
+    // Reopen the disconnected websockets that have tracked subscriptions
+    void reconnect();
+
+    // Send subscribe/unsubscribe requests through a SubscriptionBatcher per
+    // websocket: requests within config.window are coalesced into frames of up
+    // to max_products_per_message products, paced to max_messages_per_second.
+    // Reconnect replays go through it as well, without the window. Must be
+    // called before subscribing.
+    void enableSubscriptionBatching(SubscriptionBatchConfig config = {});
+
+    bool subscriptionBatchingEnabled() const noexcept {
+        return md_batcher_ != nullptr || user_batcher_ != nullptr;
+    }
+
+    // Unsubscribe and subscribe level2 again for the tracked ones of product_ids,
+    // so Coinbase sends fresh snapshots. Not batched: coalescing would cancel
+    // the pair out. A no-op while the market data websocket is disconnected.
+    void resyncLevel2(const std::vector<std::string> &product_ids);
+
+    // Rebuild the books registered with addOrderBook() after a market data
+    // sequence gap instead of applying deltas to a book that missed some.
+    // While a book recovers its deltas are held back and onOrderBookUpdate()
+    // does not fire; onOrderBookRecovered() reports the rebuilt book. Must be
+    // called before subscribing.
+    void enableLevel2Recovery(Level2RecoveryConfig config = {}) {
+        level2_recovery_ = std::move(config);
+    }
+
+    const Level2RecoveryConfig& level2Recovery() const noexcept {
+        return level2_recovery_;
+    }
+
+    // Run config.standby_connections more market data websockets next to the
+    // primary one, subscribed to the same channels and products. The first
+    // copy of every frame is processed and later copies are dropped (see
+    // MarketDataArbiter), so callbacks see the fastest connection and a stalled
+    // or lost one costs nothing while another is up. Sequence numbers are
+    // checked per connection, and onMarketDataGap() fires only for frames no
+    // connection delivered; the seq_num passed to callbacks is that of the
+    // connection that won. Snapshots are taken from one connection only, so
+    // a connection (re)joining while another is up does not reset the books
+    // or repeat the snapshot callbacks. onMarketDataConnected() fires when the
+    // first connection is up and onMarketDataDisconnected() when the last one
+    // is lost. Standby i reads into multiplexer producer standby_producer_id + i,
+    // which must not collide with any client's producer range. Must be called
+    // before subscribing. Returns false if the client has no market data URL,
+    // redundancy is already enabled or a producer id is taken.
+    bool enableMarketDataRedundancy(uint32_t standby_producer_id, MarketDataRedundancyConfig config = {});
+
+    bool marketDataRedundancyEnabled() const noexcept {
+        return md_arbiter_ != nullptr;
+    }
+
+    // Per market data connection, the primary first. Empty unless redundancy is enabled.
+    std::vector<MarketDataConnectionStats> marketDataConnectionStats() const;
+
+    // Tracked products of channel, sorted. Empty for a channel subscribed
+    // without product ids (heartbeats, status, all products).
+    std::vector<std::string> subscriptions(WebSocketChannel channel) const;
+    bool isSubscribed(WebSocketChannel channel) const;
+
+    ResubscribeStats marketDataResubscribeStats() const;
+    ResubscribeStats userDataResubscribeStats() const;
+
     void logData(std::string_view data_file);
 
+    // Maintain an order book for product, fed from the level2 channel. Must be
+    // called before subscribing; the book is updated on the thread that runs the
+    // callbacks and onOrderBookUpdate() fires after every applied event.
+    OrderBook* addOrderBook(const Product &product, uint32_t window_ticks = OrderBook::DEFAULT_WINDOW_TICKS) {
+        return data_handler_->addOrderBook(product, window_ticks);
+    }
+
+    const OrderBook* orderBook(std::string_view product_id) const noexcept {
+        return data_handler_->orderBook(product_id);
+    }
+
+    const OrderBook* orderBook(ProductHandle product_handle) const noexcept {
+        return data_handler_->orderBook(product_handle);
+    }
+
     slick::stream_buffer_multiplexer& streamBufferMultiplexer() noexcept {
         return mux_;
     }
 
+    // Select the market data decoding engine. MarketDataDecoder::ON_DEMAND scans
+    // each frame once without building a JSON DOM; the same callbacks fire.
+    void setMarketDataDecoder(MarketDataDecoder decoder) noexcept {
+        md_decoder_.store(decoder, std::memory_order_relaxed);
+    }
+
+    MarketDataDecoder marketDataDecoder() const noexcept {
+        return md_decoder_.load(std::memory_order_relaxed);
+    }
+
+    // Restrict decoding to the channels and ticker fields the application
+    // consumes, e.g. {channel_mask({TICKER}), TickerField::BEST_BID | TickerField::BEST_ASK}.
+    void setMarketDataInterest(MarketDataInterest interest) noexcept {
+        md_channels_.store(interest.channels, std::memory_order_relaxed);
+        md_ticker_fields_.store(interest.ticker_fields, std::memory_order_relaxed);
+    }
+
+    MarketDataInterest marketDataInterest() const noexcept {
+        return {md_channels_.load(std::memory_order_relaxed), md_ticker_fields_.load(std::memory_order_relaxed)};
+    }
+
+    // Publish every decoded market data (and, if user_producer_id is given, user
+    // order) event once more as fixed-layout binary records (see
+    // normalized_records.hpp) on dedicated producers of the multiplexer, so
+    // readers in other threads or processes consume them without parsing JSON.
+    // The producer ids must not collide with any client's producer range. Must be
+    // called before subscribing. Returns false if a producer id is taken.
+    bool enableNormalizedRecords(
+        uint32_t md_producer_id,
+        uint32_t user_producer_id = NO_PRODUCER_ID,
+        uint32_t buffer_size = 1u << 24,                    // 16 MB per producer
+        uint32_t record_size = 1u << 16,                    // 64K records
+        const char* md_shm_name = nullptr,
+        const char* user_shm_name = nullptr
+    );
+
+    RecordWriter* marketDataRecordWriter() const noexcept {
+        return md_record_writer_.get();
+    }
+
+    RecordWriter* userDataRecordWriter() const noexcept {
+        return user_record_writer_.get();
+    }
+
+    // Keep the best bid/ask and last trade of every product in a seqlock-guarded
+    // table in named shared memory (see top_of_book.hpp), updated from tickers,
+    // trades and the books registered with addOrderBook(). Local processes read
+    // it with TopOfBookReader without attaching to the multiplexer. Must be
+    // called before subscribing. Returns false if the table cannot be mapped.
+    bool enableTopOfBook(const char* shm_name, uint32_t capacity = TopOfBookTable::DEFAULT_CAPACITY);
+
+    TopOfBookWriter* topOfBookWriter() const noexcept {
+        return top_of_book_.get();
+    }
+
+    // Track the last event time, sequence number and event rate of every
+    // product with market data in a handle-indexed ProductActivityTracker.
+    // Risk checks query it per product (productActivity()->isStale(handle))
+    // from any thread; onProductStale() fires once a product has been quiet
+    // for stale_after, onProductActive() when it trades or quotes again.
+    // A thread owned by the client scans for quiet products every
+    // stale_after / 4, so they are reported even when the connection stalls
+    // and no frame arrives. Must be called before subscribing.
+    void enableProductActivity(std::chrono::nanoseconds stale_after = std::chrono::seconds(5));
+
+    ProductActivityTracker* productActivity() const noexcept {
+        return product_activity_.get();
+    }
+
 private:
     void init(
         WebsocketCallbacks *callbacks,
@@ -230,41 +651,229 @@ private:
         const char* user_read_buffer_shm_name,
         uint32_t write_buffer_size
     );
-    void onMarketDataConnected();
-    void onMarketDataDisconnected();
+    void onMarketDataConnected(uint32_t connection = 0);
+    void onMarketDataDisconnected(uint32_t connection = 0);
     void onUserDataConnected();
     void onUserDataDisconnected();
-    void onMarketData(const char* data, std::size_t size);
+    void onMarketData(uint32_t connection, const char* data, std::size_t size);
     void onUserData(const char* data, std::size_t size);
     void onMarketDataError(std::string &&err);
     void onUserDataError(std::string &&err);
     void dispatchData(ProducerType pt, const char* data, std::size_t size, MessageType type);
     void runDataLogger();
 
+    // Report the products that went quiet, from the activity timer thread
+    void scanProductActivity();
+    class ActivityScanner;
+
+    // Subscription tracking, with subscription_mutex_ held. user selects the
+    // user data websocket (the user channel) or the market data one (the rest).
+    struct Connection {
+        bool live = false;                                  // between connected and disconnected
+        std::chrono::steady_clock::time_point disconnected_at{};
+        ResubscribeStats stats;
+    };
+    // A user channel JWT is reused for this long instead of being signed per frame
+    static constexpr std::chrono::seconds USER_JWT_REUSE{30};
+    static constexpr uint32_t NO_CONNECTION = std::numeric_limits<uint32_t>::max();
+    static bool isUserChannel(WebSocketChannel channel) noexcept {
+        return channel == WebSocketChannel::USER;
+    }
+    struct MarketDataStandby {
+        std::unique_ptr<Websocket> websocket;
+        Connection connection;
+    };
+    bool hasSubscriptions(bool user) const noexcept;
+    const std::string& userJwt();
+    void sendSubscribe(Websocket &websocket, WebSocketChannel channel, const std::vector<std::string> &product_ids);
+    void sendBatched(bool user, const SubscriptionMessage &message);
+
+    // Returns true if another websocket of the same kind is live
+    bool resubscribe(bool user, uint32_t connection = 0);
+    bool markDisconnected(bool user, uint32_t connection = 0);
+
+    // Market data connection 0 is market_data_websocket_, the others are standbys
+    uint32_t marketDataConnectionCount() const noexcept {
+        return 1 + static_cast<uint32_t>(md_standbys_.size());
+    }
+    Websocket* marketDataWebsocket(uint32_t connection) const noexcept {
+        return connection == 0 ? market_data_websocket_.get() : md_standbys_[connection - 1].websocket.get();
+    }
+    Connection& marketDataConnection(uint32_t connection) noexcept {
+        return connection == 0 ? md_connection_ : md_standbys_[connection - 1].connection;
+    }
+    bool isLive(bool user, uint32_t except = NO_CONNECTION) const noexcept;
+
+    // f(Websocket&, Connection&) for the user data websocket or every market data one
+    template<typename F>
+    void forEachConnection(bool user, F &&f) {
+        if (user) {
+            if (user_data_websocket_) {
+                f(*user_data_websocket_, user_connection_);
+            }
+            return;
+        }
+        for (uint32_t i = 0; i < marketDataConnectionCount(); ++i) {
+            if (auto *websocket = marketDataWebsocket(i)) {
+                f(*websocket, marketDataConnection(i));
+            }
+        }
+    }
+
+    // Whether a market data frame of connection carries events no other
+    // connection delivered first, setting frame to the part to process and
+    // reporting frames lost on every connection as a gap
+    bool arbitrate(uint32_t connection, const char* data, std::size_t size, std::string_view &frame);
+
 private:
     friend struct UserThreadWebsocketCallbacks;
     DataHandler* data_handler_ = nullptr;
+    bool owns_data_handler_ = false;
     std::string market_data_url_;
     std::string user_data_url_;
     std::unique_ptr<Websocket> market_data_websocket_;
     std::unique_ptr<Websocket> user_data_websocket_;
+    mutable std::mutex subscription_mutex_;
     std::array<std::unordered_set<std::string>, WebSocketChannel::_CHANNEL_COUNT_> product_ids_;
-    std::vector<std::string> pending_subscriptions_;
+    uint32_t subscribed_channels_ = 0;      // channel_mask() of tracked channels
+    Connection md_connection_;
+    Connection user_connection_;
+    std::string user_jwt_;
+    std::chrono::steady_clock::time_point user_jwt_signed_at_{};
+    std::unique_ptr<SubscriptionBatcher> md_batcher_;
+    std::unique_ptr<SubscriptionBatcher> user_batcher_;
+    Level2RecoveryConfig level2_recovery_{Level2Recovery::NONE, {}};
+    std::vector<MarketDataStandby> md_standbys_;
+    std::unique_ptr<MarketDataArbiter> md_arbiter_;
+    std::mutex arbitration_mutex_;          // serializes the connections' frames when they are processed on the websocket threads
     std::string user_id_;
     std::unique_ptr<slick::stream_buffer_multiplexer> owning_mux_;
     slick::stream_buffer_multiplexer &mux_;
     uint32_t producer_offset_;
     UserThreadWebsocketCallbacks *user_thread_callbacks_ = nullptr;
     std::vector<slick::stream_buffer_multiplexer::producer_buffer*> producer_buffers_;
+    std::mutex dispatch_mutex_;             // control messages come from the websocket and activity timer threads
     std::fstream data_log_;
     std::thread logger_thread_;
     std::atomic_bool logger_run_ = false;
     uint64_t log_cursor_ = 0;
     uint32_t md_data_producer_id_ = std::numeric_limits<uint32_t>::max();
     uint32_t user_data_producer_id_ = std::numeric_limits<uint32_t>::max();
+    std::atomic<MarketDataDecoder> md_decoder_ = MarketDataDecoder::DOM;
+    std::atomic<uint32_t> md_channels_ = MarketDataInterest::ALL;
+    std::atomic<uint32_t> md_ticker_fields_ = TickerField::ALL;
+    std::unique_ptr<RecordWriter> md_record_writer_;
+    std::unique_ptr<RecordWriter> user_record_writer_;
+    std::unique_ptr<TopOfBookWriter> top_of_book_;
+    std::unique_ptr<ProductActivityTracker> product_activity_;
+    std::unique_ptr<ActivityScanner> activity_scanner_;
     static inline constexpr char empty_msg = '\0';
 };
 
+template<typename Sink>
+void DataHandler::decodeMarketData(WebSocketClient *ws_client, const char* data, std::size_t size, Sink &sink) {
+    try {
+        MarketDataFrame frame;
+        bool use_dom = false;
+        auto ok = scan_market_data_frame(data, size, frame, [&](const MarketDataFrame &f, JsonScanner &s) {
+            auto channel = f.channel;
+            if (channel == "status") {
+                // rare and not latency sensitive, decoded through the DOM below
+                // to refresh the ProductCatalog
+                use_dom = true;
+                s.skipValue();
+                return;
+            }
+            if (f.has_sequence_num) {
+                checkMarketDataSequenceNumber(ws_client, f.sequence_num);
+            }
+            if (channel == "l2_data") {
+                if (sink.decodes(WebSocketChannel::LEVEL2)) {
+                    decode_level2_events(s, l2_scratch_, [&](std::string_view type, const Level2UpdateBatch &b) {
+                        decodeLevel2Event(ws_client, f.sequence_num, f.timestamp, type, b.product_id, b.product_handle, b.updates, sink);
+                    });
+                    return;
+                }
+            }
+            else if (channel == "ticker" || channel == "ticker_batch") {
+                if (sink.decodes(WebSocketChannel::TICKER)) {
+                    auto timestamp = to_nanoseconds(f.timestamp);
+                    decode_events(s, "tickers", ticker_scratch_, [&](std::string_view type, const std::vector<Ticker> &t) {
+                        auto snapshot = type == "snapshot";
+                        if (!snapshot && type != "update") {
+                            LOG_WARN("unknown ticker event type: {}", type);
+                            return;
+                        }
+                        publishTickers(ws_client, f.sequence_num, timestamp, snapshot, t);
+                        sink.tickers(ws_client, f.sequence_num, timestamp, snapshot, t);
+                    }, ws_client->marketDataInterest().ticker_fields);
+                    return;
+                }
+            }
+            else if (channel == "market_trades") {
+                if (sink.decodes(WebSocketChannel::MARKET_TRADES)) {
+                    decode_events(s, "trades", trade_scratch_, [&](std::string_view type, const std::vector<MarketTrade> &t) {
+                        auto snapshot = type == "snapshot";
+                        if (!snapshot && type != "update") {
+                            LOG_WARN("unknown market_trades event type: {}", type);
+                            return;
+                        }
+                        publishTrades(ws_client, f.sequence_num, f.timestamp, snapshot, t);
+                        sink.trades(ws_client, f.sequence_num, snapshot, t);
+                    });
+                    return;
+                }
+            }
+            else if (channel == "candles") {
+                if (sink.decodes(WebSocketChannel::CANDLES)) {
+                    auto timestamp = to_nanoseconds(f.timestamp);
+                    decode_events(s, "candles", candle_scratch_, [&](std::string_view type, const std::vector<Candle> &c) {
+                        auto snapshot = type == "snapshot";
+                        if (!snapshot && type != "update") {
+                            LOG_WARN("unknown candles event type: {}", type);
+                            return;
+                        }
+                        publishCandles(ws_client, f.sequence_num, timestamp, snapshot, c);
+                        sink.candles(ws_client, f.sequence_num, timestamp, snapshot, c);
+                    });
+                    return;
+                }
+            }
+            else if (channel != "subscriptions" && channel != "heartbeats") {
+                LOG_ERROR("unknown channel: {}", channel);
+            }
+            s.skipValue();
+        });
+
+        if (use_dom || (ok && frame.type == "error")) {
+            processMarketDataDom(ws_client, data, size);
+            return;
+        }
+        if (!ok) {
+            LOG_ERROR("error: malformed market data frame. data: {}", std::string_view(data, size));
+        }
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("error: {}. data: {}", e.what(), std::string_view(data, size));
+    }
+}
+
+template<typename Sink>
+void DataHandler::decodeLevel2Event(WebSocketClient *ws_client, uint64_t seq_num, std::string_view timestamp, std::string_view type, std::string_view product_id, ProductHandle product_handle, std::span<const Level2Update> updates, Sink &sink) {
+    auto snapshot = type == "snapshot";
+    if (!snapshot && type != "update") {
+        LOG_WARN("unknown l2_data event type: {}", type);
+        return;
+    }
+    auto *book = orderBook(product_handle);
+    if (book && !applyLevel2(ws_client, *book, snapshot, seq_num, updates)) {
+        // held back while the book recovers from a gap
+        book = nullptr;
+    }
+    publishLevel2(ws_client, seq_num, timestamp, snapshot, product_id, product_handle, updates, book);
+    sink.level2(ws_client, seq_num, product_id, snapshot, updates, book);
+}
+
 constexpr uint32_t MESSAGE_HEADER_SIZE = sizeof(WebSocketClient*) + sizeof(char);
 
 }  // end namespace coinbase
\ No newline at end of file
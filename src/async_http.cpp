@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#include <coinbase/async_http.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/beast/version.hpp>
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace ssl = asio::ssl;
+using tcp = asio::ip::tcp;
+
+namespace coinbase {
+
+void parse_base_url(std::string_view url, std::string &host, std::string &port) {
+    auto pos = url.find("://");
+    if (pos != std::string_view::npos) {
+        url.remove_prefix(pos + 3);
+    }
+    url = url.substr(0, url.find('/'));
+    pos = url.find(':');
+    if (pos == std::string_view::npos) {
+        host = std::string(url);
+        port = "443";
+    }
+    else {
+        host = std::string(url.substr(0, pos));
+        port = std::string(url.substr(pos + 1));
+    }
+}
+
+ssl::context& tls_client_context() {
+    static ssl::context ctx = [] {
+        ssl::context c(ssl::context::tls_client);
+        c.set_default_verify_paths();
+        c.set_verify_mode(ssl::verify_peer);
+        return c;
+    }();
+    return ctx;
+}
+
+AsyncHttpClient::AsyncHttpClient(std::string_view base_url) {
+    set_base_url(base_url);
+}
+
+void AsyncHttpClient::set_base_url(std::string_view url) {
+    parse_base_url(url, host_, port_);
+}
+
+asio::awaitable<HttpResponse> AsyncHttpClient::request(http::verb method, std::string target, std::string body, std::string authorization) const {
+    auto executor = co_await asio::this_coro::executor;
+    // copies, so set_base_url() on another request's client cannot race this one
+    auto host = host_;
+    auto port = port_;
+    auto timeout = timeout_;
+
+    beast::ssl_stream<beast::tcp_stream> stream(executor, tls_client_context());
+    if (!SSL_set_tlsext_host_name(stream.native_handle(), host.c_str())) {
+        throw beast::system_error(beast::error_code(static_cast<int>(::ERR_get_error()), asio::error::get_ssl_category()));
+    }
+    stream.set_verify_callback(ssl::host_name_verification(host));
+
+    tcp::resolver resolver(executor);
+    auto endpoints = co_await resolver.async_resolve(host, port, asio::use_awaitable);
+    beast::get_lowest_layer(stream).expires_after(timeout);
+    co_await beast::get_lowest_layer(stream).async_connect(endpoints, asio::use_awaitable);
+    beast::get_lowest_layer(stream).expires_after(timeout);
+    co_await stream.async_handshake(ssl::stream_base::client, asio::use_awaitable);
+
+    http::request<http::string_body> req{method, target, 11};
+    req.set(http::field::host, host);
+    req.set(http::field::user_agent, BOOST_BEAST_VERSION_STRING);
+    if (!authorization.empty()) {
+        req.set(http::field::authorization, authorization);
+    }
+    if (!body.empty()) {
+        req.set(http::field::content_type, "application/json");
+        req.body() = std::move(body);
+    }
+    req.prepare_payload();
+
+    beast::get_lowest_layer(stream).expires_after(timeout);
+    co_await http::async_write(stream, req, asio::use_awaitable);
+
+    beast::flat_buffer buffer;
+    http::response<http::string_body> res;
+    beast::get_lowest_layer(stream).expires_after(timeout);
+    co_await http::async_read(stream, buffer, res, asio::use_awaitable);
+
+    // The response is complete. A TLS shutdown would cost another round trip,
+    // or the whole timeout when the server never answers close_notify, and
+    // the connection is not reused: just close the socket.
+    beast::get_lowest_layer(stream).close();
+
+    co_return HttpResponse{res.result_int(), std::move(res.body()), std::string(res.reason())};
+}
+
+}   // end namespace coinbase
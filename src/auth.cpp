@@ -4,17 +4,81 @@
 
 #include <coinbase/auth.hpp>
 #include <coinbase/utils.hpp>
-#ifndef JWT_DISABLE_PICOJSON
-#define JWT_DISABLE_PICOJSON
-#endif
-#include <jwt-cpp/jwt.h>
-#include <jwt-cpp/traits/nlohmann-json/traits.h>
+#include <slick/net/logging.hpp>
+#include <openssl/bio.h>
+#include <openssl/ecdsa.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
 #include <chrono>
-#include <sstream>
+#include <memory>
 #include <random>
+#include <stdexcept>
 
 namespace coinbase {
 
+namespace {
+
+constexpr char BASE64URL[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+constexpr char HEX[] = "0123456789abcdef";
+
+void base64url_append(std::string &out, const unsigned char *data, std::size_t size) {
+    std::size_t i = 0;
+    for (; i + 3 <= size; i += 3) {
+        uint32_t v = (uint32_t(data[i]) << 16) | (uint32_t(data[i + 1]) << 8) | data[i + 2];
+        out += BASE64URL[v >> 18];
+        out += BASE64URL[(v >> 12) & 0x3f];
+        out += BASE64URL[(v >> 6) & 0x3f];
+        out += BASE64URL[v & 0x3f];
+    }
+    if (auto rest = size - i) {
+        uint32_t v = uint32_t(data[i]) << 16;
+        if (rest == 2) {
+            v |= uint32_t(data[i + 1]) << 8;
+        }
+        out += BASE64URL[v >> 18];
+        out += BASE64URL[(v >> 12) & 0x3f];
+        if (rest == 2) {
+            out += BASE64URL[(v >> 6) & 0x3f];
+        }
+    }
+}
+
+void base64url_append(std::string &out, std::string_view s) {
+    base64url_append(out, reinterpret_cast<const unsigned char*>(s.data()), s.size());
+}
+
+void json_escape_append(std::string &out, std::string_view s) {
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20) {
+            out += "\\u00";
+            out += HEX[c >> 4];
+            out += HEX[c & 0xf];
+        }
+        else {
+            out += c;
+        }
+    }
+}
+
+// Split json into the base64url of its longest prefix that is a multiple of 3
+// bytes, which later bytes can be appended to, and the remaining bytes.
+void split_constant(std::string_view json, std::string &encoded, std::string &tail) {
+    auto n = json.size() - json.size() % 3;
+    encoded.clear();
+    base64url_append(encoded, json.substr(0, n));
+    tail = std::string(json.substr(n));
+}
+
+struct MdCtxDeleter {
+    void operator()(EVP_MD_CTX *ctx) const noexcept { EVP_MD_CTX_free(ctx); }
+};
+
+}   // end anonymous namespace
+
 std::string fix_pem_format(std::string key) {
     if (key.empty()) {
         return key;
@@ -33,39 +97,116 @@ std::string fix_pem_format(std::string key) {
     return key;
 }
 
+JwtSigner::JwtSigner(std::string key_name, std::string_view private_key)
+    : key_name_(std::move(key_name))
+{
+    std::string header = R"({"alg":"ES256","kid":")";
+    json_escape_append(header, key_name_);
+    header += R"(","nonce":")";
+    split_constant(header, header_prefix_, header_tail_);
+
+    std::string payload = R"({"iss":"cdp","sub":")";
+    json_escape_append(payload, key_name_);
+    payload += R"(","nbf":)";
+    split_constant(payload, payload_prefix_, payload_tail_);
+
+    if (private_key.empty()) {
+        return;     // no credentials, public endpoints only
+    }
+    BIO *bio = BIO_new_mem_buf(private_key.data(), static_cast<int>(private_key.size()));
+    EVP_PKEY *pkey = bio ? PEM_read_bio_PrivateKey(bio, nullptr, nullptr, nullptr) : nullptr;
+    BIO_free(bio);
+    if (!pkey || EVP_PKEY_base_id(pkey) != EVP_PKEY_EC) {
+        LOG_ERROR("JwtSigner: failed to load the EC private key of {}", key_name_);
+        EVP_PKEY_free(pkey);
+        return;
+    }
+    key_ = pkey;
+}
+
+JwtSigner::~JwtSigner() {
+    EVP_PKEY_free(static_cast<EVP_PKEY*>(key_));
+}
+
+std::string JwtSigner::sign(std::string_view uri, int64_t now_seconds) const {
+    if (!key_) [[unlikely]] {
+        return {};
+    }
+    if (now_seconds == 0) {
+        now_seconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    thread_local std::mt19937_64 nonce_gen{std::random_device{}()};
+    auto nonce = nonce_gen();
+
+    std::string token;
+    token.reserve(header_prefix_.size() + payload_prefix_.size() + uri.size() * 4 / 3 + 256);
+
+    char buf[128];
+    std::string tail = header_tail_;
+    for (int shift = 60; shift >= 0; shift -= 4) {
+        tail += HEX[(nonce >> shift) & 0xf];
+    }
+    tail += R"(","typ":"JWT"})";
+    token += header_prefix_;
+    base64url_append(token, tail);
+    token += '.';
+
+    auto n = std::snprintf(buf, sizeof(buf), R"(%lld,"exp":%lld)", static_cast<long long>(now_seconds), static_cast<long long>(now_seconds + LIFETIME_SECONDS));
+    tail.assign(payload_tail_).append(buf, n);
+    if (!uri.empty()) {
+        tail += R"(,"uri":")";
+        json_escape_append(tail, uri);
+        tail += '"';
+    }
+    tail += '}';
+    token += payload_prefix_;
+    base64url_append(token, tail);
+
+    // one digest context per thread; reset, since it may last have signed with another key
+    thread_local std::unique_ptr<EVP_MD_CTX, MdCtxDeleter> ctx{EVP_MD_CTX_new()};
+    unsigned char der[80];
+    std::size_t der_len = sizeof(der);
+    if (!ctx
+        || EVP_MD_CTX_reset(ctx.get()) != 1
+        || EVP_DigestSignInit(ctx.get(), nullptr, EVP_sha256(), nullptr, static_cast<EVP_PKEY*>(key_)) != 1
+        || EVP_DigestSign(ctx.get(), der, &der_len, reinterpret_cast<const unsigned char*>(token.data()), token.size()) != 1) {
+        LOG_ERROR("JwtSigner: failed to sign for {}", key_name_);
+        return {};
+    }
+
+    // JWS wants the raw 32-byte r and s, OpenSSL produces DER
+    const unsigned char *p = der;
+    ECDSA_SIG *sig = d2i_ECDSA_SIG(nullptr, &p, static_cast<long>(der_len));
+    if (!sig) {
+        LOG_ERROR("JwtSigner: invalid signature for {}", key_name_);
+        return {};
+    }
+    unsigned char raw[64];
+    const BIGNUM *r = nullptr;
+    const BIGNUM *s = nullptr;
+    ECDSA_SIG_get0(sig, &r, &s);
+    BN_bn2binpad(r, raw, 32);
+    BN_bn2binpad(s, raw + 32, 32);
+    ECDSA_SIG_free(sig);
+
+    token += '.';
+    base64url_append(token, raw, sizeof(raw));
+    return token;
+}
+
+const JwtSigner& JwtSigner::instance() {
+    static JwtSigner signer(get_env("COINBASE_API_KEY"), fix_pem_format(get_env("COINBASE_API_SECRET")));
+    return signer;
+}
+
 std::string generate_coinbase_jwt(const char* uri)
 {
-    static auto api_key = get_env("COINBASE_API_KEY");
-    static auto api_secret = get_env("COINBASE_API_SECRET");
-    static std::string private_key = fix_pem_format(api_secret);
-
-    // Get current time
-    auto now = std::chrono::system_clock::now();
-    auto exp = now + std::chrono::minutes(2);
-
-    // Generate random nonce (hex string)
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<uint32_t> dis(0, 0xFFFFFFFF);
-    std::stringstream nonce_stream;
-    nonce_stream << std::hex << dis(gen) << dis(gen);
-    std::string nonce = nonce_stream.str();
-
-    // Create the JWT
-    auto jwt = jwt::create<jwt::traits::nlohmann_json>()
-        .set_type("JWT")
-        .set_issuer("cdp")
-        .set_subject(api_key)
-        .set_not_before(now)
-        .set_expires_at(exp)
-        .set_algorithm("ES256")
-        .set_header_claim("kid", jwt::basic_claim<jwt::traits::nlohmann_json>(api_key))
-        .set_header_claim("nonce", jwt::basic_claim<jwt::traits::nlohmann_json>(nonce));
-
-    if (uri) {
-        jwt.set_payload_claim("uri", jwt::basic_claim<jwt::traits::nlohmann_json>(std::string(uri)));
+    auto token = JwtSigner::instance().sign(uri ? std::string_view(uri) : std::string_view());
+    if (token.empty()) {
+        throw std::runtime_error("failed to sign Coinbase JWT");
     }
-    return jwt.sign(jwt::algorithm::es256("", private_key, "", ""));
+    return token;
 }
 
 }   // namespace coinbase
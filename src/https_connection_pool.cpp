@@ -0,0 +1,276 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#include <coinbase/https_connection_pool.hpp>
+#include <slick/net/logging.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/asio/use_future.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/beast/version.hpp>
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace ssl = asio::ssl;
+using tcp = asio::ip::tcp;
+
+namespace coinbase {
+
+namespace {
+
+// Run op to completion on ioc from the calling thread.
+template<typename T>
+T run(asio::io_context &ioc, asio::awaitable<T> op) {
+    auto result = asio::co_spawn(ioc, std::move(op), asio::use_future);
+    ioc.restart();
+    ioc.run();
+    return result.get();
+}
+
+// what a server closing an idle keep-alive connection looks like to the next request
+bool closed_by_peer(const beast::error_code &ec) {
+    return ec == http::error::end_of_stream
+        || ec == asio::error::eof
+        || ec == asio::error::connection_reset
+        || ec == asio::error::connection_aborted
+        || ec == asio::error::broken_pipe
+        || ec == ssl::error::stream_truncated;
+}
+
+// safe to resend after the server may have processed it
+bool idempotent(http::verb method) {
+    return method == http::verb::get || method == http::verb::head || method == http::verb::put || method == http::verb::delete_;
+}
+
+}   // end anonymous namespace
+
+struct HttpsConnectionPool::Connection {
+    asio::io_context ioc;
+    beast::ssl_stream<beast::tcp_stream> stream;
+    beast::flat_buffer buffer;
+    std::chrono::steady_clock::time_point last_used;
+    bool keep_alive = true;
+    bool from_pool = false;     // opened before the current request
+    bool sent = false;          // the current request was written in full
+
+    Connection() : stream(ioc, tls_client_context()) {}
+};
+
+HttpsConnectionPool::HttpsConnectionPool(std::string_view base_url, ConnectionPoolConfig config)
+    : config_(config)
+{
+    parse_base_url(base_url, host_, port_);
+    if (config_.size > 0) {
+        idle_.reserve(config_.size);
+        maintenance_thread_ = std::thread([this] { maintain(); });
+    }
+}
+
+HttpsConnectionPool::~HttpsConnectionPool() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (maintenance_thread_.joinable()) {
+        maintenance_thread_.join();
+    }
+}
+
+std::size_t HttpsConnectionPool::idle() const {
+    std::lock_guard lock(mutex_);
+    return idle_.size();
+}
+
+std::unique_ptr<HttpsConnectionPool::Connection> HttpsConnectionPool::connect() {
+    auto conn = std::make_unique<Connection>();
+    if (!SSL_set_tlsext_host_name(conn->stream.native_handle(), host_.c_str())) {
+        throw beast::system_error(beast::error_code(static_cast<int>(::ERR_get_error()), asio::error::get_ssl_category()));
+    }
+    conn->stream.set_verify_callback(ssl::host_name_verification(host_));
+
+    run(conn->ioc, [](Connection &c, const std::string &host, const std::string &port, std::chrono::milliseconds timeout) -> asio::awaitable<void> {
+        tcp::resolver resolver(c.ioc);
+        auto endpoints = co_await resolver.async_resolve(host, port, asio::use_awaitable);
+        beast::get_lowest_layer(c.stream).expires_after(timeout);
+        co_await beast::get_lowest_layer(c.stream).async_connect(endpoints, asio::use_awaitable);
+        beast::get_lowest_layer(c.stream).expires_after(timeout);
+        co_await c.stream.async_handshake(ssl::stream_base::client, asio::use_awaitable);
+    }(*conn, host_, port_, config_.timeout));
+
+    beast::get_lowest_layer(conn->stream).socket().set_option(tcp::no_delay(true));
+    conn->last_used = std::chrono::steady_clock::now();
+    return conn;
+}
+
+std::unique_ptr<HttpsConnectionPool::Connection> HttpsConnectionPool::acquire() {
+    {
+        std::lock_guard lock(mutex_);
+        if (!idle_.empty()) {
+            // most recently used first; its TLS session is the least likely to have been dropped
+            auto conn = std::move(idle_.back());
+            idle_.pop_back();
+            conn->from_pool = true;
+            return conn;
+        }
+        ++open_;
+    }
+    try {
+        return connect();
+    }
+    catch (...) {
+        std::lock_guard lock(mutex_);
+        --open_;
+        throw;
+    }
+}
+
+void HttpsConnectionPool::release(std::unique_ptr<Connection> conn) {
+    std::lock_guard lock(mutex_);
+    if (conn && conn->keep_alive && !stopping_ && idle_.size() < config_.size) {
+        conn->from_pool = false;
+        idle_.push_back(std::move(conn));
+        return;
+    }
+    // closed when conn goes out of scope; the maintenance thread reopens it
+    --open_;
+}
+
+HttpResponse HttpsConnectionPool::exchange(Connection &conn, http::verb method, std::string_view target, std::string_view body, std::string_view authorization) {
+    http::request<http::string_body> req{method, beast::string_view(target.data(), target.size()), 11};
+    req.set(http::field::host, host_);
+    req.set(http::field::user_agent, BOOST_BEAST_VERSION_STRING);
+    if (!authorization.empty()) {
+        req.set(http::field::authorization, beast::string_view(authorization.data(), authorization.size()));
+    }
+    if (!body.empty()) {
+        req.set(http::field::content_type, "application/json");
+        req.body() = std::string(body);
+    }
+    req.prepare_payload();
+
+    http::response<http::string_body> res;
+    conn.sent = false;
+    run(conn.ioc, [](Connection &c, http::request<http::string_body> &req, http::response<http::string_body> &res, std::chrono::milliseconds timeout) -> asio::awaitable<void> {
+        beast::get_lowest_layer(c.stream).expires_after(timeout);
+        co_await http::async_write(c.stream, req, asio::use_awaitable);
+        c.sent = true;
+        beast::get_lowest_layer(c.stream).expires_after(timeout);
+        co_await http::async_read(c.stream, c.buffer, res, asio::use_awaitable);
+    }(conn, req, res, config_.timeout));
+
+    conn.keep_alive = res.keep_alive();
+    conn.last_used = std::chrono::steady_clock::now();
+    return HttpResponse{res.result_int(), std::move(res.body()), std::string(res.reason())};
+}
+
+HttpResponse HttpsConnectionPool::request(http::verb method, std::string_view target, std::string_view body, std::string_view authorization) {
+    auto conn = acquire();
+    try {
+        auto res = exchange(*conn, method, target, body, authorization);
+        release(std::move(conn));
+        return res;
+    }
+    catch (const beast::system_error &e) {
+        // The server closed the connection while it was idle. A request that
+        // was written in full may have been executed before the connection
+        // dropped, so only idempotent ones are resent then; orders are not.
+        bool retry = conn->from_pool && closed_by_peer(e.code()) && (!conn->sent || idempotent(method));
+        conn.reset();
+        release(nullptr);
+        if (!retry) {
+            throw;
+        }
+        LOG_DEBUG("{} connection closed by peer, retrying {}", host_, target);
+    }
+    catch (...) {
+        conn.reset();
+        release(nullptr);
+        throw;
+    }
+
+    conn = acquire();
+    try {
+        auto res = exchange(*conn, method, target, body, authorization);
+        release(std::move(conn));
+        return res;
+    }
+    catch (...) {
+        conn.reset();
+        release(nullptr);
+        throw;
+    }
+}
+
+void HttpsConnectionPool::maintain() {
+    std::unique_lock lock(mutex_);
+    while (!stopping_) {
+        // top the pool back up
+        while (open_ < config_.size && !stopping_) {
+            ++open_;
+            lock.unlock();
+            std::unique_ptr<Connection> conn;
+            try {
+                conn = connect();
+            }
+            catch (const std::exception &e) {
+                LOG_WARN("failed to connect to {}: {}", host_, e.what());
+            }
+            lock.lock();
+            if (!conn) {
+                --open_;
+                break;      // try again on the next round
+            }
+            idle_.push_back(std::move(conn));
+        }
+
+        // ping connections that sat idle for a full interval
+        auto now = std::chrono::steady_clock::now();
+        std::vector<std::unique_ptr<Connection>> pinged;
+        for (auto it = idle_.begin(); it != idle_.end();) {
+            if (now - (*it)->last_used >= config_.ping_interval) {
+                pinged.push_back(std::move(*it));
+                it = idle_.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+        if (!pinged.empty()) {
+            lock.unlock();
+            for (auto &conn : pinged) {
+                try {
+                    exchange(*conn, http::verb::get, "/api/v3/brokerage/time", {}, {});
+                    if (!conn->keep_alive) {
+                        conn.reset();
+                    }
+                }
+                catch (const std::exception &e) {
+                    LOG_DEBUG("{} idle connection dropped: {}", host_, e.what());
+                    conn.reset();
+                }
+            }
+            lock.lock();
+            for (auto &conn : pinged) {
+                if (conn && idle_.size() < config_.size) {
+                    idle_.push_back(std::move(conn));
+                }
+                else {
+                    --open_;
+                }
+            }
+            continue;   // reopen the dropped ones right away
+        }
+
+        cv_.wait_for(lock, config_.ping_interval / 2, [this] { return stopping_; });
+    }
+    idle_.clear();
+}
+
+}   // end namespace coinbase
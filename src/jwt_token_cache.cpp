@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#include <coinbase/jwt_token_cache.hpp>
+#include <slick/net/logging.hpp>
+#include <stdexcept>
+
+namespace coinbase {
+
+namespace {
+
+int64_t now_seconds() {
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+}   // end anonymous namespace
+
+JwtTokenCache::JwtTokenCache(const JwtSigner &signer, std::chrono::milliseconds refresh_interval)
+    : signer_(signer)
+    , refresh_interval_(refresh_interval)
+{
+    refresh_thread_ = std::thread([this] { refresh(); });
+}
+
+JwtTokenCache::~JwtTokenCache() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (refresh_thread_.joinable()) {
+        refresh_thread_.join();
+    }
+}
+
+std::string JwtTokenCache::sign(std::string_view uri, int64_t now) const {
+    auto token = signer_.sign(uri, now);
+    if (token.empty()) {
+        throw std::runtime_error("failed to sign Coinbase JWT");
+    }
+    return "Bearer " + token;
+}
+
+void JwtTokenCache::add(std::string uri) {
+    auto now = now_seconds();
+    auto authorization = sign(uri, now);
+    std::lock_guard lock(mutex_);
+    for (auto &e : entries_) {
+        if (e.uri == uri) {
+            return;
+        }
+    }
+    entries_.push_back(Entry{std::move(uri), std::move(authorization), now});
+}
+
+std::string JwtTokenCache::authorization(std::string_view uri) const {
+    auto now = now_seconds();
+    {
+        std::lock_guard lock(mutex_);
+        for (const auto &e : entries_) {
+            if (e.uri == uri) {
+                if (now < e.not_before + JwtSigner::LIFETIME_SECONDS - MIN_REMAINING.count()) [[likely]] {
+                    return e.authorization;
+                }
+                LOG_WARN("pre-signed JWT for {} is about to expire, signing inline", uri);
+                break;
+            }
+        }
+    }
+    return sign(uri, now);
+}
+
+std::size_t JwtTokenCache::size() const {
+    std::lock_guard lock(mutex_);
+    return entries_.size();
+}
+
+void JwtTokenCache::refresh() {
+    std::unique_lock lock(mutex_);
+    while (!cv_.wait_for(lock, refresh_interval_, [this] { return stopping_; })) {
+        std::vector<std::string> uris;
+        uris.reserve(entries_.size());
+        for (const auto &e : entries_) {
+            uris.push_back(e.uri);
+        }
+        lock.unlock();
+
+        // sign outside the lock so requests keep getting the current tokens
+        auto now = now_seconds();
+        std::vector<std::string> tokens;
+        tokens.reserve(uris.size());
+        for (const auto &uri : uris) {
+            try {
+                tokens.push_back(sign(uri, now));
+            }
+            catch (const std::exception &e) {
+                LOG_ERROR("failed to refresh JWT for {}: {}", uri, e.what());
+                tokens.emplace_back();
+            }
+        }
+
+        lock.lock();
+        for (std::size_t i = 0; i < uris.size(); ++i) {
+            if (tokens[i].empty()) {
+                continue;
+            }
+            for (auto &e : entries_) {
+                if (e.uri == uris[i]) {
+                    e.authorization = std::move(tokens[i]);
+                    e.not_before = now;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+}   // end namespace coinbase
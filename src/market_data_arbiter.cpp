@@ -0,0 +1,331 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#include <coinbase/market_data_arbiter.hpp>
+#include <coinbase/market_data_decoder.hpp>
+#include <coinbase/json_scanner.hpp>
+#include <slick/net/logging.hpp>
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <span>
+#include <string_view>
+
+namespace coinbase {
+
+namespace {
+
+uint64_t hash_combine(uint64_t seed, std::string_view value) noexcept {
+    return seed ^ (std::hash<std::string_view>{}(value) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+}
+
+// Key of one item of a frame: a trade on (product_id, trade_id), a level2
+// update on (product_id, side, price_level, event_time), anything else on its
+// text. product_id is the one of the enclosing event, if it has one.
+uint64_t item_key(std::string_view channel, std::string_view product_id, std::string_view item) noexcept {
+    auto key = std::hash<std::string_view>{}(channel);
+    auto trades = channel == "market_trades";
+    if (trades || channel == "l2_data") {
+        std::string_view fields[3];     // trade_id or side, price_level, event_time
+        std::string_view k;
+        JsonScanner s(item.data(), item.size());
+        if (s.enterObject()) {
+            while (s.nextKey(k)) {
+                if (k == "product_id") {
+                    s.readScalar(product_id);
+                }
+                else if (trades ? k == "trade_id" : k == "side") {
+                    s.readScalar(fields[0]);
+                }
+                else if (!trades && k == "price_level") {
+                    s.readScalar(fields[1]);
+                }
+                else if (!trades && k == "event_time") {
+                    s.readScalar(fields[2]);
+                }
+                else {
+                    s.skipValue();
+                }
+            }
+        }
+        if (s.ok() && !fields[0].empty() && (trades || (!fields[1].empty() && !fields[2].empty()))) {
+            key = hash_combine(key, product_id);
+            for (auto field : fields) {
+                key = hash_combine(key, field);
+            }
+            return key != 0 ? key : 1;
+        }
+    }
+    key = hash_combine(hash_combine(key, product_id), item);
+    return key != 0 ? key : 1;
+}
+
+}   // end anonymous namespace
+
+MarketDataArbiter::MarketDataArbiter(uint32_t connections, uint32_t dedup_window)
+    : count_(std::max<uint32_t>(connections, 1))
+    , connections_(std::make_unique<Connection[]>(count_))
+{
+    auto buckets = std::bit_ceil(std::max<uint32_t>(dedup_window / WAYS, 1));
+    keys_.assign(static_cast<std::size_t>(buckets) * WAYS, 0);
+    next_.assign(buckets, 0);
+    bucket_mask_ = buckets - 1;
+}
+
+bool MarketDataArbiter::accept(uint32_t connection, const char* data, std::size_t size, bool &gap, std::string_view &frame) {
+    gap = false;
+    frame = std::string_view(data, size);
+    if (connection >= count_) [[unlikely]] {
+        return true;
+    }
+    auto &c = connections_[connection];
+    c.frames.fetch_add(1, std::memory_order_relaxed);
+
+    MarketDataFrame header;
+    if (peek_market_data_frame(data, size, header) && header.has_sequence_num) {
+        auto seq_num = static_cast<int64_t>(header.sequence_num);
+        auto last_seq = c.last_seq_num.load(std::memory_order_relaxed);
+        if (last_seq >= 0 && seq_num != last_seq + 1) {
+            c.gaps.fetch_add(1, std::memory_order_relaxed);
+            gap = !othersConnected(connection);
+            LOG_WARN("market data connection {} lost frames. seq_num: {}, last_seq_num: {}{}", connection, seq_num, last_seq,
+                gap ? "" : ", covered by the other connections");
+        }
+        c.last_seq_num.store(seq_num, std::memory_order_relaxed);
+    }
+
+    if (isSnapshot(data, size)) {
+        // per connection, never a copy of another connection's
+        auto source = snapshot_source_.load(std::memory_order_acquire);
+        if (source != NO_CONNECTION && source != connection) {
+            c.snapshots.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        c.forwarded.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    if (!scanEvents(data, size)) {
+        // errors and acknowledgements without events
+        c.forwarded.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    std::size_t fresh = 0;
+    for (auto &item : items_) {
+        item.fresh = !known(item.key);
+        fresh += item.fresh ? 1 : 0;
+    }
+    if (fresh == 0) {
+        c.duplicates.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    for (const auto &item : items_) {
+        if (item.fresh) {
+            remember(item.key);
+        }
+    }
+    if (fresh < items_.size()) {
+        frame = filter(data, size);
+        c.filtered.fetch_add(1, std::memory_order_relaxed);
+    }
+    c.forwarded.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool MarketDataArbiter::scanEvents(const char* data, std::size_t size) {
+    events_.clear();
+    items_.clear();
+    events_begin_ = events_end_ = nullptr;
+
+    JsonScanner s(data, size);
+    std::string_view key, channel;
+    if (!s.enterObject()) {
+        return false;
+    }
+    while (s.nextKey(key)) {
+        if (key == "channel") {
+            s.readString(channel);
+            continue;
+        }
+        if (key != "events" || !s.enterArray()) {
+            s.skipValue();
+            continue;
+        }
+        events_begin_ = s.position();
+        while (s.nextElement()) {
+            Event event{s.position(), nullptr, nullptr, nullptr, static_cast<uint32_t>(items_.size()), 0};
+            std::string_view product_id;
+            if (!s.enterObject()) {
+                return false;
+            }
+            while (s.nextKey(key)) {
+                if (key == "product_id") {
+                    s.readString(product_id);
+                }
+                else if (!event.items_begin && (key == "trades" || key == "updates" || key == "tickers" || key == "candles")) {
+                    if (!s.enterArray()) {
+                        return false;
+                    }
+                    event.items_begin = s.position();
+                    while (s.nextElement()) {
+                        auto *begin = s.position();
+                        s.skipValue();
+                        items_.push_back({begin, s.position(), 0, false});
+                    }
+                    event.items_end = s.position() - 1;
+                }
+                else {
+                    s.skipValue();
+                }
+            }
+            event.end = s.position();
+            event.item_count = static_cast<uint32_t>(items_.size()) - event.first_item;
+            if (event.item_count == 0) {
+                // heartbeats, subscriptions and empty batches are matched whole
+                event.items_begin = event.items_end = nullptr;
+                items_.push_back({event.begin, event.end, 0, false});
+                event.item_count = 1;
+            }
+            for (auto i = event.first_item; i < event.first_item + event.item_count; ++i) {
+                auto &item = items_[i];
+                item.key = item_key(channel, product_id, std::string_view(item.begin, static_cast<std::size_t>(item.end - item.begin)));
+            }
+            events_.push_back(event);
+        }
+        events_end_ = s.position() - 1;
+    }
+    return s.ok() && events_end_ && !items_.empty();
+}
+
+bool MarketDataArbiter::known(uint64_t key) const noexcept {
+    const auto *keys = &keys_[(key & bucket_mask_) * WAYS];
+    for (uint32_t i = 0; i < WAYS; ++i) {
+        if (keys[i] == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void MarketDataArbiter::remember(uint64_t key) noexcept {
+    auto bucket = key & bucket_mask_;
+    keys_[bucket * WAYS + next_[bucket]++ % WAYS] = key;
+}
+
+std::string_view MarketDataArbiter::filter(const char* data, std::size_t size) {
+    // the envelope, then the events with a fresh item, each with its fresh items
+    filtered_.assign(data, events_begin_);
+    bool first_event = true;
+    for (const auto &event : events_) {
+        auto items = std::span<const Item>(items_).subspan(event.first_item, event.item_count);
+        if (std::none_of(items.begin(), items.end(), [](const Item &item) { return item.fresh; })) {
+            continue;
+        }
+        if (!first_event) {
+            filtered_ += ',';
+        }
+        first_event = false;
+        if (!event.items_begin) {
+            filtered_.append(event.begin, event.end);
+            continue;
+        }
+        filtered_.append(event.begin, event.items_begin);
+        bool first_item = true;
+        for (const auto &item : items) {
+            if (item.fresh) {
+                if (!first_item) {
+                    filtered_ += ',';
+                }
+                first_item = false;
+                filtered_.append(item.begin, item.end);
+            }
+        }
+        filtered_.append(event.items_end, event.end);
+    }
+    filtered_.append(events_end_, data + size);
+    return filtered_;
+}
+
+void MarketDataArbiter::connected(uint32_t connection) noexcept {
+    if (connection < count_) {
+        connections_[connection].last_seq_num.store(-1, std::memory_order_relaxed);
+        connections_[connection].connected.store(true, std::memory_order_release);
+        // alone, its snapshots rebuild the books; otherwise the source's
+        // deltas keep them current and its replay snapshots are dropped
+        auto source = NO_CONNECTION;
+        if (!othersConnected(connection)) {
+            snapshot_source_.store(connection, std::memory_order_release);
+        }
+        else {
+            snapshot_source_.compare_exchange_strong(source, connection, std::memory_order_acq_rel);
+        }
+    }
+}
+
+void MarketDataArbiter::disconnected(uint32_t connection) noexcept {
+    if (connection < count_) {
+        connections_[connection].connected.store(false, std::memory_order_release);
+        connections_[connection].last_seq_num.store(-1, std::memory_order_relaxed);
+        // hand over to a connection still up, so snapshots of new
+        // subscriptions keep coming through
+        auto source = connection;
+        auto next = NO_CONNECTION;
+        for (uint32_t i = 0; i < count_ && next == NO_CONNECTION; ++i) {
+            if (connections_[i].connected.load(std::memory_order_acquire)) {
+                next = i;
+            }
+        }
+        snapshot_source_.compare_exchange_strong(source, next, std::memory_order_acq_rel);
+    }
+}
+
+void MarketDataArbiter::setSnapshotSource(uint32_t connection) noexcept {
+    if (connection < count_) {
+        snapshot_source_.store(connection, std::memory_order_release);
+    }
+}
+
+uint32_t MarketDataArbiter::connectedCount() const noexcept {
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < count_; ++i) {
+        n += connections_[i].connected.load(std::memory_order_acquire) ? 1 : 0;
+    }
+    return n;
+}
+
+bool MarketDataArbiter::othersConnected(uint32_t connection) const noexcept {
+    for (uint32_t i = 0; i < count_; ++i) {
+        if (i != connection && connections_[i].connected.load(std::memory_order_acquire)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+MarketDataConnectionStats MarketDataArbiter::stats(uint32_t connection) const noexcept {
+    MarketDataConnectionStats stats;
+    if (connection < count_) {
+        const auto &c = connections_[connection];
+        stats.frames = c.frames.load(std::memory_order_relaxed);
+        stats.forwarded = c.forwarded.load(std::memory_order_relaxed);
+        stats.duplicates = c.duplicates.load(std::memory_order_relaxed);
+        stats.filtered = c.filtered.load(std::memory_order_relaxed);
+        stats.gaps = c.gaps.load(std::memory_order_relaxed);
+        stats.snapshots = c.snapshots.load(std::memory_order_relaxed);
+        stats.connected = c.connected.load(std::memory_order_acquire);
+    }
+    return stats;
+}
+
+bool MarketDataArbiter::isSnapshot(const char* data, std::size_t size) noexcept {
+    std::string_view frame(data, size);
+    auto events = frame.find("\"events\":");
+    if (events == std::string_view::npos) {
+        return false;
+    }
+    auto type = frame.find("\"type\":", events);
+    return type != std::string_view::npos && frame.substr(type + 7).starts_with("\"snapshot\"");
+}
+
+}   // end namespace coinbase
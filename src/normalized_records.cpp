@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#include <coinbase/normalized_records.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace coinbase {
+
+namespace {
+
+template<std::size_t N>
+void copy_string(char (&field)[N], std::string_view value) noexcept {
+    std::memcpy(field, value.data(), std::min(N, value.size()));
+}
+
+}   // end anonymous namespace
+
+RecordWriter::RecordWriter(std::shared_ptr<ProducerBuffer> buffer, uint32_t max_record_size)
+    : buffer_(std::move(buffer))
+    , max_record_size_(max_record_size)
+{
+    assert(max_record_size_ >= sizeof(RecordHeader) + sizeof(OrderEntry));
+}
+
+template<typename Entry, typename Item, typename Fill>
+void RecordWriter::write(uint64_t seq_num, uint64_t timestamp, bool snapshot, std::string_view product_id, std::span<const Item> items, Fill &&fill) {
+    static_assert(Entry::OFFSET % 8 == 0 && sizeof(Entry) % 8 == 0);
+    auto per_record = std::min<std::size_t>((max_record_size_ - Entry::OFFSET) / sizeof(Entry), std::numeric_limits<uint16_t>::max());
+    std::size_t i = 0;
+    do {
+        auto n = std::min(per_record, items.size() - i);
+        auto size = static_cast<uint32_t>(Entry::OFFSET + n * sizeof(Entry));
+        auto [ptr, capacity] = buffer_->prepare(size);
+        std::memset(ptr, 0, size);
+
+        auto *header = reinterpret_cast<RecordHeader*>(ptr);
+        header->type = Entry::TYPE;
+        header->flags = static_cast<uint8_t>((snapshot ? RecordFlags::SNAPSHOT : 0)
+            | (i == 0 ? RecordFlags::FIRST : 0)
+            | (i + n == items.size() ? RecordFlags::LAST : 0));
+        header->count = static_cast<uint16_t>(n);
+        header->size = size;
+        header->seq_num = seq_num;
+        header->timestamp = timestamp;
+        if constexpr (Entry::OFFSET == sizeof(Level2Record)) {
+            copy_string(reinterpret_cast<Level2Record*>(ptr)->product_id, product_id);
+        }
+
+        auto *entries = reinterpret_cast<Entry*>(ptr + Entry::OFFSET);
+        for (std::size_t k = 0; k < n; ++k) {
+            fill(entries[k], items[i + k]);
+        }
+        buffer_->commit(size);
+        buffer_->consume(size);
+        i += n;
+    }
+    while (i < items.size());
+}
+
+void RecordWriter::writeLevel2(uint64_t seq_num, uint64_t timestamp, bool snapshot, std::string_view product_id, std::span<const Level2Update> updates) {
+    write<Level2Entry>(seq_num, timestamp, snapshot, product_id, updates, [](Level2Entry &e, const Level2Update &u) {
+        e.event_time = u.event_time;
+        e.price_level = u.price_level;
+        e.new_quantity = u.new_quantity;
+        e.side = u.side;
+    });
+}
+
+void RecordWriter::writeTrades(uint64_t seq_num, uint64_t timestamp, bool snapshot, std::span<const MarketTrade> trades) {
+    write<TradeEntry>(seq_num, timestamp, snapshot, {}, trades, [](TradeEntry &e, const MarketTrade &t) {
+        copy_string(e.product_id, t.product_id);
+        copy_string(e.trade_id, t.trade_id);
+        e.time = t.time;
+        e.price = t.price;
+        e.size = t.size;
+        e.side = t.side;
+    });
+}
+
+void RecordWriter::writeTickers(uint64_t seq_num, uint64_t timestamp, bool snapshot, std::span<const Ticker> tickers) {
+    write<TickerEntry>(seq_num, timestamp, snapshot, {}, tickers, [](TickerEntry &e, const Ticker &t) {
+        copy_string(e.product_id, t.product_id);
+        e.price = t.price;
+        e.volume_24_h = t.volume_24_h;
+        e.low_24_h = t.low_24_h;
+        e.high_24_h = t.high_24_h;
+        e.low_52_w = t.low_52_w;
+        e.high_52_w = t.high_52_w;
+        e.price_percent_chg_24_h = t.price_percent_chg_24_h;
+        e.best_bid = t.best_bid;
+        e.best_bid_quantity = t.best_bid_quantity;
+        e.best_ask = t.best_ask;
+        e.best_ask_quantity = t.best_ask_quantity;
+    });
+}
+
+void RecordWriter::writeCandles(uint64_t seq_num, uint64_t timestamp, bool snapshot, std::span<const Candle> candles) {
+    write<CandleEntry>(seq_num, timestamp, snapshot, {}, candles, [](CandleEntry &e, const Candle &c) {
+        copy_string(e.product_id, c.product_id);
+        e.start = c.start;
+        e.open = c.open;
+        e.high = c.high;
+        e.low = c.low;
+        e.close = c.close;
+        e.volume = c.volume;
+    });
+}
+
+void RecordWriter::writeOrders(uint64_t seq_num, uint64_t timestamp, bool snapshot, std::span<const Order> orders) {
+    write<OrderEntry>(seq_num, timestamp, snapshot, {}, orders, [](OrderEntry &e, const Order &o) {
+        copy_string(e.product_id, o.product_id);
+        copy_string(e.order_id, o.order_id);
+        copy_string(e.client_order_id, o.client_order_id);
+        e.created_time = o.created_time;
+        e.last_fill_time = o.last_fill_time;
+        e.limit_price = o.limit_price;
+        e.avg_price = o.avg_price;
+        e.leaves_quantity = o.leaves_quantity;
+        e.cumulative_quantity = o.cumulative_quantity;
+        e.filled_value = o.filled_value;
+        e.total_fees = o.total_fees;
+        e.number_of_fills = o.number_of_fills;
+        e.side = o.side;
+        e.status = o.status;
+        e.order_type = o.order_type;
+        e.time_in_force = o.time_in_force;
+    });
+}
+
+}   // end namespace coinbase
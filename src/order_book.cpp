@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#include <coinbase/order_book.hpp>
+#include <algorithm>
+#include <cassert>
+
+namespace coinbase {
+
+// OrderBook::Ladder implementation
+OrderBook::Ladder::Ladder(bool is_bid, uint32_t window_ticks)
+    : is_bid_(is_bid)
+    , qty_(std::max(window_ticks, 4u), 0.)
+{
+}
+
+void OrderBook::Ladder::clear() {
+    if (dense_count_ > 0) {
+        std::fill(qty_.begin(), qty_.end(), 0.);
+        dense_count_ = 0;
+    }
+    overflow_.clear();
+    best_ = 0;
+}
+
+double OrderBook::Ladder::get(int64_t tick) const noexcept {
+    if (inWindow(tick)) {
+        return qty_[index(tick)];
+    }
+    auto it = overflow_.find(tick);
+    return it != overflow_.end() ? it->second : 0.;
+}
+
+void OrderBook::Ladder::set(int64_t tick, double quantity) {
+    if (inWindow(tick)) [[likely]] {
+        auto &slot = qty_[index(tick)];
+        if (quantity > 0.) {
+            if (slot <= 0.) {
+                ++dense_count_;
+            }
+            slot = quantity;
+            if (dense_count_ == 1 || better(tick, best_)) {
+                best_ = tick;
+            }
+        }
+        else if (slot > 0.) {
+            slot = 0.;
+            --dense_count_;
+            if (tick == best_) {
+                findBest();
+            }
+        }
+        return;
+    }
+
+    if (quantity > 0.) {
+        if (!hasBest() || better(tick, best_)) {
+            // new best outside the window
+            recenter(tick);
+            set(tick, quantity);
+        }
+        else {
+            overflow_[tick] = quantity;
+        }
+    }
+    else {
+        overflow_.erase(tick);
+    }
+}
+
+void OrderBook::Ladder::findBest() {
+    if (dense_count_ > 0) {
+        int64_t step = is_bid_ ? -1 : 1;
+        for (auto tick = best_ + step; inWindow(tick); tick += step) {
+            if (qty_[index(tick)] > 0.) {
+                best_ = tick;
+                return;
+            }
+        }
+    }
+    if (!overflow_.empty()) {
+        recenter(is_bid_ ? overflow_.rbegin()->first : overflow_.begin()->first);
+    }
+}
+
+void OrderBook::Ladder::recenter(int64_t best_tick) {
+    std::vector<std::pair<int64_t, double>> levels;
+    levels.reserve(dense_count_ + overflow_.size());
+    if (dense_count_ > 0) {
+        for (std::size_t i = 0; i < qty_.size(); ++i) {
+            if (qty_[i] > 0.) {
+                levels.emplace_back(base_ + static_cast<int64_t>(i), qty_[i]);
+                qty_[i] = 0.;
+            }
+        }
+    }
+    for (const auto &level : overflow_) {
+        levels.emplace_back(level);
+    }
+    overflow_.clear();
+    dense_count_ = 0;
+
+    // leave most of the window on the side where the rest of the book is
+    auto n = static_cast<int64_t>(qty_.size());
+    base_ = is_bid_ ? best_tick - (n * 3) / 4 : best_tick - n / 4;
+    best_ = best_tick;
+    for (const auto &[tick, quantity] : levels) {
+        if (inWindow(tick)) {
+            qty_[index(tick)] = quantity;
+            ++dense_count_;
+        }
+        else {
+            overflow_.emplace(tick, quantity);
+        }
+    }
+}
+
+// OrderBook implementation
+OrderBook::OrderBook(const Product &product, uint32_t window_ticks)
+    : OrderBook(product.product_id, product.quote_increment > 0. ? product.quote_increment : product.price_increment, window_ticks)
+{
+}
+
+OrderBook::OrderBook(std::string_view product_id, double tick_size, uint32_t window_ticks)
+    : product_id_(product_id)
+    , tick_size_(tick_size)
+    , price_scale_(tick_size)
+    , bids_(true, window_ticks)
+    , asks_(false, window_ticks)
+{
+    assert(tick_size > 0.);
+}
+
+void OrderBook::clear() {
+    bids_.clear();
+    asks_.clear();
+}
+
+void OrderBook::applySnapshot(std::span<const Level2Update> snapshot, uint64_t seq_num) {
+    clear();
+    applyUpdates(snapshot, seq_num);
+}
+
+void OrderBook::applyUpdates(std::span<const Level2Update> updates, uint64_t seq_num) {
+    for (const auto &update : updates) {
+        apply(update);
+    }
+    seq_num_ = seq_num;
+}
+
+void OrderBook::apply(const Level2Update &update) {
+    ladder(update.side).set(toTick(update.price_level), update.new_quantity);
+    event_time_ = update.event_time;
+}
+
+double OrderBook::quantityAt(Side side, double price) const noexcept {
+    return ladder(side).get(toTick(price));
+}
+
+std::size_t OrderBook::depth(Side side, std::span<BookLevel> out) const {
+    std::size_t n = 0;
+    if (out.empty()) {
+        return n;
+    }
+    ladder(side).forEach([&](int64_t tick, double quantity) {
+        out[n++] = BookLevel{toPrice(tick), quantity};
+        return n < out.size();
+    });
+    return n;
+}
+
+std::vector<BookLevel> OrderBook::depth(Side side, std::size_t n) const {
+    std::vector<BookLevel> levels(std::min(n, levelCount(side)));
+    levels.resize(depth(side, levels));
+    return levels;
+}
+
+int64_t OrderBook::toTick(double price) const noexcept {
+    return price_scale_.fromDouble(price).value;
+}
+
+double OrderBook::toPrice(int64_t tick) const noexcept {
+    return price_scale_.toDouble(Price(tick));
+}
+
+std::optional<BookLevel> OrderBook::best(const Ladder &l) const noexcept {
+    if (!l.hasBest()) {
+        return std::nullopt;
+    }
+    return BookLevel{toPrice(l.bestTick()), l.bestQuantity()};
+}
+
+}   // end namespace coinbase
@@ -0,0 +1,570 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#include <coinbase/order_request.hpp>
+#include <coinbase/product_catalog.hpp>
+#include <coinbase/utils.hpp>
+#include <slick/net/logging.hpp>
+#include <cmath>
+#include <format>
+
+namespace coinbase {
+
+namespace {
+
+const Product& product(std::string_view product_id) {
+    return ProductCatalog::instance().get(product_id);
+}
+
+void append_json_string(std::string &out, std::string_view s) {
+    constexpr char HEX[] = "0123456789abcdef";
+    out += '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20) {
+            out += "\\u00";
+            out += HEX[c >> 4];
+            out += HEX[c & 0xf];
+        }
+        else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+}   // end anonymous namespace
+
+void OrderRequestWriter::addProduct(const Product &product) {
+    auto it = overrides_.insert_or_assign(product.product_id, ProductSpec{}).first;
+    it->second = ProductSpec::from(product, it->first);
+}
+
+const ProductSpec* OrderRequestWriter::productSpec(std::string_view product_id) {
+    if (product_id.empty()) [[unlikely]] {
+        return nullptr;
+    }
+    if (!overrides_.empty()) [[unlikely]] {
+        if (auto it = overrides_.find(product_id); it != overrides_.end()) {
+            return &it->second;
+        }
+    }
+    // the catalog keeps specs current with status channel updates
+    auto &catalog = ProductCatalog::instance();
+    auto handle = catalog.handle(product_id);
+    if (handle == INVALID_PRODUCT_HANDLE || !catalog.spec(handle, spec_)) [[unlikely]] {
+        // fetches a product that is not loaded yet; the catalog caches failures
+        const auto &prod = catalog.get(product_id);
+        if (prod.product_id.empty()) {
+            return nullptr;
+        }
+        spec_ = ProductSpec::from(prod, prod.product_id);
+    }
+    return &spec_;
+}
+
+void OrderRequestWriter::appendString(std::string_view s) {
+    append_json_string(buffer_, s);
+}
+
+bool OrderRequestWriter::checkDecimals(CreateOrderResponse &rsp, const ProductSpec &spec, double size, double limit_price, bool size_in_quote,
+                                       const std::optional<double> &stop_price, const std::optional<double> &take_profit_price) {
+    const char *invalid = nullptr;
+    double value = 0.;
+    Price price;
+    Qty qty;
+    if (!placeholders_ && (!(size_in_quote ? spec.quote_size : spec.base_size).fromDouble(size, qty, DecimalScale::Rounding::TOWARD_ZERO) || qty.value <= 0)) {
+        invalid = "size";
+        value = size;
+    }
+    else if (!placeholders_ && !std::isnan(limit_price) && !spec.price.fromDouble(limit_price, price)) {
+        invalid = "limit price";
+        value = limit_price;
+    }
+    else if (stop_price.has_value() && !spec.price.fromDouble(stop_price.value(), price)) {
+        invalid = "stop price";
+        value = stop_price.value();
+    }
+    else if (take_profit_price.has_value() && !spec.price.fromDouble(take_profit_price.value(), price)) {
+        invalid = "take profit price";
+        value = take_profit_price.value();
+    }
+    if (invalid) [[unlikely]] {
+        rsp.error_response.message = std::format("Invalid {} {}", invalid, value);
+        rsp.success = false;
+        LOG_ERROR(rsp.error_response.message.c_str());
+        return false;
+    }
+    return true;
+}
+
+void OrderRequestWriter::appendDecimal(const char *key, const DecimalScale &scale, double value, DecimalScale::Rounding rounding) {
+    char buf[32];
+    buffer_ += '"';
+    buffer_ += key;
+    buffer_ += R"(":")";
+    buffer_.append(buf, scale.toChars(buf, buf + sizeof(buf), scale.fromDouble<QtyTag>(value, rounding)));
+    buffer_ += '"';
+}
+
+void OrderRequestWriter::appendSize(const ProductSpec &spec, double size, bool size_in_quote) {
+    if (placeholders_) {
+        buffer_ += size_in_quote ? R"("quote_size":")" : R"("base_size":")";
+        buffer_ += SIZE_PLACEHOLDER;
+        buffer_ += '"';
+    }
+    else if (size_in_quote) {
+        appendDecimal("quote_size", spec.quote_size, size, DecimalScale::Rounding::TOWARD_ZERO);
+    }
+    else {
+        appendDecimal("base_size", spec.base_size, size, DecimalScale::Rounding::TOWARD_ZERO);
+    }
+}
+
+void OrderRequestWriter::appendLimitPrice(const ProductSpec &spec, double limit_price) {
+    if (placeholders_) {
+        buffer_ += R"("limit_price":")";
+        buffer_ += PRICE_PLACEHOLDER;
+        buffer_ += '"';
+    }
+    else {
+        appendDecimal("limit_price", spec.price, limit_price);
+    }
+}
+
+void OrderRequestWriter::appendTimestamp(const char *key, uint64_t timestamp_ms) {
+    buffer_ += '"';
+    buffer_ += key;
+    buffer_ += R"(":")";
+    buffer_ += timestamp_to_string(timestamp_ms);
+    buffer_ += '"';
+}
+
+bool OrderRequestWriter::writeCreateOrder(
+    CreateOrderResponse &rsp,
+    std::string_view client_order_id,
+    std::string_view product_id,
+    Side side,
+    OrderType order_type,
+    TimeInForce time_in_force,
+    double size,
+    double limit_price,
+    bool post_only,
+    bool size_in_quote,
+    const std::optional<double> &stop_price,
+    const std::optional<double> &take_profit_price,
+    const std::optional<uint64_t> &end_time,
+    const std::optional<uint64_t> &twap_start_time,
+    const std::optional<SorPreference> &sor_preference,
+    const std::optional<double> &leverage,
+    const std::optional<MarginType> &margin_type,
+    const std::optional<json> &attached_order_configuration,
+    std::optional<PredictionMetadata> &&prediction_metadata
+) {
+    const auto *product_spec = productSpec(product_id);
+    if (!product_spec) [[unlikely]] {
+        // no increments to format the order with
+        rsp.error_response.message = std::format("Unknown product {}. client_order_id: {}", product_id, client_order_id);
+        rsp.success = false;
+        LOG_ERROR(rsp.error_response.message.c_str());
+        return false;
+    }
+    const auto &spec = *product_spec;
+    if (!checkDecimals(rsp, spec, size, limit_price, size_in_quote, stop_price, take_profit_price)) {
+        return false;
+    }
+    bool bracket = false;   // attach a TP/SL bracket from take_profit_price and stop_price
+
+    buffer_.clear();
+    buffer_ += R"({"client_order_id":)";
+    if (placeholders_) {
+        buffer_ += '"';
+        buffer_ += CLIENT_ORDER_ID_PLACEHOLDER;
+        buffer_ += '"';
+    }
+    else {
+        appendString(client_order_id);
+    }
+    buffer_ += R"(,"product_id":)";
+    appendString(product_id);
+    buffer_ += side == Side::BUY ? R"(,"side":"BUY")" : R"(,"side":"SELL")";
+    buffer_ += R"(,"order_configuration":{)";
+    switch (order_type) {
+        case OrderType::MARKET: {
+            if (!std::isnan(limit_price)) {
+                LOG_WARN("limit price ignored. Limit price should not be set for market order");
+            }
+            if (time_in_force == TimeInForce::FILL_OR_KILL) {
+                buffer_ += R"("market_market_fok":{)";
+                appendSize(spec, size, size_in_quote);
+                buffer_ += '}';
+            }
+            else if (time_in_force == TimeInForce::IMMEDIATE_OR_CANCEL) {
+                buffer_ += R"("market_market_ioc":{)";
+                appendSize(spec, size, size_in_quote);
+                buffer_ += '}';
+            }
+            else {
+                rsp.error_response.message = std::format("TimeInForce {} invalid for market order", to_string(time_in_force));
+                rsp.success = false;
+                LOG_ERROR(rsp.error_response.message.c_str());
+                return false;
+            }
+
+            if (stop_price.has_value() && take_profit_price.has_value()) {
+                if (spec.product_type == ProductType::SPOT && side == Side::SELL) {
+                    LOG_ERROR("Invalid order side for attached TP/SL");
+                    rsp.error_response.message = "Invalid order side for attached TP/SL";
+                    rsp.success = false;
+                    return false;
+                }
+                bracket = true;
+            }
+            else if (stop_price.has_value()) {
+                LOG_ERROR("braket order must have both stop_price and take_profit_price");
+                rsp.error_response.message = "braket order must have both stop_price and take_profit_price";
+                rsp.success = false;
+                return false;
+            }
+            break;
+        }
+        case OrderType::LIMIT: {
+            if (std::isnan(limit_price)) {
+                LOG_ERROR("Invalid limit price NAN");
+                rsp.error_response.message = "Invalid limit price NAN";
+                rsp.success = false;
+                return false;
+            }
+            if (time_in_force == TimeInForce::FILL_OR_KILL) {
+                buffer_ += R"("limit_limit_fok":{)";
+                appendSize(spec, size, size_in_quote);
+                buffer_ += ',';
+                appendLimitPrice(spec, limit_price);
+                buffer_ += '}';
+            }
+            else if (time_in_force == TimeInForce::IMMEDIATE_OR_CANCEL) {
+                buffer_ += R"("sor_limit_ioc":{)";
+                appendSize(spec, size, size_in_quote);
+                buffer_ += ',';
+                appendLimitPrice(spec, limit_price);
+                buffer_ += '}';
+            }
+            else if (time_in_force == TimeInForce::GOOD_UNTIL_CANCELLED) {
+                buffer_ += R"("limit_limit_gtc":{)";
+                appendSize(spec, size, size_in_quote);
+                buffer_ += ',';
+                appendLimitPrice(spec, limit_price);
+                buffer_ += post_only ? R"(,"post_only":true})" : R"(,"post_only":false})";
+            }
+            else if (time_in_force == TimeInForce::GOOD_UNTIL_DATE_TIME) {
+                if (!end_time.has_value()) {
+                    LOG_ERROR("end_time missing for limit_gtd order");
+                    rsp.error_response.message = "end_time missing for limit_gtd order";
+                    rsp.success = false;
+                    return false;
+                }
+                buffer_ += R"("limit_limit_gtd":{)";
+                appendSize(spec, size, size_in_quote);
+                buffer_ += ',';
+                appendLimitPrice(spec, limit_price);
+                buffer_ += post_only ? R"(,"post_only":true,)" : R"(,"post_only":false,)";
+                appendTimestamp("end_time", end_time.value());
+                buffer_ += '}';
+            }
+            else {
+                rsp.error_response.message = std::format("TimeInForce {} invalid for market order", to_string(time_in_force));
+                rsp.success = false;
+                LOG_ERROR(rsp.error_response.message.c_str());
+                return false;
+            }
+
+            if (stop_price.has_value() && take_profit_price.has_value()) {
+                if (spec.product_type == ProductType::SPOT && side == Side::SELL) {
+                    LOG_ERROR("Invalid order side for attached TP/SL");
+                    rsp.error_response.message = "Invalid order side for attached TP/SL";
+                    rsp.success = false;
+                    return false;
+                }
+                bracket = true;
+            }
+            else if (stop_price.has_value() ^ take_profit_price.has_value()) {
+                LOG_ERROR("braket order must have both stop_price and take_profit_price");
+                rsp.error_response.message = "braket order must have both stop_price and take_profit_price";
+                rsp.success = false;
+                return false;
+            }
+            break;
+        }
+        case OrderType::STOP_LIMIT: {
+            if (size_in_quote) {
+                LOG_ERROR("Invalid parameter. stop limit order size only in base_size");
+                rsp.error_response.message = "Invalid parameter. stop limit order size only in base_size";
+                rsp.success = false;
+                return false;
+            }
+            if (!stop_price.has_value() || std::isnan(stop_price.value())) {
+                LOG_ERROR("Invalid stop_price {}", stop_price.value_or(NAN));
+                rsp.error_response.message = std::format("Invalid stop_price {}", stop_price.value_or(NAN));
+                rsp.success = false;
+                return false;
+            }
+            if (std::isnan(limit_price)) {
+                LOG_ERROR("Invalid limit price NAN");
+                rsp.error_response.message = "Invalid limit price NAN";
+                rsp.success = false;
+                return false;
+            }
+            if (time_in_force == TimeInForce::GOOD_UNTIL_CANCELLED) {
+                buffer_ += R"("stop_limit_stop_limit_gtc":{)";
+                appendSize(spec, size, false);
+                buffer_ += ',';
+                appendLimitPrice(spec, limit_price);
+                buffer_ += ',';
+                appendDecimal("stop_price", spec.price, stop_price.value());
+                buffer_ += '}';
+            }
+            else if (time_in_force == TimeInForce::GOOD_UNTIL_DATE_TIME) {
+                if (!end_time.has_value())
+                {
+                    LOG_ERROR("end_time missing for limit_gtd order");
+                    rsp.error_response.message = "end_time missing for limit_gtd order";
+                    rsp.success = false;
+                    return false;
+                }
+                buffer_ += R"("stop_limit_stop_limit_gtd":{)";
+                appendSize(spec, size, false);
+                buffer_ += ',';
+                appendLimitPrice(spec, limit_price);
+                buffer_ += ',';
+                appendDecimal("stop_price", spec.price, stop_price.value());
+                buffer_ += ',';
+                appendTimestamp("end_time", end_time.value());
+                buffer_ += '}';
+            }
+            else {
+                rsp.error_response.message = std::format("TimeInForce {} invalid for market order", to_string(time_in_force));
+                rsp.success = false;
+                LOG_ERROR(rsp.error_response.message.c_str());
+                return false;
+            }
+            break;
+        }
+        case OrderType::TWAP: {
+            if (!twap_start_time.has_value() || !end_time.has_value()) {
+                LOG_ERROR("twap order must have start and end time");
+                rsp.error_response.message = "twap order must have start and end time";
+                rsp.success = false;
+                return false;
+            }
+            if (std::isnan(limit_price)) {
+                LOG_ERROR("Invalid limit price NAN");
+                rsp.error_response.message = "Invalid limit price NAN";
+                rsp.success = false;
+                return false;
+            }
+
+            buffer_ += R"("twap_limit_gtd":{)";
+            appendSize(spec, size, size_in_quote);
+            buffer_ += ',';
+            appendLimitPrice(spec, limit_price);
+            buffer_ += ',';
+            appendTimestamp("start_time", twap_start_time.value());
+            buffer_ += ',';
+            appendTimestamp("end_time", end_time.value());
+            buffer_ += '}';
+            break;
+        }
+        case OrderType::BRACKET: {
+            if (spec.product_type == ProductType::SPOT && side == Side::BUY) {
+                LOG_ERROR("Invalid order side for Bracket order");
+                rsp.error_response.message = "Invalid order side for Bracket order";
+                rsp.success = false;
+                return false;
+            }
+
+            if (size_in_quote) {
+                LOG_ERROR("Invalid parameter. Bracket order size only in base_size");
+                rsp.error_response.message = "Invalid parameter. Bracket order size only in base_size";
+                rsp.success = false;
+                return false;
+            }
+
+            if (!stop_price.has_value() || (!take_profit_price.has_value() && std::isnan(limit_price))) {
+                LOG_ERROR("braket order must have both stop_price and take_profit_price");
+                rsp.error_response.message = "braket order must have both stop_price and take_profit_price";
+                rsp.success = false;
+                return false;
+            }
+            buffer_ += R"("trigger_bracket_gtc":{)";
+            appendSize(spec, size, false);
+            buffer_ += ',';
+            if (take_profit_price.has_value()) {
+                appendDecimal("limit_price", spec.price, take_profit_price.value());
+            }
+            else {
+                // use limit_price as take_profit_price for stop loss only bracket order
+                appendLimitPrice(spec, limit_price);
+            }
+            buffer_ += ',';
+            appendDecimal("stop_trigger_price", spec.price, stop_price.value());
+            buffer_ += '}';
+            break;
+        }
+        default: {
+            rsp.error_response.message = std::format("OrderType {} is not supported. client_order_id: {}", to_string(order_type), client_order_id);
+            LOG_ERROR(rsp.error_response.message.c_str());
+            rsp.success = false;
+            return false;
+        }
+    }
+    buffer_ += '}';
+
+    if (leverage.has_value()) {
+        buffer_ += R"(,"leverage":)";
+        appendString(std::to_string(leverage.value()));
+    }
+    if (margin_type.has_value()) {
+        buffer_ += R"(,"margin_type":)";
+        appendString(to_string(margin_type.value()));
+    }
+    if (attached_order_configuration.has_value()) {
+        buffer_ += R"(,"attached_order_configuration":)";
+        buffer_ += attached_order_configuration->dump();
+    }
+    else if (bracket) {
+        buffer_ += R"(,"attached_order_configuration":{"trigger_bracket_gtc":{)";
+        appendDecimal("limit_price", spec.price, take_profit_price.value());
+        buffer_ += ',';
+        appendDecimal("stop_trigger_price", spec.price, stop_price.value());
+        buffer_ += "}}";
+    }
+    buffer_ += R"(,"sor_preference":)";
+    appendString(to_string(sor_preference.value_or(SorPreference::SOR_ENABLED)));
+    if (prediction_metadata.has_value()) {
+        json j;
+        to_json(j, prediction_metadata.value());
+        buffer_ += R"(,"prediction_metadata":)";
+        buffer_ += j.dump();
+    }
+    buffer_ += '}';
+    return true;
+}
+
+OrderTemplate::OrderTemplate(
+    const Product &product,
+    Side side,
+    OrderType order_type,
+    TimeInForce time_in_force,
+    bool post_only,
+    bool size_in_quote,
+    const std::optional<double> &stop_price,
+    const std::optional<double> &take_profit_price,
+    const std::optional<uint64_t> &end_time,
+    const std::optional<uint64_t> &twap_start_time,
+    const std::optional<SorPreference> &sor_preference,
+    const std::optional<double> &leverage,
+    const std::optional<MarginType> &margin_type,
+    const std::optional<json> &attached_order_configuration
+)
+    : product_id_(product.product_id)
+{
+    OrderRequestWriter writer;
+    writer.addProduct(product);
+    writer.placeholders_ = true;
+    CreateOrderResponse rsp;
+    // any valid price passes validation; it is written as a placeholder
+    double limit_price = order_type == OrderType::MARKET ? NAN : 1.;
+    if (!writer.writeCreateOrder(rsp, {}, product_id_, side, order_type, time_in_force, 1., limit_price, post_only, size_in_quote,
+            stop_price, take_profit_price, end_time, twap_start_time, sor_preference, leverage, margin_type, attached_order_configuration, {})) {
+        error_ = std::move(rsp.error_response.message);
+        return;
+    }
+
+    const auto &spec = *writer.productSpec(product_id_);
+    size_scale_ = size_in_quote ? spec.quote_size : spec.base_size;
+    price_scale_ = spec.price;
+
+    auto body = writer.body();
+    std::size_t start = 0;
+    for (std::size_t i = 0; i < body.size(); ++i) {
+        auto c = body[i];
+        if (c == OrderRequestWriter::CLIENT_ORDER_ID_PLACEHOLDER
+            || c == OrderRequestWriter::SIZE_PLACEHOLDER
+            || c == OrderRequestWriter::PRICE_PLACEHOLDER) {
+            uses_limit_price_ |= c == OrderRequestWriter::PRICE_PLACEHOLDER;
+            // client_order_id is written with its quotes
+            auto end = c == OrderRequestWriter::CLIENT_ORDER_ID_PLACEHOLDER ? i - 1 : i;
+            segments_.push_back(Segment{std::string(body.substr(start, end - start)), c});
+            start = c == OrderRequestWriter::CLIENT_ORDER_ID_PLACEHOLDER ? i + 2 : i + 1;
+        }
+    }
+    segments_.push_back(Segment{std::string(body.substr(start)), 0});
+}
+
+bool OrderTemplate::write(std::string &out, std::string_view client_order_id, double size, double limit_price) const {
+    char buf[32];
+    Qty qty;
+    if (!size_scale_.fromDouble(size, qty, DecimalScale::Rounding::TOWARD_ZERO) || qty.value <= 0) [[unlikely]] {
+        return false;
+    }
+    Price price;
+    if (uses_limit_price_ && !price_scale_.fromDouble(limit_price, price)) [[unlikely]] {
+        return false;
+    }
+    out.clear();
+    for (const auto &segment : segments_) {
+        out += segment.text;
+        switch (segment.placeholder) {
+            case OrderRequestWriter::CLIENT_ORDER_ID_PLACEHOLDER:
+                append_json_string(out, client_order_id);
+                break;
+            case OrderRequestWriter::SIZE_PLACEHOLDER:
+                out.append(buf, size_scale_.toChars(buf, buf + sizeof(buf), qty));
+                break;
+            case OrderRequestWriter::PRICE_PLACEHOLDER:
+                out.append(buf, price_scale_.toChars(buf, buf + sizeof(buf), price));
+                break;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+json build_modify_order_body(
+    const std::string &order_id,
+    const std::string &product_id,
+    double price,
+    double size,
+    const std::optional<double> &stop_price,
+    const std::optional<double> &take_profit_price,
+    const std::optional<bool> &cancel_attached_order
+) {
+    json body {
+        {"order_id", order_id},
+        {"size", std::to_string(size)},
+    };
+    body["price"] = to_string(price, product(product_id).quote_increment);
+    if (stop_price.has_value() && take_profit_price.has_value()) {
+        auto &prod = product(product_id);
+        body["attached_order_configuration"] = {
+            {"trigger_bracket_gtc", {
+                {"limit_price", to_string(take_profit_price.value(), prod.quote_increment)},
+                {"stop_trigger_price", to_string(stop_price.value(), prod.quote_increment)},
+            }}
+        };
+    }
+    else if (stop_price.has_value()) {
+        body["stop_price"] = to_string(stop_price.value(), product(product_id).quote_increment);
+    }
+    if (cancel_attached_order.has_value()) {
+        body["cancel_attached_order"] = cancel_attached_order.value();
+    }
+    return body;
+}
+
+}   // end namespace coinbase
@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#include <coinbase/product_activity.hpp>
+#include <coinbase/product_catalog.hpp>
+#include <algorithm>
+
+namespace coinbase {
+
+static_assert(ProductActivityTracker::MAX_HANDLES == ProductCatalog::MAX_HANDLES);
+
+ProductActivityTracker::ProductActivityTracker(std::chrono::nanoseconds stale_after)
+    : stale_after_(static_cast<uint64_t>(std::max<int64_t>(stale_after.count(), 1)))
+    , scan_interval_(std::max<uint64_t>(stale_after_ / 4, 1))
+{
+}
+
+ProductActivityTracker::~ProductActivityTracker() = default;
+
+bool ProductActivityTracker::record(ProductHandle handle, uint64_t seq_num, uint64_t event_time, uint64_t now) {
+    if (handle >= MAX_HANDLES) [[unlikely]] {
+        return false;
+    }
+    auto &chunk = chunks_[handle / CHUNK_SIZE];
+    auto *slots = chunk.load(std::memory_order_relaxed);
+    if (!slots) [[unlikely]] {
+        slots = storage_.emplace_back(std::make_unique<Slot[]>(CHUNK_SIZE)).get();
+        chunk.store(slots, std::memory_order_release);
+    }
+    auto &entry = slots[handle % CHUNK_SIZE];
+
+    auto rate = entry.activity.event_rate;
+    if (entry.activity.last_receive_time == 0) {
+        tracked_.push_back(handle);
+        entry.window_start = now;
+    }
+    else if (now - entry.window_start >= RATE_WINDOW) {
+        rate = entry.window_count * 1e9 / static_cast<double>(now - entry.window_start);
+        entry.window_start = now;
+        entry.window_count = 0;
+    }
+    ++entry.window_count;
+
+    auto seq = entry.sequence.load(std::memory_order_relaxed);
+    entry.sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    entry.activity.last_event_time = event_time;
+    entry.activity.last_receive_time = std::max<uint64_t>(now, 1);
+    entry.activity.last_seq_num = seq_num;
+    ++entry.activity.event_count;
+    entry.activity.event_rate = rate;
+    entry.sequence.store(seq + 2, std::memory_order_release);
+
+    if (entry.stale.load(std::memory_order_relaxed)) [[unlikely]] {
+        return entry.stale.exchange(false, std::memory_order_acq_rel);
+    }
+    return false;
+}
+
+}   // end namespace coinbase
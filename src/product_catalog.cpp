@@ -0,0 +1,618 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#include <coinbase/product_catalog.hpp>
+#include <coinbase/rest.hpp>
+#include <slick/net/logging.hpp>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace coinbase {
+
+namespace {
+
+// Snapshot layout: a header, count fixed-size records, then the strings the
+// records refer to by offset into the string table.
+struct SnapshotHeader {
+    static constexpr uint64_t MAGIC = 0x54414350534e4243ull;   // "CBNSPCAT"
+    static constexpr uint32_t VERSION = 1;
+
+    uint64_t magic;
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t count;
+    uint32_t strings_size;
+    uint64_t saved_at;      // nanoseconds since the epoch
+};
+
+struct SnapshotString {
+    uint32_t offset;
+    uint32_t size;
+};
+
+struct SnapshotRecord {
+    enum Flags : uint8_t {
+        IS_DISABLED = 1 << 0,
+        CANCEL_ONLY = 1 << 1,
+        LIMIT_ONLY = 1 << 2,
+        POST_ONLY = 1 << 3,
+        TRADING_DISABLED = 1 << 4,
+        AUCTION_MODE = 1 << 5,
+        VIEW_ONLY = 1 << 6,
+    };
+
+    SnapshotString product_id;
+    SnapshotString base_currency_id;
+    SnapshotString quote_currency_id;
+    SnapshotString display_name;
+    SnapshotString status;
+    SnapshotString product_venue;
+    SnapshotString alias;
+    SnapshotString contract_expiry_type;
+    double price_increment;
+    double base_increment;
+    double base_min_size;
+    double base_max_size;
+    double quote_increment;
+    double quote_min_size;
+    double quote_max_size;
+    double contract_size;
+    uint64_t contract_expiry;
+    ProductType product_type;
+    uint8_t flags;
+    uint8_t reserved[6];
+};
+static_assert(sizeof(SnapshotHeader) == 32);
+static_assert(sizeof(SnapshotRecord) == 144);
+
+// Read-only view of a whole file
+class MappedFile {
+public:
+    explicit MappedFile(const std::string &path) {
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            LOG_ERROR("failed to open product snapshot {}: error {}", path, GetLastError());
+            return;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+            CloseHandle(file);
+            return;
+        }
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping) {
+            LOG_ERROR("failed to map product snapshot {}: error {}", path, GetLastError());
+            return;
+        }
+        data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping);
+        if (!data_) {
+            LOG_ERROR("failed to map product snapshot {}: error {}", path, GetLastError());
+            return;
+        }
+        size_ = static_cast<std::size_t>(size.QuadPart);
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            LOG_ERROR("failed to open product snapshot {}: {}", path, std::strerror(errno));
+            return;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close(fd);
+            return;
+        }
+        void *base = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (base == MAP_FAILED) {
+            LOG_ERROR("failed to map product snapshot {}: {}", path, std::strerror(errno));
+            return;
+        }
+        data_ = static_cast<const char*>(base);
+        size_ = static_cast<std::size_t>(st.st_size);
+#endif
+    }
+
+    ~MappedFile() {
+        if (!data_) {
+            return;
+        }
+#if defined(_WIN32)
+        UnmapViewOfFile(data_);
+#else
+        munmap(const_cast<char*>(data_), size_);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+
+private:
+    const char *data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+}   // end anonymous namespace
+
+ProductCatalog& ProductCatalog::instance() {
+    // leaked on purpose: see the class comment
+    static ProductCatalog *catalog = new ProductCatalog();
+    return *catalog;
+}
+
+ProductCatalog::~ProductCatalog() {
+    if (loader_.joinable()) {
+        loader_.join();
+    }
+}
+
+ProductHandle intern_product_id(std::string_view product_id) {
+    struct StringHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+    };
+    // handles never change, so the cache is never invalidated
+    thread_local std::unordered_map<std::string, ProductHandle, StringHash, std::equal_to<>> cache;
+    if (auto it = cache.find(product_id); it != cache.end()) [[likely]] {
+        return it->second;
+    }
+    auto handle = ProductCatalog::instance().intern(product_id);
+    if (handle != INVALID_PRODUCT_HANDLE) {
+        cache.emplace(product_id, handle);
+    }
+    return handle;
+}
+
+const Product* ProductCatalog::find(std::string_view product_id) const {
+    auto map = snapshot();
+    auto it = map->handles.find(product_id);
+    return it == map->handles.end() ? nullptr : map->products[it->second];
+}
+
+ProductHandle ProductCatalog::handle(std::string_view product_id) const {
+    auto map = snapshot();
+    auto it = map->handles.find(product_id);
+    return it == map->handles.end() ? INVALID_PRODUCT_HANDLE : it->second;
+}
+
+ProductHandle ProductCatalog::intern(std::string_view product_id) {
+    if (product_id.empty()) {
+        return INVALID_PRODUCT_HANDLE;
+    }
+    if (auto h = handle(product_id); h != INVALID_PRODUCT_HANDLE) [[likely]] {
+        return h;
+    }
+    std::lock_guard lock(mutex_);
+    auto current = snapshot();
+    if (auto it = current->handles.find(product_id); it != current->handles.end()) {
+        return it->second;
+    }
+    auto map = std::make_shared<Map>(*current);
+    auto h = assignHandle(product_id, *map);
+    publish(std::move(map));
+    return h;
+}
+
+std::string_view ProductCatalog::productId(ProductHandle handle) const {
+    auto map = snapshot();
+    return handle < map->ids.size() ? map->ids[handle] : std::string_view();
+}
+
+const Product* ProductCatalog::product(ProductHandle handle) const {
+    auto map = snapshot();
+    return handle < map->products.size() ? map->products[handle] : nullptr;
+}
+
+const Product& ProductCatalog::get(std::string_view product_id) {
+    if (auto *prod = find(product_id)) [[likely]] {
+        return *prod;
+    }
+    static const Product empty{};
+    if (product_id.empty()) {
+        return empty;
+    }
+
+    {
+        std::lock_guard lock(mutex_);
+        auto it = missing_.find(std::string(product_id));
+        if (it != missing_.end() && std::chrono::steady_clock::now() < it->second) {
+            return empty;
+        }
+    }
+
+    CoinbaseRestClient client(baseUrl(), ConnectionPoolConfig{.size = 0});
+    auto prod = client.get_public_product(product_id);
+    std::lock_guard lock(mutex_);
+    if (prod.product_id != product_id) {
+        LOG_ERROR("product {} not found, not requested again for {}s", product_id, MISSING_RETRY_INTERVAL.count());
+        missing_.insert_or_assign(std::string(product_id), std::chrono::steady_clock::now() + MISSING_RETRY_INTERVAL);
+        return empty;
+    }
+    missing_.erase(std::string(product_id));
+    if (auto *existing = find(product_id)) {
+        return *existing;   // loaded while we were fetching
+    }
+    auto map = std::make_shared<Map>(*snapshot());
+    auto *stored = store(std::move(prod), *map);
+    publish(std::move(map));
+    return *stored;
+}
+
+std::size_t ProductCatalog::size() const {
+    return snapshot()->product_count;
+}
+
+void ProductCatalog::setBaseUrl(std::string base_url) {
+    std::lock_guard lock(mutex_);
+    base_url_ = std::move(base_url);
+}
+
+std::string ProductCatalog::baseUrl() const {
+    std::lock_guard lock(mutex_);
+    return base_url_;
+}
+
+ProductHandle ProductCatalog::assignHandle(std::string_view product_id, Map &map) {
+    if (auto it = map.handles.find(product_id); it != map.handles.end()) {
+        return it->second;
+    }
+    auto handle = static_cast<ProductHandle>(ids_.size());
+    std::string_view id = ids_.emplace_back(product_id);
+    map.handles.emplace(id, handle);
+    map.ids.push_back(id);
+    map.products.push_back(nullptr);
+    return handle;
+}
+
+const Product* ProductCatalog::store(Product &&product, Map &map) {
+    auto *prod = products_.emplace_back(std::make_unique<const Product>(std::move(product))).get();
+    auto handle = assignHandle(prod->product_id, map);
+    map.product_count += map.products[handle] == nullptr;
+    map.products[handle] = prod;
+    writeSpec(ProductSpec::from(*prod, map.ids[handle], handle));
+    return prod;
+}
+
+void ProductCatalog::writeSpec(const ProductSpec &spec) {
+    if (spec.handle >= MAX_HANDLES) [[unlikely]] {
+        LOG_ERROR("no product spec for {}: all {} handles are used", spec.product_id, MAX_HANDLES);
+        return;
+    }
+    auto &chunk = spec_chunks_[spec.handle / SPEC_CHUNK_SIZE];
+    auto *slots = chunk.load(std::memory_order_relaxed);
+    if (!slots) {
+        slots = spec_storage_.emplace_back(std::make_unique<SpecSlot[]>(SPEC_CHUNK_SIZE)).get();
+        chunk.store(slots, std::memory_order_release);
+    }
+    auto &slot = slots[spec.handle % SPEC_CHUNK_SIZE];
+    auto seq = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.spec = spec;
+    slot.sequence.store(seq + 2, std::memory_order_release);
+}
+
+void ProductCatalog::publish(std::shared_ptr<const Map> map) {
+    snapshot_.store(std::move(map), std::memory_order_release);
+    version_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void ProductCatalog::load(std::vector<Product> products, bool full_list) {
+    merge(std::move(products), false);
+    if (full_list) {
+        loaded_.store(true, std::memory_order_release);
+    }
+}
+
+void ProductCatalog::merge(std::vector<Product> &&products, bool keep_existing) {
+    std::lock_guard lock(mutex_);
+    auto map = std::make_shared<Map>(*snapshot());
+    map->handles.reserve(map->handles.size() + products.size());
+    for (auto &prod : products) {
+        if (prod.product_id.empty()) {
+            continue;
+        }
+        if (keep_existing) {
+            auto it = map->handles.find(prod.product_id);
+            if (it != map->handles.end() && map->products[it->second]) {
+                continue;
+            }
+        }
+        store(std::move(prod), *map);
+    }
+    publish(std::move(map));
+}
+
+void ProductCatalog::add(Product product) {
+    std::vector<Product> products;
+    products.emplace_back(std::move(product));
+    load(std::move(products), false);
+}
+
+bool ProductCatalog::loadFromFile(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        LOG_ERROR("failed to open product snapshot {}", path);
+        return false;
+    }
+    try {
+        std::stringstream ss;
+        ss << file.rdbuf();
+        auto j = json::parse(ss.str());
+        std::vector<Product> products = j.contains("products") ? j["products"] : j;
+        if (products.empty()) {
+            LOG_ERROR("no products in {}", path);
+            return false;
+        }
+        load(std::move(products));
+        return true;
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("failed to load product snapshot {}: {}", path, e.what());
+    }
+    return false;
+}
+
+std::shared_future<bool> ProductCatalog::loadAsync() {
+    return loadAsync(baseUrl());
+}
+
+std::shared_future<bool> ProductCatalog::loadAsync(std::string base_url) {
+    std::lock_guard lock(mutex_);
+    if (loading_.valid()) {
+        return loading_;
+    }
+    if (loaded()) {
+        std::promise<bool> done;
+        done.set_value(true);
+        return loading_ = done.get_future().share();
+    }
+    base_url_ = base_url;
+    auto done = std::make_shared<std::promise<bool>>();
+    loading_ = done->get_future().share();
+    if (loader_.joinable()) {
+        // a failed load; the thread released the lock for the last time when it reset loading_
+        loader_.join();
+    }
+    loader_ = std::thread([this, done, base_url = std::move(base_url)]() {
+        CoinbaseRestClient client(base_url, ConnectionPoolConfig{.size = 0});
+        auto products = client.list_public_products();
+        if (products.empty()) {
+            LOG_ERROR("failed to load products from {}", base_url);
+            {
+                std::lock_guard lock(mutex_);
+                loading_ = {};  // a later loadAsync() retries
+            }
+            done->set_value(false);
+            return;
+        }
+        load(std::move(products));
+        if (auto path = snapshotPath(); !path.empty()) {
+            saveSnapshot(path);
+        }
+        done->set_value(true);
+    });
+    return loading_;
+}
+
+bool ProductCatalog::saveSnapshot(const std::string &path) const {
+    auto map = snapshot();
+    std::vector<SnapshotRecord> records;
+    records.reserve(map->product_count);
+    std::string strings;
+    auto add_string = [&strings](std::string_view str) {
+        SnapshotString ref{static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(str.size())};
+        strings.append(str);
+        return ref;
+    };
+    for (const auto *prod : map->products) {
+        if (!prod) {
+            continue;
+        }
+        SnapshotRecord r{};
+        r.product_id = add_string(prod->product_id);
+        r.base_currency_id = add_string(prod->base_currency_id);
+        r.quote_currency_id = add_string(prod->quote_currency_id);
+        r.display_name = add_string(prod->display_name);
+        r.status = add_string(prod->status);
+        r.product_venue = add_string(prod->product_venue);
+        r.alias = add_string(prod->alias);
+        r.contract_expiry_type = add_string(prod->future_product_details.contract_expiry_type);
+        r.price_increment = prod->price_increment;
+        r.base_increment = prod->base_increment;
+        r.base_min_size = prod->base_min_size;
+        r.base_max_size = prod->base_max_size;
+        r.quote_increment = prod->quote_increment;
+        r.quote_min_size = prod->quote_min_size;
+        r.quote_max_size = prod->quote_max_size;
+        r.contract_size = prod->future_product_details.contract_size;
+        r.contract_expiry = prod->future_product_details.contract_expiry;
+        r.product_type = prod->product_type;
+        r.flags = (prod->is_disabled ? SnapshotRecord::IS_DISABLED : 0)
+            | (prod->cancel_only ? SnapshotRecord::CANCEL_ONLY : 0)
+            | (prod->limit_only ? SnapshotRecord::LIMIT_ONLY : 0)
+            | (prod->post_only ? SnapshotRecord::POST_ONLY : 0)
+            | (prod->trading_disabled ? SnapshotRecord::TRADING_DISABLED : 0)
+            | (prod->auction_mode ? SnapshotRecord::AUCTION_MODE : 0)
+            | (prod->view_only ? SnapshotRecord::VIEW_ONLY : 0);
+        records.push_back(r);
+    }
+
+    SnapshotHeader header{};
+    header.magic = SnapshotHeader::MAGIC;
+    header.version = SnapshotHeader::VERSION;
+    header.record_size = sizeof(SnapshotRecord);
+    header.count = static_cast<uint32_t>(records.size());
+    header.strings_size = static_cast<uint32_t>(strings.size());
+    header.saved_at = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+
+    auto tmp_path = path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(SnapshotRecord)));
+        file.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+        if (!file) {
+            LOG_ERROR("failed to write product snapshot {}", tmp_path);
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+    if (ec) {
+        LOG_ERROR("failed to replace product snapshot {}: {}", path, ec.message());
+        std::filesystem::remove(tmp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+bool ProductCatalog::loadSnapshot(const std::string &path) {
+    MappedFile file(path);
+    if (!file.data()) {
+        return false;
+    }
+    if (file.size() < sizeof(SnapshotHeader)) {
+        LOG_ERROR("product snapshot {} is truncated", path);
+        return false;
+    }
+    SnapshotHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (header.magic != SnapshotHeader::MAGIC || header.version != SnapshotHeader::VERSION || header.record_size != sizeof(SnapshotRecord)) {
+        LOG_ERROR("{} is not a product snapshot of this version", path);
+        return false;
+    }
+    auto records_size = static_cast<std::size_t>(header.count) * sizeof(SnapshotRecord);
+    if (file.size() < sizeof(SnapshotHeader) + records_size + header.strings_size) {
+        LOG_ERROR("product snapshot {} is truncated", path);
+        return false;
+    }
+
+    const char *records = file.data() + sizeof(SnapshotHeader);
+    std::string_view strings(records + records_size, header.strings_size);
+    bool valid = true;
+    auto get_string = [&strings, &valid](SnapshotString ref) {
+        if (ref.offset > strings.size() || ref.size > strings.size() - ref.offset) {
+            valid = false;
+            return std::string();
+        }
+        return std::string(strings.substr(ref.offset, ref.size));
+    };
+
+    std::vector<Product> products(header.count);
+    for (uint32_t i = 0; i < header.count; ++i) {
+        SnapshotRecord r;
+        std::memcpy(&r, records + i * sizeof(SnapshotRecord), sizeof(r));
+        auto &prod = products[i];
+        prod.product_id = get_string(r.product_id);
+        prod.base_currency_id = get_string(r.base_currency_id);
+        prod.quote_currency_id = get_string(r.quote_currency_id);
+        prod.display_name = get_string(r.display_name);
+        prod.status = get_string(r.status);
+        prod.product_venue = get_string(r.product_venue);
+        prod.alias = get_string(r.alias);
+        prod.future_product_details.contract_expiry_type = get_string(r.contract_expiry_type);
+        prod.price_increment = r.price_increment;
+        prod.base_increment = r.base_increment;
+        prod.base_min_size = r.base_min_size;
+        prod.base_max_size = r.base_max_size;
+        prod.quote_increment = r.quote_increment;
+        prod.quote_min_size = r.quote_min_size;
+        prod.quote_max_size = r.quote_max_size;
+        prod.future_product_details.contract_size = r.contract_size;
+        prod.future_product_details.contract_expiry = r.contract_expiry;
+        prod.product_type = r.product_type;
+        prod.is_disabled = r.flags & SnapshotRecord::IS_DISABLED;
+        prod.cancel_only = r.flags & SnapshotRecord::CANCEL_ONLY;
+        prod.limit_only = r.flags & SnapshotRecord::LIMIT_ONLY;
+        prod.post_only = r.flags & SnapshotRecord::POST_ONLY;
+        prod.trading_disabled = r.flags & SnapshotRecord::TRADING_DISABLED;
+        prod.auction_mode = r.flags & SnapshotRecord::AUCTION_MODE;
+        prod.view_only = r.flags & SnapshotRecord::VIEW_ONLY;
+    }
+    if (!valid) {
+        LOG_ERROR("product snapshot {} is corrupt", path);
+        return false;
+    }
+    // whatever the catalog already has is at least as fresh as the file
+    merge(std::move(products), true);
+    return true;
+}
+
+bool ProductCatalog::useSnapshot(std::string path) {
+    std::error_code ec;
+    bool loaded = std::filesystem::exists(path, ec) && loadSnapshot(path);
+    std::lock_guard lock(mutex_);
+    snapshot_path_ = std::move(path);
+    return loaded;
+}
+
+std::string ProductCatalog::snapshotPath() const {
+    std::lock_guard lock(mutex_);
+    return snapshot_path_;
+}
+
+void ProductCatalog::update(const std::vector<Status> &status) {
+    std::lock_guard lock(mutex_);
+    std::shared_ptr<Map> map;
+    for (const auto &s : status) {
+        if (s.id.empty()) {
+            continue;
+        }
+        Product prod;
+        if (auto *existing = find(s.id)) {
+            if (existing->status == s.status && existing->base_increment == s.base_increment
+                && existing->quote_increment == s.quote_increment
+                && (!(s.min_market_funds > 0.) || existing->quote_min_size == s.min_market_funds)) {
+                continue;
+            }
+            prod = *existing;
+        }
+        else {
+            prod = Product{};
+            prod.product_id = s.id;
+            prod.base_currency_id = s.base_currency;
+            prod.quote_currency_id = s.quote_currency;
+            prod.display_name = s.display_name;
+            prod.product_type = s.product_type;
+        }
+        prod.status = s.status;
+        prod.base_increment = s.base_increment;
+        prod.quote_increment = s.quote_increment;
+        if (s.min_market_funds > 0.) {
+            prod.quote_min_size = s.min_market_funds;
+        }
+        if (!map) {
+            map = std::make_shared<Map>(*snapshot());
+        }
+        store(std::move(prod), *map);
+    }
+    if (map) {
+        publish(std::move(map));
+    }
+}
+
+}   // end namespace coinbase
@@ -4,23 +4,66 @@
 
 #include <coinbase/rest.hpp>
 #include <coinbase/auth.hpp>
+#include <coinbase/jwt_token_cache.hpp>
+#include <coinbase/order_request.hpp>
+#include <coinbase/product_catalog.hpp>
 #include <coinbase/utils.hpp>
 #include <nlohmann/json.hpp>
-#include <slick/net/http.hpp>
+#include <slick/net/logging.hpp>
 #include <format>
 #include <numeric>
 #include <algorithm>
 
 using json = nlohmann::json;
-using Http = slick::net::Http;
 
 namespace coinbase {
 
-std::once_flag CoinbaseRestClient::initialize_products_;
-std::unordered_map<std::string, Product> CoinbaseRestClient::products_;
+namespace {
 
-CoinbaseRestClient::CoinbaseRestClient(std::string base_url)
+std::string bearer(const std::string &uri) {
+    return "Bearer " + coinbase::generate_coinbase_jwt(uri.c_str());
+}
+
+}   // end anonymous namespace
+
+// Pre-signed tokens for the order entry endpoints of one domain. Created on
+// the first order entry call, so clients that never trade (such as the ones
+// ProductCatalog uses to fetch products) neither sign nor start the refresh
+// thread.
+struct CoinbaseRestClient::OrderTokens {
+    explicit OrderTokens(std::string domain) : domain(std::move(domain)) {}
+
+    // nullptr without credentials or if signing failed
+    const JwtTokenCache* get() {
+        std::call_once(once, [this] {
+            const auto &signer = JwtSigner::instance();
+            if (!signer.isValid()) {
+                return;
+            }
+            auto tokens = std::make_unique<JwtTokenCache>(signer);
+            try {
+                tokens->add(std::format("POST {}/api/v3/brokerage/orders", domain));
+                tokens->add(std::format("POST {}/api/v3/brokerage/orders/edit", domain));
+                tokens->add(std::format("POST {}/api/v3/brokerage/orders/batch_cancel", domain));
+            }
+            catch (const std::exception &e) {
+                LOG_ERROR("failed to pre-sign order tokens: {}", e.what());
+                return;
+            }
+            cache = std::move(tokens);
+        });
+        return cache.get();
+    }
+
+    std::string domain;
+    std::once_flag once;
+    std::unique_ptr<JwtTokenCache> cache;
+};
+
+CoinbaseRestClient::CoinbaseRestClient(std::string base_url, ConnectionPoolConfig pool_config)
     : base_url_(std::move(base_url))
+    , pool_config_(pool_config)
+    , pool_(std::make_shared<HttpsConnectionPool>(base_url_, pool_config_))
 {
     auto pos = base_url_.find("://");
     if (pos == std::string::npos) {
@@ -29,20 +72,18 @@ CoinbaseRestClient::CoinbaseRestClient(std::string base_url)
     else {
         domain_ = base_url_.substr(pos + 3);
     }
-    std::call_once(initialize_products_, [this](){
-        auto product_list = list_public_products();
-        for (auto &prod : product_list) {
-            products_.emplace(prod.product_id, std::move(prod));
-        }
-    });
+    order_tokens_ = std::make_shared<OrderTokens>(domain_);
+    // products are needed to format order prices; load them without blocking the constructor
+    ProductCatalog::instance().loadAsync(base_url_);
 }
 
 const Product& CoinbaseRestClient::product(std::string_view product_id) {
-    return products_[std::string(product_id)];
+    return ProductCatalog::instance().get(product_id);
 }
 
 void CoinbaseRestClient::set_base_url(std::string_view url) {
     base_url_ = std::string(url);
+    pool_ = std::make_shared<HttpsConnectionPool>(base_url_, pool_config_);
     auto pos = base_url_.find("://");
     if (pos == std::string::npos) {
         domain_ = base_url_;
@@ -50,11 +91,21 @@ void CoinbaseRestClient::set_base_url(std::string_view url) {
     else {
         domain_ = base_url_.substr(pos + 3);
     }
+    order_tokens_ = std::make_shared<OrderTokens>(domain_);
+}
+
+void CoinbaseRestClient::presign_order_tokens() const {
+    order_tokens_->get();
+}
+
+std::string CoinbaseRestClient::order_authorization(const std::string &uri) const {
+    auto *tokens = order_tokens_->get();
+    return tokens ? tokens->authorization(uri) : bearer(uri);
 }
 
 uint64_t CoinbaseRestClient::get_server_time() const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/time", base_url_));
+        auto res = pool_->get("/api/v3/brokerage/time");
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return std::stoull(j["epochMillis"].get<std::string_view>().data());
@@ -69,18 +120,14 @@ uint64_t CoinbaseRestClient::get_server_time() const {
 
 std::vector<Account> CoinbaseRestClient::list_accounts(const AccountQueryParams &params) const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/accounts{}", base_url_, params()), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/accounts", domain_).c_str())}
-        });
+        auto res = pool_->get(std::format("/api/v3/brokerage/accounts{}", params()), bearer(std::format("GET {}/api/v3/brokerage/accounts", domain_)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             std::vector<Account> accounts = j["accounts"];
             while (j.contains("has_next") && j["has_next"].get<bool>() && !j["cursor"].get<std::string_view>().empty()) {
                 AccountQueryParams new_params = params;
                 new_params.cursor = j["cursor"].get<std::string_view>();
-                res = Http::get(std::format("{}/api/v3/brokerage/accounts{}", base_url_, new_params()), {
-                    {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/accounts", domain_).c_str())}
-                });
+                res = pool_->get(std::format("/api/v3/brokerage/accounts{}", new_params()), bearer(std::format("GET {}/api/v3/brokerage/accounts", domain_)));
                 if (res.is_ok()) {
                     j = json::parse(res.result_text);
                     accounts.insert(accounts.end(), std::make_move_iterator(j["accounts"].begin()), std::make_move_iterator(j["accounts"].end()));
@@ -102,9 +149,7 @@ std::vector<Account> CoinbaseRestClient::list_accounts(const AccountQueryParams
 
 Account CoinbaseRestClient::get_account(std::string_view account_uuid) const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/accounts/{}", base_url_, account_uuid), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/accounts/{}", domain_, account_uuid).c_str())}
-        });
+        auto res = pool_->get(std::format("/api/v3/brokerage/accounts/{}", account_uuid), bearer(std::format("GET {}/api/v3/brokerage/accounts/{}", domain_, account_uuid)));
         if (res.is_ok()) {
             auto j_res = json::parse(res.result_text);
             return j_res["account"].get<Account>();
@@ -119,9 +164,7 @@ Account CoinbaseRestClient::get_account(std::string_view account_uuid) const {
 
 std::vector<Product> CoinbaseRestClient::list_products(const ProductQueryParams &params) const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/products{}", base_url_, params()), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/products", domain_).c_str())}
-        });
+        auto res = pool_->get(std::format("/api/v3/brokerage/products{}", params()), bearer(std::format("GET {}/api/v3/brokerage/products", domain_)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j["products"];
@@ -136,9 +179,7 @@ std::vector<Product> CoinbaseRestClient::list_products(const ProductQueryParams
 
 Product CoinbaseRestClient::get_product(std::string_view prod_id, bool get_tradability_status) const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/products/{}{}", base_url_, prod_id, get_tradability_status ? "?get_tradability_status=true" : ""), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/products/{}", domain_, prod_id).c_str())}
-        });
+        auto res = pool_->get(std::format("/api/v3/brokerage/products/{}{}", prod_id, get_tradability_status ? "?get_tradability_status=true" : ""), bearer(std::format("GET {}/api/v3/brokerage/products/{}", domain_, prod_id)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j.get<Product>();
@@ -153,7 +194,7 @@ Product CoinbaseRestClient::get_product(std::string_view prod_id, bool get_trada
 
 std::vector<Product> CoinbaseRestClient::list_public_products(const ProductQueryParams &params) const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/market/products{}", base_url_, params()));
+        auto res = pool_->get(std::format("/api/v3/brokerage/market/products{}", params()));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j["products"];
@@ -168,7 +209,7 @@ std::vector<Product> CoinbaseRestClient::list_public_products(const ProductQuery
 
 Product CoinbaseRestClient::get_public_product(std::string_view prod_id) const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/market/products/{}", base_url_, prod_id));
+        auto res = pool_->get(std::format("/api/v3/brokerage/market/products/{}", prod_id));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j.get<Product>();
@@ -183,18 +224,14 @@ Product CoinbaseRestClient::get_public_product(std::string_view prod_id) const {
 
 std::vector<Order> CoinbaseRestClient::list_orders(const OrderQueryParams &query) const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/orders/historical/batch{}", base_url_, query()), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/orders/historical/batch", domain_).c_str())}
-        });
+        auto res = pool_->get(std::format("/api/v3/brokerage/orders/historical/batch{}", query()), bearer(std::format("GET {}/api/v3/brokerage/orders/historical/batch", domain_)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             std::vector<Order> orders = j["orders"];
             while (j.contains("has_next") && j["has_next"].get<bool>() && !j["cursor"].get<std::string_view>().empty()) {
                 OrderQueryParams new_query = query;
                 new_query.cursor = j["cursor"].get<std::string_view>();
-                res = Http::get(std::format("{}/api/v3/brokerage/orders/historical/batch{}", base_url_, new_query()), {
-                    {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/orders/historical/batch", domain_).c_str())}
-                });
+                res = pool_->get(std::format("/api/v3/brokerage/orders/historical/batch{}", new_query()), bearer(std::format("GET {}/api/v3/brokerage/orders/historical/batch", domain_)));
                 if (res.is_ok()) {
                     j = json::parse(res.result_text);
                     orders.insert(orders.end(), std::make_move_iterator(j["orders"].begin()), std::make_move_iterator(j["orders"].end()));
@@ -216,9 +253,7 @@ std::vector<Order> CoinbaseRestClient::list_orders(const OrderQueryParams &query
 
 Order CoinbaseRestClient::get_order(std::string_view order_id) const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/orders/historical/{}", base_url_, order_id), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/orders/historical/{}", domain_, order_id).c_str())}
-        });
+        auto res = pool_->get(std::format("/api/v3/brokerage/orders/historical/{}", order_id), bearer(std::format("GET {}/api/v3/brokerage/orders/historical/{}", domain_, order_id)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             LOG_TRACE(j.dump().c_str());
@@ -234,18 +269,14 @@ Order CoinbaseRestClient::get_order(std::string_view order_id) const {
 
 std::vector<Fill> CoinbaseRestClient::list_fills(const FillQueryParams &params) const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/orders/historical/fills{}", base_url_, params()), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/orders/historical/fills", domain_).c_str())}
-        });
+        auto res = pool_->get(std::format("/api/v3/brokerage/orders/historical/fills{}", params()), bearer(std::format("GET {}/api/v3/brokerage/orders/historical/fills", domain_)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             std::vector<Fill> fills = j["fills"];
             while(j.contains("cursor") && !j["cursor"].get<std::string_view>().empty()) {
                 FillQueryParams new_query = params;
                 new_query.cursor = j["cursor"].get<std::string_view>();
-                res = Http::get(std::format("{}/api/v3/brokerage/orders/historical/fills{}", base_url_, new_query()), {
-                    {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/orders/historical/fills", domain_).c_str())}
-                });
+                res = pool_->get(std::format("/api/v3/brokerage/orders/historical/fills{}", new_query()), bearer(std::format("GET {}/api/v3/brokerage/orders/historical/fills", domain_)));
                 if (res.is_ok()) {
                     j = json::parse(res.result_text);
                     fills.insert(fills.end(), std::make_move_iterator(j["fills"].begin()), std::make_move_iterator(j["fills"].end()));
@@ -267,9 +298,7 @@ std::vector<Fill> CoinbaseRestClient::list_fills(const FillQueryParams &params)
 
 double CoinbaseRestClient::get_taker_fee_rate() const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/transaction_summary", base_url_), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/transaction_summary", domain_).c_str())}
-        });
+        auto res = pool_->get("/api/v3/brokerage/transaction_summary", bearer(std::format("GET {}/api/v3/brokerage/transaction_summary", domain_)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return atof(j["fee_tier"]["taker_fee_rate"].get<std::string>().c_str());
@@ -284,9 +313,7 @@ double CoinbaseRestClient::get_taker_fee_rate() const {
 
 double CoinbaseRestClient::get_maker_fee_rate() const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/transaction_summary", base_url_), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/transaction_summary", domain_).c_str())}
-        });
+        auto res = pool_->get("/api/v3/brokerage/transaction_summary", bearer(std::format("GET {}/api/v3/brokerage/transaction_summary", domain_)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return atof(j["fee_tier"]["maker_fee_rate"].get<std::string>().c_str());
@@ -314,9 +341,7 @@ std::vector<PriceBook> CoinbaseRestClient::get_best_bid_ask(const std::vector<st
             [](const std::string& a, const std::string &b) {
                 return a + "&" + b;
             }));
-        auto res = Http::get(std::format("{}/api/v3/brokerage/best_bid_ask{}", base_url_, query), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/best_bid_ask", domain_).c_str())}
-        });
+        auto res = pool_->get(std::format("/api/v3/brokerage/best_bid_ask{}", query), bearer(std::format("GET {}/api/v3/brokerage/best_bid_ask", domain_)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             LOG_TRACE(j.dump().c_str());
@@ -332,9 +357,7 @@ std::vector<PriceBook> CoinbaseRestClient::get_best_bid_ask(const std::vector<st
 
 PriceBookResponse CoinbaseRestClient::get_product_book(const PriceBookQueryParams &params) const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/product_book{}", base_url_, params()), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/product_book", domain_).c_str())}
-        });
+        auto res = pool_->get(std::format("/api/v3/brokerage/product_book{}", params()), bearer(std::format("GET {}/api/v3/brokerage/product_book", domain_)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j;
@@ -349,9 +372,7 @@ PriceBookResponse CoinbaseRestClient::get_product_book(const PriceBookQueryParam
 
 MarketTrades CoinbaseRestClient::get_market_trades(std::string_view product_id, const MarketTradesQueryParams &params) const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/products/{}/ticker{}", base_url_, product_id, params()), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/products/{}/ticker", domain_, product_id).c_str())}
-        });
+        auto res = pool_->get(std::format("/api/v3/brokerage/products/{}/ticker{}", product_id, params()), bearer(std::format("GET {}/api/v3/brokerage/products/{}/ticker", domain_, product_id)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j;
@@ -368,9 +389,7 @@ std::vector<Candle> CoinbaseRestClient::get_product_candles(std::string_view pro
 {
     try {
         LOG_TRACE(params().c_str());
-        auto res = Http::get(std::format("{}/api/v3/brokerage/products/{}/candles{}", base_url_, product_id, params()), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/products/{}/candles", domain_, product_id).c_str())}
-        });
+        auto res = pool_->get(std::format("/api/v3/brokerage/products/{}/candles{}", product_id, params()), bearer(std::format("GET {}/api/v3/brokerage/products/{}/candles", domain_, product_id)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j["candles"];
@@ -405,283 +424,58 @@ CreateOrderResponse CoinbaseRestClient::create_order(
 ) const {
     CreateOrderResponse rsp;
     try {
-        json body {
-            {"client_order_id", client_order_id},
-            {"product_id", product_id},
-            {"side", to_string(side)},
-            {"order_configuration", {}}
-        };
-        auto &order_configuration = body["order_configuration"];
-        switch (order_type) {
-            case OrderType::MARKET: {
-                if (!std::isnan(limit_price)) {
-                    LOG_WARN("limit price ignored. Limit price should not be set for market order");
-                }
-                if (time_in_force == TimeInForce::FILL_OR_KILL) {
-                    auto &config = order_configuration["market_market_fok"];
-                    if (size_in_quote) {
-                        config["quote_size"] = std::to_string(size);
-                    }
-                    else {
-                        config["base_size"] = std::to_string(size);
-                    }
-                }
-                else if (time_in_force == TimeInForce::IMMEDIATE_OR_CANCEL) {
-                    auto &config = order_configuration["market_market_ioc"];
-                    if (size_in_quote) {
-                        config["quote_size"] = std::to_string(size);
-                    }
-                    else {
-                        config["base_size"] = std::to_string(size);
-                    }
-                }
-                else {
-                    rsp.error_response.message = std::format("TimeInForce {} invalid for market order", to_string(time_in_force));
-                    rsp.success = false;
-                    LOG_ERROR(rsp.error_response.message.c_str());
-                    return rsp;
-                }
-
-                if (stop_price.has_value() && take_profit_price.has_value()) {
-                    auto &prod = product(product_id);
-                    if (prod.product_type == ProductType::SPOT && side == Side::SELL) {
-                        LOG_ERROR("Invalid order side for attached TP/SL");
-                        rsp.error_response.message = "Invalid order side for attached TP/SL";
-                        rsp.success = false;
-                        return rsp;
-                    }
-                    body["attached_order_configuration"] = {
-                        {"trigger_bracket_gtc", {
-                            {"limit_price", to_string(take_profit_price.value(), prod.quote_increment)},
-                            {"stop_trigger_price", to_string(stop_price.value(), prod.quote_increment)},
-                        }}
-                    };
-                }
-                else if (stop_price.has_value()) {
-                    if (side == Side::SELL) {
-
-                    }
-                    LOG_ERROR("braket order must have both stop_price and take_profit_price");
-                    rsp.error_response.message = "braket order must have both stop_price and take_profit_price";
-                    rsp.success = false;
-                    return rsp;
-                }
-                else {
-
-                }
-                break;
-            }
-            case OrderType::LIMIT: {
-                if (std::isnan(limit_price)) {
-                    LOG_ERROR("Invalid limit price NAN");
-                    rsp.error_response.message = "Invalid limit price NAN";
-                    rsp.success = false;
-                    return rsp;
-                }
-                if (time_in_force == TimeInForce::FILL_OR_KILL) {
-                    auto &config = order_configuration["limit_limit_fok"];
-                    if (size_in_quote) {
-                        config["quote_size"] = std::to_string(size);
-                    }
-                    else {
-                        config["base_size"] = std::to_string(size);
-                    }
-                    config["limit_price"] = to_string(limit_price, product(product_id).quote_increment);
-                }
-                else if (time_in_force == TimeInForce::IMMEDIATE_OR_CANCEL) {
-                    auto &config = order_configuration["sor_limit_ioc"];
-                    if (size_in_quote) {
-                        config["quote_size"] = std::to_string(size);
-                    }
-                    else {
-                        config["base_size"] = std::to_string(size);
-                    }
-                    config["limit_price"] = to_string(limit_price, product(product_id).quote_increment);
-                }
-                else if (time_in_force == TimeInForce::GOOD_UNTIL_CANCELLED) {
-                    auto &config = order_configuration["limit_limit_gtc"];
-                    if (size_in_quote) {
-                        config["quote_size"] = std::to_string(size);
-                    }
-                    else {
-                        config["base_size"] = std::to_string(size);
-                    }
-                    config["limit_price"] = to_string(limit_price, product(product_id).quote_increment);
-                    config["post_only"] = post_only;
-                }
-                else if (time_in_force == TimeInForce::GOOD_UNTIL_DATE_TIME) {
-                    if (!end_time.has_value()) {
-                        LOG_ERROR("end_time missing for limit_gtd order");
-                        rsp.error_response.message = "end_time missing for limit_gtd order";
-                        rsp.success = false;
-                        return rsp;
-                    }
-                    auto &config = order_configuration["limit_limit_gtd"];
-                    if (size_in_quote) {
-                        config["quote_size"] = std::to_string(size);
-                    }
-                    else {
-                        config["base_size"] = std::to_string(size);
-                    }
-                    config["limit_price"] = to_string(limit_price, product(product_id).quote_increment);
-                    config["post_only"] = post_only;
-                    config["end_time"] = timestamp_to_string(end_time.value());
-                }
-                else {
-                    rsp.error_response.message = std::format("TimeInForce {} invalid for market order", to_string(time_in_force));
-                    rsp.success = false;
-                    LOG_ERROR(rsp.error_response.message.c_str());
-                    return rsp;
-                }
-
-                if (stop_price.has_value() && take_profit_price.has_value()) {
-                    auto &prod = product(product_id);
-                    if (prod.product_type == ProductType::SPOT && side == Side::SELL) {
-                        LOG_ERROR("Invalid order side for attached TP/SL");
-                        rsp.error_response.message = "Invalid order side for attached TP/SL";
-                        rsp.success = false;
-                        return rsp;
-                    }
-                    body["attached_order_configuration"] = {
-                        {"trigger_bracket_gtc", {
-                            {"limit_price", to_string(take_profit_price.value(), prod.quote_increment)},
-                            {"stop_trigger_price", to_string(stop_price.value(), prod.quote_increment)},
-                        }}
-                    };
-                }
-                else if (stop_price.has_value() ^ take_profit_price.has_value()) {
-                    LOG_ERROR("braket order must have both stop_price and take_profit_price");
-                    rsp.error_response.message = "braket order must have both stop_price and take_profit_price";
-                    rsp.success = false;
-                    return rsp;
-                }
-                break;
-            }
-            case OrderType::STOP_LIMIT: {
-                if (size_in_quote) {
-                    LOG_ERROR("Invalid parameter. stop limit order size only in base_size");
-                    rsp.error_response.message = "Invalid parameter. stop limit order size only in base_size";
-                    rsp.success = false;
-                    return rsp;
-                }
-                if (!stop_price.has_value() || std::isnan(stop_price.value())) {
-                    LOG_ERROR("Invalid stop_price {}", stop_price.value_or(NAN));
-                    rsp.error_response.message = std::format("Invalid stop_price {}", stop_price.value_or(NAN));
-                    rsp.success = false;
-                    return rsp;
-                }
-                if (time_in_force == TimeInForce::GOOD_UNTIL_CANCELLED) {
-                    auto &config = order_configuration["stop_limit_stop_limit_gtc"];
-                    config["base_size"] = std::to_string(size);
-                    config["limit_price"] = to_string(limit_price, product(product_id).quote_increment);
-                    config["stop_price"] = to_string(stop_price.value(), product(product_id).quote_increment);
-                }
-                else if (time_in_force == TimeInForce::GOOD_UNTIL_DATE_TIME) {
-                    if (!end_time.has_value())
-                    {
-                        LOG_ERROR("end_time missing for limit_gtd order");
-                        rsp.error_response.message = "end_time missing for limit_gtd order";
-                        rsp.success = false;
-                        return rsp;
-                    }
-                    auto &config = order_configuration["stop_limit_stop_limit_gtd"];
-                    config["base_size"] = std::to_string(size);
-                    config["limit_price"] = to_string(limit_price, product(product_id).quote_increment);
-                    config["end_time"] = timestamp_to_string(end_time.value());
-                }
-                else {
-                    rsp.error_response.message = std::format("TimeInForce {} invalid for market order", to_string(time_in_force));
-                    rsp.success = false;
-                    LOG_ERROR(rsp.error_response.message.c_str());
-                    return rsp;
-                }
-                break;
-            }
-            case OrderType::TWAP: {
-                if (!twap_start_time.has_value() || !end_time.has_value()) {
-                    LOG_ERROR("twap order must have start and end time");
-                    rsp.error_response.message = "twap order must have start and end time";
-                    rsp.success = false;
-                    return rsp;
-                }
+        thread_local OrderRequestWriter writer;
+        if (!writer.writeCreateOrder(rsp, client_order_id, product_id, side, order_type, time_in_force, size, limit_price, post_only, size_in_quote,
+                stop_price, take_profit_price, end_time, twap_start_time, sor_preference, leverage, margin_type,
+                attached_order_configuration, std::move(prediction_metadata))) {
+            return rsp;
+        }
 
-                auto &config = order_configuration["twap_limit_gtd"];
-                if (size_in_quote) {
-                    config["quote_size"] = std::to_string(size);
-                }
-                else {
-                    config["base_size"] = std::to_string(size);
-                }
-                config["limit_price"] = to_string(limit_price, product(product_id).quote_increment);
-                config["start_time"] = timestamp_to_string(twap_start_time.value());
-                config["end_time"] = timestamp_to_string(end_time.value());
-                break;
-            }
-            case OrderType::BRACKET: {
-                auto &prod = product(product_id);
-                if (prod.product_type == ProductType::SPOT && side == Side::BUY) {
-                    LOG_ERROR("Invalid order side for Bracket order");
-                    rsp.error_response.message = "Invalid order side for Bracket order";
-                    rsp.success = false;
-                    return rsp;
-                }
+        LOG_TRACE("create order: {}", writer.body());
+        auto res = pool_->post("/api/v3/brokerage/orders", writer.body(), order_authorization(std::format("POST {}/api/v3/brokerage/orders", domain_)));
 
-                if (size_in_quote) {
-                    LOG_ERROR("Invalid parameter. Bracket order size only in base_size");
-                    rsp.error_response.message = "Invalid parameter. Bracket order size only in base_size";
-                    rsp.success = false;
-                    return rsp;
-                }
-
-                if (stop_price.has_value() && take_profit_price.has_value()) {
-                    order_configuration["trigger_bracket_gtc"] = {
-                        {"base_size", std::to_string(size)},
-                        {"limit_price", to_string(take_profit_price.value(), prod.quote_increment)},
-                        {"stop_trigger_price", to_string(stop_price.value(), prod.quote_increment)},
-                    };
-                }
-                else if (stop_price.has_value() && !std::isnan(limit_price)) {
-                    // use limit_price as take_profit_price for stop loss only bracket order
-                    order_configuration["trigger_bracket_gtc"] = {
-                        {"base_size", std::to_string(size)},
-                        {"limit_price", to_string(limit_price, prod.quote_increment)},
-                        {"stop_trigger_price", to_string(stop_price.value(), prod.quote_increment)},
-                    };
-                }
-                else {
-                    LOG_ERROR("braket order must have both stop_price and take_profit_price");
-                    rsp.error_response.message = "braket order must have both stop_price and take_profit_price";
-                    rsp.success = false;
-                    return rsp;
-                }
-                break;
-            }
-            default: {
-                rsp.error_response.message = std::format("OrderType {} is not supported. client_order_id: {}", to_string(order_type), client_order_id);
-                LOG_ERROR(rsp.error_response.message.c_str());
-                rsp.success = false;
-                return rsp;
-            }
-        }
-        if (leverage.has_value()) {
-            body["leverage"] = std::to_string(leverage.value());
-        }
-        if (margin_type.has_value()) {
-            body["margin_type"] = to_string(margin_type.value());
-        }
-        if (attached_order_configuration.has_value()) {
-            body["attached_order_configuration"] = attached_order_configuration.value();
+        rsp.success = res.is_ok();
+        if (!res.result_text.empty()) {
+            auto j = json::parse(res.result_text);
+            LOG_TRACE(j.dump().c_str());
+            return j;
         }
-        body["sor_preference"] = to_string(sor_preference.value_or(SorPreference::SOR_ENABLED));
-        if (prediction_metadata.has_value()) {
-            to_json(body["prediction_metadata"], prediction_metadata.value());
+        rsp.error_response.message = std::format("Failed to create order. client_order_id: {} error: {}", client_order_id, res.result_text);
+        LOG_ERROR(rsp.error_response.message.c_str());
+    }
+    catch (const std::exception &e) {
+        rsp.error_response.message = std::format("Failed to create order. client_order_id: {}  error: {}", client_order_id, e.what());
+        LOG_ERROR(rsp.error_response.message.c_str());
+    }
+    rsp.success = false;
+    return rsp;
+}
+
+CreateOrderResponse CoinbaseRestClient::create_order(const OrderTemplate &order_template, std::string_view client_order_id, double size, double limit_price) const {
+    CreateOrderResponse rsp;
+    if (!order_template.isValid()) {
+        rsp.error_response.message = std::format("Invalid order template. client_order_id: {} error: {}", client_order_id, order_template.error());
+        LOG_ERROR(rsp.error_response.message.c_str());
+        rsp.success = false;
+        return rsp;
+    }
+    if (order_template.usesLimitPrice() && std::isnan(limit_price)) {
+        LOG_ERROR("Invalid limit price NAN");
+        rsp.error_response.message = "Invalid limit price NAN";
+        rsp.success = false;
+        return rsp;
+    }
+    try {
+        thread_local std::string body;
+        if (!order_template.write(body, client_order_id, size, limit_price)) {
+            rsp.error_response.message = std::format("Invalid size {} or limit price {}. client_order_id: {}", size, limit_price, client_order_id);
+            LOG_ERROR(rsp.error_response.message.c_str());
+            rsp.success = false;
+            return rsp;
         }
 
-        LOG_TRACE("create order: {}", body.dump());
-        auto res = Http::post(std::format("{}/api/v3/brokerage/orders", base_url_), body.dump(), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("POST {}/api/v3/brokerage/orders", domain_).c_str())},
-            {"Content-Type", "application/json"}
-        });
+        LOG_TRACE("create order: {}", body);
+        auto res = pool_->post("/api/v3/brokerage/orders", body, order_authorization(std::format("POST {}/api/v3/brokerage/orders", domain_)));
 
         rsp.success = res.is_ok();
         if (!res.result_text.empty()) {
@@ -711,32 +505,9 @@ ModifyOrderResponse CoinbaseRestClient::modify_order(
 ) const {
     ModifyOrderResponse rsp;
     try {
-        json body {
-            {"order_id", order_id},
-            {"size", std::to_string(size)},
-        };
-        body["price"] = to_string(price, product(product_id).quote_increment);
-        if (stop_price.has_value() && take_profit_price.has_value()) {
-            auto &prod = product(product_id);
-            body["attached_order_configuration"] = {
-                {"trigger_bracket_gtc", {
-                    {"limit_price", to_string(take_profit_price.value(), prod.quote_increment)},
-                    {"stop_trigger_price", to_string(stop_price.value(), prod.quote_increment)},
-                }}
-            };
-        }
-        else if (stop_price.has_value()) {
-            body["stop_price"] = to_string(stop_price.value(), product(product_id).quote_increment);
-        }
-        if (cancel_attached_order.has_value()) {
-            body["cancel_attached_order"] = cancel_attached_order.value();
-        }
-
+        auto body = build_modify_order_body(order_id, product_id, price, size, stop_price, take_profit_price, cancel_attached_order);
         LOG_TRACE("modify order: {}", body.dump());
-        auto res = Http::post(std::format("{}/api/v3/brokerage/orders/edit", base_url_), body.dump(), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("POST {}/api/v3/brokerage/orders/edit", domain_).c_str())},
-            {"Content-Type", "application/json"}
-        });
+        auto res = pool_->post("/api/v3/brokerage/orders/edit", body.dump(), order_authorization(std::format("POST {}/api/v3/brokerage/orders/edit", domain_)));
         rsp.success = res.is_ok();
         if (!res.result_text.empty()) {
             auto j = json::parse(res.result_text);
@@ -760,10 +531,7 @@ std::vector<CancelOrderResponse> CoinbaseRestClient::cancel_orders(const std::ve
         };
 
         LOG_TRACE("cancel order: {}", body.dump());
-        auto res = Http::post(std::format("{}/api/v3/brokerage/orders/batch_cancel", base_url_), body.dump(), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("POST {}/api/v3/brokerage/orders/batch_cancel", domain_).c_str())},
-            {"Content-Type", "application/json"}
-        });
+        auto res = pool_->post("/api/v3/brokerage/orders/batch_cancel", body.dump(), order_authorization(std::format("POST {}/api/v3/brokerage/orders/batch_cancel", domain_)));
         if (!res.result_text.empty()) {
             auto j = json::parse(res.result_text);
             LOG_TRACE(j.dump().c_str());
@@ -797,9 +565,7 @@ std::vector<Portfolio> CoinbaseRestClient::list_portfolios(std::optional<Portfol
         if (portfolio_type.has_value()) {
             query = std::format("?portfolio_type={}", to_string(portfolio_type.value()));
         }
-        auto res = Http::get(std::format("{}/api/v3/brokerage/portfolios{}", base_url_, query), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/portfolios", domain_).c_str())}
-        });
+        auto res = pool_->get(std::format("/api/v3/brokerage/portfolios{}", query), bearer(std::format("GET {}/api/v3/brokerage/portfolios", domain_)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j["portfolios"];
@@ -817,10 +583,7 @@ Portfolio CoinbaseRestClient::create_portfolio(std::string_view name) const {
         json body {
             {"name", name},
         };
-        auto res = Http::post(std::format("{}/api/v3/brokerage/portfolios", base_url_), body.dump(), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("POST {}/api/v3/brokerage/portfolios", domain_).c_str())},
-            {"Content-Type", "application/json"}
-        });
+        auto res = pool_->post("/api/v3/brokerage/portfolios", body.dump(), bearer(std::format("POST {}/api/v3/brokerage/portfolios", domain_)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j["portfolio"].get<Portfolio>();
@@ -839,9 +602,7 @@ PortfolioBreakdown CoinbaseRestClient::get_portfolio_breakdown(std::string_view
         if (currency.has_value()) {
             query = std::format("?currency={}", currency.value());
         }
-        auto res = Http::get(std::format("{}/api/v3/brokerage/portfolios/{}{}", base_url_, portfolio_uuid, query), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/portfolios/{}", domain_, portfolio_uuid).c_str())}
-        });
+        auto res = pool_->get(std::format("/api/v3/brokerage/portfolios/{}{}", portfolio_uuid, query), bearer(std::format("GET {}/api/v3/brokerage/portfolios/{}", domain_, portfolio_uuid)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j["breakdown"].get<PortfolioBreakdown>();
@@ -864,10 +625,7 @@ MovePortfolioFundsResult CoinbaseRestClient::move_portfolio_funds(double value,
             {"source_portfolio_uuid", source_portfolio_uuid},
             {"target_portfolio_uuid", target_portfolio_uuid},
         };
-        auto res = Http::post(std::format("{}/api/v3/brokerage/portfolios/move_funds", base_url_), body.dump(), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("POST {}/api/v3/brokerage/portfolios/move_funds", domain_).c_str())},
-            {"Content-Type", "application/json"}
-        });
+        auto res = pool_->post("/api/v3/brokerage/portfolios/move_funds", body.dump(), bearer(std::format("POST {}/api/v3/brokerage/portfolios/move_funds", domain_)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j.get<MovePortfolioFundsResult>();
@@ -885,10 +643,7 @@ Portfolio CoinbaseRestClient::edit_portfolio(std::string_view portfolio_uuid, st
         json body {
             {"name", name},
         };
-        auto res = Http::put(std::format("{}/api/v3/brokerage/portfolios/{}", base_url_, portfolio_uuid), body.dump(), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("PUT {}/api/v3/brokerage/portfolios/{}", domain_, portfolio_uuid).c_str())},
-            {"Content-Type", "application/json"}
-        });
+        auto res = pool_->put(std::format("/api/v3/brokerage/portfolios/{}", portfolio_uuid), body.dump(), bearer(std::format("PUT {}/api/v3/brokerage/portfolios/{}", domain_, portfolio_uuid)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j["portfolio"].get<Portfolio>();
@@ -903,9 +658,7 @@ Portfolio CoinbaseRestClient::edit_portfolio(std::string_view portfolio_uuid, st
 
 bool CoinbaseRestClient::delete_portfolio(std::string_view portfolio_uuid) const {
     try {
-        auto res = Http::del(std::format("{}/api/v3/brokerage/portfolios/{}", base_url_, portfolio_uuid), "", {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("DELETE {}/api/v3/brokerage/portfolios/{}", domain_, portfolio_uuid).c_str())}
-        });
+        auto res = pool_->del(std::format("/api/v3/brokerage/portfolios/{}", portfolio_uuid), bearer(std::format("DELETE {}/api/v3/brokerage/portfolios/{}", domain_, portfolio_uuid)));
         if (res.is_ok()) {
             return true;
         }
@@ -924,10 +677,7 @@ ConvertTrade CoinbaseRestClient::create_convert_quote(std::string_view from_acco
             {"to_account", to_account},
             {"amount", std::to_string(amount)},
         };
-        auto res = Http::post(std::format("{}/api/v3/brokerage/convert/quote", base_url_), body.dump(), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("POST {}/api/v3/brokerage/convert/quote", domain_).c_str())},
-            {"Content-Type", "application/json"}
-        });
+        auto res = pool_->post("/api/v3/brokerage/convert/quote", body.dump(), bearer(std::format("POST {}/api/v3/brokerage/convert/quote", domain_)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j["trade"].get<ConvertTrade>();
@@ -943,9 +693,7 @@ ConvertTrade CoinbaseRestClient::create_convert_quote(std::string_view from_acco
 ConvertTrade CoinbaseRestClient::get_convert_trade(std::string_view trade_id, std::string_view from_account, std::string_view to_account) const {
     try {
         auto query = std::format("?from_account={}&to_account={}", from_account, to_account);
-        auto res = Http::get(std::format("{}/api/v3/brokerage/convert/trade/{}{}", base_url_, trade_id, query), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/convert/trade/{}", domain_, trade_id).c_str())}
-        });
+        auto res = pool_->get(std::format("/api/v3/brokerage/convert/trade/{}{}", trade_id, query), bearer(std::format("GET {}/api/v3/brokerage/convert/trade/{}", domain_, trade_id)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j["trade"].get<ConvertTrade>();
@@ -964,10 +712,7 @@ ConvertTrade CoinbaseRestClient::commit_convert_trade(std::string_view trade_id,
             {"from_account", from_account},
             {"to_account", to_account},
         };
-        auto res = Http::post(std::format("{}/api/v3/brokerage/convert/trade/{}", base_url_, trade_id), body.dump(), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("POST {}/api/v3/brokerage/convert/trade/{}", domain_, trade_id).c_str())},
-            {"Content-Type", "application/json"}
-        });
+        auto res = pool_->post(std::format("/api/v3/brokerage/convert/trade/{}", trade_id), body.dump(), bearer(std::format("POST {}/api/v3/brokerage/convert/trade/{}", domain_, trade_id)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j["trade"].get<ConvertTrade>();
@@ -982,9 +727,7 @@ ConvertTrade CoinbaseRestClient::commit_convert_trade(std::string_view trade_id,
 
 std::vector<PaymentMethod> CoinbaseRestClient::list_payment_methods() const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/payment_methods", base_url_), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/payment_methods", domain_).c_str())}
-        });
+        auto res = pool_->get("/api/v3/brokerage/payment_methods", bearer(std::format("GET {}/api/v3/brokerage/payment_methods", domain_)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j["payment_methods"];
@@ -999,9 +742,7 @@ std::vector<PaymentMethod> CoinbaseRestClient::list_payment_methods() const {
 
 PaymentMethod CoinbaseRestClient::get_payment_method(std::string_view payment_method_id) const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/payment_methods/{}", base_url_, payment_method_id), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/payment_methods/{}", domain_, payment_method_id).c_str())}
-        });
+        auto res = pool_->get(std::format("/api/v3/brokerage/payment_methods/{}", payment_method_id), bearer(std::format("GET {}/api/v3/brokerage/payment_methods/{}", domain_, payment_method_id)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j["payment_method"].get<PaymentMethod>();
@@ -1016,9 +757,7 @@ PaymentMethod CoinbaseRestClient::get_payment_method(std::string_view payment_me
 
 ApiKeyPermissions CoinbaseRestClient::get_api_key_permissions() const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/key_permissions", base_url_), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/key_permissions", domain_).c_str())}
-        });
+        auto res = pool_->get("/api/v3/brokerage/key_permissions", bearer(std::format("GET {}/api/v3/brokerage/key_permissions", domain_)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j.get<ApiKeyPermissions>();
@@ -1033,9 +772,7 @@ ApiKeyPermissions CoinbaseRestClient::get_api_key_permissions() const {
 
 FCMBalanceSummary CoinbaseRestClient::get_futures_balance_summary() const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/cfm/balance_summary", base_url_), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/cfm/balance_summary", domain_).c_str())}
-        });
+        auto res = pool_->get("/api/v3/brokerage/cfm/balance_summary", bearer(std::format("GET {}/api/v3/brokerage/cfm/balance_summary", domain_)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j["balance_summary"].get<FCMBalanceSummary>();
@@ -1050,9 +787,7 @@ FCMBalanceSummary CoinbaseRestClient::get_futures_balance_summary() const {
 
 std::vector<FCMPosition> CoinbaseRestClient::list_futures_positions() const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/cfm/positions", base_url_), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/cfm/positions", domain_).c_str())}
-        });
+        auto res = pool_->get("/api/v3/brokerage/cfm/positions", bearer(std::format("GET {}/api/v3/brokerage/cfm/positions", domain_)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j["positions"];
@@ -1067,9 +802,7 @@ std::vector<FCMPosition> CoinbaseRestClient::list_futures_positions() const {
 
 FCMPosition CoinbaseRestClient::get_futures_position(std::string_view product_id) const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/cfm/positions/{}", base_url_, product_id), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/cfm/positions/{}", domain_, product_id).c_str())}
-        });
+        auto res = pool_->get(std::format("/api/v3/brokerage/cfm/positions/{}", product_id), bearer(std::format("GET {}/api/v3/brokerage/cfm/positions/{}", domain_, product_id)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j["position"].get<FCMPosition>();
@@ -1087,10 +820,7 @@ bool CoinbaseRestClient::schedule_futures_sweep(double usd_amount) const {
         json body {
             {"usd_amount", std::to_string(usd_amount)},
         };
-        auto res = Http::post(std::format("{}/api/v3/brokerage/cfm/sweeps/schedule", base_url_), body.dump(), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("POST {}/api/v3/brokerage/cfm/sweeps/schedule", domain_).c_str())},
-            {"Content-Type", "application/json"}
-        });
+        auto res = pool_->post("/api/v3/brokerage/cfm/sweeps/schedule", body.dump(), bearer(std::format("POST {}/api/v3/brokerage/cfm/sweeps/schedule", domain_)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j.value("success", false);
@@ -1105,9 +835,7 @@ bool CoinbaseRestClient::schedule_futures_sweep(double usd_amount) const {
 
 std::vector<FCMSweep> CoinbaseRestClient::list_futures_sweeps() const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/cfm/sweeps", base_url_), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/cfm/sweeps", domain_).c_str())}
-        });
+        auto res = pool_->get("/api/v3/brokerage/cfm/sweeps", bearer(std::format("GET {}/api/v3/brokerage/cfm/sweeps", domain_)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j["sweeps"];
@@ -1122,9 +850,7 @@ std::vector<FCMSweep> CoinbaseRestClient::list_futures_sweeps() const {
 
 bool CoinbaseRestClient::cancel_pending_futures_sweep() const {
     try {
-        auto res = Http::del(std::format("{}/api/v3/brokerage/cfm/sweeps", base_url_), "", {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("DELETE {}/api/v3/brokerage/cfm/sweeps", domain_).c_str())}
-        });
+        auto res = pool_->del("/api/v3/brokerage/cfm/sweeps", bearer(std::format("DELETE {}/api/v3/brokerage/cfm/sweeps", domain_)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j.value("success", false);
@@ -1139,9 +865,7 @@ bool CoinbaseRestClient::cancel_pending_futures_sweep() const {
 
 std::string CoinbaseRestClient::get_intraday_margin_setting() const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/cfm/intraday/margin_setting", base_url_), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/cfm/intraday/margin_setting", domain_).c_str())}
-        });
+        auto res = pool_->get("/api/v3/brokerage/cfm/intraday/margin_setting", bearer(std::format("GET {}/api/v3/brokerage/cfm/intraday/margin_setting", domain_)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j.value("setting", std::string{});
@@ -1157,9 +881,7 @@ std::string CoinbaseRestClient::get_intraday_margin_setting() const {
 CurrentMarginWindow CoinbaseRestClient::get_current_margin_window(std::string_view margin_profile_type) const {
     try {
         auto query = std::format("?margin_profile_type={}", margin_profile_type);
-        auto res = Http::get(std::format("{}/api/v3/brokerage/cfm/intraday/current_margin_window{}", base_url_, query), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/cfm/intraday/current_margin_window", domain_).c_str())}
-        });
+        auto res = pool_->get(std::format("/api/v3/brokerage/cfm/intraday/current_margin_window{}", query), bearer(std::format("GET {}/api/v3/brokerage/cfm/intraday/current_margin_window", domain_)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j.get<CurrentMarginWindow>();
@@ -1177,10 +899,7 @@ bool CoinbaseRestClient::set_intraday_margin_setting(std::string_view setting) c
         json body {
             {"setting", setting},
         };
-        auto res = Http::post(std::format("{}/api/v3/brokerage/cfm/intraday/margin_setting", base_url_), body.dump(), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("POST {}/api/v3/brokerage/cfm/intraday/margin_setting", domain_).c_str())},
-            {"Content-Type", "application/json"}
-        });
+        auto res = pool_->post("/api/v3/brokerage/cfm/intraday/margin_setting", body.dump(), bearer(std::format("POST {}/api/v3/brokerage/cfm/intraday/margin_setting", domain_)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j.value("success", false);
@@ -1201,10 +920,7 @@ bool CoinbaseRestClient::allocate_portfolio(std::string_view portfolio_uuid, std
             {"amount", std::to_string(amount)},
             {"currency", currency},
         };
-        auto res = Http::post(std::format("{}/api/v3/brokerage/intx/allocate", base_url_), body.dump(), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("POST {}/api/v3/brokerage/intx/allocate", domain_).c_str())},
-            {"Content-Type", "application/json"}
-        });
+        auto res = pool_->post("/api/v3/brokerage/intx/allocate", body.dump(), bearer(std::format("POST {}/api/v3/brokerage/intx/allocate", domain_)));
         if (res.is_ok()) {
             return true;
         }
@@ -1218,9 +934,7 @@ bool CoinbaseRestClient::allocate_portfolio(std::string_view portfolio_uuid, std
 
 PerpsPortfolioSummaryResponse CoinbaseRestClient::get_perps_portfolio_summary(std::string_view portfolio_uuid) const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/intx/portfolio/{}", base_url_, portfolio_uuid), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/intx/portfolio/{}", domain_, portfolio_uuid).c_str())}
-        });
+        auto res = pool_->get(std::format("/api/v3/brokerage/intx/portfolio/{}", portfolio_uuid), bearer(std::format("GET {}/api/v3/brokerage/intx/portfolio/{}", domain_, portfolio_uuid)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j.get<PerpsPortfolioSummaryResponse>();
@@ -1235,9 +949,7 @@ PerpsPortfolioSummaryResponse CoinbaseRestClient::get_perps_portfolio_summary(st
 
 PerpsPositionsResponse CoinbaseRestClient::list_perps_positions(std::string_view portfolio_uuid) const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/intx/positions/{}", base_url_, portfolio_uuid), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/intx/positions/{}", domain_, portfolio_uuid).c_str())}
-        });
+        auto res = pool_->get(std::format("/api/v3/brokerage/intx/positions/{}", portfolio_uuid), bearer(std::format("GET {}/api/v3/brokerage/intx/positions/{}", domain_, portfolio_uuid)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j.get<PerpsPositionsResponse>();
@@ -1252,9 +964,7 @@ PerpsPositionsResponse CoinbaseRestClient::list_perps_positions(std::string_view
 
 PerpsPosition CoinbaseRestClient::get_perps_position(std::string_view portfolio_uuid, std::string_view symbol) const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/intx/positions/{}/{}", base_url_, portfolio_uuid, symbol), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/intx/positions/{}/{}", domain_, portfolio_uuid, symbol).c_str())}
-        });
+        auto res = pool_->get(std::format("/api/v3/brokerage/intx/positions/{}/{}", portfolio_uuid, symbol), bearer(std::format("GET {}/api/v3/brokerage/intx/positions/{}/{}", domain_, portfolio_uuid, symbol)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j["position"].get<PerpsPosition>();
@@ -1269,9 +979,7 @@ PerpsPosition CoinbaseRestClient::get_perps_position(std::string_view portfolio_
 
 std::vector<PerpsPortfolioBalance> CoinbaseRestClient::get_perps_portfolio_balances(std::string_view portfolio_uuid) const {
     try {
-        auto res = Http::get(std::format("{}/api/v3/brokerage/intx/balances/{}", base_url_, portfolio_uuid), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("GET {}/api/v3/brokerage/intx/balances/{}", domain_, portfolio_uuid).c_str())}
-        });
+        auto res = pool_->get(std::format("/api/v3/brokerage/intx/balances/{}", portfolio_uuid), bearer(std::format("GET {}/api/v3/brokerage/intx/balances/{}", domain_, portfolio_uuid)));
         if (res.is_ok()) {
             auto j = json::parse(res.result_text);
             return j["portfolio_balances"];
@@ -1290,10 +998,7 @@ bool CoinbaseRestClient::opt_in_or_out_multi_asset_collateral(std::string_view p
             {"portfolio_uuid", portfolio_uuid},
             {"multi_asset_collateral_enabled", enabled},
         };
-        auto res = Http::post(std::format("{}/api/v3/brokerage/intx/multi_asset_collateral", base_url_), body.dump(), {
-            {"Authorization", "Bearer " + coinbase::generate_coinbase_jwt(std::format("POST {}/api/v3/brokerage/intx/multi_asset_collateral", domain_).c_str())},
-            {"Content-Type", "application/json"}
-        });
+        auto res = pool_->post("/api/v3/brokerage/intx/multi_asset_collateral", body.dump(), bearer(std::format("POST {}/api/v3/brokerage/intx/multi_asset_collateral", domain_)));
         if (res.is_ok()) {
             return true;
         }
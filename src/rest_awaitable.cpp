@@ -3,7 +3,14 @@
 // https://github.com/SlickQuant/slick-socket
 
 #include <coinbase/rest_awaitable.hpp>
-#include <coinbase/rest.hpp>
+#include <coinbase/product_catalog.hpp>
+#include <coinbase/auth.hpp>
+#include <coinbase/order_request.hpp>
+#include <coinbase/utils.hpp>
+#include <slick/net/logging.hpp>
+#include <algorithm>
+#include <format>
+#include <numeric>
 #include <utility>
 
 namespace coinbase {
@@ -18,102 +25,327 @@ std::string extract_domain(std::string_view base_url) {
     return std::string(base_url.substr(pos + 3));
 }
 
+std::string bearer(const std::string &uri) {
+    return "Bearer " + coinbase::generate_coinbase_jwt(uri.c_str());
+}
+
 }  // namespace
 
 CoinbaseAwaitableRestClient::CoinbaseAwaitableRestClient(std::string base_url)
     : base_url_(std::move(base_url))
     , domain_(extract_domain(base_url_))
-    , sync_client_(std::make_unique<CoinbaseRestClient>(base_url_))
+    , http_(base_url_)
 {
+    // order prices are formatted with the products of the process-wide catalog
+    ProductCatalog::instance().loadAsync(base_url_);
 }
 
 CoinbaseAwaitableRestClient::~CoinbaseAwaitableRestClient() = default;
 
-CoinbaseAwaitableRestClient::CoinbaseAwaitableRestClient(const CoinbaseAwaitableRestClient& other)
-    : base_url_(other.base_url_)
-    , domain_(other.domain_)
-    , sync_client_(std::make_unique<CoinbaseRestClient>(other.base_url_))
-{
-}
+CoinbaseAwaitableRestClient::CoinbaseAwaitableRestClient(const CoinbaseAwaitableRestClient& other) = default;
 
-CoinbaseAwaitableRestClient& CoinbaseAwaitableRestClient::operator=(const CoinbaseAwaitableRestClient& other) {
-    if (this == &other) {
-        return *this;
-    }
-    base_url_ = other.base_url_;
-    domain_ = other.domain_;
-    sync_client_ = std::make_unique<CoinbaseRestClient>(base_url_);
-    return *this;
-}
+CoinbaseAwaitableRestClient& CoinbaseAwaitableRestClient::operator=(const CoinbaseAwaitableRestClient& other) = default;
 
 CoinbaseAwaitableRestClient::CoinbaseAwaitableRestClient(CoinbaseAwaitableRestClient&& other) noexcept = default;
 
 CoinbaseAwaitableRestClient& CoinbaseAwaitableRestClient::operator=(CoinbaseAwaitableRestClient&& other) noexcept = default;
 
 const Product& CoinbaseAwaitableRestClient::product(std::string_view product_id) {
-    return CoinbaseRestClient::product(product_id);
+    return ProductCatalog::instance().get(product_id);
 }
 
 void CoinbaseAwaitableRestClient::set_base_url(std::string_view url) {
     base_url_ = std::string(url);
     domain_ = extract_domain(base_url_);
-    sync_client_->set_base_url(base_url_);
+    http_.set_base_url(base_url_);
 }
 
 asio::awaitable<uint64_t> CoinbaseAwaitableRestClient::get_server_time() const {
-    co_return sync_client_->get_server_time();
+    try {
+        auto res = co_await http_.get("/api/v3/brokerage/time");
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return std::stoull(j["epochMillis"].get<std::string_view>().data());
+        }
+        LOG_ERROR("Failed to get_server_time. error: {}", res.result_text);
+    }
+    catch(const std::exception& e) {
+        LOG_ERROR("Failed to get_server_time. error: {}", e.what());
+    }
+    co_return uint64_t{};
 }
 
 asio::awaitable<std::vector<Account>> CoinbaseAwaitableRestClient::list_accounts(const AccountQueryParams &params) const {
-    co_return sync_client_->list_accounts(params);
+    try {
+        auto res = co_await http_.get(std::format("/api/v3/brokerage/accounts{}", params()), bearer(std::format("GET {}/api/v3/brokerage/accounts", domain_)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            std::vector<Account> accounts = j["accounts"];
+            while (j.contains("has_next") && j["has_next"].get<bool>() && !j["cursor"].get<std::string_view>().empty()) {
+                AccountQueryParams new_params = params;
+                new_params.cursor = j["cursor"].get<std::string_view>();
+                res = co_await http_.get(std::format("/api/v3/brokerage/accounts{}", new_params()), bearer(std::format("GET {}/api/v3/brokerage/accounts", domain_)));
+                if (res.is_ok()) {
+                    j = json::parse(res.result_text);
+                    accounts.insert(accounts.end(), std::make_move_iterator(j["accounts"].begin()), std::make_move_iterator(j["accounts"].end()));
+                }
+                else {
+                    LOG_ERROR("Failed to list accounts. error: {}", res.result_text);
+                    break;
+                }
+            }
+            co_return accounts;
+        }
+        LOG_ERROR("Failed to list accounts. error: {}", res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("Failed to list accounts. error: {}", e.what());
+    }
+    co_return std::vector<Account>{};
 }
 
 asio::awaitable<Account> CoinbaseAwaitableRestClient::get_account(std::string_view account_uuid) const {
-    co_return sync_client_->get_account(account_uuid);
+    try {
+        auto res = co_await http_.get(std::format("/api/v3/brokerage/accounts/{}", account_uuid), bearer(std::format("GET {}/api/v3/brokerage/accounts/{}", domain_, account_uuid)));
+        if (res.is_ok()) {
+            auto j_res = json::parse(res.result_text);
+            co_return j_res["account"].get<Account>();
+        }
+        LOG_ERROR("Failed to get account {}. error: {}", account_uuid, res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("Failed to get account {}. error: {}", account_uuid, e.what());
+    }
+    co_return Account{};
 }
 
 asio::awaitable<std::vector<Product>> CoinbaseAwaitableRestClient::list_products(const ProductQueryParams &params) const {
-    co_return sync_client_->list_products(params);
+    try {
+        auto res = co_await http_.get(std::format("/api/v3/brokerage/products{}", params()), bearer(std::format("GET {}/api/v3/brokerage/products", domain_)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j["products"].get<std::vector<Product>>();
+        }
+        LOG_ERROR("Failed to get products. error: {}", res.result_text);
+    }
+    catch(const std::exception& e) {
+        LOG_ERROR("Failed to get products. error: {}", e.what());
+    }
+    co_return std::vector<Product>{};
 }
 
-asio::awaitable<Product> CoinbaseAwaitableRestClient::get_product(std::string_view product_id, bool get_tradability_status) const {
-    co_return sync_client_->get_product(product_id, get_tradability_status);
+asio::awaitable<Product> CoinbaseAwaitableRestClient::get_product(std::string_view prod_id, bool get_tradability_status) const {
+    try {
+        auto res = co_await http_.get(std::format("/api/v3/brokerage/products/{}{}", prod_id, get_tradability_status ? "?get_tradability_status=true" : ""), bearer(std::format("GET {}/api/v3/brokerage/products/{}", domain_, prod_id)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j.get<Product>();
+        }
+        LOG_ERROR("Failed to get product {}. error: {}", prod_id, res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("Failed to get product {}. error: {}", prod_id, e.what());
+    }
+    co_return Product{};
 }
 
 asio::awaitable<std::vector<Product>> CoinbaseAwaitableRestClient::list_public_products(const ProductQueryParams &params) const {
-    co_return sync_client_->list_public_products(params);
+    try {
+        auto res = co_await http_.get(std::format("/api/v3/brokerage/market/products{}", params()));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j["products"].get<std::vector<Product>>();
+        }
+        LOG_ERROR("Failed to get products. error: {}", res.result_text);
+    }
+    catch(const std::exception& e) {
+        LOG_ERROR("Failed to get products. error: {}", e.what());
+    }
+    co_return std::vector<Product>{};
 }
 
-asio::awaitable<Product> CoinbaseAwaitableRestClient::get_public_product(std::string_view product_id) const {
-    co_return sync_client_->get_public_product(product_id);
+asio::awaitable<Product> CoinbaseAwaitableRestClient::get_public_product(std::string_view prod_id) const {
+    try {
+        auto res = co_await http_.get(std::format("/api/v3/brokerage/market/products/{}", prod_id));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j.get<Product>();
+        }
+        LOG_ERROR("Failed to get product {}. error: {}", prod_id, res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("Failed to get product {}. error: {}", prod_id, e.what());
+    }
+    co_return Product{};
+}
+
+asio::awaitable<bool> CoinbaseAwaitableRestClient::load_product(std::string_view product_id) const {
+    auto &catalog = ProductCatalog::instance();
+    if (catalog.find(product_id)) [[likely]] {
+        co_return true;
+    }
+    if (product_id.empty()) {
+        co_return false;
+    }
+    auto prod = co_await get_public_product(product_id);
+    if (prod.product_id != product_id) {
+        co_return false;
+    }
+    if (!catalog.find(product_id)) {
+        // unless it was loaded while we were fetching
+        catalog.add(std::move(prod));
+    }
+    co_return true;
 }
 
 asio::awaitable<std::vector<Order>> CoinbaseAwaitableRestClient::list_orders(const OrderQueryParams &query) const {
-    co_return sync_client_->list_orders(query);
+    try {
+        auto res = co_await http_.get(std::format("/api/v3/brokerage/orders/historical/batch{}", query()), bearer(std::format("GET {}/api/v3/brokerage/orders/historical/batch", domain_)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            std::vector<Order> orders = j["orders"];
+            while (j.contains("has_next") && j["has_next"].get<bool>() && !j["cursor"].get<std::string_view>().empty()) {
+                OrderQueryParams new_query = query;
+                new_query.cursor = j["cursor"].get<std::string_view>();
+                res = co_await http_.get(std::format("/api/v3/brokerage/orders/historical/batch{}", new_query()), bearer(std::format("GET {}/api/v3/brokerage/orders/historical/batch", domain_)));
+                if (res.is_ok()) {
+                    j = json::parse(res.result_text);
+                    orders.insert(orders.end(), std::make_move_iterator(j["orders"].begin()), std::make_move_iterator(j["orders"].end()));
+                }
+                else {
+                    LOG_ERROR("Failed to list orders. error: {}", res.result_text);
+                    break;
+                }
+            }
+            co_return orders;
+        }
+        LOG_ERROR("Failed to list orders. error: {}", res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("Failed to list orders. error: {}", e.what());
+    }
+    co_return std::vector<Order>{};
 }
 
 asio::awaitable<Order> CoinbaseAwaitableRestClient::get_order(std::string_view order_id) const {
-    co_return sync_client_->get_order(order_id);
+    try {
+        auto res = co_await http_.get(std::format("/api/v3/brokerage/orders/historical/{}", order_id), bearer(std::format("GET {}/api/v3/brokerage/orders/historical/{}", domain_, order_id)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            LOG_TRACE(j.dump().c_str());
+            co_return j["order"].get<Order>();
+        }
+        LOG_ERROR("Failed to get order {}. error: {}", order_id, res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("Failed to get order {}. error: {}", order_id, e.what());
+    }
+    co_return Order{};
 }
 
 asio::awaitable<std::vector<Fill>> CoinbaseAwaitableRestClient::list_fills(const FillQueryParams &params) const {
-    co_return sync_client_->list_fills(params);
+    try {
+        auto res = co_await http_.get(std::format("/api/v3/brokerage/orders/historical/fills{}", params()), bearer(std::format("GET {}/api/v3/brokerage/orders/historical/fills", domain_)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            std::vector<Fill> fills = j["fills"];
+            while(j.contains("cursor") && !j["cursor"].get<std::string_view>().empty()) {
+                FillQueryParams new_query = params;
+                new_query.cursor = j["cursor"].get<std::string_view>();
+                res = co_await http_.get(std::format("/api/v3/brokerage/orders/historical/fills{}", new_query()), bearer(std::format("GET {}/api/v3/brokerage/orders/historical/fills", domain_)));
+                if (res.is_ok()) {
+                    j = json::parse(res.result_text);
+                    fills.insert(fills.end(), std::make_move_iterator(j["fills"].begin()), std::make_move_iterator(j["fills"].end()));
+                }
+                else {
+                    LOG_ERROR("Failed to list orders. error: {}", res.result_text);
+                    break;
+                }
+            }
+            co_return fills;
+        }
+        LOG_ERROR("list_fills failed. error: {}", res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("list_fills failed. error: {}", e.what());
+    }
+    co_return std::vector<Fill>{};
 }
 
 asio::awaitable<std::vector<PriceBook>> CoinbaseAwaitableRestClient::get_best_bid_ask(const std::vector<std::string> &product_ids) const {
-    co_return sync_client_->get_best_bid_ask(product_ids);
+    try {
+        if (product_ids.empty()) {
+            LOG_WARN("get_best_bid_ask empty product_ids provided");
+            co_return std::vector<PriceBook>{};
+        }
+
+        std::vector<std::string> params(product_ids.size());
+        std::transform(product_ids.begin(), product_ids.end(), params.begin(),
+            [](const std::string &i) { return std::format("product_ids={}", i); });
+
+        auto query = std::format("?{}", std::accumulate(std::next(params.begin()), params.end(), params[0],
+            [](const std::string& a, const std::string &b) {
+                return a + "&" + b;
+            }));
+        auto res = co_await http_.get(std::format("/api/v3/brokerage/best_bid_ask{}", query), bearer(std::format("GET {}/api/v3/brokerage/best_bid_ask", domain_)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            LOG_TRACE(j.dump().c_str());
+            co_return j["pricebooks"].get<std::vector<PriceBook>>();
+        }
+        LOG_ERROR("get_best_bid_ask failed. error: {}", res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("get_best_bid_ask failed. error: {}", e.what());
+    }
+    co_return std::vector<PriceBook>{};
 }
 
 asio::awaitable<PriceBookResponse> CoinbaseAwaitableRestClient::get_product_book(const PriceBookQueryParams &params) const {
-    co_return sync_client_->get_product_book(params);
+    try {
+        auto res = co_await http_.get(std::format("/api/v3/brokerage/product_book{}", params()), bearer(std::format("GET {}/api/v3/brokerage/product_book", domain_)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j.get<PriceBookResponse>();
+        }
+        LOG_ERROR("get_product_book failed. error: {}", res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("get_product_book failed. error: {}", e.what());
+    }
+    co_return PriceBookResponse{};
 }
 
 asio::awaitable<MarketTrades> CoinbaseAwaitableRestClient::get_market_trades(std::string_view product_id, const MarketTradesQueryParams &params) const {
-    co_return sync_client_->get_market_trades(product_id, params);
+    try {
+        auto res = co_await http_.get(std::format("/api/v3/brokerage/products/{}/ticker{}", product_id, params()), bearer(std::format("GET {}/api/v3/brokerage/products/{}/ticker", domain_, product_id)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j.get<MarketTrades>();
+        }
+        LOG_ERROR("get_market_trades failed. error: {}", res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("get_market_trades failed. error: {}", e.what());
+    }
+    co_return MarketTrades{};
 }
 
-asio::awaitable<std::vector<Candle>> CoinbaseAwaitableRestClient::get_product_candles(std::string_view product_id, const ProductCandlesQueryParams &params) const {
-    co_return sync_client_->get_product_candles(product_id, params);
+asio::awaitable<std::vector<Candle>> CoinbaseAwaitableRestClient::get_product_candles(std::string_view product_id, const ProductCandlesQueryParams &params) const
+{
+    try {
+        LOG_TRACE(params().c_str());
+        auto res = co_await http_.get(std::format("/api/v3/brokerage/products/{}/candles{}", product_id, params()), bearer(std::format("GET {}/api/v3/brokerage/products/{}/candles", domain_, product_id)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j["candles"].get<std::vector<Candle>>();
+        }
+        LOG_ERROR("get_product_candles failed. error: {}", res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("get_market_trades failed. error: {}", e.what());
+    }
+    co_return std::vector<Candle>{};
 }
 
 asio::awaitable<CreateOrderResponse> CoinbaseAwaitableRestClient::create_order(
@@ -123,7 +355,7 @@ asio::awaitable<CreateOrderResponse> CoinbaseAwaitableRestClient::create_order(
     OrderType order_type,
     TimeInForce time_in_force,
     double size,
-    double price,
+    double limit_price,
     bool post_only,
     bool size_in_quote,
     std::optional<double> stop_price,
@@ -136,25 +368,83 @@ asio::awaitable<CreateOrderResponse> CoinbaseAwaitableRestClient::create_order(
     std::optional<json> &&attached_order_configuration,
     std::optional<PredictionMetadata> &&prediction_metadata
 ) const {
-    co_return sync_client_->create_order(
-        std::move(client_order_id),
-        std::move(product_id),
-        side,
-        order_type,
-        time_in_force,
-        size,
-        price,
-        post_only,
-        size_in_quote,
-        stop_price,
-        take_profit_price,
-        end_time,
-        twap_start_time,
-        std::move(sor_preference),
-        std::move(leverage),
-        std::move(margin_type),
-        std::move(attached_order_configuration),
-        std::move(prediction_metadata));
+    CreateOrderResponse rsp;
+    try {
+        if (!co_await load_product(product_id)) {
+            rsp.error_response.message = std::format("Failed to create order. client_order_id: {} error: product {} not loaded", client_order_id, product_id);
+            LOG_ERROR(rsp.error_response.message.c_str());
+            rsp.success = false;
+            co_return rsp;
+        }
+        // copied out before the next suspension, when another coroutine may reuse the writer
+        thread_local OrderRequestWriter writer;
+        if (!writer.writeCreateOrder(rsp, client_order_id, product_id, side, order_type, time_in_force, size, limit_price, post_only, size_in_quote,
+                stop_price, take_profit_price, end_time, twap_start_time, sor_preference, leverage, margin_type,
+                attached_order_configuration, std::move(prediction_metadata))) {
+            co_return rsp;
+        }
+
+        LOG_TRACE("create order: {}", writer.body());
+        auto res = co_await http_.post("/api/v3/brokerage/orders", std::string(writer.body()), bearer(std::format("POST {}/api/v3/brokerage/orders", domain_)));
+
+        rsp.success = res.is_ok();
+        if (!res.result_text.empty()) {
+            auto j = json::parse(res.result_text);
+            LOG_TRACE(j.dump().c_str());
+            co_return j.get<CreateOrderResponse>();
+        }
+        rsp.error_response.message = std::format("Failed to create order. client_order_id: {} error: {}", client_order_id, res.result_text);
+        LOG_ERROR(rsp.error_response.message.c_str());
+    }
+    catch (const std::exception &e) {
+        rsp.error_response.message = std::format("Failed to create order. client_order_id: {}  error: {}", client_order_id, e.what());
+        LOG_ERROR(rsp.error_response.message.c_str());
+    }
+    rsp.success = false;
+    co_return rsp;
+}
+
+asio::awaitable<CreateOrderResponse> CoinbaseAwaitableRestClient::create_order(const OrderTemplate &order_template, std::string client_order_id, double size, double limit_price) const {
+    CreateOrderResponse rsp;
+    if (!order_template.isValid()) {
+        rsp.error_response.message = std::format("Invalid order template. client_order_id: {} error: {}", client_order_id, order_template.error());
+        LOG_ERROR(rsp.error_response.message.c_str());
+        rsp.success = false;
+        co_return rsp;
+    }
+    if (order_template.usesLimitPrice() && std::isnan(limit_price)) {
+        LOG_ERROR("Invalid limit price NAN");
+        rsp.error_response.message = "Invalid limit price NAN";
+        rsp.success = false;
+        co_return rsp;
+    }
+    try {
+        std::string body;
+        if (!order_template.write(body, client_order_id, size, limit_price)) {
+            rsp.error_response.message = std::format("Invalid size {} or limit price {}. client_order_id: {}", size, limit_price, client_order_id);
+            LOG_ERROR(rsp.error_response.message.c_str());
+            rsp.success = false;
+            co_return rsp;
+        }
+
+        LOG_TRACE("create order: {}", body);
+        auto res = co_await http_.post("/api/v3/brokerage/orders", std::move(body), bearer(std::format("POST {}/api/v3/brokerage/orders", domain_)));
+
+        rsp.success = res.is_ok();
+        if (!res.result_text.empty()) {
+            auto j = json::parse(res.result_text);
+            LOG_TRACE(j.dump().c_str());
+            co_return j.get<CreateOrderResponse>();
+        }
+        rsp.error_response.message = std::format("Failed to create order. client_order_id: {} error: {}", client_order_id, res.result_text);
+        LOG_ERROR(rsp.error_response.message.c_str());
+    }
+    catch (const std::exception &e) {
+        rsp.error_response.message = std::format("Failed to create order. client_order_id: {}  error: {}", client_order_id, e.what());
+        LOG_ERROR(rsp.error_response.message.c_str());
+    }
+    rsp.success = false;
+    co_return rsp;
 }
 
 asio::awaitable<ModifyOrderResponse> CoinbaseAwaitableRestClient::modify_order(
@@ -166,126 +456,516 @@ asio::awaitable<ModifyOrderResponse> CoinbaseAwaitableRestClient::modify_order(
     std::optional<double> take_profit_price,
     std::optional<bool> cancel_attached_order
 ) const {
-    co_return sync_client_->modify_order(
-        std::move(order_id),
-        std::move(product_id),
-        price,
-        size,
-        stop_price,
-        take_profit_price,
-        cancel_attached_order);
+    ModifyOrderResponse rsp;
+    try {
+        if (!co_await load_product(product_id)) {
+            LOG_ERROR("modify_order failed. order_id: {}, error: product {} not loaded", order_id, product_id);
+            rsp.success = false;
+            co_return rsp;
+        }
+        auto body = build_modify_order_body(order_id, product_id, price, size, stop_price, take_profit_price, cancel_attached_order);
+        LOG_TRACE("modify order: {}", body.dump());
+        auto res = co_await http_.post("/api/v3/brokerage/orders/edit", body.dump(), bearer(std::format("POST {}/api/v3/brokerage/orders/edit", domain_)));
+        rsp.success = res.is_ok();
+        if (!res.result_text.empty()) {
+            auto j = json::parse(res.result_text);
+            LOG_TRACE(j.dump().c_str());
+            co_return j.get<ModifyOrderResponse>();
+        }
+        LOG_ERROR("modify_order failed. order_id: {}, error: {}", order_id, res.reason);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("modify_order failed. order_id: {}, error: {}", order_id, e.what());
+    }
+    rsp.success = false;
+    co_return rsp;
 }
 
 asio::awaitable<std::vector<CancelOrderResponse>> CoinbaseAwaitableRestClient::cancel_orders(const std::vector<std::string_view> &order_ids) const {
-    co_return sync_client_->cancel_orders(order_ids);
+    std::vector<CancelOrderResponse> rt;
+    try {
+        json body {
+            {"order_ids", order_ids},
+        };
+
+        LOG_TRACE("cancel order: {}", body.dump());
+        auto res = co_await http_.post("/api/v3/brokerage/orders/batch_cancel", body.dump(), bearer(std::format("POST {}/api/v3/brokerage/orders/batch_cancel", domain_)));
+        if (!res.result_text.empty()) {
+            auto j = json::parse(res.result_text);
+            LOG_TRACE(j.dump().c_str());
+            co_return j["results"].get<std::vector<CancelOrderResponse>>();
+        }
+        LOG_ERROR("cancel_orders failed. error: {}", res.result_text);
+        for (auto oid : order_ids) {
+            CancelOrderResponse rsp;
+            rsp.success = false;
+            rsp.failure_reason = "INVALID_CANCEL_REQUEST";
+            rsp.order_id = oid;
+            rt.emplace_back(std::move(rsp));
+        }
+    }
+    catch (const std::exception &e) {
+        for (auto oid : order_ids) {
+            CancelOrderResponse rsp;
+            rsp.success = false;
+            rsp.failure_reason = "INVALID_CANCEL_REQUEST";
+            rsp.order_id = oid;
+            rt.emplace_back(std::move(rsp));
+        }
+        LOG_ERROR("cancel_orders failed. error: {}", e.what());
+    }
+    co_return rt;
 }
 
 asio::awaitable<std::vector<Portfolio>> CoinbaseAwaitableRestClient::list_portfolios(std::optional<PortfolioType> portfolio_type) const {
-    co_return sync_client_->list_portfolios(portfolio_type);
+    try {
+        std::string query;
+        if (portfolio_type.has_value()) {
+            query = std::format("?portfolio_type={}", to_string(portfolio_type.value()));
+        }
+        auto res = co_await http_.get(std::format("/api/v3/brokerage/portfolios{}", query), bearer(std::format("GET {}/api/v3/brokerage/portfolios", domain_)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j["portfolios"].get<std::vector<Portfolio>>();
+        }
+        LOG_ERROR("list_portfolios failed. error: {}", res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("list_portfolios failed. error: {}", e.what());
+    }
+    co_return std::vector<Portfolio>{};
 }
 
 asio::awaitable<Portfolio> CoinbaseAwaitableRestClient::create_portfolio(std::string_view name) const {
-    co_return sync_client_->create_portfolio(name);
+    try {
+        json body {
+            {"name", name},
+        };
+        auto res = co_await http_.post("/api/v3/brokerage/portfolios", body.dump(), bearer(std::format("POST {}/api/v3/brokerage/portfolios", domain_)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j["portfolio"].get<Portfolio>();
+        }
+        LOG_ERROR("create_portfolio failed. error: {}", res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("create_portfolio failed. error: {}", e.what());
+    }
+    co_return Portfolio{};
 }
 
 asio::awaitable<PortfolioBreakdown> CoinbaseAwaitableRestClient::get_portfolio_breakdown(std::string_view portfolio_uuid, std::optional<std::string_view> currency) const {
-    co_return sync_client_->get_portfolio_breakdown(portfolio_uuid, currency);
+    try {
+        std::string query;
+        if (currency.has_value()) {
+            query = std::format("?currency={}", currency.value());
+        }
+        auto res = co_await http_.get(std::format("/api/v3/brokerage/portfolios/{}{}", portfolio_uuid, query), bearer(std::format("GET {}/api/v3/brokerage/portfolios/{}", domain_, portfolio_uuid)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j["breakdown"].get<PortfolioBreakdown>();
+        }
+        LOG_ERROR("get_portfolio_breakdown failed. portfolio_uuid: {}, error: {}", portfolio_uuid, res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("get_portfolio_breakdown failed. portfolio_uuid: {}, error: {}", portfolio_uuid, e.what());
+    }
+    co_return PortfolioBreakdown{};
 }
 
 asio::awaitable<MovePortfolioFundsResult> CoinbaseAwaitableRestClient::move_portfolio_funds(double value, std::string_view currency, std::string_view source_portfolio_uuid, std::string_view target_portfolio_uuid) const {
-    co_return sync_client_->move_portfolio_funds(value, currency, source_portfolio_uuid, target_portfolio_uuid);
+    try {
+        json body {
+            {"funds", {
+                {"value", std::to_string(value)},
+                {"currency", currency},
+            }},
+            {"source_portfolio_uuid", source_portfolio_uuid},
+            {"target_portfolio_uuid", target_portfolio_uuid},
+        };
+        auto res = co_await http_.post("/api/v3/brokerage/portfolios/move_funds", body.dump(), bearer(std::format("POST {}/api/v3/brokerage/portfolios/move_funds", domain_)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j.get<MovePortfolioFundsResult>();
+        }
+        LOG_ERROR("move_portfolio_funds failed. error: {}", res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("move_portfolio_funds failed. error: {}", e.what());
+    }
+    co_return MovePortfolioFundsResult{};
 }
 
 asio::awaitable<Portfolio> CoinbaseAwaitableRestClient::edit_portfolio(std::string_view portfolio_uuid, std::string_view name) const {
-    co_return sync_client_->edit_portfolio(portfolio_uuid, name);
+    try {
+        json body {
+            {"name", name},
+        };
+        auto res = co_await http_.put(std::format("/api/v3/brokerage/portfolios/{}", portfolio_uuid), body.dump(), bearer(std::format("PUT {}/api/v3/brokerage/portfolios/{}", domain_, portfolio_uuid)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j["portfolio"].get<Portfolio>();
+        }
+        LOG_ERROR("edit_portfolio failed. portfolio_uuid: {}, error: {}", portfolio_uuid, res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("edit_portfolio failed. portfolio_uuid: {}, error: {}", portfolio_uuid, e.what());
+    }
+    co_return Portfolio{};
 }
 
 asio::awaitable<bool> CoinbaseAwaitableRestClient::delete_portfolio(std::string_view portfolio_uuid) const {
-    co_return sync_client_->delete_portfolio(portfolio_uuid);
+    try {
+        auto res = co_await http_.del(std::format("/api/v3/brokerage/portfolios/{}", portfolio_uuid), bearer(std::format("DELETE {}/api/v3/brokerage/portfolios/{}", domain_, portfolio_uuid)));
+        if (res.is_ok()) {
+            co_return true;
+        }
+        LOG_ERROR("delete_portfolio failed. portfolio_uuid: {}, error: {}", portfolio_uuid, res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("delete_portfolio failed. portfolio_uuid: {}, error: {}", portfolio_uuid, e.what());
+    }
+    co_return false;
 }
 
 asio::awaitable<ConvertTrade> CoinbaseAwaitableRestClient::create_convert_quote(std::string_view from_account, std::string_view to_account, double amount) const {
-    co_return sync_client_->create_convert_quote(from_account, to_account, amount);
+    try {
+        json body {
+            {"from_account", from_account},
+            {"to_account", to_account},
+            {"amount", std::to_string(amount)},
+        };
+        auto res = co_await http_.post("/api/v3/brokerage/convert/quote", body.dump(), bearer(std::format("POST {}/api/v3/brokerage/convert/quote", domain_)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j["trade"].get<ConvertTrade>();
+        }
+        LOG_ERROR("create_convert_quote failed. error: {}", res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("create_convert_quote failed. error: {}", e.what());
+    }
+    co_return ConvertTrade{};
 }
 
 asio::awaitable<ConvertTrade> CoinbaseAwaitableRestClient::get_convert_trade(std::string_view trade_id, std::string_view from_account, std::string_view to_account) const {
-    co_return sync_client_->get_convert_trade(trade_id, from_account, to_account);
+    try {
+        auto query = std::format("?from_account={}&to_account={}", from_account, to_account);
+        auto res = co_await http_.get(std::format("/api/v3/brokerage/convert/trade/{}{}", trade_id, query), bearer(std::format("GET {}/api/v3/brokerage/convert/trade/{}", domain_, trade_id)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j["trade"].get<ConvertTrade>();
+        }
+        LOG_ERROR("get_convert_trade failed. trade_id: {}, error: {}", trade_id, res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("get_convert_trade failed. trade_id: {}, error: {}", trade_id, e.what());
+    }
+    co_return ConvertTrade{};
 }
 
 asio::awaitable<ConvertTrade> CoinbaseAwaitableRestClient::commit_convert_trade(std::string_view trade_id, std::string_view from_account, std::string_view to_account) const {
-    co_return sync_client_->commit_convert_trade(trade_id, from_account, to_account);
+    try {
+        json body {
+            {"from_account", from_account},
+            {"to_account", to_account},
+        };
+        auto res = co_await http_.post(std::format("/api/v3/brokerage/convert/trade/{}", trade_id), body.dump(), bearer(std::format("POST {}/api/v3/brokerage/convert/trade/{}", domain_, trade_id)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j["trade"].get<ConvertTrade>();
+        }
+        LOG_ERROR("commit_convert_trade failed. trade_id: {}, error: {}", trade_id, res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("commit_convert_trade failed. trade_id: {}, error: {}", trade_id, e.what());
+    }
+    co_return ConvertTrade{};
 }
 
 asio::awaitable<std::vector<PaymentMethod>> CoinbaseAwaitableRestClient::list_payment_methods() const {
-    co_return sync_client_->list_payment_methods();
+    try {
+        auto res = co_await http_.get("/api/v3/brokerage/payment_methods", bearer(std::format("GET {}/api/v3/brokerage/payment_methods", domain_)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j["payment_methods"].get<std::vector<PaymentMethod>>();
+        }
+        LOG_ERROR("list_payment_methods failed. error: {}", res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("list_payment_methods failed. error: {}", e.what());
+    }
+    co_return std::vector<PaymentMethod>{};
 }
 
 asio::awaitable<PaymentMethod> CoinbaseAwaitableRestClient::get_payment_method(std::string_view payment_method_id) const {
-    co_return sync_client_->get_payment_method(payment_method_id);
+    try {
+        auto res = co_await http_.get(std::format("/api/v3/brokerage/payment_methods/{}", payment_method_id), bearer(std::format("GET {}/api/v3/brokerage/payment_methods/{}", domain_, payment_method_id)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j["payment_method"].get<PaymentMethod>();
+        }
+        LOG_ERROR("get_payment_method failed. payment_method_id: {}, error: {}", payment_method_id, res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("get_payment_method failed. payment_method_id: {}, error: {}", payment_method_id, e.what());
+    }
+    co_return PaymentMethod{};
 }
 
 asio::awaitable<ApiKeyPermissions> CoinbaseAwaitableRestClient::get_api_key_permissions() const {
-    co_return sync_client_->get_api_key_permissions();
+    try {
+        auto res = co_await http_.get("/api/v3/brokerage/key_permissions", bearer(std::format("GET {}/api/v3/brokerage/key_permissions", domain_)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j.get<ApiKeyPermissions>();
+        }
+        LOG_ERROR("get_api_key_permissions failed. error: {}", res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("get_api_key_permissions failed. error: {}", e.what());
+    }
+    co_return ApiKeyPermissions{};
 }
 
 asio::awaitable<FCMBalanceSummary> CoinbaseAwaitableRestClient::get_futures_balance_summary() const {
-    co_return sync_client_->get_futures_balance_summary();
+    try {
+        auto res = co_await http_.get("/api/v3/brokerage/cfm/balance_summary", bearer(std::format("GET {}/api/v3/brokerage/cfm/balance_summary", domain_)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j["balance_summary"].get<FCMBalanceSummary>();
+        }
+        LOG_ERROR("get_futures_balance_summary failed. error: {}", res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("get_futures_balance_summary failed. error: {}", e.what());
+    }
+    co_return FCMBalanceSummary{};
 }
 
 asio::awaitable<std::vector<FCMPosition>> CoinbaseAwaitableRestClient::list_futures_positions() const {
-    co_return sync_client_->list_futures_positions();
+    try {
+        auto res = co_await http_.get("/api/v3/brokerage/cfm/positions", bearer(std::format("GET {}/api/v3/brokerage/cfm/positions", domain_)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j["positions"].get<std::vector<FCMPosition>>();
+        }
+        LOG_ERROR("list_futures_positions failed. error: {}", res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("list_futures_positions failed. error: {}", e.what());
+    }
+    co_return std::vector<FCMPosition>{};
 }
 
 asio::awaitable<FCMPosition> CoinbaseAwaitableRestClient::get_futures_position(std::string_view product_id) const {
-    co_return sync_client_->get_futures_position(product_id);
+    try {
+        auto res = co_await http_.get(std::format("/api/v3/brokerage/cfm/positions/{}", product_id), bearer(std::format("GET {}/api/v3/brokerage/cfm/positions/{}", domain_, product_id)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j["position"].get<FCMPosition>();
+        }
+        LOG_ERROR("get_futures_position failed. product_id: {}, error: {}", product_id, res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("get_futures_position failed. product_id: {}, error: {}", product_id, e.what());
+    }
+    co_return FCMPosition{};
 }
 
 asio::awaitable<bool> CoinbaseAwaitableRestClient::schedule_futures_sweep(double usd_amount) const {
-    co_return sync_client_->schedule_futures_sweep(usd_amount);
+    try {
+        json body {
+            {"usd_amount", std::to_string(usd_amount)},
+        };
+        auto res = co_await http_.post("/api/v3/brokerage/cfm/sweeps/schedule", body.dump(), bearer(std::format("POST {}/api/v3/brokerage/cfm/sweeps/schedule", domain_)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j.value("success", false);
+        }
+        LOG_ERROR("schedule_futures_sweep failed. error: {}", res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("schedule_futures_sweep failed. error: {}", e.what());
+    }
+    co_return false;
 }
 
 asio::awaitable<std::vector<FCMSweep>> CoinbaseAwaitableRestClient::list_futures_sweeps() const {
-    co_return sync_client_->list_futures_sweeps();
+    try {
+        auto res = co_await http_.get("/api/v3/brokerage/cfm/sweeps", bearer(std::format("GET {}/api/v3/brokerage/cfm/sweeps", domain_)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j["sweeps"].get<std::vector<FCMSweep>>();
+        }
+        LOG_ERROR("list_futures_sweeps failed. error: {}", res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("list_futures_sweeps failed. error: {}", e.what());
+    }
+    co_return std::vector<FCMSweep>{};
 }
 
 asio::awaitable<bool> CoinbaseAwaitableRestClient::cancel_pending_futures_sweep() const {
-    co_return sync_client_->cancel_pending_futures_sweep();
+    try {
+        auto res = co_await http_.del("/api/v3/brokerage/cfm/sweeps", bearer(std::format("DELETE {}/api/v3/brokerage/cfm/sweeps", domain_)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j.value("success", false);
+        }
+        LOG_ERROR("cancel_pending_futures_sweep failed. error: {}", res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("cancel_pending_futures_sweep failed. error: {}", e.what());
+    }
+    co_return false;
 }
 
 asio::awaitable<std::string> CoinbaseAwaitableRestClient::get_intraday_margin_setting() const {
-    co_return sync_client_->get_intraday_margin_setting();
+    try {
+        auto res = co_await http_.get("/api/v3/brokerage/cfm/intraday/margin_setting", bearer(std::format("GET {}/api/v3/brokerage/cfm/intraday/margin_setting", domain_)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j.value("setting", std::string{});
+        }
+        LOG_ERROR("get_intraday_margin_setting failed. error: {}", res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("get_intraday_margin_setting failed. error: {}", e.what());
+    }
+    co_return std::string{};
 }
 
 asio::awaitable<CurrentMarginWindow> CoinbaseAwaitableRestClient::get_current_margin_window(std::string_view margin_profile_type) const {
-    co_return sync_client_->get_current_margin_window(margin_profile_type);
+    try {
+        auto query = std::format("?margin_profile_type={}", margin_profile_type);
+        auto res = co_await http_.get(std::format("/api/v3/brokerage/cfm/intraday/current_margin_window{}", query), bearer(std::format("GET {}/api/v3/brokerage/cfm/intraday/current_margin_window", domain_)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j.get<CurrentMarginWindow>();
+        }
+        LOG_ERROR("get_current_margin_window failed. error: {}", res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("get_current_margin_window failed. error: {}", e.what());
+    }
+    co_return CurrentMarginWindow{};
 }
 
 asio::awaitable<bool> CoinbaseAwaitableRestClient::set_intraday_margin_setting(std::string_view setting) const {
-    co_return sync_client_->set_intraday_margin_setting(setting);
+    try {
+        json body {
+            {"setting", setting},
+        };
+        auto res = co_await http_.post("/api/v3/brokerage/cfm/intraday/margin_setting", body.dump(), bearer(std::format("POST {}/api/v3/brokerage/cfm/intraday/margin_setting", domain_)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j.value("success", false);
+        }
+        LOG_ERROR("set_intraday_margin_setting failed. error: {}", res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("set_intraday_margin_setting failed. error: {}", e.what());
+    }
+    co_return false;
 }
 
 asio::awaitable<bool> CoinbaseAwaitableRestClient::allocate_portfolio(std::string_view portfolio_uuid, std::string_view symbol, double amount, std::string_view currency) const {
-    co_return sync_client_->allocate_portfolio(portfolio_uuid, symbol, amount, currency);
+    try {
+        json body {
+            {"portfolio_uuid", portfolio_uuid},
+            {"symbol", symbol},
+            {"amount", std::to_string(amount)},
+            {"currency", currency},
+        };
+        auto res = co_await http_.post("/api/v3/brokerage/intx/allocate", body.dump(), bearer(std::format("POST {}/api/v3/brokerage/intx/allocate", domain_)));
+        if (res.is_ok()) {
+            co_return true;
+        }
+        LOG_ERROR("allocate_portfolio failed. error: {}", res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("allocate_portfolio failed. error: {}", e.what());
+    }
+    co_return false;
 }
 
 asio::awaitable<PerpsPortfolioSummaryResponse> CoinbaseAwaitableRestClient::get_perps_portfolio_summary(std::string_view portfolio_uuid) const {
-    co_return sync_client_->get_perps_portfolio_summary(portfolio_uuid);
+    try {
+        auto res = co_await http_.get(std::format("/api/v3/brokerage/intx/portfolio/{}", portfolio_uuid), bearer(std::format("GET {}/api/v3/brokerage/intx/portfolio/{}", domain_, portfolio_uuid)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j.get<PerpsPortfolioSummaryResponse>();
+        }
+        LOG_ERROR("get_perps_portfolio_summary failed. portfolio_uuid: {}, error: {}", portfolio_uuid, res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("get_perps_portfolio_summary failed. portfolio_uuid: {}, error: {}", portfolio_uuid, e.what());
+    }
+    co_return PerpsPortfolioSummaryResponse{};
 }
 
 asio::awaitable<PerpsPositionsResponse> CoinbaseAwaitableRestClient::list_perps_positions(std::string_view portfolio_uuid) const {
-    co_return sync_client_->list_perps_positions(portfolio_uuid);
+    try {
+        auto res = co_await http_.get(std::format("/api/v3/brokerage/intx/positions/{}", portfolio_uuid), bearer(std::format("GET {}/api/v3/brokerage/intx/positions/{}", domain_, portfolio_uuid)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j.get<PerpsPositionsResponse>();
+        }
+        LOG_ERROR("list_perps_positions failed. portfolio_uuid: {}, error: {}", portfolio_uuid, res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("list_perps_positions failed. portfolio_uuid: {}, error: {}", portfolio_uuid, e.what());
+    }
+    co_return PerpsPositionsResponse{};
 }
 
 asio::awaitable<PerpsPosition> CoinbaseAwaitableRestClient::get_perps_position(std::string_view portfolio_uuid, std::string_view symbol) const {
-    co_return sync_client_->get_perps_position(portfolio_uuid, symbol);
+    try {
+        auto res = co_await http_.get(std::format("/api/v3/brokerage/intx/positions/{}/{}", portfolio_uuid, symbol), bearer(std::format("GET {}/api/v3/brokerage/intx/positions/{}/{}", domain_, portfolio_uuid, symbol)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j["position"].get<PerpsPosition>();
+        }
+        LOG_ERROR("get_perps_position failed. portfolio_uuid: {}, symbol: {}, error: {}", portfolio_uuid, symbol, res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("get_perps_position failed. portfolio_uuid: {}, symbol: {}, error: {}", portfolio_uuid, symbol, e.what());
+    }
+    co_return PerpsPosition{};
 }
 
 asio::awaitable<std::vector<PerpsPortfolioBalance>> CoinbaseAwaitableRestClient::get_perps_portfolio_balances(std::string_view portfolio_uuid) const {
-    co_return sync_client_->get_perps_portfolio_balances(portfolio_uuid);
+    try {
+        auto res = co_await http_.get(std::format("/api/v3/brokerage/intx/balances/{}", portfolio_uuid), bearer(std::format("GET {}/api/v3/brokerage/intx/balances/{}", domain_, portfolio_uuid)));
+        if (res.is_ok()) {
+            auto j = json::parse(res.result_text);
+            co_return j["portfolio_balances"].get<std::vector<PerpsPortfolioBalance>>();
+        }
+        LOG_ERROR("get_perps_portfolio_balances failed. portfolio_uuid: {}, error: {}", portfolio_uuid, res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("get_perps_portfolio_balances failed. portfolio_uuid: {}, error: {}", portfolio_uuid, e.what());
+    }
+    co_return std::vector<PerpsPortfolioBalance>{};
 }
 
 asio::awaitable<bool> CoinbaseAwaitableRestClient::opt_in_or_out_multi_asset_collateral(std::string_view portfolio_uuid, bool enabled) const {
-    co_return sync_client_->opt_in_or_out_multi_asset_collateral(portfolio_uuid, enabled);
+    try {
+        json body {
+            {"portfolio_uuid", portfolio_uuid},
+            {"multi_asset_collateral_enabled", enabled},
+        };
+        auto res = co_await http_.post("/api/v3/brokerage/intx/multi_asset_collateral", body.dump(), bearer(std::format("POST {}/api/v3/brokerage/intx/multi_asset_collateral", domain_)));
+        if (res.is_ok()) {
+            co_return true;
+        }
+        LOG_ERROR("opt_in_or_out_multi_asset_collateral failed. error: {}", res.result_text);
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR("opt_in_or_out_multi_asset_collateral failed. error: {}", e.what());
+    }
+    co_return false;
 }
 
 }   // end namespace coinbase
@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#include <coinbase/subscription_batcher.hpp>
+#include <slick/net/logging.hpp>
+#include <algorithm>
+#include <exception>
+
+namespace coinbase {
+
+SubscriptionBatcher::SubscriptionBatcher(Sender sender, SubscriptionBatchConfig config)
+    : sender_(std::move(sender))
+    , config_(config)
+{
+    config_.max_products_per_message = std::max<uint32_t>(config_.max_products_per_message, 1);
+    config_.max_messages_per_second = std::max<uint32_t>(config_.max_messages_per_second, 1);
+    thread_ = std::thread([this] { run(); });
+}
+
+SubscriptionBatcher::~SubscriptionBatcher() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void SubscriptionBatcher::subscribe(const std::string &channel, const std::vector<std::string> &product_ids) {
+    {
+        std::lock_guard lock(mutex_);
+        auto &pending = pending_[channel];
+        if (product_ids.empty()) {
+            pending.subscribe_channel = true;
+            pending.unsubscribe_channel = false;
+        }
+        for (const auto &product_id : product_ids) {
+            pending.unsubscribe.erase(product_id);
+            pending.subscribe.insert(product_id);
+        }
+    }
+    cv_.notify_all();
+}
+
+void SubscriptionBatcher::unsubscribe(const std::string &channel, const std::vector<std::string> &product_ids) {
+    {
+        std::lock_guard lock(mutex_);
+        auto &pending = pending_[channel];
+        if (product_ids.empty()) {
+            // supersedes every subscribe requested so far
+            pending.unsubscribe_channel = true;
+            pending.subscribe_channel = false;
+            pending.subscribe.clear();
+        }
+        for (const auto &product_id : product_ids) {
+            pending.subscribe.erase(product_id);
+            pending.unsubscribe.insert(product_id);
+        }
+    }
+    cv_.notify_all();
+}
+
+void SubscriptionBatcher::flush() {
+    {
+        std::lock_guard lock(mutex_);
+        flush_ = true;
+    }
+    cv_.notify_all();
+}
+
+void SubscriptionBatcher::clear() {
+    std::lock_guard lock(mutex_);
+    pending_.clear();
+}
+
+std::size_t SubscriptionBatcher::pending() const {
+    std::lock_guard lock(mutex_);
+    return pending_.size();
+}
+
+std::vector<SubscriptionMessage> SubscriptionBatcher::drain() {
+    std::lock_guard lock(mutex_);
+    return drainLocked();
+}
+
+std::vector<SubscriptionMessage> SubscriptionBatcher::drainLocked() {
+    std::vector<SubscriptionMessage> messages;
+    for (const auto &[channel, pending] : pending_) {
+        // a whole-channel unsubscribe must not remove products subscribed after it
+        if (pending.unsubscribe_channel) {
+            messages.push_back(SubscriptionMessage{channel, false, {}});
+        }
+        split(messages, channel, false, pending.unsubscribe);
+        if (pending.subscribe_channel) {
+            messages.push_back(SubscriptionMessage{channel, true, {}});
+        }
+        split(messages, channel, true, pending.subscribe);
+    }
+    pending_.clear();
+    return messages;
+}
+
+void SubscriptionBatcher::split(std::vector<SubscriptionMessage> &messages, const std::string &channel, bool subscribe, const std::set<std::string> &product_ids) const {
+    for (auto it = product_ids.begin(); it != product_ids.end();) {
+        auto &message = messages.emplace_back(SubscriptionMessage{channel, subscribe, {}});
+        message.product_ids.reserve(std::min<std::size_t>(product_ids.size(), config_.max_products_per_message));
+        while (it != product_ids.end() && message.product_ids.size() < config_.max_products_per_message) {
+            message.product_ids.push_back(*it++);
+        }
+    }
+}
+
+void SubscriptionBatcher::run() {
+    using clock = std::chrono::steady_clock;
+    const double rate = config_.max_messages_per_second;
+    double tokens = rate;
+    auto refilled = clock::now();
+
+    std::unique_lock lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+        // let the rest of the burst arrive
+        cv_.wait_for(lock, config_.window, [this] { return stopping_ || flush_; });
+        if (stopping_) {
+            return;
+        }
+        flush_ = false;
+        auto messages = drainLocked();
+
+        for (const auto &message : messages) {
+            auto now = clock::now();
+            tokens = std::min(rate, tokens + std::chrono::duration<double>(now - refilled).count() * rate);
+            refilled = now;
+            if (tokens < 1.) {
+                auto delay = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>((1. - tokens) / rate));
+                if (cv_.wait_for(lock, delay, [this] { return stopping_; })) {
+                    return;
+                }
+                tokens = 1.;
+                refilled = clock::now();
+            }
+            tokens -= 1.;
+
+            lock.unlock();
+            try {
+                sender_(message);
+            }
+            catch (const std::exception &e) {
+                LOG_ERROR("failed to send {} {} request: {}", message.channel, message.subscribe ? "subscribe" : "unsubscribe", e.what());
+            }
+            lock.lock();
+        }
+    }
+}
+
+}   // end namespace coinbase
@@ -0,0 +1,321 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025-2026 Slick Quant
+// https://github.com/SlickQuant/slick-socket
+
+#include <coinbase/top_of_book.hpp>
+#include <slick/net/logging.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace coinbase {
+
+struct alignas(64) TopOfBookTable::Header {
+    static constexpr uint64_t MAGIC = 0x4b4f4f4250544243ull;   // "CBTPBOOK"
+    static constexpr uint32_t VERSION = 1;
+
+    std::atomic<uint64_t> magic;    // set last, once the table is initialized
+    uint32_t version;
+    uint32_t capacity;
+    std::atomic<uint32_t> size;
+};
+
+namespace {
+
+constexpr std::size_t CACHE_LINE = 64;
+constexpr std::size_t PRODUCT_IDS_OFFSET = CACHE_LINE;     // after the header
+
+std::size_t slots_offset(uint32_t capacity) noexcept {
+    auto ids_size = capacity * TopOfBookTable::PRODUCT_ID_SIZE;
+    return PRODUCT_IDS_OFFSET + (ids_size + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+}
+
+std::size_t table_size(uint32_t capacity) noexcept {
+    return slots_offset(capacity) + capacity * sizeof(TopOfBookSlot);
+}
+
+}   // end anonymous namespace
+
+// TopOfBookTable implementation
+TopOfBookTable::~TopOfBookTable() {
+    if (!header_) {
+        return;
+    }
+#if defined(_WIN32)
+    UnmapViewOfFile(header_);
+    CloseHandle(static_cast<HANDLE>(handle_));
+#else
+    munmap(header_, mapped_size_);
+#endif
+}
+
+bool TopOfBookTable::map(const char* shm_name, uint32_t capacity, bool create) {
+    static_assert(sizeof(Header) == CACHE_LINE);
+    void *base = nullptr;
+    std::size_t size = create ? table_size(capacity) : 0;
+
+#if defined(_WIN32)
+    HANDLE handle = create
+        ? CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>(static_cast<uint64_t>(size) >> 32), static_cast<DWORD>(size), shm_name)
+        : OpenFileMappingA(FILE_MAP_READ, FALSE, shm_name);
+    if (!handle) {
+        LOG_ERROR("failed to open top of book table {}: error {}", shm_name, GetLastError());
+        return false;
+    }
+    base = MapViewOfFile(handle, create ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, size);
+    if (!base) {
+        LOG_ERROR("failed to map top of book table {}: error {}", shm_name, GetLastError());
+        CloseHandle(handle);
+        return false;
+    }
+    if (!create) {
+        MEMORY_BASIC_INFORMATION info;
+        VirtualQuery(base, &info, sizeof(info));
+        size = info.RegionSize;
+    }
+    handle_ = handle;
+#else
+    std::string name = shm_name[0] == '/' ? std::string(shm_name) : "/" + std::string(shm_name);
+    int fd = shm_open(name.c_str(), create ? O_CREAT | O_RDWR : O_RDONLY, 0666);
+    if (fd < 0) {
+        LOG_ERROR("failed to open top of book table {}: {}", shm_name, std::strerror(errno));
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        LOG_ERROR("failed to stat top of book table {}: {}", shm_name, std::strerror(errno));
+        close(fd);
+        return false;
+    }
+    if (create) {
+        if (static_cast<std::size_t>(st.st_size) != size && ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            LOG_ERROR("failed to size top of book table {}: {}", shm_name, std::strerror(errno));
+            close(fd);
+            return false;
+        }
+    }
+    else {
+        size = static_cast<std::size_t>(st.st_size);
+    }
+    if (size < sizeof(Header)) {
+        close(fd);
+        return false;
+    }
+    base = mmap(nullptr, size, create ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        LOG_ERROR("failed to map top of book table {}: {}", shm_name, std::strerror(errno));
+        return false;
+    }
+#endif
+
+    auto *header = static_cast<Header*>(base);
+    auto *bytes = static_cast<char*>(base);
+    if (create) {
+        if (header->magic.load(std::memory_order_acquire) != Header::MAGIC || header->version != Header::VERSION || header->capacity != capacity) {
+            // new table, or one left behind by a different layout
+            std::memset(bytes + sizeof(std::atomic<uint64_t>), 0, size - sizeof(std::atomic<uint64_t>));
+            header->version = Header::VERSION;
+            header->capacity = capacity;
+            header->size.store(0, std::memory_order_relaxed);
+            header->magic.store(Header::MAGIC, std::memory_order_release);
+        }
+    }
+    else if (header->magic.load(std::memory_order_acquire) != Header::MAGIC || header->version != Header::VERSION || size < table_size(header->capacity)) {
+        // not created yet, or not a top of book table
+#if defined(_WIN32)
+        UnmapViewOfFile(base);
+        CloseHandle(static_cast<HANDLE>(handle_));
+        handle_ = nullptr;
+#else
+        munmap(base, size);
+#endif
+        return false;
+    }
+
+    header_ = header;
+    product_ids_ = reinterpret_cast<char (*)[PRODUCT_ID_SIZE]>(bytes + PRODUCT_IDS_OFFSET);
+    slots_ = reinterpret_cast<TopOfBookSlot*>(bytes + slots_offset(header->capacity));
+    mapped_size_ = size;
+    return true;
+}
+
+uint32_t TopOfBookTable::capacity() const noexcept {
+    return header_ ? header_->capacity : 0;
+}
+
+uint32_t TopOfBookTable::size() const noexcept {
+    return header_ ? header_->size.load(std::memory_order_acquire) : 0;
+}
+
+std::string_view TopOfBookTable::productId(uint32_t slot) const noexcept {
+    if (slot >= size()) {
+        return {};
+    }
+    const char *id = product_ids_[slot];
+    return std::string_view(id, std::find(id, id + PRODUCT_ID_SIZE, '\0') - id);
+}
+
+uint32_t TopOfBookTable::find(std::string_view product_id) const noexcept {
+    auto n = size();
+    for (uint32_t i = 0; i < n; ++i) {
+        if (productId(i) == product_id) {
+            return i;
+        }
+    }
+    return NO_SLOT;
+}
+
+void TopOfBookTable::remove([[maybe_unused]] const char* shm_name) {
+#if !defined(_WIN32)
+    // Windows releases the mapping with its last handle
+    std::string name = shm_name[0] == '/' ? std::string(shm_name) : "/" + std::string(shm_name);
+    shm_unlink(name.c_str());
+#endif
+}
+
+// TopOfBookWriter implementation
+TopOfBookWriter::TopOfBookWriter(const char* shm_name, uint32_t capacity) {
+    if (!map(shm_name, std::max(capacity, 1u), true)) {
+        return;
+    }
+    last_trade_time_.resize(this->capacity(), 0);
+    // a previous writer that died mid-update leaves an odd sequence behind
+    for (uint32_t i = 0; i < size(); ++i) {
+        auto &seq = slots_[i].sequence;
+        if (seq.load(std::memory_order_relaxed) & 1u) {
+            seq.fetch_add(1, std::memory_order_release);
+        }
+    }
+}
+
+uint32_t TopOfBookWriter::slot(std::string_view product_id) {
+    if (auto it = slot_cache_.find(product_id); it != slot_cache_.end()) [[likely]] {
+        return it->second;
+    }
+    if (!header_) {
+        return NO_SLOT;
+    }
+
+    // a reattached table keeps the slots of the previous writer
+    auto slot = find(product_id);
+    if (slot == NO_SLOT) {
+        auto n = header_->size.load(std::memory_order_relaxed);
+        if (n < header_->capacity && product_id.size() <= PRODUCT_ID_SIZE) {
+            std::memcpy(product_ids_[n], product_id.data(), product_id.size());
+            header_->size.store(n + 1, std::memory_order_release);
+            slot = n;
+        }
+        else {
+            LOG_ERROR("no top of book slot for {}: {} of {} slots used", product_id, n, header_->capacity);
+        }
+    }
+    slot_cache_.emplace(product_id, slot);
+    return slot;
+}
+
+template<typename F>
+void TopOfBookWriter::write(std::string_view product_id, F &&f) {
+    auto i = slot(product_id);
+    if (i == NO_SLOT) [[unlikely]] {
+        return;
+    }
+    auto &s = slots_[i];
+    auto seq = s.sequence.load(std::memory_order_relaxed);
+    s.sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    f(s);
+    s.sequence.store(seq + 2, std::memory_order_release);
+}
+
+void TopOfBookWriter::updateQuote(std::string_view product_id, double bid_price, double bid_quantity, double ask_price, double ask_quantity, uint64_t update_time) {
+    write(product_id, [&](TopOfBookSlot &s) {
+        s.bid_price = bid_price;
+        s.bid_quantity = bid_quantity;
+        s.ask_price = ask_price;
+        s.ask_quantity = ask_quantity;
+        s.update_time = update_time;
+    });
+}
+
+void TopOfBookWriter::updateTrade(std::string_view product_id, double price, double size, Side side, uint64_t update_time) {
+    write(product_id, [&](TopOfBookSlot &s) {
+        s.last_price = price;
+        s.last_size = size;
+        s.last_side = side;
+        s.update_time = update_time;
+    });
+}
+
+void TopOfBookWriter::update(const Ticker &ticker, uint64_t timestamp) {
+    write(ticker.product_id, [&](TopOfBookSlot &s) {
+        s.bid_price = ticker.best_bid;
+        s.bid_quantity = ticker.best_bid_quantity;
+        s.ask_price = ticker.best_ask;
+        s.ask_quantity = ticker.best_ask_quantity;
+        s.last_price = ticker.price;
+        s.update_time = timestamp;
+    });
+}
+
+void TopOfBookWriter::update(const MarketTrade &trade) {
+    // batches are not ordered by time; keep the latest trade
+    auto i = slot(trade.product_id);
+    if (i == NO_SLOT || trade.time < last_trade_time_[i]) {
+        return;
+    }
+    last_trade_time_[i] = trade.time;
+    updateTrade(trade.product_id, trade.price, trade.size, trade.side, trade.time);
+}
+
+void TopOfBookWriter::update(const OrderBook &book) {
+    auto bid = book.bestBid().value_or(BookLevel{0., 0.});
+    auto ask = book.bestAsk().value_or(BookLevel{0., 0.});
+    updateQuote(book.productId(), bid.price, bid.quantity, ask.price, ask.quantity, book.eventTime());
+}
+
+// TopOfBookReader implementation
+TopOfBookReader::TopOfBookReader(const char* shm_name) {
+    map(shm_name, 0, false);
+}
+
+bool TopOfBookReader::read(uint32_t slot, TopOfBook &out) const noexcept {
+    if (slot >= size()) {
+        return false;
+    }
+    const auto &s = slots_[slot];
+    for (uint32_t attempt = 0; attempt < READ_RETRIES; ++attempt) {
+        auto seq = s.sequence.load(std::memory_order_acquire);
+        if (seq & 1u) [[unlikely]] {
+            continue;
+        }
+        out.bid_price = s.bid_price;
+        out.bid_quantity = s.bid_quantity;
+        out.ask_price = s.ask_price;
+        out.ask_quantity = s.ask_quantity;
+        out.last_price = s.last_price;
+        out.last_size = s.last_size;
+        out.update_time = s.update_time;
+        out.last_side = s.last_side;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s.sequence.load(std::memory_order_relaxed) == seq) [[likely]] {
+            return true;
+        }
+    }
+    return false;
+}
+
+}   // end namespace coinbase
@@ -53,141 +53,143 @@ std::string timestamp_to_string(uint64_t timestamp_ms) {
     return std::string(result);
 }
 
-uint64_t to_milliseconds(const std::string &iso_str) {
-    // Parse ISO 8601 format: "YYYY-MM-DDTHH:MM:SS.sssZ"
-    std::tm tm = {};
-    double fractional_seconds = 0.0;
-
-    // Find the decimal point position
-    size_t dot_pos = iso_str.find('.');
-    if (dot_pos != std::string::npos) {
-        // Parse base timestamp
-        std::sscanf(iso_str.c_str(), "%d-%d-%dT%d:%d:%d",
-                    &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
-                    &tm.tm_hour, &tm.tm_min, &tm.tm_sec);
-
-        // Extract fractional seconds (e.g., ".718887" -> 0.718887)
-        size_t end_pos = iso_str.find_first_of("Z+", dot_pos);
-        if (end_pos == std::string::npos) end_pos = iso_str.length();
-        std::string frac_str = "0" + iso_str.substr(dot_pos, end_pos - dot_pos);
-        fractional_seconds = std::stod(frac_str);
-    } else {
-        // No fractional seconds
-        std::sscanf(iso_str.c_str(), "%d-%d-%dT%d:%d:%d",
-                    &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
-                    &tm.tm_hour, &tm.tm_min, &tm.tm_sec);
+bool parse_double_slow(std::string_view sv, double &out) noexcept {
+    const char *p = sv.data();
+    const char *end = p + sv.size();
+    if (p != end && *p == '+') {
+        ++p;
     }
-
-    tm.tm_year -= 1900;  // tm_year is years since 1900
-    tm.tm_mon -= 1;       // tm_mon is 0-11
-    tm.tm_isdst = 0;      // Not daylight saving time
-
-    // Convert to time_t (seconds since epoch, UTC)
-#ifdef _WIN32
-    auto time = _mkgmtime(&tm);
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    auto [ptr, ec] = std::from_chars(p, end, out);
+    return ec == std::errc() && ptr == end;
 #else
-    auto time = timegm(&tm);
+    // no floating-point from_chars (older libc++), strtod needs a terminated copy
+    char buf[128];
+    auto n = static_cast<std::size_t>(end - p);
+    if (n == 0 || n >= sizeof(buf)) {
+        return false;
+    }
+    std::memcpy(buf, p, n);
+    buf[n] = '\0';
+    char *stop = nullptr;
+    out = std::strtod(buf, &stop);
+    return stop == buf + n;
 #endif
+}
+
+namespace {
 
-    // Convert to milliseconds and add the fractional part
-    uint64_t milliseconds = static_cast<uint64_t>(fractional_seconds * 1000.0);
-    return static_cast<uint64_t>(time) * 1000 + milliseconds;
+constexpr uint32_t pow10_u32[10] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+inline uint32_t two_digits(const char *p) noexcept {
+    return static_cast<uint32_t>(p[0] - '0') * 10 + static_cast<uint32_t>(p[1] - '0');
 }
 
-uint64_t to_microseconds(const std::string &iso_str) {
-    // Parse ISO 8601 format: "YYYY-MM-DDTHH:MM:SS.ssssssZ"
-    std::tm tm = {};
-    double fractional_seconds = 0.0;
-
-    // Find the decimal point position
-    size_t dot_pos = iso_str.find('.');
-    if (dot_pos != std::string::npos) {
-        // Parse base timestamp
-        int parsed = std::sscanf(iso_str.c_str(), "%d-%d-%dT%d:%d:%d",
-                                 &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
-                                 &tm.tm_hour, &tm.tm_min, &tm.tm_sec);
-
-        if (parsed < 6) {
-            return 0;
-        }
+// Days since 1970-01-01 of a proleptic Gregorian date (Howard Hinnant's days_from_civil).
+constexpr int64_t days_from_civil(int64_t y, uint32_t m, uint32_t d) noexcept {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const auto yoe = static_cast<uint32_t>(y - era * 400);
+    const uint32_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
 
-        // Extract fractional seconds (e.g., ".718887" -> 0.718887)
-        size_t end_pos = iso_str.find_first_of("Z+", dot_pos);
-        if (end_pos == std::string::npos) end_pos = iso_str.length();
-        std::string frac_str = "0" + iso_str.substr(dot_pos, end_pos - dot_pos);
-        fractional_seconds = std::stod(frac_str);
-    } else {
-        // No fractional seconds
-        int parsed = std::sscanf(iso_str.c_str(), "%d-%d-%dT%d:%d:%d",
-                                 &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
-                                 &tm.tm_hour, &tm.tm_min, &tm.tm_sec);
-        if (parsed < 6) {
-            return 0;
-        }
-    }
+static_assert(days_from_civil(1970, 1, 1) == 0);
+static_assert(days_from_civil(2000, 3, 1) == 11017);
 
-    tm.tm_year -= 1900;  // tm_year is years since 1900
-    tm.tm_mon -= 1;       // tm_mon is 0-11
-    tm.tm_isdst = 0;      // Not daylight saving time
+// Parse "YYYY-MM-DDTHH:MM:SS[.fraction][Z|+hh:mm]" into whole seconds since the
+// epoch and nanoseconds. Fractions are exact to the nanosecond, further digits
+// are truncated. The zone designator is ignored, Coinbase always sends UTC.
+bool parse_iso8601(std::string_view iso_str, int64_t &seconds, uint32_t &nanos) noexcept {
+    if (iso_str.size() < 19) [[unlikely]] {
+        return false;
+    }
+    const char *p = iso_str.data();
 
-    // Convert to time_t (seconds since epoch, UTC)
-#ifdef _WIN32
-    auto time = _mkgmtime(&tm);
-#else
-    auto time = timegm(&tm);
-#endif
+    unsigned bad = (p[4] != '-') | (p[7] != '-') | (p[10] != 'T' && p[10] != ' ') | (p[13] != ':') | (p[16] != ':');
+    for (auto i : {0, 1, 2, 3, 5, 6, 8, 9, 11, 12, 14, 15, 17, 18}) {
+        bad |= static_cast<unsigned char>(p[i] - '0') > 9;
+    }
+    if (bad) [[unlikely]] {
+        return false;
+    }
 
-    // Convert to microseconds and add the fractional part
-    uint64_t microseconds = static_cast<uint64_t>(fractional_seconds * 1000000.0);
-    return static_cast<uint64_t>(time) * 1000000ULL + microseconds;
-}
+    // the date part rarely changes between consecutive timestamps
+    struct DayCache {
+        char date[10] = {};
+        int64_t days = 0;
+    };
+    thread_local DayCache day_cache;
 
-uint64_t to_nanoseconds(const std::string &iso_str) {
-    // Parse ISO 8601 format: "YYYY-MM-DDTHH:MM:SS.sssssssssZ"
-    std::tm tm = {};
-    double fractional_seconds = 0.0;
-
-    // Find the decimal point position
-    size_t dot_pos = iso_str.find('.');
-    if (dot_pos != std::string::npos) {
-        // Parse base timestamp
-        int parsed = std::sscanf(iso_str.c_str(), "%d-%d-%dT%d:%d:%d",
-                                 &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
-                                 &tm.tm_hour, &tm.tm_min, &tm.tm_sec);
-
-        if (parsed < 6) {
-            return 0;
+    int64_t days;
+    if (std::memcmp(day_cache.date, p, sizeof(day_cache.date)) == 0) [[likely]] {
+        days = day_cache.days;
+    }
+    else {
+        auto year = two_digits(p) * 100 + two_digits(p + 2);
+        auto month = two_digits(p + 5);
+        auto day = two_digits(p + 8);
+        if (month - 1 > 11 || day - 1 > 30) [[unlikely]] {
+            return false;
         }
+        days = days_from_civil(year, month, day);
+        std::memcpy(day_cache.date, p, sizeof(day_cache.date));
+        day_cache.days = days;
+    }
 
-        // Extract fractional seconds (e.g., ".718887475" -> 0.718887475)
-        size_t end_pos = iso_str.find_first_of("Z+", dot_pos);
-        if (end_pos == std::string::npos) end_pos = iso_str.length();
-        std::string frac_str = "0" + iso_str.substr(dot_pos, end_pos - dot_pos);
-        fractional_seconds = std::stod(frac_str);
-    } else {
-        // No fractional seconds
-        int parsed = std::sscanf(iso_str.c_str(), "%d-%d-%dT%d:%d:%d",
-                                 &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
-                                 &tm.tm_hour, &tm.tm_min, &tm.tm_sec);
-        if (parsed < 6) {
-            return 0;
+    auto hour = two_digits(p + 11);
+    auto minute = two_digits(p + 14);
+    auto second = two_digits(p + 17);
+    if (hour > 23 || minute > 59 || second > 60) [[unlikely]] {
+        return false;
+    }
+    seconds = days * 86400 + hour * 3600 + minute * 60 + second;
+
+    nanos = 0;
+    if (iso_str.size() > 20 && p[19] == '.') {
+        const char *f = p + 20;
+        const char *end = p + iso_str.size();
+        uint32_t digits = 0;
+        while (f < end && static_cast<unsigned char>(*f - '0') <= 9) {
+            if (digits < 9) {
+                nanos = nanos * 10 + static_cast<uint32_t>(*f - '0');
+                ++digits;
+            }
+            ++f;
         }
+        nanos *= pow10_u32[9 - digits];
     }
+    return true;
+}
 
-    tm.tm_year -= 1900;  // tm_year is years since 1900
-    tm.tm_mon -= 1;       // tm_mon is 0-11
-    tm.tm_isdst = 0;      // Not daylight saving time
+}   // namespace
 
-    // Convert to time_t (seconds since epoch, UTC)
-#ifdef _WIN32
-    auto time = _mkgmtime(&tm);
-#else
-    auto time = timegm(&tm);
-#endif
+uint64_t to_milliseconds(std::string_view iso_str) {
+    int64_t seconds;
+    uint32_t nanos;
+    if (!parse_iso8601(iso_str, seconds, nanos)) {
+        return 0;
+    }
+    return static_cast<uint64_t>(seconds) * 1000ULL + nanos / 1000000;
+}
 
-    // Convert to nanoseconds and add the fractional part
-    uint64_t nanoseconds = static_cast<uint64_t>(fractional_seconds * 1000000000.0);
-    return static_cast<uint64_t>(time) * 1000000000ULL + nanoseconds;
+uint64_t to_microseconds(std::string_view iso_str) {
+    int64_t seconds;
+    uint32_t nanos;
+    if (!parse_iso8601(iso_str, seconds, nanos)) {
+        return 0;
+    }
+    return static_cast<uint64_t>(seconds) * 1000000ULL + nanos / 1000;
+}
+
+uint64_t to_nanoseconds(std::string_view iso_str) {
+    int64_t seconds;
+    uint32_t nanos;
+    if (!parse_iso8601(iso_str, seconds, nanos)) {
+        return 0;
+    }
+    return static_cast<uint64_t>(seconds) * 1000000000ULL + nanos;
 }
 
 }   // namespace coinbase
@@ -3,6 +3,10 @@
 // https://github.com/SlickQuant/slick-socket
 
 #include <coinbase/websocket.hpp>
+#include <coinbase/product_catalog.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
 
 namespace coinbase {
 
@@ -32,8 +36,58 @@ std::string to_string(WebSocketChannel channel) {
     return "UNKNOWN_CHANNEL";
 }
 
+WebSocketChannel channel_from_frame(std::string_view channel) noexcept {
+    if (channel == "l2_data") {
+        return WebSocketChannel::LEVEL2;
+    }
+    if (channel == "ticker") {
+        return WebSocketChannel::TICKER;
+    }
+    if (channel == "ticker_batch") {
+        return WebSocketChannel::TICKER_BATCH;
+    }
+    if (channel == "market_trades") {
+        return WebSocketChannel::MARKET_TRADES;
+    }
+    if (channel == "candles") {
+        return WebSocketChannel::CANDLES;
+    }
+    if (channel == "heartbeats") {
+        return WebSocketChannel::HEARTBEATS;
+    }
+    if (channel == "status") {
+        return WebSocketChannel::STATUS;
+    }
+    if (channel == "user") {
+        return WebSocketChannel::USER;
+    }
+    if (channel == "futures_balance_summary") {
+        return WebSocketChannel::FUTURES_BALANCE_SUMMARY;
+    }
+    return WebSocketChannel::_CHANNEL_COUNT_;
+}
+
+// WebsocketCallbacks implementation
+void WebsocketCallbacks::onLevel2SnapshotView(WebSocketClient* client, uint64_t seq_num, std::string_view product_id, std::span<const Level2Update> snapshot) {
+    thread_local Level2UpdateBatch batch;
+    batch.product_id.assign(product_id);
+    batch.updates.assign(snapshot.begin(), snapshot.end());
+    onLevel2Snapshot(client, seq_num, batch);
+}
+
+void WebsocketCallbacks::onLevel2UpdatesView(WebSocketClient* client, uint64_t seq_num, std::string_view product_id, std::span<const Level2Update> updates) {
+    thread_local Level2UpdateBatch batch;
+    batch.product_id.assign(product_id);
+    batch.updates.assign(updates.begin(), updates.end());
+    onLevel2Updates(client, seq_num, batch);
+}
+
 // UserThreadWebsocketCallbacks implementation
 bool UserThreadWebsocketCallbacks::checkMarketDataSequenceNumber(WebSocketClient *ws_client, int64_t seq_num) {
+    if (ws_client->marketDataRedundancyEnabled()) {
+        // checked per connection by the arbiter
+        return true;
+    }
     auto it = md_seq_nums_.find(ws_client);
     if (it == md_seq_nums_.end()) [[unlikely]] {
         it = md_seq_nums_.emplace(ws_client, seq_num - 1).first;
@@ -42,7 +96,9 @@ bool UserThreadWebsocketCallbacks::checkMarketDataSequenceNumber(WebSocketClient
     auto last_seq = seq_atomic.load(std::memory_order_acquire);
     if (seq_num != last_seq + 1) {
         LOG_ERROR("market data message lost. seq_num: {}, last_md_seq_num: {}", seq_num, last_seq);
-        callbacks_->onMarketDataGap(ws_client);
+        // count on from here, so one lost frame is reported once
+        seq_atomic.store(seq_num, std::memory_order_release);
+        marketDataGap(ws_client);
         return false;
     }
     seq_atomic.store(seq_num, std::memory_order_release);
@@ -90,6 +146,30 @@ void UserThreadWebsocketCallbacks::mapProducerType(uint32_t producer_id, Produce
     producer_types_[producer_id] = pt;
 }
 
+void UserThreadWebsocketCallbacks::addMarketDataStandby(WebSocketClient *client, uint32_t producer_id, uint32_t connection) {
+    if (clients_.size() <= producer_id) {
+        clients_.resize(producer_id + 1, nullptr);
+        producer_types_.resize(producer_id + 1, ProducerType::_PRODUCER_TYPE_COUNT_);
+    }
+    if (md_connections_.size() <= producer_id) {
+        md_connections_.resize(producer_id + 1, 0);
+    }
+    // standby frames are arbitrated whether or not the primary is connected
+    clients_[producer_id] = client;
+    producer_types_[producer_id] = ProducerType::MD_DATA;
+    md_connections_[producer_id] = connection;
+}
+
+namespace {
+
+// Payload of a MessageType::PRODUCT_STALE control message
+struct ProductStaleMessage {
+    ProductHandle product_handle;
+    int64_t age;    // nanoseconds
+};
+
+}   // end anonymous namespace
+
 void UserThreadWebsocketCallbacks::processData(uint32_t max_drain_count) {
     if (!mux_) return;
 
@@ -156,12 +236,23 @@ void UserThreadWebsocketCallbacks::processData(uint32_t max_drain_count) {
                             callbacks_->onUserDataGap(client);
                         }
                         break;
+                    case MessageType::PRODUCT_STALE: {
+                        // reported while disconnected too: a stalled connection may never say so
+                        ProductStaleMessage msg;
+                        memcpy(&msg, data_ptr, sizeof(msg));
+                        callbacks_->onProductStale(client, msg.product_handle, std::chrono::nanoseconds(msg.age));
+                        break;
+                    }
                 }
                 break;
             }
             case ProducerType::MD_DATA:
-                if (clients_[record.producer_id]) {
-                    processMarketData(clients_[record.producer_id], reinterpret_cast<const char*>(record.data), record.length);
+                if (auto *client = clients_[record.producer_id]) {
+                    std::string_view frame(reinterpret_cast<const char*>(record.data), record.length);
+                    auto connection = record.producer_id < md_connections_.size() ? md_connections_[record.producer_id] : 0;
+                    if (!client->marketDataRedundancyEnabled() || client->arbitrate(connection, frame.data(), frame.size(), frame)) {
+                        processMarketData(client, frame.data(), frame.size());
+                    }
                 }
                 break;
             case ProducerType::USER_DATA:
@@ -176,6 +267,43 @@ void UserThreadWebsocketCallbacks::processData(uint32_t max_drain_count) {
     while(++i < max_drain_count);
 }
 
+// Calls WebSocketClient::scanProductActivity() every scan interval of the
+// tracker, so products going quiet are reported whether or not frames arrive.
+class WebSocketClient::ActivityScanner {
+public:
+    ActivityScanner(WebSocketClient *client, std::chrono::nanoseconds interval)
+        : client_(client)
+        , interval_(interval)
+        , worker_([this] { run(); })
+    {}
+
+    ~ActivityScanner() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_one();
+        worker_.join();
+    }
+
+private:
+    void run() {
+        std::unique_lock lock(mutex_);
+        while (!cv_.wait_for(lock, interval_, [this] { return stop_; })) {
+            lock.unlock();
+            client_->scanProductActivity();
+            lock.lock();
+        }
+    }
+
+    WebSocketClient *client_;
+    std::chrono::nanoseconds interval_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    std::thread worker_;    // last, so it starts after the members it reads
+};
+
 // WebSocketClient implementation
 WebSocketClient::WebSocketClient(
     WebsocketCallbacks *callbacks,
@@ -241,7 +369,76 @@ WebSocketClient::WebSocketClient(
     );
 }
 
+WebSocketClient::WebSocketClient(
+    StaticDataHandlerBase *handler,
+    std::string_view market_data_url,
+    std::string_view user_data_url,
+    const char* mux_shm_name,
+    uint32_t md_read_buffer_size,
+    uint32_t md_record_size,
+    const char* md_read_buffer_shm_name,
+    uint32_t user_read_buffer_size,
+    uint32_t user_record_size,
+    const char* user_read_buffer_shm_name,
+    uint32_t write_buffer_size
+)
+    : data_handler_(handler)
+    , market_data_url_(market_data_url)
+    , user_data_url_(user_data_url)
+    , owning_mux_(new slick::stream_buffer_multiplexer(std::max(md_record_size, user_record_size) * 2, mux_shm_name))
+    , mux_(*owning_mux_.get())
+    , producer_offset_(0)
+{
+    init(
+        nullptr,
+        md_read_buffer_size,
+        md_record_size,
+        md_read_buffer_shm_name,
+        user_read_buffer_size,
+        user_record_size,
+        user_read_buffer_shm_name,
+        write_buffer_size
+    );
+}
+
+WebSocketClient::WebSocketClient(
+    StaticDataHandlerBase *handler,
+    slick::stream_buffer_multiplexer &mux,
+    std::string_view market_data_url,
+    std::string_view user_data_url,
+    uint32_t producer_offset,
+    uint32_t md_read_buffer_size,
+    uint32_t md_record_size,
+    const char* md_read_buffer_shm_name,
+    uint32_t user_read_buffer_size,
+    uint32_t user_record_size,
+    const char* user_read_buffer_shm_name,
+    uint32_t write_buffer_size
+)
+    : data_handler_(handler)
+    , market_data_url_(market_data_url)
+    , user_data_url_(user_data_url)
+    , mux_(mux)
+    , producer_offset_(producer_offset)
+{
+    init(
+        nullptr,
+        md_read_buffer_size,
+        md_record_size,
+        md_read_buffer_shm_name,
+        user_read_buffer_size,
+        user_record_size,
+        user_read_buffer_shm_name,
+        write_buffer_size
+    );
+}
+
 WebSocketClient::~WebSocketClient() {
+    // the activity scanner reports through the data handler
+    activity_scanner_.reset();
+    // batcher threads send on the websockets
+    md_batcher_.reset();
+    user_batcher_.reset();
     if (market_data_websocket_) {
         if (market_data_websocket_->status() != Websocket::Status::DISCONNECTED) {
             market_data_websocket_->detach();
@@ -249,6 +446,13 @@ WebSocketClient::~WebSocketClient() {
         }
         market_data_websocket_.reset();
     }
+    for (auto &standby : md_standbys_) {
+        if (standby.websocket->status() != Websocket::Status::DISCONNECTED) {
+            standby.websocket->detach();
+            standby.websocket->close();
+        }
+        standby.websocket.reset();
+    }
     if (user_data_websocket_) {
         if (user_data_websocket_->status() != Websocket::Status::DISCONNECTED) {
             user_data_websocket_->detach();
@@ -262,12 +466,10 @@ WebSocketClient::~WebSocketClient() {
         logger_thread_.join();
     }
 
-    if (!user_thread_callbacks_) {
+    if (owns_data_handler_) {
         delete data_handler_;
     }
-    else {
-        user_thread_callbacks_ = nullptr;
-    }
+    user_thread_callbacks_ = nullptr;
     data_handler_ = nullptr;
 }
 
@@ -288,9 +490,10 @@ void WebSocketClient::init(
         user_thread_callbacks_->addClient(mux_, producer_offset_);
         data_handler_ = user_thread_callbacks_;
     }
-    else {
+    else if (!data_handler_) {
         data_handler_ = new DataHandler();
         data_handler_->callbacks_ = callbacks;
+        owns_data_handler_ = true;
     }
 
     if (!user_data_url_.empty()) {
@@ -336,7 +539,7 @@ void WebSocketClient::init(
             market_data_url_,
             [this]() { onMarketDataConnected(); },
             [this]() { onMarketDataDisconnected(); },
-            [this](const char* data, std::size_t size) { onMarketData(data, size); },
+            [this](const char* data, std::size_t size) { onMarketData(0, data, size); },
             [this](std::string err) { onMarketDataError(std::move(err)); },
             md_data_pb,
             write_buffer_size
@@ -344,69 +547,199 @@ void WebSocketClient::init(
     }
 }
 
-void WebSocketClient::stop() {
-    if (market_data_websocket_) {
-        if (market_data_websocket_->status() != Websocket::Status::DISCONNECTED) {
-            market_data_websocket_->close();
+bool WebSocketClient::enableNormalizedRecords(
+    uint32_t md_producer_id,
+    uint32_t user_producer_id,
+    uint32_t buffer_size,
+    uint32_t record_size,
+    const char* md_shm_name,
+    const char* user_shm_name
+) {
+    auto taken = [this](uint32_t pid) {
+        return pid >= producer_offset_ && pid < producer_offset_ + ProducerType::_PRODUCER_TYPE_COUNT_;
+    };
+    if (md_producer_id == NO_PRODUCER_ID || taken(md_producer_id) || taken(user_producer_id) || md_producer_id == user_producer_id) {
+        LOG_ERROR("invalid normalized record producer ids {} and {}: producers {} to {} belong to this client",
+            md_producer_id, user_producer_id, producer_offset_, producer_offset_ + ProducerType::_PRODUCER_TYPE_COUNT_ - 1);
+        return false;
+    }
+    if (record_size < sizeof(RecordHeader) + sizeof(OrderEntry)) {
+        LOG_ERROR("normalized record size {} is too small", record_size);
+        return false;
+    }
+
+    md_record_writer_ = std::make_unique<RecordWriter>(mux_.add_producer(md_producer_id, buffer_size, record_size, md_shm_name), record_size);
+    if (user_producer_id != NO_PRODUCER_ID) {
+        user_record_writer_ = std::make_unique<RecordWriter>(mux_.add_producer(user_producer_id, buffer_size, record_size, user_shm_name), record_size);
+    }
+    return true;
+}
+
+bool WebSocketClient::enableTopOfBook(const char* shm_name, uint32_t capacity) {
+    auto top_of_book = std::make_unique<TopOfBookWriter>(shm_name, capacity);
+    if (!top_of_book->isOpen()) {
+        return false;
+    }
+    top_of_book_ = std::move(top_of_book);
+    return true;
+}
+
+void WebSocketClient::enableProductActivity(std::chrono::nanoseconds stale_after) {
+    activity_scanner_.reset();
+    product_activity_ = std::make_unique<ProductActivityTracker>(stale_after);
+    activity_scanner_ = std::make_unique<ActivityScanner>(this, product_activity_->scanInterval());
+}
+
+void WebSocketClient::scanProductActivity() {
+    product_activity_->scan(ProductActivityTracker::now(), [this](ProductHandle product_handle, std::chrono::nanoseconds age) {
+        if (user_thread_callbacks_) {
+            ProductStaleMessage msg{product_handle, age.count()};
+            dispatchData(ProducerType::MD_CTRL, reinterpret_cast<const char*>(&msg), sizeof(msg), MessageType::PRODUCT_STALE);
+        }
+        else {
+            data_handler_->callbacks_->onProductStale(this, product_handle, age);
         }
+    });
+}
+
+bool WebSocketClient::enableMarketDataRedundancy(uint32_t standby_producer_id, MarketDataRedundancyConfig config) {
+    if (!market_data_websocket_ || md_arbiter_ || config.standby_connections == 0) {
+        LOG_ERROR("market data redundancy needs a market data URL and at least one standby connection, and can be enabled once");
+        return false;
     }
-    if (user_data_websocket_) {
-        if (user_data_websocket_->status() != Websocket::Status::DISCONNECTED) {
-            user_data_websocket_->close();
+    for (uint32_t i = 0; i < config.standby_connections; ++i) {
+        auto pid = standby_producer_id + i;
+        if (pid == NO_PRODUCER_ID || (pid >= producer_offset_ && pid < producer_offset_ + ProducerType::_PRODUCER_TYPE_COUNT_)) {
+            LOG_ERROR("invalid market data standby producer id {}: producers {} to {} belong to this client",
+                pid, producer_offset_, producer_offset_ + ProducerType::_PRODUCER_TYPE_COUNT_ - 1);
+            return false;
+        }
+    }
+
+    std::lock_guard lock(subscription_mutex_);
+    md_arbiter_ = std::make_unique<MarketDataArbiter>(1 + config.standby_connections, config.dedup_window);
+    if (md_connection_.live) {
+        md_arbiter_->connected(0);
+    }
+    md_standbys_.reserve(config.standby_connections);
+    for (uint32_t connection = 1; connection <= config.standby_connections; ++connection) {
+        auto pid = standby_producer_id + connection - 1;
+        auto pb = mux_.add_producer(pid, config.read_buffer_size, config.record_size);
+        if (user_thread_callbacks_) {
+            user_thread_callbacks_->addMarketDataStandby(this, pid, connection);
         }
+        auto &standby = md_standbys_.emplace_back();
+        standby.websocket = std::make_unique<Websocket>(
+            market_data_url_,
+            [this, connection]() { onMarketDataConnected(connection); },
+            [this, connection]() { onMarketDataDisconnected(connection); },
+            [this, connection](const char* data, std::size_t size) { onMarketData(connection, data, size); },
+            [this](std::string err) { onMarketDataError(std::move(err)); },
+            pb,
+            config.write_buffer_size
+        );
     }
+    return true;
 }
 
-void WebSocketClient::subscribe(const std::vector<std::string> &product_ids, const std::vector<WebSocketChannel> &channels) {
-    for (auto channel : channels) {
-        auto products = product_ids_[static_cast<uint8_t>(channel)];
-        auto subscribe_json = json{{"type", "subscribe"}, {"product_ids", product_ids}, {"channel", to_string(channel)}};
-        Websocket* websocket = nullptr;
-        if (channel == WebSocketChannel::USER) {
-            if (user_data_websocket_) {
-                if (user_data_websocket_->status() > Websocket::Status::CONNECTED) {
-                    user_data_websocket_->open();
-                    
-                    // subscribe heartbeat to keep user channel alive
-                    auto heartbeat_sub = json{{"type", "subscribe"}, {"channel", "heartbeats"}};
-                    heartbeat_sub["jwt"] = generate_coinbase_jwt(user_data_url_.c_str());
-                    auto subscribe_str = heartbeat_sub.dump();
-                    user_data_websocket_->send(subscribe_str.c_str(), subscribe_str.size());
-                }
-                websocket = user_data_websocket_.get();
-                subscribe_json["jwt"] = generate_coinbase_jwt(user_data_url_.c_str());
-            }
+std::vector<MarketDataConnectionStats> WebSocketClient::marketDataConnectionStats() const {
+    std::vector<MarketDataConnectionStats> stats;
+    if (md_arbiter_) {
+        for (uint32_t i = 0; i < md_arbiter_->connections(); ++i) {
+            stats.push_back(md_arbiter_->stats(i));
         }
-        else {
-            if (market_data_websocket_) {
-                if (market_data_websocket_->status() > Websocket::Status::CONNECTED) {
-                    market_data_websocket_->open();
-                }
-                websocket = market_data_websocket_.get();
-            }
+    }
+    return stats;
+}
+
+void WebSocketClient::stop() {
+    {
+        // a stopped client has nothing to restore
+        std::lock_guard lock(subscription_mutex_);
+        for (auto &products : product_ids_) {
+            products.clear();
         }
+        subscribed_channels_ = 0;
+    }
+    for (bool user : {false, true}) {
+        forEachConnection(user, [](Websocket &websocket, Connection&) {
+            if (websocket.status() != Websocket::Status::DISCONNECTED) {
+                websocket.close();
+            }
+        });
+    }
+}
 
+void WebSocketClient::subscribe(const std::vector<std::string> &product_ids, const std::vector<WebSocketChannel> &channels) {
+    std::lock_guard lock(subscription_mutex_);
+    for (auto channel : channels) {
+        auto user = isUserChannel(channel);
+        auto &websocket = user ? user_data_websocket_ : market_data_websocket_;
         if (websocket == nullptr) {
             LOG_WARN("WebSocket for channel {} is not initialized, URL is empty.", to_string(channel));
             continue;
         }
 
-        auto subscribe_str = subscribe_json.dump();
-        websocket->send(subscribe_str.c_str(), subscribe_str.size());
+        product_ids_[channel].insert(product_ids.begin(), product_ids.end());
+        subscribed_channels_ |= 1u << channel;
+
+        // the batcher sends to every live websocket of its kind
+        auto *batcher = (user ? user_batcher_ : md_batcher_).get();
+        if (batcher && isLive(user)) {
+            batcher->subscribe(to_string(channel), product_ids);
+        }
+        forEachConnection(user, [&](Websocket &ws, Connection &connection) {
+            if (connection.live) {
+                if (!batcher) {
+                    sendSubscribe(ws, channel, product_ids);
+                }
+            }
+            else if (ws.status() > Websocket::Status::CONNECTED) {
+                // the whole set is sent once connected, see resubscribe()
+                ws.open();
+            }
+        });
     }
 }
 
 void WebSocketClient::unsubscribe(const std::vector<std::string> &product_ids, const std::vector<WebSocketChannel> &channels) {
+    std::lock_guard lock(subscription_mutex_);
     for (auto channel : channels) {
-        auto &websocket = channel == WebSocketChannel::USER ? user_data_websocket_ : market_data_websocket_;
+        auto user = isUserChannel(channel);
+        auto &websocket = user ? user_data_websocket_ : market_data_websocket_;
         auto unsubscribe_json = json{{"type", "unsubscribe"}, {"product_ids", product_ids}, {"channel", to_string(channel)}};
         auto unsubscribe_str = unsubscribe_json.dump();
         if (websocket == nullptr) {
             LOG_WARN("WebSocket for channel {} is not initialized.", to_string(channel));
             continue;
         }
-        if (websocket->status() <= Websocket::Status::CONNECTED) {
-            websocket->send(unsubscribe_str.c_str(), unsubscribe_str.size());
+
+        auto &products = product_ids_[channel];
+        if (product_ids.empty()) {
+            products.clear();
+            subscribed_channels_ &= ~(1u << channel);
+        }
+        else if (!products.empty()) {
+            for (const auto &product_id : product_ids) {
+                products.erase(product_id);
+            }
+            if (products.empty()) {
+                subscribed_channels_ &= ~(1u << channel);
+            }
+        }
+
+        auto *batcher = (user ? user_batcher_ : md_batcher_).get();
+        if (batcher) {
+            if (isLive(user)) {
+                batcher->unsubscribe(to_string(channel), product_ids);
+            }
+        }
+        else {
+            forEachConnection(user, [&](Websocket &ws, Connection&) {
+                if (ws.status() <= Websocket::Status::CONNECTED) {
+                    ws.send(unsubscribe_str.c_str(), unsubscribe_str.size());
+                }
+            });
         }
         if (channel == WebSocketChannel::HEARTBEATS) {
             if (user_data_websocket_ && user_data_websocket_->status() <= Websocket::Status::CONNECTED) {
@@ -416,6 +749,209 @@ void WebSocketClient::unsubscribe(const std::vector<std::string> &product_ids, c
     }
 }
 
+void WebSocketClient::reconnect() {
+    std::lock_guard lock(subscription_mutex_);
+    for (bool user : {false, true}) {
+        if (!hasSubscriptions(user)) {
+            continue;
+        }
+        forEachConnection(user, [](Websocket &websocket, Connection&) {
+            if (websocket.status() > Websocket::Status::CONNECTED) {
+                websocket.open();
+            }
+        });
+    }
+}
+
+void WebSocketClient::enableSubscriptionBatching(SubscriptionBatchConfig config) {
+    std::lock_guard lock(subscription_mutex_);
+    if (market_data_websocket_ && !md_batcher_) {
+        md_batcher_ = std::make_unique<SubscriptionBatcher>([this](const SubscriptionMessage &message) { sendBatched(false, message); }, config);
+    }
+    if (user_data_websocket_ && !user_batcher_) {
+        user_batcher_ = std::make_unique<SubscriptionBatcher>([this](const SubscriptionMessage &message) { sendBatched(true, message); }, config);
+    }
+}
+
+void WebSocketClient::resyncLevel2(const std::vector<std::string> &product_ids) {
+    std::lock_guard lock(subscription_mutex_);
+    // one fresh snapshot is enough: with redundancy the other connections'
+    // deltas are arbitrated against the same book
+    Websocket *websocket = nullptr;
+    uint32_t connection = 0;
+    for (; connection < marketDataConnectionCount(); ++connection) {
+        if (marketDataConnection(connection).live) {
+            websocket = marketDataWebsocket(connection);
+            break;
+        }
+    }
+    if (!websocket) {
+        // the replay on reconnect brings new snapshots
+        return;
+    }
+    std::vector<std::string> subscribed;
+    for (const auto &product_id : product_ids) {
+        if (product_ids_[WebSocketChannel::LEVEL2].contains(product_id)) {
+            subscribed.push_back(product_id);
+        }
+    }
+    if (subscribed.empty()) {
+        return;
+    }
+    if (md_arbiter_) {
+        // the snapshot asked for must not be dropped as another connection's
+        md_arbiter_->setSnapshotSource(connection);
+    }
+    for (const char *type : {"unsubscribe", "subscribe"}) {
+        auto message_str = json{{"type", type}, {"product_ids", subscribed}, {"channel", to_string(WebSocketChannel::LEVEL2)}}.dump();
+        websocket->send(message_str.c_str(), message_str.size());
+    }
+}
+
+std::vector<std::string> WebSocketClient::subscriptions(WebSocketChannel channel) const {
+    std::vector<std::string> product_ids;
+    if (channel < WebSocketChannel::_CHANNEL_COUNT_) {
+        std::lock_guard lock(subscription_mutex_);
+        product_ids.assign(product_ids_[channel].begin(), product_ids_[channel].end());
+    }
+    std::sort(product_ids.begin(), product_ids.end());
+    return product_ids;
+}
+
+bool WebSocketClient::isSubscribed(WebSocketChannel channel) const {
+    std::lock_guard lock(subscription_mutex_);
+    return channel < WebSocketChannel::_CHANNEL_COUNT_ && ((subscribed_channels_ >> channel) & 1u);
+}
+
+ResubscribeStats WebSocketClient::marketDataResubscribeStats() const {
+    std::lock_guard lock(subscription_mutex_);
+    return md_connection_.stats;
+}
+
+ResubscribeStats WebSocketClient::userDataResubscribeStats() const {
+    std::lock_guard lock(subscription_mutex_);
+    return user_connection_.stats;
+}
+
+bool WebSocketClient::isLive(bool user, uint32_t except) const noexcept {
+    if (user) {
+        return user_connection_.live;
+    }
+    for (uint32_t i = 0; i < marketDataConnectionCount(); ++i) {
+        if (i != except && (i == 0 ? md_connection_ : md_standbys_[i - 1].connection).live) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WebSocketClient::hasSubscriptions(bool user) const noexcept {
+    constexpr uint32_t user_channels = 1u << WebSocketChannel::USER;
+    return (subscribed_channels_ & (user ? user_channels : ~user_channels)) != 0;
+}
+
+const std::string& WebSocketClient::userJwt() {
+    auto now = std::chrono::steady_clock::now();
+    if (user_jwt_.empty() || now - user_jwt_signed_at_ >= USER_JWT_REUSE) {
+        user_jwt_ = generate_coinbase_jwt(user_data_url_.c_str());
+        user_jwt_signed_at_ = now;
+    }
+    return user_jwt_;
+}
+
+void WebSocketClient::sendSubscribe(Websocket &websocket, WebSocketChannel channel, const std::vector<std::string> &product_ids) {
+    auto subscribe_json = json{{"type", "subscribe"}, {"product_ids", product_ids}, {"channel", to_string(channel)}};
+    if (isUserChannel(channel)) {
+        subscribe_json["jwt"] = userJwt();
+    }
+    auto subscribe_str = subscribe_json.dump();
+    websocket.send(subscribe_str.c_str(), subscribe_str.size());
+}
+
+void WebSocketClient::sendBatched(bool user, const SubscriptionMessage &message) {
+    std::lock_guard lock(subscription_mutex_);
+    if (!isLive(user)) {
+        // dropped with the connection; the reconnect replays the tracked set
+        return;
+    }
+    auto message_json = json{{"type", message.subscribe ? "subscribe" : "unsubscribe"}, {"product_ids", message.product_ids}, {"channel", message.channel}};
+    if (user) {
+        message_json["jwt"] = userJwt();
+    }
+    auto message_str = message_json.dump();
+    forEachConnection(user, [&](Websocket &websocket, Connection &connection) {
+        if (connection.live) {
+            websocket.send(message_str.c_str(), message_str.size());
+        }
+    });
+}
+
+bool WebSocketClient::resubscribe(bool user, uint32_t md_connection) {
+    std::lock_guard lock(subscription_mutex_);
+    auto &connection = user ? user_connection_ : marketDataConnection(md_connection);
+    auto &websocket = user ? *user_data_websocket_ : *marketDataWebsocket(md_connection);
+    auto others_live = !user && isLive(false, md_connection);
+    // the batcher would send the replay to the other live websockets as well
+    auto *batcher = others_live ? nullptr : (user ? user_batcher_ : md_batcher_).get();
+    connection.live = true;
+
+    if (user) {
+        // a new connection gets a fresh token
+        user_jwt_.clear();
+
+        // subscribe heartbeat to keep user channel alive
+        auto heartbeat_sub = json{{"type", "subscribe"}, {"channel", "heartbeats"}};
+        heartbeat_sub["jwt"] = userJwt();
+        auto subscribe_str = heartbeat_sub.dump();
+        websocket.send(subscribe_str.c_str(), subscribe_str.size());
+    }
+
+    bool replayed = false;
+    for (uint8_t i = 0; i < WebSocketChannel::_CHANNEL_COUNT_; ++i) {
+        auto channel = static_cast<WebSocketChannel>(i);
+        if (isUserChannel(channel) != user || ((subscribed_channels_ >> i) & 1u) == 0) {
+            continue;
+        }
+        const auto &products = product_ids_[i];
+        std::vector<std::string> product_ids(products.begin(), products.end());
+        if (batcher) {
+            batcher->subscribe(to_string(channel), product_ids);
+        }
+        else {
+            sendSubscribe(websocket, channel, product_ids);
+        }
+        replayed = true;
+    }
+    if (batcher && replayed) {
+        batcher->flush();
+    }
+
+    if (replayed && connection.disconnected_at != std::chrono::steady_clock::time_point{}) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - connection.disconnected_at);
+        ++connection.stats.count;
+        connection.stats.last = elapsed;
+        connection.stats.max = std::max(connection.stats.max, elapsed);
+        LOG_INFO("{} subscriptions restored {} us after disconnect", user ? "user data" : "market data",
+            std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    }
+    connection.disconnected_at = {};
+    return others_live;
+}
+
+bool WebSocketClient::markDisconnected(bool user, uint32_t md_connection) {
+    std::lock_guard lock(subscription_mutex_);
+    auto &connection = user ? user_connection_ : marketDataConnection(md_connection);
+    connection.live = false;
+    auto others_live = !user && isLive(false, md_connection);
+    if (auto *batcher = (user ? user_batcher_ : md_batcher_).get(); batcher && !others_live) {
+        batcher->clear();
+    }
+    if (hasSubscriptions(user) && connection.disconnected_at == std::chrono::steady_clock::time_point{}) {
+        connection.disconnected_at = std::chrono::steady_clock::now();
+    }
+    return others_live;
+}
+
 void WebSocketClient::logData(std::string_view data_file) {
     data_log_.open(std::string(data_file), std::ios::out | std::ios::app);
     if (data_log_.is_open()) {
@@ -433,6 +969,7 @@ void WebSocketClient::dispatchData(ProducerType pt, const char* data, std::size_
     assert(pt > ProducerType::USER_DATA && (producer_offset_ + pt) < producer_buffers_.size());
     auto *pb = producer_buffers_[producer_offset_ + pt];
     if (pb) [[likely]] {
+        std::lock_guard lock(dispatch_mutex_);
         auto sz = (uint32_t)(MESSAGE_HEADER_SIZE + size);
         void *self = this;
         auto [ptr, n] = pb->prepare(sz);
@@ -475,7 +1012,15 @@ void WebSocketClient::runDataLogger() {
     }
 }
 
-void WebSocketClient::onMarketDataConnected() {
+void WebSocketClient::onMarketDataConnected(uint32_t connection) {
+    auto others_live = resubscribe(false, connection);
+    if (md_arbiter_) {
+        md_arbiter_->connected(connection);
+    }
+    if (others_live) {
+        LOG_INFO("market data connection {} is up, {} connected", connection, md_arbiter_->connectedCount());
+        return;
+    }
     if (user_thread_callbacks_) {
         dispatchData(ProducerType::MD_CTRL, &empty_msg, 1, MessageType::MARKET_CONNECTED);
     }
@@ -484,7 +1029,15 @@ void WebSocketClient::onMarketDataConnected() {
     }
 }
 
-void WebSocketClient::onMarketDataDisconnected() {
+void WebSocketClient::onMarketDataDisconnected(uint32_t connection) {
+    auto others_live = markDisconnected(false, connection);
+    if (md_arbiter_) {
+        md_arbiter_->disconnected(connection);
+    }
+    if (others_live) {
+        LOG_WARN("market data connection {} is down, {} connected", connection, md_arbiter_->connectedCount());
+        return;
+    }
     if (user_thread_callbacks_) {
         dispatchData(ProducerType::MD_CTRL, &empty_msg, 1, MessageType::MARKET_DISCONNECTED);
     }
@@ -496,6 +1049,7 @@ void WebSocketClient::onMarketDataDisconnected() {
 
 
 void WebSocketClient::onUserDataConnected() {
+    resubscribe(true);
     if (user_thread_callbacks_) {
         dispatchData(ProducerType::USER_CTRL, &empty_msg, 1, MessageType::USER_CONNECTED);
     }
@@ -505,6 +1059,7 @@ void WebSocketClient::onUserDataConnected() {
 }
 
 void WebSocketClient::onUserDataDisconnected() {
+    markDisconnected(true);
     if (user_thread_callbacks_) {
         dispatchData(ProducerType::USER_CTRL, &empty_msg, 1, MessageType::USER_DISCONNECTED);
     }
@@ -514,10 +1069,28 @@ void WebSocketClient::onUserDataDisconnected() {
     }
 }
 
-void WebSocketClient::onMarketData(const char* data, std::size_t size) {
-    if (!user_thread_callbacks_) {
-        data_handler_->processMarketData(this, data, size);
+void WebSocketClient::onMarketData(uint32_t connection, const char* data, std::size_t size) {
+    if (user_thread_callbacks_) {
+        return;
     }
+    if (md_arbiter_) {
+        std::lock_guard lock(arbitration_mutex_);
+        std::string_view frame;
+        if (arbitrate(connection, data, size, frame)) {
+            data_handler_->processMarketData(this, frame.data(), frame.size());
+        }
+        return;
+    }
+    data_handler_->processMarketData(this, data, size);
+}
+
+bool WebSocketClient::arbitrate(uint32_t connection, const char* data, std::size_t size, std::string_view &frame) {
+    bool gap = false;
+    auto first = md_arbiter_->accept(connection, data, size, gap, frame);
+    if (gap) {
+        data_handler_->marketDataGap(this);
+    }
+    return first;
 }
 
 void WebSocketClient::onUserData(const char* data, std::size_t size) {
@@ -545,7 +1118,89 @@ void WebSocketClient::onUserDataError(std::string &&err) {
 }
 
 // DataHandler implementation
+namespace {
+
+// DataHandler's sink for decodeMarketData(): the WebsocketCallbacks virtuals
+struct CallbackSink {
+    WebsocketCallbacks *callbacks;
+
+    static constexpr bool decodes(WebSocketChannel) noexcept {
+        return true;
+    }
+    void level2(WebSocketClient *ws_client, uint64_t seq_num, std::string_view product_id, bool snapshot, std::span<const Level2Update> updates, const OrderBook *book) {
+        if (snapshot) {
+            callbacks->onLevel2SnapshotView(ws_client, seq_num, product_id, updates);
+        }
+        else {
+            callbacks->onLevel2UpdatesView(ws_client, seq_num, product_id, updates);
+        }
+        if (book) {
+            callbacks->onOrderBookUpdate(ws_client, seq_num, *book);
+        }
+    }
+    void tickers(WebSocketClient *ws_client, uint64_t seq_num, uint64_t timestamp, bool snapshot, const std::vector<Ticker> &tickers) {
+        if (snapshot) {
+            callbacks->onTickerSnapshot(ws_client, seq_num, timestamp, tickers);
+        }
+        else {
+            callbacks->onTickers(ws_client, seq_num, timestamp, tickers);
+        }
+    }
+    void trades(WebSocketClient *ws_client, uint64_t seq_num, bool snapshot, const std::vector<MarketTrade> &trades) {
+        if (snapshot) {
+            callbacks->onMarketTradesSnapshot(ws_client, seq_num, trades);
+        }
+        else {
+            callbacks->onMarketTrades(ws_client, seq_num, trades);
+        }
+    }
+    void candles(WebSocketClient *ws_client, uint64_t seq_num, uint64_t timestamp, bool snapshot, const std::vector<Candle> &candles) {
+        if (snapshot) {
+            callbacks->onCandlesSnapshot(ws_client, seq_num, timestamp, candles);
+        }
+        else {
+            callbacks->onCandles(ws_client, seq_num, timestamp, candles);
+        }
+    }
+};
+
+}   // end anonymous namespace
+
 void DataHandler::processMarketData(WebSocketClient *ws_client, const char* data, std::size_t size) {
+    if (skipMarketData(ws_client, data, size, ws_client->marketDataInterest().channels)) {
+        return;
+    }
+    if (ws_client->marketDataDecoder() == MarketDataDecoder::ON_DEMAND) {
+        processMarketDataOnDemand(ws_client, data, size);
+    }
+    else {
+        processMarketDataDom(ws_client, data, size);
+    }
+}
+
+bool DataHandler::skipMarketData(WebSocketClient *ws_client, const char* data, std::size_t size, uint32_t channels) {
+    if (recovering_books_ != 0) [[unlikely]] {
+        pollBookFetches(ws_client);
+    }
+    if (MarketDataInterest::containsAll(channels)) [[likely]] {
+        return false;
+    }
+    MarketDataFrame frame;
+    if (!peek_market_data_frame(data, size, frame) || frame.channel.empty()) [[unlikely]] {
+        // errors and malformed frames take the regular path
+        return false;
+    }
+    auto channel = channel_from_frame(frame.channel);
+    if (channel != WebSocketChannel::HEARTBEATS && frame.channel != "subscriptions" && MarketDataInterest::contains(channels, channel)) {
+        return false;
+    }
+    if (frame.has_sequence_num) {
+        checkMarketDataSequenceNumber(ws_client, frame.sequence_num);
+    }
+    return true;
+}
+
+void DataHandler::processMarketDataDom(WebSocketClient *ws_client, const char* data, std::size_t size) {
     try {
         auto j = json::parse(data, data + size);
         if (j.contains("sequence_num")) {
@@ -585,6 +1240,11 @@ void DataHandler::processMarketData(WebSocketClient *ws_client, const char* data
     }
 }
 
+void DataHandler::processMarketDataOnDemand(WebSocketClient *ws_client, const char* data, std::size_t size) {
+    CallbackSink sink{callbacks_};
+    decodeMarketData(ws_client, data, size, sink);
+}
+
 void DataHandler::processUserData(WebSocketClient *ws_client, const char* data, std::size_t size) {
     try {
         auto j = json::parse(data, data + size);
@@ -617,27 +1277,355 @@ void DataHandler::processUserData(WebSocketClient *ws_client, const char* data,
 
 void DataHandler::processLevel2Update(WebSocketClient *ws_client, const json &j) {
     auto seq_num = j["sequence_num"].get<uint64_t>();
+    auto timestamp = j.contains("timestamp") ? j["timestamp"].get<std::string_view>() : std::string_view();
     for (const auto &event : j["events"]) {
-        if (event["type"] == "snapshot") {
-            callbacks_->onLevel2Snapshot(ws_client, seq_num, event);
+        l2_scratch_.product_id.assign(event.at("product_id").get_ref<const std::string&>());
+        l2_scratch_.product_handle = intern_product_id(l2_scratch_.product_id);
+        l2_scratch_.updates.clear();
+        for (const auto &update : event.at("updates")) {
+            from_json(update, l2_scratch_.updates.emplace_back());
         }
-        else if (event["type"] == "update") {
-            callbacks_->onLevel2Updates(ws_client, seq_num, event);
+        processLevel2Event(ws_client, seq_num, timestamp, event["type"].get<std::string_view>(), l2_scratch_.product_id, l2_scratch_.product_handle, l2_scratch_.updates);
+    }
+}
+
+void DataHandler::processLevel2Event(WebSocketClient *ws_client, uint64_t seq_num, std::string_view timestamp, std::string_view type, std::string_view product_id, ProductHandle product_handle, std::span<const Level2Update> updates) {
+    CallbackSink sink{callbacks_};
+    decodeLevel2Event(ws_client, seq_num, timestamp, type, product_id, product_handle, updates, sink);
+}
+
+// Runs the REST_SNAPSHOT fetches of one data handler in order on a single
+// thread, so a burst of recovering books does not start a thread per book and
+// no fetch outlives the handler.
+class DataHandler::BookFetcher {
+public:
+    BookFetcher() : worker_([this] { run(); }) {}
+
+    ~BookFetcher() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_one();
+        worker_.join();
+    }
+
+    void push(std::shared_ptr<BookFetch> fetch) {
+        {
+            std::lock_guard lock(mutex_);
+            queue_.push_back(std::move(fetch));
+        }
+        cv_.notify_one();
+    }
+
+private:
+    void run() {
+        while (true) {
+            std::shared_ptr<BookFetch> fetch;
+            {
+                std::unique_lock lock(mutex_);
+                cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+                if (stop_) {
+                    return;
+                }
+                fetch = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            if (!fetch->cancelled.load(std::memory_order_acquire)) {
+                try {
+                    PriceBook book;
+                    if (fetch->fetch_book(fetch->product_id, book)) {
+                        fetch->book = std::move(book);
+                    }
+                }
+                catch (const std::exception &e) {
+                    LOG_ERROR("failed to fetch the {} book: {}", fetch->product_id, e.what());
+                }
+            }
+            fetch->done.store(true, std::memory_order_release);
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::shared_ptr<BookFetch>> queue_;
+    bool stop_ = false;
+    std::thread worker_;    // last, so it starts after the members it reads
+};
+
+DataHandler::DataHandler() = default;
+DataHandler::~DataHandler() = default;
+
+OrderBook* DataHandler::addOrderBook(const Product &product, uint32_t window_ticks) {
+    if (auto *book = orderBook(product.product_id)) {
+        return book;
+    }
+    if (!(product.quote_increment > 0.) && !(product.price_increment > 0.)) {
+        LOG_ERROR("cannot create order book for {}: invalid quote_increment {}", product.product_id, product.quote_increment);
+        return nullptr;
+    }
+    auto *book = order_books_.emplace_back(std::make_unique<OrderBook>(product, window_ticks)).get();
+    recoveries_.resize(order_books_.size());
+    auto handle = intern_product_id(product.product_id);
+    if (handle >= books_by_handle_.size()) {
+        books_by_handle_.resize(handle + 1, nullptr);
+    }
+    books_by_handle_[handle] = book;
+    return book;
+}
+
+bool DataHandler::isRecovering(const OrderBook &book) const noexcept {
+    for (std::size_t i = 0; i < order_books_.size(); ++i) {
+        if (order_books_[i].get() == &book) {
+            return recoveries_[i].active;
+        }
+    }
+    return false;
+}
+
+void DataHandler::marketDataGap(WebSocketClient *ws_client) {
+    startLevel2Recovery(ws_client);
+    callbacks_->onMarketDataGap(ws_client);
+}
+
+void DataHandler::startLevel2Recovery(WebSocketClient *ws_client) {
+    const auto &config = ws_client->level2Recovery();
+    if (config.mode == Level2Recovery::NONE || order_books_.empty()) {
+        return;
+    }
+    // only books fed by this client's level2 subscriptions
+    auto subscribed = ws_client->subscriptions(WebSocketChannel::LEVEL2);
+    std::vector<std::string> resync;
+    auto now = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < order_books_.size(); ++i) {
+        auto &recovery = recoveries_[i];
+        std::string product_id(order_books_[i]->productId());
+        if (recovery.active || !std::binary_search(subscribed.begin(), subscribed.end(), product_id)) {
+            continue;
+        }
+        recovery.active = true;
+        recovery.started = now;
+        recovery.buffered.clear();
+        ++recovering_books_;
+
+        if (config.mode == Level2Recovery::REST_SNAPSHOT && config.fetch_book) {
+            recovery.mode = Level2Recovery::REST_SNAPSHOT;
+            recovery.fetch = std::make_shared<BookFetch>();
+            recovery.fetch->product_id = product_id;
+            recovery.fetch->fetch_book = config.fetch_book;
+            if (!book_fetcher_) {
+                book_fetcher_ = std::make_unique<BookFetcher>();
+            }
+            book_fetcher_->push(recovery.fetch);
         }
         else {
-            LOG_WARN("unknown l2_data event type: {}", event["type"].get<std::string_view>());
+            recovery.mode = Level2Recovery::RESUBSCRIBE;
+            resync.push_back(std::move(product_id));
+        }
+    }
+    if (!resync.empty()) {
+        ws_client->resyncLevel2(resync);
+    }
+}
+
+bool DataHandler::applyLevel2Recovering(WebSocketClient *ws_client, OrderBook &book, bool snapshot, uint64_t seq_num, std::span<const Level2Update> updates) {
+    std::size_t i = 0;
+    while (i < order_books_.size() && order_books_[i].get() != &book) {
+        ++i;
+    }
+    if (i == order_books_.size() || !recoveries_[i].active) {
+        if (snapshot) {
+            book.applySnapshot(updates, seq_num);
         }
+        else {
+            book.applyUpdates(updates, seq_num);
+        }
+        return true;
+    }
+
+    auto &recovery = recoveries_[i];
+    if (snapshot) {
+        // a snapshot from the resubscription (or a reconnect) replaces everything
+        book.applySnapshot(updates, seq_num);
+        finishLevel2Recovery(ws_client, book, recovery);
+        return true;
     }
+    if (recovery.mode == Level2Recovery::RESUBSCRIBE) {
+        // superseded by the snapshot on its way
+        return false;
+    }
+
+    recovery.buffered.insert(recovery.buffered.end(), updates.begin(), updates.end());
+    return completeBookFetch(ws_client, i, seq_num, std::chrono::steady_clock::now());
+}
+
+bool DataHandler::completeBookFetch(WebSocketClient *ws_client, std::size_t i, uint64_t seq_num, std::chrono::steady_clock::time_point now) {
+    auto &book = *order_books_[i];
+    auto &recovery = recoveries_[i];
+    auto done = recovery.fetch->done.load(std::memory_order_acquire);
+    if (!done && now - recovery.started < ws_client->level2Recovery().fetch_timeout) {
+        return false;
+    }
+    auto &price_book = recovery.fetch->book;
+    if (!done || !price_book) {
+        LOG_WARN("{} REST book for {}, resubscribing level2", done ? "no" : "timed out waiting for the", book.productId());
+        recovery.mode = Level2Recovery::RESUBSCRIBE;
+        recovery.buffered.clear();
+        cancelBookFetch(recovery);
+        ws_client->resyncLevel2({std::string(book.productId())});
+        return false;
+    }
+
+    // rebuild in one step on this thread: the REST levels, then the deltas
+    // newer than the REST book (levels carry absolute quantities)
+    std::vector<Level2Update> levels;
+    levels.reserve(price_book->bids.size() + price_book->asks.size());
+    for (const auto &level : price_book->bids) {
+        levels.push_back(Level2Update{price_book->time, Side::BUY, level.price, level.size});
+    }
+    for (const auto &level : price_book->asks) {
+        levels.push_back(Level2Update{price_book->time, Side::SELL, level.price, level.size});
+    }
+    book.applySnapshot(levels, seq_num);
+    levels.clear();
+    for (const auto &update : recovery.buffered) {
+        if (update.event_time >= price_book->time) {
+            levels.push_back(update);
+        }
+    }
+    book.applyUpdates(levels, seq_num);
+    finishLevel2Recovery(ws_client, book, recovery);
+    return true;
+}
+
+void DataHandler::pollBookFetches(WebSocketClient *ws_client) {
+    auto now = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < order_books_.size(); ++i) {
+        if (recoveries_[i].active && recoveries_[i].mode == Level2Recovery::REST_SNAPSHOT) {
+            completeBookFetch(ws_client, i, order_books_[i]->sequenceNum(), now);
+        }
+    }
+}
+
+void DataHandler::cancelBookFetch(BookRecovery &recovery) {
+    if (recovery.fetch) {
+        // the fetcher keeps its own reference until the fetch is done
+        recovery.fetch->cancelled.store(true, std::memory_order_release);
+        recovery.fetch.reset();
+    }
+}
+
+void DataHandler::finishLevel2Recovery(WebSocketClient *ws_client, OrderBook &book, BookRecovery &recovery) {
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - recovery.started);
+    recovery.active = false;
+    recovery.mode = Level2Recovery::NONE;
+    recovery.buffered.clear();
+    cancelBookFetch(recovery);
+    --recovering_books_;
+    LOG_INFO("order book {} recovered {} us after a market data gap", book.productId(),
+        std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+    callbacks_->onOrderBookRecovered(ws_client, book, duration);
+}
+
+bool DataHandler::publishesMarketData(const WebSocketClient *ws_client) noexcept {
+    return ws_client->marketDataRecordWriter() || ws_client->topOfBookWriter() || ws_client->productActivity();
+}
+
+void DataHandler::recordActivity(WebSocketClient *ws_client, ProductActivityTracker &activity, ProductHandle product_handle, uint64_t seq_num, uint64_t event_time, uint64_t now) {
+    if (activity.record(product_handle, seq_num, event_time, now)) [[unlikely]] {
+        callbacks_->onProductActive(ws_client, product_handle);
+    }
+}
+
+void DataHandler::publishLevel2(WebSocketClient *ws_client, uint64_t seq_num, std::string_view timestamp, bool snapshot, std::string_view product_id, ProductHandle product_handle, std::span<const Level2Update> updates, const OrderBook *book) {
+    if (auto *records = ws_client->marketDataRecordWriter()) {
+        records->writeLevel2(seq_num, to_nanoseconds(timestamp), snapshot, product_id, updates);
+    }
+    if (auto *activity = ws_client->productActivity()) {
+        recordActivity(ws_client, *activity, product_handle, seq_num, to_nanoseconds(timestamp), ProductActivityTracker::now());
+    }
+    // deltas alone carry no top of book, only a maintained book does
+    if (auto *top = ws_client->topOfBookWriter(); top && book) {
+        top->update(*book);
+    }
+}
+
+void DataHandler::publishTickers(WebSocketClient *ws_client, uint64_t seq_num, uint64_t timestamp, bool snapshot, std::span<const Ticker> tickers) {
+    if (auto *records = ws_client->marketDataRecordWriter()) {
+        records->writeTickers(seq_num, timestamp, snapshot, tickers);
+    }
+    if (auto *top = ws_client->topOfBookWriter()) {
+        for (const auto &ticker : tickers) {
+            top->update(ticker, timestamp);
+        }
+    }
+    if (auto *activity = ws_client->productActivity()) {
+        auto now = ProductActivityTracker::now();
+        for (const auto &ticker : tickers) {
+            recordActivity(ws_client, *activity, ticker.product_handle, seq_num, timestamp, now);
+        }
+    }
+}
+
+void DataHandler::publishTrades(WebSocketClient *ws_client, uint64_t seq_num, std::string_view timestamp, bool snapshot, std::span<const MarketTrade> trades) {
+    if (auto *records = ws_client->marketDataRecordWriter()) {
+        records->writeTrades(seq_num, to_nanoseconds(timestamp), snapshot, trades);
+    }
+    if (auto *top = ws_client->topOfBookWriter()) {
+        for (const auto &trade : trades) {
+            top->update(trade);
+        }
+    }
+    if (auto *activity = ws_client->productActivity()) {
+        auto event_time = to_nanoseconds(timestamp);
+        auto now = ProductActivityTracker::now();
+        for (const auto &trade : trades) {
+            recordActivity(ws_client, *activity, trade.product_handle, seq_num, event_time, now);
+        }
+    }
+}
+
+void DataHandler::publishCandles(WebSocketClient *ws_client, uint64_t seq_num, uint64_t timestamp, bool snapshot, std::span<const Candle> candles) {
+    if (auto *records = ws_client->marketDataRecordWriter()) {
+        records->writeCandles(seq_num, timestamp, snapshot, candles);
+    }
+    if (auto *activity = ws_client->productActivity()) {
+        auto now = ProductActivityTracker::now();
+        for (const auto &candle : candles) {
+            recordActivity(ws_client, *activity, candle.product_handle, seq_num, timestamp, now);
+        }
+    }
+}
+
+void DataHandler::publishOrders(WebSocketClient *ws_client, uint64_t seq_num, std::string_view timestamp, bool snapshot, std::span<const Order> orders) {
+    if (auto *records = ws_client->userDataRecordWriter()) {
+        records->writeOrders(seq_num, to_nanoseconds(timestamp), snapshot, orders);
+    }
+}
+
+OrderBook* DataHandler::orderBook(std::string_view product_id) const noexcept {
+    // a handful of books per handler, a linear scan beats hashing
+    for (const auto &book : order_books_) {
+        if (book->productId() == product_id) {
+            return book.get();
+        }
+    }
+    return nullptr;
 }
 
 void DataHandler::processTicker(WebSocketClient *ws_client, const json &j) {
     auto seq_num = j["sequence_num"].get<uint64_t>();
+    auto timestamp = to_nanoseconds(j["timestamp"].get<std::string_view>());
     for (const auto &event : j["events"]) {
         if (event["type"] == "snapshot") {
-            callbacks_->onTickerSnapshot(ws_client, seq_num, to_nanoseconds(j["timestamp"]), event["tickers"]);
+            event["tickers"].get_to(ticker_scratch_);
+            publishTickers(ws_client, seq_num, timestamp, true, ticker_scratch_);
+            callbacks_->onTickerSnapshot(ws_client, seq_num, timestamp, ticker_scratch_);
         }
         else if (event["type"] == "update") {
-            callbacks_->onTickers(ws_client, seq_num, to_nanoseconds(j["timestamp"]), event["tickers"]);
+            event["tickers"].get_to(ticker_scratch_);
+            publishTickers(ws_client, seq_num, timestamp, false, ticker_scratch_);
+            callbacks_->onTickers(ws_client, seq_num, timestamp, ticker_scratch_);
         }
         else {
             LOG_WARN("unknown ticker event type: {}", j["type"].get<std::string_view>());
@@ -647,12 +1635,17 @@ void DataHandler::processTicker(WebSocketClient *ws_client, const json &j) {
 
 void DataHandler::processMarketTrades(WebSocketClient *ws_client, const json &j) {
     auto seq_num = j["sequence_num"].get<uint64_t>();
+    auto timestamp = j.contains("timestamp") ? j["timestamp"].get<std::string_view>() : std::string_view();
     for (const auto &event : j["events"]) {
         if (event["type"] == "snapshot") {
-            callbacks_->onMarketTradesSnapshot(ws_client, seq_num, event["trades"]);
+            event["trades"].get_to(trade_scratch_);
+            publishTrades(ws_client, seq_num, timestamp, true, trade_scratch_);
+            callbacks_->onMarketTradesSnapshot(ws_client, seq_num, trade_scratch_);
         }
         else if (event["type"] == "update") {
-            callbacks_->onMarketTrades(ws_client, seq_num, event["trades"]);
+            event["trades"].get_to(trade_scratch_);
+            publishTrades(ws_client, seq_num, timestamp, false, trade_scratch_);
+            callbacks_->onMarketTrades(ws_client, seq_num, trade_scratch_);
         }
         else {
             LOG_WARN("unknown market_trades event type: {}", event["type"].get<std::string_view>());
@@ -661,12 +1654,18 @@ void DataHandler::processMarketTrades(WebSocketClient *ws_client, const json &j)
 }
 
 void DataHandler::processCandles(WebSocketClient *ws_client, const json &j) {
+    auto seq_num = j["sequence_num"].get<uint64_t>();
+    auto timestamp = to_nanoseconds(j["timestamp"].get<std::string_view>());
     for (const auto &event : j["events"]) {
         if (event["type"] == "snapshot") {
-            callbacks_->onCandlesSnapshot(ws_client, j["sequence_num"].get<uint64_t>(), to_nanoseconds(j["timestamp"]), event["candles"]);
+            event["candles"].get_to(candle_scratch_);
+            publishCandles(ws_client, seq_num, timestamp, true, candle_scratch_);
+            callbacks_->onCandlesSnapshot(ws_client, seq_num, timestamp, candle_scratch_);
         }
         else if (event["type"] == "update") {
-            callbacks_->onCandles(ws_client, j["sequence_num"].get<uint64_t>(), to_nanoseconds(j["timestamp"]), event["candles"]);
+            event["candles"].get_to(candle_scratch_);
+            publishCandles(ws_client, seq_num, timestamp, false, candle_scratch_);
+            callbacks_->onCandles(ws_client, seq_num, timestamp, candle_scratch_);
         }
         else {
             LOG_WARN("unknown candles event type: {}", j["type"].get<std::string_view>());
@@ -677,10 +1676,14 @@ void DataHandler::processCandles(WebSocketClient *ws_client, const json &j) {
 void DataHandler::processStatus(WebSocketClient *ws_client, const json &j) {
     for (const auto &event : j["events"]) {
         if (event["type"] == "snapshot") {
-            callbacks_->onStatusSnapshot(ws_client, j["sequence_num"].get<uint64_t>(), to_nanoseconds(j["timestamp"]), event["products"]);
+            std::vector<Status> status = event["products"];
+            ProductCatalog::instance().update(status);
+            callbacks_->onStatusSnapshot(ws_client, j["sequence_num"].get<uint64_t>(), to_nanoseconds(j["timestamp"].get<std::string_view>()), status);
         }
         else if (event["type"] == "update") {
-            callbacks_->onStatus(ws_client, j["sequence_num"].get<uint64_t>(), to_nanoseconds(j["timestamp"]), event["products"]);
+            std::vector<Status> status = event["products"];
+            ProductCatalog::instance().update(status);
+            callbacks_->onStatus(ws_client, j["sequence_num"].get<uint64_t>(), to_nanoseconds(j["timestamp"].get<std::string_view>()), status);
         }
         else {
             LOG_WARN("unknown status event type: {}", j["type"].get<std::string_view>());
@@ -689,6 +1692,7 @@ void DataHandler::processStatus(WebSocketClient *ws_client, const json &j) {
 }
 
 void DataHandler::processUserEvent(WebSocketClient *ws_client, const json &j) {
+    auto timestamp = j.contains("timestamp") ? j["timestamp"].get<std::string_view>() : std::string_view();
     for (auto& event : j["events"]) {
         std::vector<Order> orders;
         for (auto& order : event.at("orders")) {
@@ -696,10 +1700,12 @@ void DataHandler::processUserEvent(WebSocketClient *ws_client, const json &j) {
             from_snapshot(order, orders.back());
         }
         if (event["type"] == "snapshot") {
+            publishOrders(ws_client, j.at("sequence_num").get<uint64_t>(), timestamp, true, orders);
             auto &positions = event.at("positions");
             callbacks_->onUserDataSnapshot(ws_client, j.at("sequence_num").get<uint64_t>(), orders, positions.at("perpetual_futures_positions"), positions.at("expiring_futures_positions"));
         }
         else if (event["type"] == "update") {
+            publishOrders(ws_client, j.at("sequence_num").get<uint64_t>(), timestamp, false, orders);
             callbacks_->onOrderUpdates(ws_client, j.at("sequence_num").get<uint64_t>(), orders);
         }
         else {
@@ -712,14 +1718,20 @@ bool DataHandler::processHeartbeat([[maybe_unused]] WebSocketClient *ws_client,
     return true;
 }
 
-bool DataHandler::checkMarketDataSequenceNumber([[maybe_unused]] WebSocketClient* ws_client, int64_t seq_num) {
+bool DataHandler::checkMarketDataSequenceNumber(WebSocketClient* ws_client, int64_t seq_num) {
+    if (ws_client->marketDataRedundancyEnabled()) {
+        // checked per connection by the arbiter
+        return true;
+    }
     if (last_md_seq_num_ < 0) [[unlikely]] {
         last_md_seq_num_ = seq_num;
         return true;
     }
     if (seq_num != last_md_seq_num_ + 1) {
         LOG_ERROR("market data message lost. seq_num: {}, last_md_seq_num: {}", seq_num, last_md_seq_num_);
-        callbacks_->onMarketDataGap(ws_client);
+        // count on from here, so one lost frame is reported once
+        last_md_seq_num_ = seq_num;
+        marketDataGap(ws_client);
         return false;
     }
     last_md_seq_num_ = seq_num;
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <random>
+#include <unordered_map>
+#include <coinbase/fixed_point.hpp>
+#include <coinbase/order_book.hpp>
+
+namespace coinbase::tests {
+
+class FixedPointTests : public ::testing::Test {};
+
+TEST_F(FixedPointTests, ScaleFromIncrement) {
+    DecimalScale cents(0.01);
+    EXPECT_EQ(cents.decimals(), 2u);
+    EXPECT_EQ(cents.units(), 1);
+    EXPECT_EQ(cents.increment(), 0.01);
+
+    DecimalScale satoshi(0.00000001);
+    EXPECT_EQ(satoshi.decimals(), 8u);
+    EXPECT_EQ(satoshi.units(), 1);
+
+    DecimalScale five(5.);
+    EXPECT_EQ(five.decimals(), 0u);
+    EXPECT_EQ(five.units(), 5);
+
+    DecimalScale half_cent(0.05);
+    EXPECT_EQ(half_cent.decimals(), 2u);
+    EXPECT_EQ(half_cent.units(), 5);
+
+    Product product{};
+    product.quote_increment = 0.01;
+    product.base_increment = 0.00000001;
+    EXPECT_EQ(price_scale(product), cents);
+    EXPECT_EQ(quantity_scale(product), satoshi);
+}
+
+TEST_F(FixedPointTests, ParseWireStrings) {
+    DecimalScale cents(0.01);
+    Price p;
+    ASSERT_TRUE(cents.parse("72575.01", p));
+    EXPECT_EQ(p.value, 7257501);
+    ASSERT_TRUE(cents.parse("72575", p));
+    EXPECT_EQ(p.value, 7257500);
+    ASSERT_TRUE(cents.parse("72575.1", p));
+    EXPECT_EQ(p.value, 7257510);
+    ASSERT_TRUE(cents.parse("72575.010000", p));
+    EXPECT_EQ(p.value, 7257501);
+    ASSERT_TRUE(cents.parse("-0.5", p));
+    EXPECT_EQ(p.value, -50);
+    ASSERT_TRUE(cents.parse(".25", p));
+    EXPECT_EQ(p.value, 25);
+
+    // off-grid values round to the nearest increment
+    ASSERT_TRUE(cents.parse("1.005", p));
+    EXPECT_EQ(p.value, 101);
+    ASSERT_TRUE(cents.parse("1.0049", p));
+    EXPECT_EQ(p.value, 100);
+    DecimalScale nickels(0.05);
+    ASSERT_TRUE(nickels.parse("2000.07", p));
+    EXPECT_EQ(p.value, 40001);
+    ASSERT_TRUE(nickels.parse("2000.08", p));
+    EXPECT_EQ(p.value, 40002);
+
+    Qty q = DecimalScale(0.00000001).parse<QtyTag>("0.12345678");
+    EXPECT_EQ(q.value, 12345678);
+}
+
+TEST_F(FixedPointTests, ParseInvalid) {
+    DecimalScale cents(0.01);
+    Price p(42);
+    EXPECT_FALSE(cents.parse("", p));
+    EXPECT_FALSE(cents.parse("-", p));
+    EXPECT_FALSE(cents.parse(".", p));
+    EXPECT_FALSE(cents.parse("1e-8", p));
+    EXPECT_FALSE(cents.parse("1.2.3", p));
+    EXPECT_FALSE(cents.parse("12 ", p));
+    EXPECT_FALSE(cents.parse("123456789012345678", p));   // does not fit 10^18
+    EXPECT_FALSE(cents.parse("123456789012345678901234", p));
+    EXPECT_FALSE(cents.parse("-99999999999999999999.99", p));
+    EXPECT_FALSE(DecimalScale(1.).parse("99999999999999999999", p));
+    EXPECT_EQ(p.value, 42);
+}
+
+TEST_F(FixedPointTests, Formatting) {
+    DecimalScale cents(0.01);
+    EXPECT_EQ(cents.toString(Price(7257501)), "72575.01");
+    EXPECT_EQ(cents.toString(Price(5)), "0.05");
+    EXPECT_EQ(cents.toString(Price(-50)), "-0.50");
+    EXPECT_EQ(DecimalScale(5.).toString(Price(3)), "15");
+    EXPECT_EQ(DecimalScale(0.00000001).toString(Qty(1)), "0.00000001");
+    EXPECT_EQ(to_string(72575.014, cents), "72575.01");
+    EXPECT_EQ(to_string(72575.01, cents), to_string(72575.01, 0.01));
+}
+
+// Round trip through the wire string yields the same double parse_double
+// produces, and the same integer from the double.
+TEST_F(FixedPointTests, MatchesParseDouble) {
+    DecimalScale scale(0.00000001);
+    std::mt19937_64 rng(11);
+    char buf[64];
+    for (int i = 0; i < 100000; ++i) {
+        auto integer = rng() % 1000000ULL;
+        auto fraction = rng() % 100000000ULL;
+        int n = std::snprintf(buf, sizeof(buf), "%llu.%08llu", static_cast<unsigned long long>(integer), static_cast<unsigned long long>(fraction));
+        std::string_view sv(buf, static_cast<std::size_t>(n));
+        Qty q;
+        ASSERT_TRUE(scale.parse(sv, q)) << buf;
+        ASSERT_EQ(q.value, static_cast<int64_t>(integer * 100000000ULL + fraction)) << buf;
+        ASSERT_EQ(scale.toDouble(q), to_double(sv)) << buf;
+        ASSERT_EQ(scale.fromDouble<QtyTag>(to_double(sv)), q) << buf;
+        ASSERT_EQ(scale.fromDouble<QtyTag>(to_double(sv), DecimalScale::Rounding::TOWARD_ZERO), q) << buf;
+        ASSERT_EQ(scale.toString(q), sv);
+    }
+}
+
+// Sizes round toward zero; doubles that are not finite or do not fit are rejected.
+TEST_F(FixedPointTests, FromDoubleRoundingAndRange) {
+    DecimalScale cents(0.01);
+    Qty q;
+    ASSERT_TRUE(cents.fromDouble(0.015, q, DecimalScale::Rounding::TOWARD_ZERO));
+    EXPECT_EQ(q.value, 1);
+    ASSERT_TRUE(cents.fromDouble(-0.019, q, DecimalScale::Rounding::TOWARD_ZERO));
+    EXPECT_EQ(q.value, -1);
+    ASSERT_TRUE(cents.fromDouble(0.29, q, DecimalScale::Rounding::TOWARD_ZERO));
+    EXPECT_EQ(q.value, 29);
+    ASSERT_TRUE(cents.fromDouble(0.015, q));
+    EXPECT_EQ(q.value, 2);
+
+    DecimalScale nickels(0.05);
+    ASSERT_TRUE(nickels.fromDouble(0.19, q, DecimalScale::Rounding::TOWARD_ZERO));
+    EXPECT_EQ(q.value, 3);
+
+    EXPECT_FALSE(cents.fromDouble(NAN, q));
+    EXPECT_FALSE(cents.fromDouble(INFINITY, q));
+    EXPECT_FALSE(cents.fromDouble(-INFINITY, q, DecimalScale::Rounding::TOWARD_ZERO));
+    EXPECT_FALSE(cents.fromDouble(1e17, q));
+    EXPECT_TRUE(cents.fromDouble(1e16, q));
+    EXPECT_EQ(cents.toString(q), "10000000000000000.00");
+    EXPECT_EQ(cents.fromDouble(NAN).value, 0);
+}
+
+TEST_F(FixedPointTests, HashableKeys) {
+    DecimalScale cents(0.01);
+    std::unordered_map<Price, double> levels;
+    levels[cents.parse("100.10")] = 1.;
+    levels[cents.parse("100.1")] += 2.;
+    levels[cents.fromDouble(0.1 + 0.2 + 99.8)] += 4.;
+    ASSERT_EQ(levels.size(), 1u);
+    EXPECT_EQ(levels.begin()->second, 7.);
+    EXPECT_LT(cents.parse("100.09"), cents.parse("100.1"));
+}
+
+TEST_F(FixedPointTests, OrderBookByPrice) {
+    OrderBook book("BTC-USD", 0.01, 64);
+    auto price = book.priceScale().parse("100.01");
+    book.apply(Side::BUY, price, 2.);
+    EXPECT_EQ(book.quantityAt(Side::BUY, price), 2.);
+    EXPECT_EQ(book.quantityAt(Side::BUY, 100.01), 2.);
+    EXPECT_EQ(book.bestBid()->price, 100.01);
+    book.apply(Side::BUY, price, 0.);
+    EXPECT_TRUE(book.empty(Side::BUY));
+}
+
+} // namespace coinbase::tests
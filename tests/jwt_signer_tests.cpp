@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/ecdsa.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <coinbase/auth.hpp>
+#include <coinbase/jwt_token_cache.hpp>
+
+using json = nlohmann::json;
+
+namespace coinbase::tests {
+
+namespace {
+
+std::string base64url_decode(std::string_view s) {
+    auto value = [](char c) -> int {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if (c >= '0' && c <= '9') return c - '0' + 52;
+        return c == '-' ? 62 : 63;
+    };
+    std::string out;
+    uint32_t bits = 0;
+    int count = 0;
+    for (char c : s) {
+        bits = (bits << 6) | static_cast<uint32_t>(value(c));
+        count += 6;
+        if (count >= 8) {
+            count -= 8;
+            out += static_cast<char>((bits >> count) & 0xff);
+        }
+    }
+    return out;
+}
+
+std::vector<std::string> split_token(const std::string &token) {
+    std::vector<std::string> parts;
+    std::size_t start = 0;
+    for (auto pos = token.find('.'); pos != std::string::npos; pos = token.find('.', start)) {
+        parts.push_back(token.substr(start, pos - start));
+        start = pos + 1;
+    }
+    parts.push_back(token.substr(start));
+    return parts;
+}
+
+}   // end anonymous namespace
+
+class JwtSignerTests : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto *pctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+        ASSERT_NE(pctx, nullptr);
+        ASSERT_EQ(EVP_PKEY_keygen_init(pctx), 1);
+        ASSERT_EQ(EVP_PKEY_CTX_set_ec_paramgen_curve_nid(pctx, NID_X9_62_prime256v1), 1);
+        ASSERT_EQ(EVP_PKEY_keygen(pctx, &key_), 1);
+        EVP_PKEY_CTX_free(pctx);
+
+        BIO *bio = BIO_new(BIO_s_mem());
+        PEM_write_bio_PrivateKey(bio, key_, nullptr, nullptr, 0, nullptr, nullptr);
+        char *data = nullptr;
+        auto len = BIO_get_mem_data(bio, &data);
+        pem_.assign(data, static_cast<std::size_t>(len));
+        BIO_free(bio);
+    }
+
+    void TearDown() override {
+        EVP_PKEY_free(key_);
+    }
+
+    bool verify(const std::string &token) {
+        auto pos = token.rfind('.');
+        auto raw = base64url_decode(std::string_view(token).substr(pos + 1));
+        if (raw.size() != 64) {
+            return false;
+        }
+        ECDSA_SIG *sig = ECDSA_SIG_new();
+        ECDSA_SIG_set0(sig,
+            BN_bin2bn(reinterpret_cast<const unsigned char*>(raw.data()), 32, nullptr),
+            BN_bin2bn(reinterpret_cast<const unsigned char*>(raw.data()) + 32, 32, nullptr));
+        unsigned char *der = nullptr;
+        auto der_len = i2d_ECDSA_SIG(sig, &der);
+        ECDSA_SIG_free(sig);
+
+        auto *ctx = EVP_MD_CTX_new();
+        EVP_DigestVerifyInit(ctx, nullptr, EVP_sha256(), nullptr, key_);
+        auto ok = EVP_DigestVerify(ctx, der, static_cast<std::size_t>(der_len),
+            reinterpret_cast<const unsigned char*>(token.data()), pos) == 1;
+        EVP_MD_CTX_free(ctx);
+        OPENSSL_free(der);
+        return ok;
+    }
+
+    EVP_PKEY *key_ = nullptr;
+    std::string pem_;
+};
+
+TEST_F(JwtSignerTests, SignsVerifiableToken) {
+    JwtSigner signer("organizations/org/apiKeys/key", pem_);
+    ASSERT_TRUE(signer.isValid());
+
+    auto token = signer.sign("GET api.coinbase.com/api/v3/brokerage/accounts", 1700000000);
+    auto parts = split_token(token);
+    ASSERT_EQ(parts.size(), 3u);
+    EXPECT_TRUE(verify(token));
+
+    auto header = json::parse(base64url_decode(parts[0]));
+    EXPECT_EQ(header["alg"], "ES256");
+    EXPECT_EQ(header["typ"], "JWT");
+    EXPECT_EQ(header["kid"], "organizations/org/apiKeys/key");
+    EXPECT_EQ(header["nonce"].get<std::string>().size(), 16u);
+
+    auto payload = json::parse(base64url_decode(parts[1]));
+    EXPECT_EQ(payload["iss"], "cdp");
+    EXPECT_EQ(payload["sub"], "organizations/org/apiKeys/key");
+    EXPECT_EQ(payload["nbf"], 1700000000);
+    EXPECT_EQ(payload["exp"], 1700000000 + JwtSigner::LIFETIME_SECONDS);
+    EXPECT_EQ(payload["uri"], "GET api.coinbase.com/api/v3/brokerage/accounts");
+}
+
+TEST_F(JwtSignerTests, NonceAndUri) {
+    // key names of every length exercise each base64 alignment of the constant prefixes
+    for (std::string name = "k"; name.size() < 8; name += 'x') {
+        JwtSigner signer(name, pem_);
+        auto first = split_token(signer.sign());
+        auto second = split_token(signer.sign());
+        ASSERT_EQ(first.size(), 3u);
+        auto header1 = json::parse(base64url_decode(first[0]));
+        auto header2 = json::parse(base64url_decode(second[0]));
+        EXPECT_EQ(header1["kid"], name);
+        EXPECT_NE(header1["nonce"], header2["nonce"]);
+
+        auto payload = json::parse(base64url_decode(first[1]));
+        EXPECT_EQ(payload["sub"], name);
+        EXPECT_FALSE(payload.contains("uri"));
+    }
+
+    JwtSigner signer("key", pem_);
+    auto token = signer.sign(R"(GET host/path?a="b"\c)");
+    EXPECT_TRUE(verify(token));
+    auto payload = json::parse(base64url_decode(split_token(token)[1]));
+    EXPECT_EQ(payload["uri"], R"(GET host/path?a="b"\c)");
+}
+
+TEST_F(JwtSignerTests, InvalidKey) {
+    JwtSigner signer("key", "not a pem");
+    EXPECT_FALSE(signer.isValid());
+    EXPECT_TRUE(signer.sign("GET host/path").empty());
+}
+
+TEST_F(JwtSignerTests, TokenCacheServesPresignedToken) {
+    JwtSigner signer("key", pem_);
+    JwtTokenCache cache(signer);
+    cache.add("POST api.coinbase.com/api/v3/brokerage/orders");
+    cache.add("POST api.coinbase.com/api/v3/brokerage/orders");
+    EXPECT_EQ(cache.size(), 1u);
+
+    auto first = cache.authorization("POST api.coinbase.com/api/v3/brokerage/orders");
+    auto second = cache.authorization("POST api.coinbase.com/api/v3/brokerage/orders");
+    ASSERT_EQ(first.rfind("Bearer ", 0), 0u);
+    EXPECT_EQ(first, second);
+    auto token = first.substr(7);
+    EXPECT_TRUE(verify(token));
+    auto payload = json::parse(base64url_decode(split_token(token)[1]));
+    EXPECT_EQ(payload["uri"], "POST api.coinbase.com/api/v3/brokerage/orders");
+
+    // uris that were not added are signed on every call
+    auto a = cache.authorization("GET api.coinbase.com/api/v3/brokerage/accounts");
+    auto b = cache.authorization("GET api.coinbase.com/api/v3/brokerage/accounts");
+    EXPECT_NE(a, b);
+    EXPECT_TRUE(verify(b.substr(7)));
+}
+
+TEST_F(JwtSignerTests, TokenCacheRefreshes) {
+    JwtSigner signer("key", pem_);
+    JwtTokenCache cache(signer, std::chrono::milliseconds(20));
+    cache.add("POST api.coinbase.com/api/v3/brokerage/orders/batch_cancel");
+    auto first = cache.authorization("POST api.coinbase.com/api/v3/brokerage/orders/batch_cancel");
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    auto current = first;
+    while (current == first && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        current = cache.authorization("POST api.coinbase.com/api/v3/brokerage/orders/batch_cancel");
+    }
+    EXPECT_NE(current, first);
+    EXPECT_TRUE(verify(current.substr(7)));
+}
+
+TEST_F(JwtSignerTests, TokenCacheInvalidKey) {
+    JwtSigner signer("key", "not a pem");
+    JwtTokenCache cache(signer);
+    EXPECT_THROW(cache.add("POST api.coinbase.com/api/v3/brokerage/orders"), std::runtime_error);
+    EXPECT_THROW(cache.authorization("POST api.coinbase.com/api/v3/brokerage/orders"), std::runtime_error);
+}
+
+}
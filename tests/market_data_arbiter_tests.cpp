@@ -0,0 +1,265 @@
+#include <gtest/gtest.h>
+#include <initializer_list>
+#include <string>
+#include <coinbase/market_data_arbiter.hpp>
+
+namespace coinbase::tests {
+
+namespace {
+
+std::string ticker_frame(std::string_view client_id, uint64_t seq_num, std::string_view price) {
+    std::string frame = R"({"channel":"ticker","client_id":")";
+    frame.append(client_id).append(R"(","timestamp":"2026-03-05T09:05:32.48356944)");
+    frame += std::to_string(seq_num % 10);
+    frame += R"(Z","sequence_num":)";
+    frame += std::to_string(seq_num);
+    frame += R"(,"events":[{"type":"update","tickers":[{"type":"ticker","product_id":"BTC-USD","price":")";
+    frame.append(price).append(R"("}]}]})");
+    return frame;
+}
+
+std::string l2_frame(std::string_view client_id, uint64_t seq_num, std::string_view type, std::string_view price, std::string_view quantity) {
+    std::string frame = R"({"channel":"l2_data","client_id":")";
+    frame.append(client_id).append(R"(","timestamp":"2026-03-05T09:05:35Z","sequence_num":)");
+    frame += std::to_string(seq_num);
+    frame += R"(,"events":[{"type":")";
+    frame.append(type).append(R"(","product_id":"BTC-USD","updates":[{"side":"bid","event_time":"2026-03-05T09:05:35Z","price_level":")");
+    frame.append(price).append(R"(","new_quantity":")");
+    frame.append(quantity).append(R"("}]}]})");
+    return frame;
+}
+
+std::string events_frame(std::string_view channel, std::string_view client_id, uint64_t seq_num, std::string_view events) {
+    std::string frame = R"({"channel":")";
+    frame.append(channel).append(R"(","client_id":")");
+    frame.append(client_id).append(R"(","timestamp":"2026-03-05T09:05:35Z","sequence_num":)");
+    frame += std::to_string(seq_num);
+    frame.append(R"(,"events":[)").append(events).append("]}");
+    return frame;
+}
+
+std::string join(std::initializer_list<std::string> values) {
+    std::string joined;
+    for (const auto &value : values) {
+        if (!joined.empty()) {
+            joined += ',';
+        }
+        joined += value;
+    }
+    return joined;
+}
+
+std::string trade(std::string_view trade_id, std::string_view price) {
+    std::string trade = R"({"trade_id":")";
+    trade.append(trade_id).append(R"(","product_id":"BTC-USD","price":")");
+    trade.append(price).append(R"(","size":"0.1","side":"BUY","time":"2026-03-05T09:05:35Z"})");
+    return trade;
+}
+
+std::string trades_frame(std::string_view client_id, uint64_t seq_num, std::initializer_list<std::string> trades) {
+    return events_frame("market_trades", client_id, seq_num, R"({"type":"update","trades":[)" + join(trades) + "]}");
+}
+
+std::string level2_update(std::string_view price, std::string_view quantity, std::string_view event_time) {
+    std::string update = R"({"side":"bid","event_time":")";
+    update.append(event_time).append(R"(","price_level":")");
+    update.append(price).append(R"(","new_quantity":")");
+    update.append(quantity).append(R"("})");
+    return update;
+}
+
+std::string level2_event(std::string_view product_id, std::initializer_list<std::string> updates) {
+    std::string event = R"({"type":"update","product_id":")";
+    event.append(product_id).append(R"(","updates":[)");
+    return event + join(updates) + "]}";
+}
+
+}   // end anonymous namespace
+
+TEST(MarketDataArbiterTests, FirstCopyWins) {
+    MarketDataArbiter arbiter(2, 64);
+    arbiter.connected(0);
+    arbiter.connected(1);
+    EXPECT_EQ(arbiter.connectedCount(), 2u);
+
+    // the envelope differs per connection, the events do not
+    auto a1 = ticker_frame("a", 10, "72575.01");
+    auto b1 = ticker_frame("b", 500, "72575.01");
+    auto a2 = ticker_frame("a", 11, "72575.02");
+    auto b2 = ticker_frame("b", 501, "72575.02");
+
+    bool gap = true;
+    EXPECT_TRUE(arbiter.accept(0, a1.data(), a1.size(), gap));
+    EXPECT_FALSE(gap);
+    EXPECT_FALSE(arbiter.accept(1, b1.data(), b1.size(), gap));
+    // connection 1 is faster this time
+    EXPECT_TRUE(arbiter.accept(1, b2.data(), b2.size(), gap));
+    EXPECT_FALSE(arbiter.accept(0, a2.data(), a2.size(), gap));
+
+    // frames without events are never dropped
+    std::string error = R"({"type":"error","message":"rate limited"})";
+    EXPECT_TRUE(arbiter.accept(0, error.data(), error.size(), gap));
+    EXPECT_TRUE(arbiter.accept(1, error.data(), error.size(), gap));
+
+    auto stats = arbiter.stats(0);
+    EXPECT_EQ(stats.frames, 3u);
+    EXPECT_EQ(stats.forwarded, 2u);
+    EXPECT_EQ(stats.duplicates, 1u);
+    EXPECT_EQ(stats.gaps, 0u);
+    EXPECT_TRUE(stats.connected);
+    EXPECT_EQ(arbiter.stats(1).forwarded, 2u);
+    EXPECT_EQ(arbiter.stats(1).duplicates, 1u);
+}
+
+// Connections batch the same events into frames differently. Every trade and
+// level2 update is forwarded once: a frame mixing delivered and new events is
+// cut down to the new ones, leaving out the events with nothing new.
+TEST(MarketDataArbiterTests, EventsSplitDifferently) {
+    MarketDataArbiter arbiter(2, 64);
+    arbiter.connected(0);
+    arbiter.connected(1);
+    bool gap = false;
+    std::string_view frame;
+
+    auto a1 = trades_frame("a", 1, {trade("1", "72575"), trade("2", "72576")});
+    EXPECT_TRUE(arbiter.accept(0, a1.data(), a1.size(), gap, frame));
+    EXPECT_EQ(frame, a1);
+    auto b1 = trades_frame("b", 1, {trade("1", "72575")});
+    EXPECT_FALSE(arbiter.accept(1, b1.data(), b1.size(), gap, frame));
+    auto b2 = trades_frame("b", 2, {trade("2", "72576"), trade("3", "72577")});
+    EXPECT_TRUE(arbiter.accept(1, b2.data(), b2.size(), gap, frame));
+    EXPECT_EQ(frame, trades_frame("b", 2, {trade("3", "72577")}));
+    auto a2 = trades_frame("a", 2, {trade("3", "72577")});
+    EXPECT_FALSE(arbiter.accept(0, a2.data(), a2.size(), gap, frame));
+
+    auto t1 = "2026-03-05T09:05:35.1Z";
+    auto t2 = "2026-03-05T09:05:35.2Z";
+    auto a3 = events_frame("l2_data", "a", 3, join({
+        level2_event("BTC-USD", {level2_update("72580", "1", t1), level2_update("72581", "2", t1)}),
+        level2_event("ETH-USD", {level2_update("2000", "1", t1)}),
+    }));
+    EXPECT_TRUE(arbiter.accept(0, a3.data(), a3.size(), gap, frame));
+    EXPECT_EQ(frame, a3);
+    auto b3 = events_frame("l2_data", "b", 3, level2_event("BTC-USD", {level2_update("72580", "1", t1)}));
+    EXPECT_FALSE(arbiter.accept(1, b3.data(), b3.size(), gap, frame));
+    auto b4 = events_frame("l2_data", "b", 4, join({
+        level2_event("BTC-USD", {level2_update("72581", "2", t1), level2_update("72582", "3", t2)}),
+        level2_event("ETH-USD", {level2_update("2000", "1", t1)}),
+    }));
+    EXPECT_TRUE(arbiter.accept(1, b4.data(), b4.size(), gap, frame));
+    EXPECT_EQ(frame, events_frame("l2_data", "b", 4, level2_event("BTC-USD", {level2_update("72582", "3", t2)})));
+    // the same level at a later event time is a new update
+    auto a4 = events_frame("l2_data", "a", 4, level2_event("BTC-USD", {level2_update("72582", "3", t2), level2_update("72580", "0", t2)}));
+    EXPECT_TRUE(arbiter.accept(0, a4.data(), a4.size(), gap, frame));
+    EXPECT_EQ(frame, events_frame("l2_data", "a", 4, level2_event("BTC-USD", {level2_update("72580", "0", t2)})));
+    EXPECT_FALSE(gap);
+
+    auto stats = arbiter.stats(1);
+    EXPECT_EQ(stats.frames, 4u);
+    EXPECT_EQ(stats.forwarded, 2u);
+    EXPECT_EQ(stats.duplicates, 2u);
+    EXPECT_EQ(stats.filtered, 2u);
+    EXPECT_EQ(arbiter.stats(0).filtered, 1u);
+}
+
+TEST(MarketDataArbiterTests, GapsPerConnection) {
+    MarketDataArbiter arbiter(2, 64);
+    arbiter.connected(0);
+    arbiter.connected(1);
+    bool gap = false;
+    for (uint64_t seq_num : {1, 2}) {
+        auto frame = ticker_frame("a", seq_num, std::to_string(seq_num));
+        arbiter.accept(0, frame.data(), frame.size(), gap);
+        frame = ticker_frame("b", seq_num + 100, std::to_string(seq_num));
+        arbiter.accept(1, frame.data(), frame.size(), gap);
+    }
+
+    // connection 0 lost seq 3, connection 1 delivered it
+    auto b3 = ticker_frame("b", 103, "3");
+    EXPECT_TRUE(arbiter.accept(1, b3.data(), b3.size(), gap));
+    auto a4 = ticker_frame("a", 4, "4");
+    EXPECT_TRUE(arbiter.accept(0, a4.data(), a4.size(), gap));
+    EXPECT_FALSE(gap);
+    EXPECT_EQ(arbiter.stats(0).gaps, 1u);
+
+    // alone, a lost frame is lost for good
+    arbiter.disconnected(1);
+    EXPECT_FALSE(arbiter.stats(1).connected);
+    auto a6 = ticker_frame("a", 6, "6");
+    EXPECT_TRUE(arbiter.accept(0, a6.data(), a6.size(), gap));
+    EXPECT_TRUE(gap);
+    EXPECT_EQ(arbiter.stats(0).gaps, 2u);
+
+    // a reconnected connection counts from its first frame
+    arbiter.connected(1);
+    auto b1 = ticker_frame("b", 1, "7");
+    EXPECT_TRUE(arbiter.accept(1, b1.data(), b1.size(), gap));
+    EXPECT_FALSE(gap);
+    EXPECT_EQ(arbiter.stats(1).gaps, 0u);
+}
+
+// A standby joining while the primary serves the books replays its
+// subscriptions and gets its own snapshot, after the primary's deltas. It
+// must not reset the books: its copies of those deltas are dropped.
+TEST(MarketDataArbiterTests, StandbySnapshotAfterPrimaryDeltas) {
+    MarketDataArbiter arbiter(2, 64);
+    bool gap = false;
+    arbiter.connected(0);
+    EXPECT_EQ(arbiter.snapshotSource(), 0u);
+    auto snapshot = l2_frame("a", 1, "snapshot", "72575", "1");
+    EXPECT_TRUE(MarketDataArbiter::isSnapshot(snapshot.data(), snapshot.size()));
+    EXPECT_TRUE(arbiter.accept(0, snapshot.data(), snapshot.size(), gap));
+    auto a2 = l2_frame("a", 2, "update", "72576", "2");
+    auto a3 = l2_frame("a", 3, "update", "72577", "3");
+    EXPECT_FALSE(MarketDataArbiter::isSnapshot(a2.data(), a2.size()));
+    EXPECT_TRUE(arbiter.accept(0, a2.data(), a2.size(), gap));
+    EXPECT_TRUE(arbiter.accept(0, a3.data(), a3.size(), gap));
+
+    arbiter.connected(1);
+    EXPECT_EQ(arbiter.snapshotSource(), 0u);
+    // taken before a3: forwarding it would drop the 72577 level for good
+    auto standby_snapshot = l2_frame("b", 1, "snapshot", "72576", "2");
+    EXPECT_FALSE(arbiter.accept(1, standby_snapshot.data(), standby_snapshot.size(), gap));
+    auto b2 = l2_frame("b", 2, "update", "72577", "3");
+    EXPECT_FALSE(arbiter.accept(1, b2.data(), b2.size(), gap));
+    auto b3 = l2_frame("b", 3, "update", "72578", "4");
+    EXPECT_TRUE(arbiter.accept(1, b3.data(), b3.size(), gap));
+    EXPECT_FALSE(gap);
+    EXPECT_EQ(arbiter.stats(1).snapshots, 1u);
+    EXPECT_EQ(arbiter.stats(1).duplicates, 1u);
+
+    // snapshots of new subscriptions still come through the source
+    auto eth = l2_frame("a", 4, "snapshot", "2000", "1");
+    eth.replace(eth.find("BTC-USD"), 7, "ETH-USD");
+    EXPECT_TRUE(arbiter.accept(0, eth.data(), eth.size(), gap));
+
+    // the standby takes over when the primary goes down
+    arbiter.disconnected(0);
+    EXPECT_EQ(arbiter.snapshotSource(), 1u);
+    auto resync = l2_frame("b", 4, "snapshot", "72579", "5");
+    EXPECT_TRUE(arbiter.accept(1, resync.data(), resync.size(), gap));
+
+    // the old primary rejoins as a standby; a resync requested on it moves the source
+    arbiter.connected(0);
+    auto replay = l2_frame("c", 1, "snapshot", "72580", "6");
+    EXPECT_FALSE(arbiter.accept(0, replay.data(), replay.size(), gap));
+    arbiter.setSnapshotSource(0);
+    EXPECT_TRUE(arbiter.accept(0, replay.data(), replay.size(), gap));
+}
+
+TEST(MarketDataArbiterTests, DedupWindow) {
+    MarketDataArbiter arbiter(2, 16);
+    bool gap = false;
+    std::vector<std::string> frames;
+    for (int i = 0; i < 1000; ++i) {
+        frames.push_back(ticker_frame("a", i + 1, std::to_string(70000 + i)));
+        EXPECT_TRUE(arbiter.accept(0, frames.back().data(), frames.back().size(), gap));
+    }
+    // recent frames are still known, the oldest ones have been evicted
+    auto recent = ticker_frame("b", 1, std::to_string(70999));
+    EXPECT_FALSE(arbiter.accept(1, recent.data(), recent.size(), gap));
+    auto old = ticker_frame("b", 2, std::to_string(70000));
+    EXPECT_TRUE(arbiter.accept(1, old.data(), old.size(), gap));
+}
+
+}
@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+#include <coinbase/market_data_decoder.hpp>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace coinbase::tests {
+
+namespace {
+
+const std::string L2_FRAME = R"({
+    "channel":"l2_data",
+    "client_id":"",
+    "timestamp":"2026-03-05T09:05:32.483569449Z",
+    "sequence_num":229,
+    "events":[{
+        "type":"update",
+        "product_id":"BIP-20DEC30-CDE",
+        "updates":[
+            {"side":"bid","event_time":"2026-03-05T09:05:32.449176Z","price_level":"72575","new_quantity":"0"},
+            {"side":"bid","event_time":"2026-03-05T09:05:32.449176Z","price_level":"72570.5","new_quantity":"68"},
+            {"side":"offer","event_time":"2026-03-05T09:05:32.449176Z","price_level":"72580","new_quantity":"13.25"}
+        ]
+    }]
+})";
+
+const std::string TICKER_FRAME = R"({"channel":"ticker","client_id":"","timestamp":"2026-03-05T09:05:32.483569449Z","sequence_num":7,"events":[{"type":"snapshot","tickers":[{"type":"ticker","product_id":"BTC-USD","price":"72575.01","volume_24_h":"12345.6789","low_24_h":"70000","high_24_h":"73000","low_52_w":"15460","high_52_w":"108000","price_percent_chg_24_h":"-1.2345","best_bid":"72575","best_bid_quantity":"0.5","best_ask":"72575.01","best_ask_quantity":"0.25"}]}]})";
+
+const std::string TRADES_FRAME = R"({"channel":"market_trades","client_id":"","timestamp":"2026-03-05T09:05:32.483569449Z","sequence_num":8,"events":[{"type":"update","trades":[{"trade_id":"123456789","product_id":"BTC-USD","price":"72575.01","size":"0.001","side":"BUY","time":"2026-03-05T09:05:32.449176Z"},{"trade_id":"123456790","product_id":"BTC-USD","price":"72575","size":"0.5","side":"SELL","time":"2026-03-05T09:05:32.449177Z"}]}]})";
+
+const std::string CANDLES_FRAME = R"({"channel":"candles","client_id":"","timestamp":"2026-03-05T09:05:32.483569449Z","sequence_num":9,"events":[{"type":"snapshot","candles":[{"start":"1688998200","high":"1867.72","low":"1865.63","open":"1867.38","close":"1866.81","volume":"0.20269406","product_id":"ETH-USD"}]}]})";
+
+}   // namespace
+
+class MarketDataDecoderTests : public ::testing::Test {};
+
+TEST_F(MarketDataDecoderTests, Level2MatchesDom) {
+    Level2UpdateBatch expected = json::parse(L2_FRAME)["events"][0];
+
+    MarketDataFrame frame;
+    Level2UpdateBatch batch;
+    int events = 0;
+    auto ok = scan_market_data_frame(L2_FRAME.data(), L2_FRAME.size(), frame, [&](const MarketDataFrame &, JsonScanner &s) {
+        decode_level2_events(s, batch, [&](std::string_view type, const Level2UpdateBatch &b) {
+            EXPECT_EQ(type, "update");
+            ASSERT_EQ(b.product_id, expected.product_id);
+            EXPECT_NE(b.product_handle, INVALID_PRODUCT_HANDLE);
+            EXPECT_EQ(b.product_handle, expected.product_handle);
+            ASSERT_EQ(b.updates.size(), expected.updates.size());
+            for (std::size_t i = 0; i < b.updates.size(); ++i) {
+                EXPECT_EQ(b.updates[i].side, expected.updates[i].side);
+                EXPECT_EQ(b.updates[i].event_time, expected.updates[i].event_time);
+                EXPECT_DOUBLE_EQ(b.updates[i].price_level, expected.updates[i].price_level);
+                EXPECT_DOUBLE_EQ(b.updates[i].new_quantity, expected.updates[i].new_quantity);
+            }
+            ++events;
+        });
+    });
+    ASSERT_TRUE(ok);
+    EXPECT_EQ(events, 1);
+    EXPECT_EQ(frame.channel, "l2_data");
+    EXPECT_EQ(frame.sequence_num, 229u);
+    EXPECT_EQ(frame.timestamp, "2026-03-05T09:05:32.483569449Z");
+}
+
+TEST_F(MarketDataDecoderTests, TickerMatchesDom) {
+    std::vector<Ticker> expected = json::parse(TICKER_FRAME)["events"][0]["tickers"];
+
+    MarketDataFrame frame;
+    std::vector<Ticker> tickers;
+    auto ok = scan_market_data_frame(TICKER_FRAME.data(), TICKER_FRAME.size(), frame, [&](const MarketDataFrame &, JsonScanner &s) {
+        decode_events(s, "tickers", tickers, [&](std::string_view type, const std::vector<Ticker> &t) {
+            EXPECT_EQ(type, "snapshot");
+            ASSERT_EQ(t.size(), 1u);
+            EXPECT_EQ(t[0].product_id, expected[0].product_id);
+            EXPECT_EQ(t[0].product_handle, expected[0].product_handle);
+            EXPECT_DOUBLE_EQ(t[0].price, expected[0].price);
+            EXPECT_DOUBLE_EQ(t[0].volume_24_h, expected[0].volume_24_h);
+            EXPECT_DOUBLE_EQ(t[0].price_percent_chg_24_h, expected[0].price_percent_chg_24_h);
+            EXPECT_DOUBLE_EQ(t[0].best_bid, expected[0].best_bid);
+            EXPECT_DOUBLE_EQ(t[0].best_bid_quantity, expected[0].best_bid_quantity);
+            EXPECT_DOUBLE_EQ(t[0].best_ask, expected[0].best_ask);
+            EXPECT_DOUBLE_EQ(t[0].best_ask_quantity, expected[0].best_ask_quantity);
+        });
+    });
+    ASSERT_TRUE(ok);
+    EXPECT_EQ(frame.channel, "ticker");
+}
+
+TEST_F(MarketDataDecoderTests, TickerFieldMask) {
+    MarketDataFrame frame;
+    std::vector<Ticker> tickers;
+    auto ok = scan_market_data_frame(TICKER_FRAME.data(), TICKER_FRAME.size(), frame, [&](const MarketDataFrame &, JsonScanner &s) {
+        decode_events(s, "tickers", tickers, [&](std::string_view, const std::vector<Ticker> &t) {
+            ASSERT_EQ(t.size(), 1u);
+            EXPECT_EQ(t[0].product_id, "BTC-USD");
+            EXPECT_EQ(t[0].price, 0.);
+            EXPECT_EQ(t[0].volume_24_h, 0.);
+            EXPECT_EQ(t[0].best_bid, 72575.);
+            EXPECT_EQ(t[0].best_ask, 72575.01);
+            EXPECT_EQ(t[0].best_bid_quantity, 0.);
+        }, uint32_t(TickerField::BEST_BID | TickerField::BEST_ASK));
+    });
+    EXPECT_TRUE(ok);
+}
+
+TEST_F(MarketDataDecoderTests, PeekHeader) {
+    MarketDataFrame frame;
+    ASSERT_TRUE(peek_market_data_frame(L2_FRAME.data(), L2_FRAME.size(), frame));
+    EXPECT_EQ(frame.channel, "l2_data");
+    EXPECT_TRUE(frame.has_sequence_num);
+    EXPECT_EQ(frame.sequence_num, 229u);
+
+    // the events are not scanned, so a broken tail goes unnoticed
+    auto truncated = L2_FRAME.substr(0, L2_FRAME.find("\"events\"") + 12);
+    MarketDataFrame partial;
+    EXPECT_TRUE(peek_market_data_frame(truncated.data(), truncated.size(), partial));
+    EXPECT_EQ(partial.sequence_num, 229u);
+
+    std::string error = R"({"type":"error","message":"failure"})";
+    MarketDataFrame error_frame;
+    ASSERT_TRUE(peek_market_data_frame(error.data(), error.size(), error_frame));
+    EXPECT_TRUE(error_frame.channel.empty());
+    EXPECT_EQ(error_frame.type, "error");
+}
+
+TEST_F(MarketDataDecoderTests, MarketTradesMatchDom) {
+    std::vector<MarketTrade> expected = json::parse(TRADES_FRAME)["events"][0]["trades"];
+
+    MarketDataFrame frame;
+    std::vector<MarketTrade> trades;
+    auto ok = scan_market_data_frame(TRADES_FRAME.data(), TRADES_FRAME.size(), frame, [&](const MarketDataFrame &, JsonScanner &s) {
+        decode_events(s, "trades", trades, [&](std::string_view type, const std::vector<MarketTrade> &t) {
+            EXPECT_EQ(type, "update");
+            ASSERT_EQ(t.size(), expected.size());
+            for (std::size_t i = 0; i < t.size(); ++i) {
+                EXPECT_EQ(t[i].trade_id, expected[i].trade_id);
+                EXPECT_EQ(t[i].product_id, expected[i].product_id);
+                EXPECT_EQ(t[i].product_handle, expected[i].product_handle);
+                EXPECT_EQ(t[i].time, expected[i].time);
+                EXPECT_EQ(t[i].side, expected[i].side);
+                EXPECT_DOUBLE_EQ(t[i].price, expected[i].price);
+                EXPECT_DOUBLE_EQ(t[i].size, expected[i].size);
+            }
+        });
+    });
+    ASSERT_TRUE(ok);
+}
+
+TEST_F(MarketDataDecoderTests, CandlesMatchDom) {
+    std::vector<Candle> expected = json::parse(CANDLES_FRAME)["events"][0]["candles"];
+
+    MarketDataFrame frame;
+    std::vector<Candle> candles;
+    auto ok = scan_market_data_frame(CANDLES_FRAME.data(), CANDLES_FRAME.size(), frame, [&](const MarketDataFrame &, JsonScanner &s) {
+        decode_events(s, "candles", candles, [&](std::string_view, const std::vector<Candle> &c) {
+            ASSERT_EQ(c.size(), 1u);
+            EXPECT_EQ(c[0].start, expected[0].start);
+            EXPECT_EQ(c[0].product_id, expected[0].product_id);
+            EXPECT_EQ(c[0].product_handle, expected[0].product_handle);
+            EXPECT_DOUBLE_EQ(c[0].open, expected[0].open);
+            EXPECT_DOUBLE_EQ(c[0].high, expected[0].high);
+            EXPECT_DOUBLE_EQ(c[0].low, expected[0].low);
+            EXPECT_DOUBLE_EQ(c[0].close, expected[0].close);
+            EXPECT_DOUBLE_EQ(c[0].volume, expected[0].volume);
+        });
+    });
+    ASSERT_TRUE(ok);
+}
+
+// events ahead of the header fields are revisited once the whole object is scanned
+TEST_F(MarketDataDecoderTests, EventsBeforeHeader) {
+    std::string msg = R"({"events":[{"type":"snapshot","product_id":"BTC-USD","updates":[{"side":"offer","event_time":"2026-03-05T09:05:32.449176Z","price_level":"1","new_quantity":"2"}]}],"sequence_num":3,"timestamp":"2026-03-05T09:05:32Z","channel":"l2_data"})";
+    MarketDataFrame frame;
+    Level2UpdateBatch batch;
+    int events = 0;
+    auto ok = scan_market_data_frame(msg.data(), msg.size(), frame, [&](const MarketDataFrame &f, JsonScanner &s) {
+        EXPECT_EQ(f.channel, "l2_data");
+        EXPECT_EQ(f.sequence_num, 3u);
+        decode_level2_events(s, batch, [&](std::string_view type, const Level2UpdateBatch &b) {
+            EXPECT_EQ(type, "snapshot");
+            ASSERT_EQ(b.updates.size(), 1u);
+            EXPECT_EQ(b.updates[0].side, Side::SELL);
+            ++events;
+        });
+    });
+    ASSERT_TRUE(ok);
+    EXPECT_EQ(events, 1);
+}
+
+TEST_F(MarketDataDecoderTests, SkipsNestedAndEscapedValues) {
+    std::string msg = R"({"channel":"subscriptions","client_id":"a\"b\\","timestamp":"2026-03-05T09:05:32Z","sequence_num":1,"events":[{"subscriptions":{"level2":["BTC-USD","ETH-USD"],"nested":[{"x":[1,2,{"y":"]}"}]}]}}]})";
+    MarketDataFrame frame;
+    bool called = false;
+    auto ok = scan_market_data_frame(msg.data(), msg.size(), frame, [&](const MarketDataFrame &, JsonScanner &s) {
+        called = true;
+        EXPECT_TRUE(s.skipValue());
+    });
+    EXPECT_TRUE(ok);
+    EXPECT_TRUE(called);
+    EXPECT_EQ(frame.channel, "subscriptions");
+}
+
+TEST_F(MarketDataDecoderTests, ErrorFrame) {
+    std::string msg = R"({"type":"error","message":"failure to subscribe"})";
+    MarketDataFrame frame;
+    bool called = false;
+    auto ok = scan_market_data_frame(msg.data(), msg.size(), frame, [&](const MarketDataFrame &, JsonScanner &) {
+        called = true;
+    });
+    EXPECT_TRUE(ok);
+    EXPECT_FALSE(called);
+    EXPECT_EQ(frame.type, "error");
+}
+
+TEST_F(MarketDataDecoderTests, MalformedFrame) {
+    std::string msg = R"({"channel":"l2_data","sequence_num":1,"timestamp":"x","events":[{"type":"update","updates":[{"side":"bid")";
+    MarketDataFrame frame;
+    Level2UpdateBatch batch;
+    int events = 0;
+    auto ok = scan_market_data_frame(msg.data(), msg.size(), frame, [&](const MarketDataFrame &, JsonScanner &s) {
+        decode_level2_events(s, batch, [&](std::string_view, const Level2UpdateBatch &) {
+            ++events;
+        });
+    });
+    EXPECT_FALSE(ok);
+    EXPECT_EQ(events, 0);
+}
+
+} // namespace coinbase::tests
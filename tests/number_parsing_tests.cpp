@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <coinbase/utils.hpp>
+#include <coinbase/market_data.hpp>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace coinbase::tests {
+
+class NumberParsingTests : public ::testing::Test {};
+
+TEST_F(NumberParsingTests, Decimals) {
+    double v = -1.;
+    ASSERT_TRUE(parse_double("72575.01", v));
+    EXPECT_EQ(v, 72575.01);
+    ASSERT_TRUE(parse_double("0", v));
+    EXPECT_EQ(v, 0.);
+    ASSERT_TRUE(parse_double("-0.5", v));
+    EXPECT_EQ(v, -0.5);
+    ASSERT_TRUE(parse_double("+3", v));
+    EXPECT_EQ(v, 3.);
+    ASSERT_TRUE(parse_double("0.00000001", v));
+    EXPECT_EQ(v, 1e-8);
+    ASSERT_TRUE(parse_double(".25", v));
+    EXPECT_EQ(v, 0.25);
+    ASSERT_TRUE(parse_double("12.", v));
+    EXPECT_EQ(v, 12.);
+    ASSERT_TRUE(parse_double("0.1000000000000000000000001", v));
+    EXPECT_EQ(v, 0.1);
+}
+
+TEST_F(NumberParsingTests, SlowPath) {
+    double v = 0.;
+    ASSERT_TRUE(parse_double("1e-8", v));
+    EXPECT_EQ(v, 1e-8);
+    ASSERT_TRUE(parse_double("1.5E3", v));
+    EXPECT_EQ(v, 1500.);
+    ASSERT_TRUE(parse_double("123456789012345678901234567890", v));
+    EXPECT_EQ(v, 123456789012345678901234567890.);
+    ASSERT_TRUE(parse_double("9007199254740993", v));   // 2^53 + 1
+    EXPECT_EQ(v, 9007199254740992.);
+}
+
+TEST_F(NumberParsingTests, Invalid) {
+    double v = 0.;
+    EXPECT_FALSE(parse_double("", v));
+    EXPECT_FALSE(parse_double("-", v));
+    EXPECT_FALSE(parse_double(".", v));
+    EXPECT_FALSE(parse_double("abc", v));
+    EXPECT_FALSE(parse_double("1.2.3", v));
+    EXPECT_FALSE(parse_double("12 ", v));
+    EXPECT_EQ(to_double("not a number"), 0.);
+}
+
+TEST_F(NumberParsingTests, NotNulTerminated) {
+    std::string buffer = "\"72575.01\",\"68\"";
+    EXPECT_EQ(to_double(std::string_view(buffer).substr(1, 8)), 72575.01);
+    EXPECT_EQ(to_double(std::string_view(buffer).substr(1, 5)), 72575.);
+}
+
+// Every result must equal the correctly rounded strtod conversion.
+TEST_F(NumberParsingTests, MatchesStrtod) {
+    std::mt19937_64 rng(42);
+    char buf[64];
+    for (int i = 0; i < 200000; ++i) {
+        auto integer = rng() % 100000000ULL;
+        auto decimals = static_cast<int>(rng() % 11);
+        auto fraction = decimals ? rng() % static_cast<uint64_t>(std::pow(10, decimals)) : 0;
+        int n = decimals
+            ? std::snprintf(buf, sizeof(buf), "%llu.%0*llu", static_cast<unsigned long long>(integer), decimals, static_cast<unsigned long long>(fraction))
+            : std::snprintf(buf, sizeof(buf), "%llu", static_cast<unsigned long long>(integer));
+        double v = 0.;
+        ASSERT_TRUE(parse_double(std::string_view(buf, static_cast<std::size_t>(n)), v)) << buf;
+        ASSERT_EQ(v, std::strtod(buf, nullptr)) << buf;
+    }
+}
+
+TEST_F(NumberParsingTests, FromJson) {
+    auto j = json::parse(R"({"s":"1.25","n":2.5,"null":null,"empty":"","bad":"x1","i":"42","ni":7})");
+    EXPECT_EQ(double_from_json(j, "s"), 1.25);
+    EXPECT_EQ(double_from_json(j, "n"), 2.5);
+    EXPECT_EQ(double_from_json(j, "null"), 0.);
+    EXPECT_EQ(double_from_json(j, "empty"), 0.);
+    EXPECT_EQ(double_from_json(j, "bad"), 0.);
+    EXPECT_EQ(double_from_json(j, "missing"), 0.);
+    EXPECT_EQ(int_from_json(j, "i"), 42);
+    EXPECT_EQ(int_from_json(j, "ni"), 7);
+    EXPECT_EQ(int_from_json(j, "bad"), 0);
+
+    Ticker t{};
+    from_json(json::parse(R"({"product_id":"BTC-USD","price":"72575.01","best_bid":"72575","best_ask":"72575.02"})"), t);
+    EXPECT_EQ(t.price, 72575.01);
+    EXPECT_EQ(t.best_bid, 72575.);
+    EXPECT_EQ(t.best_ask, 72575.02);
+}
+
+} // namespace coinbase::tests
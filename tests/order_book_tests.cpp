@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <map>
+#include <random>
+#include <coinbase/order_book.hpp>
+
+namespace coinbase::tests {
+
+namespace {
+
+Level2Update level(Side side, double price, double quantity, uint64_t event_time = 0) {
+    return Level2Update{event_time, side, price, quantity};
+}
+
+}   // namespace
+
+class OrderBookTests : public ::testing::Test {
+protected:
+    OrderBook book_{"BTC-USD", 0.01, 64};
+};
+
+TEST_F(OrderBookTests, EmptyBook) {
+    EXPECT_TRUE(book_.empty(Side::BUY));
+    EXPECT_TRUE(book_.empty(Side::SELL));
+    EXPECT_FALSE(book_.bestBid());
+    EXPECT_FALSE(book_.bestAsk());
+    EXPECT_TRUE(book_.depth(Side::BUY, 5).empty());
+}
+
+TEST_F(OrderBookTests, SnapshotAndBest) {
+    std::vector<Level2Update> snapshot = {
+        level(Side::BUY, 100.00, 1.0),
+        level(Side::BUY, 100.01, 2.0),
+        level(Side::BUY, 99.95, 3.0),
+        level(Side::SELL, 100.03, 4.0),
+        level(Side::SELL, 100.02, 5.0, 42),
+    };
+    book_.applySnapshot(snapshot, 7);
+
+    EXPECT_EQ(book_.sequenceNum(), 7u);
+    EXPECT_EQ(book_.eventTime(), 42u);
+    ASSERT_TRUE(book_.bestBid());
+    EXPECT_EQ(book_.bestBid()->price, 100.01);
+    EXPECT_EQ(book_.bestBid()->quantity, 2.0);
+    ASSERT_TRUE(book_.bestAsk());
+    EXPECT_EQ(book_.bestAsk()->price, 100.02);
+    EXPECT_EQ(book_.bestAsk()->quantity, 5.0);
+    EXPECT_EQ(book_.levelCount(Side::BUY), 3u);
+    EXPECT_EQ(book_.levelCount(Side::SELL), 2u);
+    EXPECT_EQ(book_.quantityAt(Side::BUY, 99.95), 3.0);
+    EXPECT_EQ(book_.quantityAt(Side::BUY, 99.96), 0.0);
+
+    auto bids = book_.depth(Side::BUY, 10);
+    ASSERT_EQ(bids.size(), 3u);
+    EXPECT_EQ(bids[0].price, 100.01);
+    EXPECT_EQ(bids[1].price, 100.00);
+    EXPECT_EQ(bids[2].price, 99.95);
+
+    // a new snapshot replaces the book
+    book_.applySnapshot(std::vector<Level2Update>{level(Side::SELL, 101.0, 1.0)}, 8);
+    EXPECT_FALSE(book_.bestBid());
+    EXPECT_EQ(book_.bestAsk()->price, 101.0);
+}
+
+TEST_F(OrderBookTests, UpdatesMoveBest) {
+    book_.applySnapshot(std::vector<Level2Update>{
+        level(Side::BUY, 100.00, 1.0),
+        level(Side::BUY, 99.90, 1.0),
+        level(Side::SELL, 100.10, 1.0),
+    }, 1);
+
+    book_.applyUpdates(std::vector<Level2Update>{level(Side::BUY, 100.05, 2.0)}, 2);
+    EXPECT_EQ(book_.bestBid()->price, 100.05);
+
+    book_.applyUpdates(std::vector<Level2Update>{level(Side::BUY, 100.05, 0.0), level(Side::BUY, 100.00, 0.0)}, 3);
+    EXPECT_EQ(book_.bestBid()->price, 99.90);
+    EXPECT_EQ(book_.levelCount(Side::BUY), 1u);
+
+    book_.applyUpdates(std::vector<Level2Update>{level(Side::SELL, 100.10, 0.0)}, 4);
+    EXPECT_FALSE(book_.bestAsk());
+    EXPECT_EQ(book_.sequenceNum(), 4u);
+
+    // removing an absent level is a no-op
+    book_.applyUpdates(std::vector<Level2Update>{level(Side::SELL, 100.20, 0.0)}, 5);
+    EXPECT_TRUE(book_.empty(Side::SELL));
+}
+
+// Levels far from the best price live outside the flat window and are moved
+// into it when the best price walks towards them.
+TEST_F(OrderBookTests, LevelsOutsideWindow) {
+    book_.applySnapshot(std::vector<Level2Update>{
+        level(Side::BUY, 100.00, 1.0),
+        level(Side::BUY, 90.00, 2.0),
+        level(Side::BUY, 80.00, 3.0),
+        level(Side::SELL, 100.01, 1.0),
+        level(Side::SELL, 150.00, 4.0),
+    }, 1);
+
+    auto bids = book_.depth(Side::BUY, 10);
+    ASSERT_EQ(bids.size(), 3u);
+    EXPECT_EQ(bids[1].price, 90.00);
+    EXPECT_EQ(bids[2].price, 80.00);
+
+    book_.apply(level(Side::BUY, 100.00, 0.0));
+    EXPECT_EQ(book_.bestBid()->price, 90.00);
+    EXPECT_EQ(book_.bestBid()->quantity, 2.0);
+    book_.apply(level(Side::BUY, 90.00, 0.0));
+    EXPECT_EQ(book_.bestBid()->price, 80.00);
+
+    book_.apply(level(Side::SELL, 100.01, 0.0));
+    EXPECT_EQ(book_.bestAsk()->price, 150.00);
+
+    // best price jumps far away from the window
+    book_.apply(level(Side::SELL, 10.00, 5.0));
+    EXPECT_EQ(book_.bestAsk()->price, 10.00);
+    auto asks = book_.depth(Side::SELL, 10);
+    ASSERT_EQ(asks.size(), 2u);
+    EXPECT_EQ(asks[1].price, 150.00);
+    EXPECT_EQ(book_.quantityAt(Side::SELL, 150.00), 4.0);
+}
+
+TEST_F(OrderBookTests, DepthIntoSpan) {
+    book_.applySnapshot(std::vector<Level2Update>{
+        level(Side::SELL, 100.01, 1.0),
+        level(Side::SELL, 100.02, 2.0),
+        level(Side::SELL, 100.03, 3.0),
+    }, 1);
+    std::array<BookLevel, 2> levels;
+    ASSERT_EQ(book_.depth(Side::SELL, levels), 2u);
+    EXPECT_EQ(levels[0].price, 100.01);
+    EXPECT_EQ(levels[1].price, 100.02);
+    EXPECT_EQ(levels[1].quantity, 2.0);
+}
+
+TEST(OrderBookProductTests, TickFromProduct) {
+    Product product{};
+    product.product_id = "BIP-20DEC30-CDE";
+    product.quote_increment = 5.;
+    OrderBook book(product);
+    EXPECT_EQ(book.productId(), "BIP-20DEC30-CDE");
+    EXPECT_EQ(book.tickSize(), 5.);
+    book.apply(level(Side::BUY, 72575, 68));
+    book.apply(level(Side::BUY, 72570, 1));
+    EXPECT_EQ(book.bestBid()->price, 72575.);
+    EXPECT_EQ(book.depth(Side::BUY, 2)[1].price, 72570.);
+}
+
+// Randomized comparison against a std::map reference book.
+TEST(OrderBookRandomTests, MatchesReference) {
+    OrderBook book("ETH-USD", 0.05, 128);
+    std::map<double, double, std::greater<double>> bids;
+    std::map<double, double> asks;
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<int> tick_dist(-400, 400);
+    std::uniform_int_distribution<int> qty_dist(0, 3);
+    for (int i = 0; i < 20000; ++i) {
+        int tick = tick_dist(rng);
+        double quantity = qty_dist(rng) * 0.5;
+        Side side = tick < 0 ? Side::BUY : Side::SELL;
+        double price = 2000. + tick * 0.05;
+        book.apply(level(side, price, quantity));
+        if (side == Side::BUY) {
+            if (quantity == 0.) bids.erase(price); else bids[price] = quantity;
+        }
+        else {
+            if (quantity == 0.) asks.erase(price); else asks[price] = quantity;
+        }
+
+        ASSERT_EQ(book.levelCount(Side::BUY), bids.size());
+        ASSERT_EQ(book.levelCount(Side::SELL), asks.size());
+        if (!bids.empty()) {
+            ASSERT_NEAR(book.bestBid()->price, bids.begin()->first, 1e-9);
+            ASSERT_EQ(book.bestBid()->quantity, bids.begin()->second);
+        }
+        if (!asks.empty()) {
+            ASSERT_NEAR(book.bestAsk()->price, asks.begin()->first, 1e-9);
+            ASSERT_EQ(book.bestAsk()->quantity, asks.begin()->second);
+        }
+    }
+    auto depth = book.depth(Side::BUY, bids.size());
+    ASSERT_EQ(depth.size(), bids.size());
+    std::size_t k = 0;
+    for (const auto &[price, quantity] : bids) {
+        EXPECT_NEAR(depth[k].price, price, 1e-9);
+        EXPECT_EQ(depth[k].quantity, quantity);
+        ++k;
+    }
+}
+
+} // namespace coinbase::tests
@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <nlohmann/json.hpp>
+#include <coinbase/order_request.hpp>
+#include <coinbase/product_catalog.hpp>
+
+using json = nlohmann::json;
+
+namespace coinbase::tests {
+
+class OrderRequestTests : public ::testing::Test {
+protected:
+    void SetUp() override {
+        btc_.product_id = "BTC-USD";
+        btc_.quote_increment = 0.01;
+        btc_.base_increment = 0.00000001;
+        btc_.product_type = ProductType::SPOT;
+        writer_.addProduct(btc_);
+
+        Product future{};
+        future.product_id = "BIT-27MAR26-CDE";
+        future.quote_increment = 5.;
+        future.base_increment = 1.;
+        future.product_type = ProductType::FUTURE;
+        writer_.addProduct(future);
+    }
+
+    json write(std::string_view product_id, Side side, OrderType type, TimeInForce tif, double size, double limit_price,
+               std::optional<double> stop_price = {}, std::optional<double> take_profit_price = {}, std::optional<uint64_t> end_time = {}) {
+        CreateOrderResponse rsp;
+        if (!writer_.writeCreateOrder(rsp, "id-1", product_id, side, type, tif, size, limit_price, true, false,
+                stop_price, take_profit_price, end_time, {}, {}, {}, {}, {}, {})) {
+            return {};
+        }
+        return json::parse(writer_.body());
+    }
+
+    Product btc_{};
+    OrderRequestWriter writer_;
+};
+
+TEST_F(OrderRequestTests, LimitOrder) {
+    auto body = write("BTC-USD", Side::BUY, OrderType::LIMIT, TimeInForce::GOOD_UNTIL_CANCELLED, 0.00012345, 72575.014);
+    ASSERT_FALSE(body.is_null());
+    EXPECT_EQ(body["client_order_id"], "id-1");
+    EXPECT_EQ(body["product_id"], "BTC-USD");
+    EXPECT_EQ(body["side"], "BUY");
+    EXPECT_EQ(body["sor_preference"], "SOR_ENABLED");
+    const auto &config = body["order_configuration"]["limit_limit_gtc"];
+    EXPECT_EQ(config["base_size"], "0.00012345");
+    EXPECT_EQ(config["limit_price"], "72575.01");
+    EXPECT_EQ(config["post_only"], true);
+    EXPECT_FALSE(body.contains("attached_order_configuration"));
+
+    body = write("BIT-27MAR26-CDE", Side::SELL, OrderType::LIMIT, TimeInForce::IMMEDIATE_OR_CANCEL, 3, 98765.);
+    EXPECT_EQ(body["order_configuration"]["sor_limit_ioc"]["base_size"], "3");
+    EXPECT_EQ(body["order_configuration"]["sor_limit_ioc"]["limit_price"], "98765");
+}
+
+TEST_F(OrderRequestTests, MarketOrderInQuote) {
+    CreateOrderResponse rsp;
+    ASSERT_TRUE(writer_.writeCreateOrder(rsp, R"(a"b\c)", "BTC-USD", Side::BUY, OrderType::MARKET, TimeInForce::IMMEDIATE_OR_CANCEL, 25.5, NAN, false, true,
+        {}, {}, {}, {}, SorPreference::SOR_DISABLED, {}, MarginType::CROSS, {}, {}));
+    auto body = json::parse(writer_.body());
+    EXPECT_EQ(body["client_order_id"], R"(a"b\c)");
+    EXPECT_EQ(body["order_configuration"]["market_market_ioc"]["quote_size"], "25.50");
+    EXPECT_EQ(body["sor_preference"], "SOR_DISABLED");
+    EXPECT_EQ(body["margin_type"], "CROSS");
+}
+
+TEST_F(OrderRequestTests, AttachedAndBracketOrders) {
+    auto body = write("BTC-USD", Side::BUY, OrderType::LIMIT, TimeInForce::GOOD_UNTIL_DATE_TIME, 1, 70000., 69000., 75000., 1772701532483ull);
+    ASSERT_FALSE(body.is_null());
+    EXPECT_EQ(body["order_configuration"]["limit_limit_gtd"]["end_time"], "2026-03-05T09:05:32.483Z");
+    EXPECT_EQ(body["attached_order_configuration"]["trigger_bracket_gtc"]["limit_price"], "75000.00");
+    EXPECT_EQ(body["attached_order_configuration"]["trigger_bracket_gtc"]["stop_trigger_price"], "69000.00");
+
+    body = write("BTC-USD", Side::SELL, OrderType::BRACKET, TimeInForce::GOOD_UNTIL_CANCELLED, 0.5, 75000., 69000.);
+    const auto &config = body["order_configuration"]["trigger_bracket_gtc"];
+    EXPECT_EQ(config["base_size"], "0.50000000");
+    EXPECT_EQ(config["limit_price"], "75000.00");
+    EXPECT_EQ(config["stop_trigger_price"], "69000.00");
+
+    body = write("BTC-USD", Side::BUY, OrderType::STOP_LIMIT, TimeInForce::GOOD_UNTIL_CANCELLED, 1, 70100., 70000.);
+    EXPECT_EQ(body["order_configuration"]["stop_limit_stop_limit_gtc"]["stop_price"], "70000.00");
+}
+
+TEST_F(OrderRequestTests, InvalidOrders) {
+    CreateOrderResponse rsp;
+    EXPECT_FALSE(writer_.writeCreateOrder(rsp, "id-1", "BTC-USD", Side::BUY, OrderType::MARKET, TimeInForce::GOOD_UNTIL_CANCELLED, 1, NAN, true, false,
+        {}, {}, {}, {}, {}, {}, {}, {}, {}));
+    EXPECT_FALSE(rsp.success);
+    EXPECT_FALSE(rsp.error_response.message.empty());
+
+    EXPECT_TRUE(write("BTC-USD", Side::BUY, OrderType::LIMIT, TimeInForce::GOOD_UNTIL_CANCELLED, 1, NAN).is_null());
+    EXPECT_TRUE(write("BTC-USD", Side::BUY, OrderType::LIMIT, TimeInForce::GOOD_UNTIL_DATE_TIME, 1, 70000.).is_null());
+    EXPECT_TRUE(write("BTC-USD", Side::SELL, OrderType::LIMIT, TimeInForce::GOOD_UNTIL_CANCELLED, 1, 70000., 69000., 75000.).is_null());
+    EXPECT_TRUE(write("BTC-USD", Side::BUY, OrderType::BRACKET, TimeInForce::GOOD_UNTIL_CANCELLED, 1, 75000., 69000.).is_null());
+}
+
+// Sizes never round up past the amount asked for; sizes and prices that do not
+// convert are rejected.
+TEST_F(OrderRequestTests, SizesRoundTowardZero) {
+    auto body = write("BTC-USD", Side::BUY, OrderType::LIMIT, TimeInForce::GOOD_UNTIL_CANCELLED, 0.000000019, 72575.015);
+    ASSERT_FALSE(body.is_null());
+    EXPECT_EQ(body["order_configuration"]["limit_limit_gtc"]["base_size"], "0.00000001");
+    EXPECT_EQ(body["order_configuration"]["limit_limit_gtc"]["limit_price"], "72575.02");
+
+    CreateOrderResponse rsp;
+    ASSERT_TRUE(writer_.writeCreateOrder(rsp, "id-1", "BTC-USD", Side::BUY, OrderType::MARKET, TimeInForce::IMMEDIATE_OR_CANCEL, 0.015, NAN, false, true,
+        {}, {}, {}, {}, {}, {}, {}, {}, {}));
+    EXPECT_EQ(json::parse(writer_.body())["order_configuration"]["market_market_ioc"]["quote_size"], "0.01");
+
+    EXPECT_TRUE(write("BTC-USD", Side::BUY, OrderType::LIMIT, TimeInForce::GOOD_UNTIL_CANCELLED, 0.000000009, 70000.).is_null());
+    EXPECT_TRUE(write("BTC-USD", Side::BUY, OrderType::LIMIT, TimeInForce::GOOD_UNTIL_CANCELLED, -1, 70000.).is_null());
+    EXPECT_TRUE(write("BTC-USD", Side::BUY, OrderType::LIMIT, TimeInForce::GOOD_UNTIL_CANCELLED, NAN, 70000.).is_null());
+    EXPECT_TRUE(write("BTC-USD", Side::BUY, OrderType::LIMIT, TimeInForce::GOOD_UNTIL_CANCELLED, 1e12, 70000.).is_null());
+    EXPECT_TRUE(write("BTC-USD", Side::BUY, OrderType::LIMIT, TimeInForce::GOOD_UNTIL_CANCELLED, 1, INFINITY).is_null());
+    EXPECT_TRUE(write("BTC-USD", Side::BUY, OrderType::LIMIT, TimeInForce::GOOD_UNTIL_CANCELLED, 1, 1e20).is_null());
+    EXPECT_TRUE(write("BTC-USD", Side::SELL, OrderType::BRACKET, TimeInForce::GOOD_UNTIL_CANCELLED, 1, 75000., NAN).is_null());
+
+    OrderTemplate bid(btc_, Side::BUY, OrderType::LIMIT, TimeInForce::GOOD_UNTIL_CANCELLED);
+    ASSERT_TRUE(bid.isValid());
+    std::string out;
+    ASSERT_TRUE(bid.write(out, "id-2", 0.000000019, 72575.015));
+    EXPECT_EQ(json::parse(out)["order_configuration"]["limit_limit_gtc"]["base_size"], "0.00000001");
+    EXPECT_FALSE(bid.write(out, "id-2", 0.000000009, 72575.01));
+    EXPECT_FALSE(bid.write(out, "id-2", INFINITY, 72575.01));
+    EXPECT_FALSE(bid.write(out, "id-2", 1, NAN));
+}
+
+// Orders for products without increments are rejected instead of guessing a
+// precision; the failed lookup is cached by the catalog.
+TEST_F(OrderRequestTests, UnknownProduct) {
+    ProductCatalog::instance().setBaseUrl("http://127.0.0.1:9");
+    for (int i = 0; i < 2; ++i) {
+        CreateOrderResponse rsp;
+        EXPECT_FALSE(writer_.writeCreateOrder(rsp, "id-1", "NOPE-USD", Side::BUY, OrderType::LIMIT, TimeInForce::GOOD_UNTIL_CANCELLED, 1, 1., true, false,
+            {}, {}, {}, {}, {}, {}, {}, {}, {}));
+        EXPECT_FALSE(rsp.success);
+    }
+    EXPECT_EQ(ProductCatalog::instance().find("NOPE-USD"), nullptr);
+    EXPECT_FALSE(OrderTemplate(Product{}, Side::BUY, OrderType::LIMIT, TimeInForce::GOOD_UNTIL_CANCELLED).isValid());
+    ProductCatalog::instance().setBaseUrl("https://api.coinbase.com");
+}
+
+TEST_F(OrderRequestTests, TemplateMatchesWriter) {
+    OrderTemplate bid(btc_, Side::BUY, OrderType::LIMIT, TimeInForce::GOOD_UNTIL_CANCELLED);
+    ASSERT_TRUE(bid.isValid());
+    EXPECT_TRUE(bid.usesLimitPrice());
+    EXPECT_EQ(bid.productId(), "BTC-USD");
+
+    std::string body;
+    for (double price : {72575.01, 72575.02, 0.5}) {
+        CreateOrderResponse rsp;
+        ASSERT_TRUE(writer_.writeCreateOrder(rsp, R"(id-"1")", "BTC-USD", Side::BUY, OrderType::LIMIT, TimeInForce::GOOD_UNTIL_CANCELLED, 0.0125, price, true, false,
+            {}, {}, {}, {}, {}, {}, {}, {}, {}));
+        ASSERT_TRUE(bid.write(body, R"(id-"1")", 0.0125, price));
+        EXPECT_EQ(body, writer_.body());
+    }
+
+    OrderTemplate market(btc_, Side::SELL, OrderType::MARKET, TimeInForce::IMMEDIATE_OR_CANCEL, false, true);
+    ASSERT_TRUE(market.isValid());
+    EXPECT_FALSE(market.usesLimitPrice());
+    ASSERT_TRUE(market.write(body, "id-2", 100, NAN));
+    auto j = json::parse(body);
+    EXPECT_EQ(j["client_order_id"], "id-2");
+    EXPECT_EQ(j["order_configuration"]["market_market_ioc"]["quote_size"], "100.00");
+
+    OrderTemplate stop_loss(btc_, Side::SELL, OrderType::BRACKET, TimeInForce::GOOD_UNTIL_CANCELLED, false, false, 69000.);
+    ASSERT_TRUE(stop_loss.isValid());
+    EXPECT_TRUE(stop_loss.usesLimitPrice());
+    ASSERT_TRUE(stop_loss.write(body, "id-3", 1, 75000.));
+    j = json::parse(body);
+    EXPECT_EQ(j["order_configuration"]["trigger_bracket_gtc"]["limit_price"], "75000.00");
+    EXPECT_EQ(j["order_configuration"]["trigger_bracket_gtc"]["stop_trigger_price"], "69000.00");
+}
+
+TEST_F(OrderRequestTests, InvalidTemplate) {
+    OrderTemplate t(btc_, Side::BUY, OrderType::LIMIT, TimeInForce::GOOD_UNTIL_DATE_TIME);
+    EXPECT_FALSE(t.isValid());
+    EXPECT_FALSE(OrderTemplate().isValid());
+    EXPECT_FALSE(OrderTemplate(btc_, Side::BUY, OrderType::STOP_LIMIT, TimeInForce::GOOD_UNTIL_CANCELLED).isValid());
+}
+
+}
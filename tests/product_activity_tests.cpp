@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <coinbase/product_activity.hpp>
+
+namespace coinbase::tests {
+
+namespace {
+
+constexpr uint64_t MS = 1'000'000;
+
+}   // end anonymous namespace
+
+TEST(ProductActivityTests, RecordAndQuery) {
+    ProductActivityTracker tracker(std::chrono::milliseconds(100));
+    ProductActivity activity;
+    EXPECT_FALSE(tracker.get(7, activity));
+    EXPECT_FALSE(tracker.get(INVALID_PRODUCT_HANDLE, activity));
+    EXPECT_EQ(tracker.age(7, 1000 * MS), std::chrono::nanoseconds::max());
+    EXPECT_TRUE(tracker.isStale(7, 1000 * MS));
+    EXPECT_FALSE(tracker.record(INVALID_PRODUCT_HANDLE, 1, 0, 1000 * MS));
+
+    // ten events a second apart by 100 ms, in another chunk as well
+    for (uint64_t i = 0; i <= 10; ++i) {
+        EXPECT_FALSE(tracker.record(7, 100 + i, 5000 + i, 1000 * MS + i * 100 * MS));
+    }
+    EXPECT_FALSE(tracker.record(1000, 200, 6000, 2000 * MS));
+    EXPECT_EQ(tracker.tracked(), (std::vector<ProductHandle>{7, 1000}));
+
+    ASSERT_TRUE(tracker.get(7, activity));
+    EXPECT_EQ(activity.last_seq_num, 110u);
+    EXPECT_EQ(activity.last_event_time, 5010u);
+    EXPECT_EQ(activity.last_receive_time, 2000 * MS);
+    EXPECT_EQ(activity.event_count, 11u);
+    EXPECT_DOUBLE_EQ(activity.event_rate, 10.);
+    EXPECT_FALSE(tracker.get(8, activity));
+
+    EXPECT_EQ(tracker.age(7, 2050 * MS), std::chrono::milliseconds(50));
+    EXPECT_FALSE(tracker.isStale(7, 2050 * MS));
+    EXPECT_TRUE(tracker.isStale(7, 2100 * MS));
+}
+
+TEST(ProductActivityTests, ScanReportsOnce) {
+    ProductActivityTracker tracker(std::chrono::milliseconds(100));
+    tracker.record(1, 1, 0, 1000 * MS);
+    tracker.record(2, 2, 0, 1080 * MS);
+
+    std::vector<std::pair<ProductHandle, std::chrono::nanoseconds>> stale;
+    auto on_stale = [&](ProductHandle handle, std::chrono::nanoseconds age) {
+        stale.emplace_back(handle, age);
+    };
+    EXPECT_TRUE(tracker.scanDue(1000 * MS));
+    tracker.scan(1100 * MS, on_stale);
+    ASSERT_EQ(stale.size(), 1u);
+    EXPECT_EQ(stale[0].first, 1u);
+    EXPECT_EQ(stale[0].second, std::chrono::milliseconds(100));
+
+    // a quarter of stale_after between scans
+    EXPECT_FALSE(tracker.scanDue(1110 * MS));
+    EXPECT_TRUE(tracker.scanDue(1125 * MS));
+    tracker.scan(1200 * MS, on_stale);
+    ASSERT_EQ(stale.size(), 2u);
+    EXPECT_EQ(stale[1].first, 2u);
+
+    // reported once until it is active again
+    tracker.scan(1300 * MS, on_stale);
+    EXPECT_EQ(stale.size(), 2u);
+    EXPECT_TRUE(tracker.record(1, 3, 0, 1310 * MS));
+    EXPECT_FALSE(tracker.record(1, 4, 0, 1320 * MS));
+    tracker.scan(1420 * MS, on_stale);
+    ASSERT_EQ(stale.size(), 3u);
+    EXPECT_EQ(stale[2].first, 1u);
+}
+
+TEST(ProductActivityTests, ConcurrentReaders) {
+    ProductActivityTracker tracker;
+    std::atomic<bool> stop{false};
+    tracker.record(3, 1, 1, 1);
+    std::thread reader([&] {
+        ProductActivity activity;
+        while (!stop.load()) {
+            ASSERT_TRUE(tracker.get(3, activity));
+            // fields written together are read together
+            EXPECT_EQ(activity.last_seq_num, activity.event_count);
+            EXPECT_EQ(activity.last_event_time, activity.last_receive_time);
+        }
+    });
+    for (uint64_t i = 2; i < 100000; ++i) {
+        tracker.record(3, i, i, i);
+    }
+    stop = true;
+    reader.join();
+}
+
+}
@@ -0,0 +1,274 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <coinbase/product_catalog.hpp>
+
+namespace coinbase::tests {
+
+namespace {
+
+Product make_product(std::string id, double quote_increment, double base_increment) {
+    Product p{};
+    p.product_id = std::move(id);
+    p.quote_increment = quote_increment;
+    p.base_increment = base_increment;
+    p.product_type = ProductType::SPOT;
+    p.status = "online";
+    return p;
+}
+
+}   // end anonymous namespace
+
+class ProductCatalogTests : public ::testing::Test {
+protected:
+    ProductCatalog catalog_;
+};
+
+TEST_F(ProductCatalogTests, LoadAndFind) {
+    EXPECT_FALSE(catalog_.loaded());
+    EXPECT_EQ(catalog_.find("BTC-USD"), nullptr);
+
+    catalog_.add(make_product("BTC-USD", 0.01, 0.00000001));
+    EXPECT_FALSE(catalog_.loaded());
+    ASSERT_NE(catalog_.find("BTC-USD"), nullptr);
+    EXPECT_EQ(catalog_.find("BTC-USD")->quote_increment, 0.01);
+    // found without a network fetch
+    EXPECT_EQ(&catalog_.get("BTC-USD"), catalog_.find("BTC-USD"));
+    EXPECT_TRUE(catalog_.get("").product_id.empty());
+
+    auto version = catalog_.version();
+    catalog_.load({make_product("ETH-USD", 0.01, 0.0001), make_product("SOL-USD", 0.01, 0.001)});
+    EXPECT_TRUE(catalog_.loaded());
+    EXPECT_GT(catalog_.version(), version);
+    EXPECT_EQ(catalog_.size(), 3u);
+    EXPECT_EQ(catalog_.find("SOL-USD")->base_increment, 0.001);
+
+    // a loaded catalog resolves loadAsync() without a request
+    EXPECT_TRUE(catalog_.loadAsync().get());
+}
+
+// A failed load can be retried, and destroying a catalog waits for its load.
+TEST_F(ProductCatalogTests, LoadAsyncFailureAndShutdown) {
+    auto catalog = std::make_unique<ProductCatalog>();
+    EXPECT_FALSE(catalog->loadAsync("http://127.0.0.1:9").get());
+    EXPECT_FALSE(catalog->loaded());
+    EXPECT_FALSE(catalog->loadAsync().get());
+    catalog->loadAsync();
+    catalog.reset();
+}
+
+TEST_F(ProductCatalogTests, StatusUpdates) {
+    catalog_.add(make_product("BTC-USD", 0.01, 0.00000001));
+    const auto &before = *catalog_.find("BTC-USD");
+    auto version = catalog_.version();
+
+    Status unchanged{};
+    unchanged.id = "BTC-USD";
+    unchanged.status = "online";
+    unchanged.quote_increment = 0.01;
+    unchanged.base_increment = 0.00000001;
+    catalog_.update({unchanged});
+    EXPECT_EQ(catalog_.version(), version);
+
+    Status changed = unchanged;
+    changed.status = "delisted";
+    changed.quote_increment = 0.1;
+    Status added{};
+    added.id = "NEW-USD";
+    added.base_currency = "NEW";
+    added.quote_currency = "USD";
+    added.status = "online";
+    added.quote_increment = 0.0001;
+    added.base_increment = 1.;
+    added.product_type = ProductType::SPOT;
+    catalog_.update({changed, added});
+    EXPECT_GT(catalog_.version(), version);
+
+    EXPECT_EQ(catalog_.find("BTC-USD")->status, "delisted");
+    EXPECT_EQ(catalog_.find("BTC-USD")->quote_increment, 0.1);
+    // earlier references stay valid with the values they were read with
+    EXPECT_EQ(before.quote_increment, 0.01);
+
+    ASSERT_NE(catalog_.find("NEW-USD"), nullptr);
+    EXPECT_EQ(catalog_.find("NEW-USD")->quote_currency_id, "USD");
+    EXPECT_EQ(catalog_.find("NEW-USD")->base_increment, 1.);
+}
+
+TEST_F(ProductCatalogTests, LoadFromFile) {
+    auto path = (std::filesystem::temp_directory_path() / "coinbase_products_test.json").string();
+    {
+        std::ofstream file(path);
+        file << R"({"products":[)"
+             << R"({"product_id":"BTC-USD","quote_increment":"0.01","base_increment":"0.00000001","product_type":"SPOT","status":"online"},)"
+             << R"({"product_id":"ETH-USD","quote_increment":"0.01","base_increment":"0.00000001","product_type":"SPOT","status":"online"})"
+             << R"(],"num_products":2})";
+    }
+    EXPECT_TRUE(catalog_.loadFromFile(path));
+    EXPECT_TRUE(catalog_.loaded());
+    EXPECT_EQ(catalog_.size(), 2u);
+    ASSERT_NE(catalog_.find("ETH-USD"), nullptr);
+    EXPECT_EQ(catalog_.find("ETH-USD")->quote_increment, 0.01);
+    std::remove(path.c_str());
+
+    EXPECT_FALSE(catalog_.loadFromFile(path));
+}
+
+TEST_F(ProductCatalogTests, BinarySnapshot) {
+    auto path = (std::filesystem::temp_directory_path() / "coinbase_products_test.bin").string();
+    auto btc = make_product("BTC-USD", 0.01, 0.00000001);
+    btc.base_currency_id = "BTC";
+    btc.quote_currency_id = "USD";
+    btc.base_min_size = 0.00000001;
+    btc.quote_min_size = 1.;
+    btc.post_only = true;
+    auto future = make_product("BIT-27MAR26-CDE", 5., 1.);
+    future.product_type = ProductType::FUTURE;
+    future.cancel_only = true;
+    future.future_product_details.contract_size = 0.01;
+    future.future_product_details.contract_expiry = 1774627200000000000ull;
+    future.future_product_details.contract_expiry_type = "EXPIRING";
+    future.future_product_details.group_description = "not kept";
+    catalog_.load({btc, future});
+    ASSERT_TRUE(catalog_.saveSnapshot(path));
+    EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+
+    ProductCatalog restored;
+    ASSERT_TRUE(restored.loadSnapshot(path));
+    EXPECT_FALSE(restored.loaded());
+    EXPECT_EQ(restored.size(), 2u);
+    const auto *p = restored.find("BTC-USD");
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(p->base_currency_id, "BTC");
+    EXPECT_EQ(p->quote_currency_id, "USD");
+    EXPECT_EQ(p->status, "online");
+    EXPECT_EQ(p->quote_increment, 0.01);
+    EXPECT_EQ(p->base_increment, 0.00000001);
+    EXPECT_EQ(p->quote_min_size, 1.);
+    EXPECT_TRUE(p->post_only);
+    EXPECT_FALSE(p->cancel_only);
+    p = restored.find("BIT-27MAR26-CDE");
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(p->product_type, ProductType::FUTURE);
+    EXPECT_TRUE(p->cancel_only);
+    EXPECT_EQ(p->future_product_details.contract_size, 0.01);
+    EXPECT_EQ(p->future_product_details.contract_expiry, 1774627200000000000ull);
+    EXPECT_EQ(p->future_product_details.contract_expiry_type, "EXPIRING");
+    EXPECT_TRUE(p->future_product_details.group_description.empty());
+
+    // a snapshot loaded after the REST list does not revert it
+    auto fresh = btc;
+    fresh.status = "cancel_only";
+    fresh.quote_increment = 0.1;
+    ProductCatalog refreshed;
+    refreshed.load({fresh});
+    ASSERT_TRUE(refreshed.loadSnapshot(path));
+    EXPECT_EQ(refreshed.size(), 2u);
+    EXPECT_EQ(refreshed.find("BTC-USD")->status, "cancel_only");
+    EXPECT_EQ(refreshed.find("BTC-USD")->quote_increment, 0.1);
+    EXPECT_NE(refreshed.find("BIT-27MAR26-CDE"), nullptr);
+
+    // truncated files are rejected without touching the catalog
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    ProductCatalog truncated;
+    EXPECT_FALSE(truncated.loadSnapshot(path));
+    EXPECT_EQ(truncated.size(), 0u);
+    std::remove(path.c_str());
+
+    ProductCatalog missing;
+    EXPECT_FALSE(missing.useSnapshot(path));
+    EXPECT_EQ(missing.snapshotPath(), path);
+}
+
+TEST_F(ProductCatalogTests, HandlesAndSpecs) {
+    ProductSpec spec;
+    EXPECT_EQ(catalog_.handle("BTC-USD"), INVALID_PRODUCT_HANDLE);
+    EXPECT_FALSE(catalog_.spec(0, spec));
+    EXPECT_FALSE(catalog_.spec(INVALID_PRODUCT_HANDLE, spec));
+
+    catalog_.load({make_product("BTC-USD", 0.01, 0.00000001), make_product("ETH-USD", 0.01, 0.0001)});
+    auto btc = catalog_.handle("BTC-USD");
+    auto eth = catalog_.handle("ETH-USD");
+    ASSERT_NE(btc, INVALID_PRODUCT_HANDLE);
+    ASSERT_NE(eth, INVALID_PRODUCT_HANDLE);
+    EXPECT_NE(btc, eth);
+    EXPECT_EQ(catalog_.product(btc), catalog_.find("BTC-USD"));
+    EXPECT_EQ(catalog_.product(INVALID_PRODUCT_HANDLE), nullptr);
+
+    ASSERT_TRUE(catalog_.spec(btc, spec));
+    EXPECT_EQ(spec.handle, btc);
+    EXPECT_EQ(spec.product_id, "BTC-USD");
+    EXPECT_EQ(spec.price.decimals(), 2u);
+    EXPECT_EQ(spec.base_size.decimals(), 8u);
+    EXPECT_EQ(spec.product_type, ProductType::SPOT);
+    EXPECT_TRUE(spec.online);
+
+    // updates keep the handle and the interned id
+    auto id = spec.product_id;
+    Status s{};
+    s.id = "BTC-USD";
+    s.status = "offline";
+    s.quote_increment = 0.1;
+    s.base_increment = 0.00000001;
+    catalog_.update({s});
+    EXPECT_EQ(catalog_.handle("BTC-USD"), btc);
+    ASSERT_TRUE(catalog_.spec(btc, spec));
+    EXPECT_EQ(spec.price.decimals(), 1u);
+    EXPECT_FALSE(spec.online);
+    EXPECT_EQ(spec.product_id.data(), id.data());
+    EXPECT_EQ(catalog_.product(btc)->quote_increment, 0.1);
+}
+
+TEST_F(ProductCatalogTests, InternedIds) {
+    auto handle = catalog_.intern("NEW-USD");
+    ASSERT_NE(handle, INVALID_PRODUCT_HANDLE);
+    EXPECT_EQ(catalog_.intern("NEW-USD"), handle);
+    EXPECT_EQ(catalog_.handle("NEW-USD"), handle);
+    EXPECT_EQ(catalog_.productId(handle), "NEW-USD");
+    EXPECT_EQ(catalog_.intern(""), INVALID_PRODUCT_HANDLE);
+    // no product behind an interned id yet
+    EXPECT_EQ(catalog_.size(), 0u);
+    EXPECT_EQ(catalog_.find("NEW-USD"), nullptr);
+    ProductSpec spec;
+    EXPECT_FALSE(catalog_.spec(handle, spec));
+
+    catalog_.add(make_product("NEW-USD", 0.0001, 1.));
+    EXPECT_EQ(catalog_.handle("NEW-USD"), handle);
+    EXPECT_EQ(catalog_.size(), 1u);
+    ASSERT_TRUE(catalog_.spec(handle, spec));
+    EXPECT_EQ(spec.price.decimals(), 4u);
+
+    // events decoded on any thread resolve to the process-wide handles
+    auto global = intern_product_id("BTC-USD");
+    EXPECT_EQ(global, ProductCatalog::instance().handle("BTC-USD"));
+    EXPECT_EQ(intern_product_id("BTC-USD"), global);
+    EXPECT_EQ(ProductCatalog::instance().productId(global), "BTC-USD");
+}
+
+TEST_F(ProductCatalogTests, ConcurrentReaders) {
+    catalog_.add(make_product("BTC-USD", 0.01, 0.00000001));
+    std::atomic<bool> stop{false};
+    std::thread reader([&] {
+        while (!stop.load()) {
+            auto *p = catalog_.find("BTC-USD");
+            ASSERT_NE(p, nullptr);
+            EXPECT_GT(p->quote_increment, 0.);
+            ProductSpec spec;
+            ASSERT_TRUE(catalog_.spec(0, spec));
+            EXPECT_TRUE(spec.price.decimals() == 1u || spec.price.decimals() == 2u);
+        }
+    });
+    for (int i = 0; i < 200; ++i) {
+        Status s{};
+        s.id = "BTC-USD";
+        s.status = "online";
+        s.quote_increment = (i % 2) ? 0.01 : 0.1;
+        s.base_increment = 0.00000001;
+        catalog_.update({s});
+    }
+    stop = true;
+    reader.join();
+}
+
+}
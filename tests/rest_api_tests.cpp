@@ -63,6 +63,25 @@ TEST_F(CoinbaseAdvancedTest, GetServerTimeTest) {
     EXPECT_TRUE(timestamp > 0);
 }
 
+TEST_F(CoinbaseAdvancedTest, ConnectionPoolTest) {
+    auto &pool = client_.connection_pool();
+    auto size = pool.config().size;
+    ASSERT_GT(size, 0u);
+    EXPECT_TRUE(wait_for_condition([&] { return pool.idle() == size; }, std::chrono::seconds(10)));
+
+    // requests borrow a warm connection and hand it back
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_GT(client_.get_server_time(), 0u);
+    }
+    EXPECT_EQ(pool.idle(), size);
+
+    // without a pool every request opens its own connection
+    HttpsConnectionPool unpooled(client_.base_url(), ConnectionPoolConfig{.size = 0});
+    auto res = unpooled.get("/api/v3/brokerage/time");
+    EXPECT_TRUE(res.is_ok());
+    EXPECT_EQ(unpooled.idle(), 0u);
+}
+
 TEST_F(CoinbaseAdvancedTest, ListAccountsGetAccountTest) {
     auto accounts = client_.list_accounts();
     EXPECT_FALSE(accounts.empty());
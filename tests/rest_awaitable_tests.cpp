@@ -8,12 +8,15 @@
 #include <boost/asio/co_spawn.hpp>
 #include <boost/asio/detached.hpp>
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
 #include <boost/asio/use_awaitable.hpp>
 
 #include <slick/logger.hpp>
 #include <slick/net/logging.hpp>
 
 #include <coinbase/rest_awaitable.hpp>
+#include <coinbase/product_catalog.hpp>
 
 namespace asio = boost::asio;
 using namespace coinbase;
@@ -404,6 +407,16 @@ TEST_F(CoinbaseAwaitableTest, GetNonExistentProductTest) {
     EXPECT_TRUE(product.product_id.empty() || product.product_id == "INVALID-PRODUCT");
 }
 
+TEST_F(CoinbaseAwaitableTest, CreateOrderNonExistentProductTest) {
+    auto rsp = run_async([this]() -> asio::awaitable<CreateOrderResponse> {
+        co_return co_await client_.create_order("id-1", "INVALID-PRODUCT", Side::BUY, OrderType::LIMIT, TimeInForce::GOOD_UNTIL_CANCELLED, 1, 1.);
+    });
+
+    // rejected before an order is sent
+    EXPECT_FALSE(rsp.success);
+    EXPECT_EQ(ProductCatalog::instance().find("INVALID-PRODUCT"), nullptr);
+}
+
 TEST_F(CoinbaseAwaitableTest, GetNonExistentAccountTest) {
     auto account = run_async([this]() -> asio::awaitable<Account> {
         co_return co_await client_.get_account("00000000-0000-0000-0000-000000000000");
@@ -620,9 +633,7 @@ TEST_F(CoinbaseAwaitableTest, GetPerpsPortfolioBalancesTest) {
 
 TEST_F(CoinbaseAwaitableTest, ConcurrentOperationsTest) {
     run_async([this]() -> asio::awaitable<void> {
-        // Launch multiple concurrent operations by directly awaiting without storing
-        // Note: These will execute sequentially, not truly concurrently, but demonstrate
-        // that multiple async operations can be chained together
+        // Chain several operations in one coroutine
         auto timestamp = co_await client_.get_server_time();
         auto accounts = co_await client_.list_accounts();
         auto products = co_await client_.list_public_products();
@@ -638,4 +649,41 @@ TEST_F(CoinbaseAwaitableTest, ConcurrentOperationsTest) {
     });
 }
 
+TEST_F(CoinbaseAwaitableTest, ConcurrentRequestsShareOneThread) {
+    constexpr int REQUESTS = 8;
+    int completed = 0;
+    int succeeded = 0;
+    int ticks_in_flight = 0;
+
+    for (int i = 0; i < REQUESTS; ++i) {
+        asio::co_spawn(*io_context_, [&]() -> asio::awaitable<void> {
+            auto timestamp = co_await client_.get_server_time();
+            if (timestamp > 0) {
+                ++succeeded;
+            }
+            ++completed;
+        }, asio::detached);
+    }
+
+    // a request that blocked the thread would starve this timer until it finished
+    asio::co_spawn(*io_context_, [&]() -> asio::awaitable<void> {
+        asio::steady_timer timer(co_await asio::this_coro::executor);
+        while (completed < REQUESTS) {
+            timer.expires_after(std::chrono::milliseconds(1));
+            co_await timer.async_wait(asio::use_awaitable);
+            if (completed < REQUESTS) {
+                ++ticks_in_flight;
+            }
+        }
+    }, asio::detached);
+
+    io_context_->run();
+    io_context_->restart();
+
+    EXPECT_EQ(completed, REQUESTS);
+    EXPECT_EQ(succeeded, REQUESTS);
+    EXPECT_GT(ticks_in_flight, 0);
+    LOG_INFO("{} concurrent requests, timer ticked {} times while in flight", REQUESTS, ticks_in_flight);
+}
+
 }  // namespace coinbase::tests
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <coinbase/subscription_batcher.hpp>
+
+namespace coinbase::tests {
+
+namespace {
+
+using namespace std::chrono_literals;
+
+struct SentMessages {
+    std::mutex mutex;
+    std::vector<SubscriptionMessage> messages;
+    std::vector<std::chrono::steady_clock::time_point> sent_at;
+
+    SubscriptionBatcher::Sender sender() {
+        return [this](const SubscriptionMessage &message) {
+            std::lock_guard lock(mutex);
+            messages.push_back(message);
+            sent_at.push_back(std::chrono::steady_clock::now());
+        };
+    }
+
+    bool waitFor(std::size_t count, std::chrono::milliseconds timeout = 5s) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (std::chrono::steady_clock::now() < deadline) {
+            {
+                std::lock_guard lock(mutex);
+                if (messages.size() >= count) {
+                    return true;
+                }
+            }
+            std::this_thread::sleep_for(1ms);
+        }
+        return false;
+    }
+};
+
+}   // end anonymous namespace
+
+TEST(SubscriptionBatcherTests, CoalescesAndSplits) {
+    SentMessages sent;
+    // the window never closes on its own, so drain() sees everything
+    SubscriptionBatcher batcher(sent.sender(), {std::chrono::hours(1), 2, 8});
+    batcher.subscribe("level2", {"BTC-USD", "ETH-USD"});
+    batcher.subscribe("level2", {"SOL-USD"});
+    batcher.unsubscribe("level2", {"ETH-USD"});
+    batcher.subscribe("ticker", {"BTC-USD"});
+    batcher.unsubscribe("ticker", {"BTC-USD"});
+    batcher.subscribe("status", {"BTC-USD"});
+    batcher.unsubscribe("status", {});
+    batcher.subscribe("heartbeats", {});
+    batcher.subscribe("market_trades", {"A-USD", "B-USD", "C-USD", "D-USD", "E-USD"});
+    EXPECT_EQ(batcher.pending(), 5u);
+
+    auto messages = batcher.drain();
+    EXPECT_EQ(batcher.pending(), 0u);
+    ASSERT_EQ(messages.size(), 8u);
+
+    EXPECT_EQ(messages[0].channel, "heartbeats");
+    EXPECT_TRUE(messages[0].subscribe);
+    EXPECT_TRUE(messages[0].product_ids.empty());
+
+    EXPECT_EQ(messages[1].channel, "level2");
+    EXPECT_FALSE(messages[1].subscribe);
+    EXPECT_EQ(messages[1].product_ids, (std::vector<std::string>{"ETH-USD"}));
+    EXPECT_EQ(messages[2].channel, "level2");
+    EXPECT_TRUE(messages[2].subscribe);
+    EXPECT_EQ(messages[2].product_ids, (std::vector<std::string>{"BTC-USD", "SOL-USD"}));
+
+    // split into max_products_per_message
+    for (std::size_t i = 3; i < 6; ++i) {
+        EXPECT_EQ(messages[i].channel, "market_trades");
+        EXPECT_TRUE(messages[i].subscribe);
+    }
+    EXPECT_EQ(messages[3].product_ids, (std::vector<std::string>{"A-USD", "B-USD"}));
+    EXPECT_EQ(messages[5].product_ids, (std::vector<std::string>{"E-USD"}));
+
+    // a whole-channel unsubscribe supersedes the subscribes before it
+    EXPECT_EQ(messages[6].channel, "status");
+    EXPECT_FALSE(messages[6].subscribe);
+    EXPECT_TRUE(messages[6].product_ids.empty());
+
+    EXPECT_EQ(messages[7].channel, "ticker");
+    EXPECT_FALSE(messages[7].subscribe);
+    EXPECT_EQ(messages[7].product_ids, (std::vector<std::string>{"BTC-USD"}));
+}
+
+TEST(SubscriptionBatcherTests, FlushAndClear) {
+    SentMessages sent;
+    SubscriptionBatcher batcher(sent.sender(), {std::chrono::hours(1), 100, 8});
+    batcher.subscribe("level2", {"BTC-USD"});
+    batcher.clear();
+    EXPECT_EQ(batcher.pending(), 0u);
+
+    batcher.subscribe("level2", {"ETH-USD"});
+    batcher.flush();
+    ASSERT_TRUE(sent.waitFor(1));
+    std::lock_guard lock(sent.mutex);
+    ASSERT_EQ(sent.messages.size(), 1u);
+    EXPECT_EQ(sent.messages[0].product_ids, (std::vector<std::string>{"ETH-USD"}));
+}
+
+TEST(SubscriptionBatcherTests, PacesMessages) {
+    SentMessages sent;
+    SubscriptionBatcher batcher(sent.sender(), {1ms, 1, 50});
+    std::vector<std::string> products;
+    for (int i = 0; i < 60; ++i) {
+        products.push_back("P" + std::to_string(100 + i) + "-USD");
+    }
+    batcher.subscribe("ticker", products);
+    ASSERT_TRUE(sent.waitFor(60));
+
+    std::lock_guard lock(sent.mutex);
+    ASSERT_EQ(sent.messages.size(), 60u);
+    for (std::size_t i = 0; i < products.size(); ++i) {
+        EXPECT_EQ(sent.messages[i].product_ids, std::vector<std::string>{products[i]});
+    }
+    // a burst of 50, then the other 10 at 50 per second
+    EXPECT_GE(sent.sent_at.back() - sent.sent_at.front(), 150ms);
+}
+
+}
@@ -65,4 +65,50 @@ TEST_F(TimestampParsingTests, ParseL2UpdateMessage) {
     EXPECT_DOUBLE_EQ(batch.updates[2].new_quantity, 13.0);
 }
 
+TEST_F(TimestampParsingTests, FractionDigits) {
+    // 2026-03-05T09:05:32Z
+    constexpr uint64_t base = 1772701532ULL * 1000000000ULL;
+    EXPECT_EQ(to_nanoseconds("2026-03-05T09:05:32Z"), base);
+    EXPECT_EQ(to_nanoseconds("2026-03-05T09:05:32.5Z"), base + 500000000ULL);
+    EXPECT_EQ(to_nanoseconds("2026-03-05T09:05:32.123Z"), base + 123000000ULL);
+    EXPECT_EQ(to_nanoseconds("2026-03-05T09:05:32.000000001Z"), base + 1ULL);
+    EXPECT_EQ(to_nanoseconds("2026-03-05T09:05:32.999999999Z"), base + 999999999ULL);
+    // digits beyond nanoseconds are truncated
+    EXPECT_EQ(to_nanoseconds("2026-03-05T09:05:32.1234567899Z"), base + 123456789ULL);
+    // zone designator is ignored
+    EXPECT_EQ(to_nanoseconds("2026-03-05T09:05:32.25+00:00"), base + 250000000ULL);
+    EXPECT_EQ(to_nanoseconds("2026-03-05T09:05:32.25"), base + 250000000ULL);
+}
+
+TEST_F(TimestampParsingTests, Resolutions) {
+    std::string_view ts = "2026-03-05T09:05:32.483569449Z";
+    EXPECT_EQ(to_nanoseconds(ts), 1772701532483569449ULL);
+    EXPECT_EQ(to_microseconds(ts), 1772701532483569ULL);
+    EXPECT_EQ(to_milliseconds(ts), 1772701532483ULL);
+    // parses from a view that is not NUL-terminated
+    std::string buffer = "\"2026-03-05T09:05:32.483569449Z\",";
+    EXPECT_EQ(to_nanoseconds(std::string_view(buffer).substr(1, ts.size())), 1772701532483569449ULL);
+}
+
+TEST_F(TimestampParsingTests, CalendarDates) {
+    EXPECT_EQ(to_milliseconds("1970-01-01T00:00:00Z"), 0ULL);
+    EXPECT_EQ(to_milliseconds("2000-01-01T00:00:00Z"), 946684800000ULL);
+    EXPECT_EQ(to_milliseconds("2024-02-29T23:59:59Z"), 1709251199000ULL);
+    EXPECT_EQ(to_milliseconds("2024-03-01T00:00:00Z"), 1709251200000ULL);
+    EXPECT_EQ(to_milliseconds("2025-12-31T23:59:59.999Z"), 1767225599999ULL);
+    EXPECT_EQ(to_milliseconds("2026-01-01T00:00:00Z"), 1767225600000ULL);
+    // switching back and forth between days
+    EXPECT_EQ(to_milliseconds("2024-02-29T23:59:59Z"), 1709251199000ULL);
+    EXPECT_EQ(to_milliseconds("2026-01-01T00:00:00Z"), 1767225600000ULL);
+}
+
+TEST_F(TimestampParsingTests, MalformedInput) {
+    EXPECT_EQ(to_nanoseconds(""), 0ULL);
+    EXPECT_EQ(to_nanoseconds("2026-03-05"), 0ULL);
+    EXPECT_EQ(to_nanoseconds("2026/03/05T09:05:32Z"), 0ULL);
+    EXPECT_EQ(to_nanoseconds("2026-03-05T09:05:3xZ"), 0ULL);
+    EXPECT_EQ(to_nanoseconds("2026-13-05T09:05:32Z"), 0ULL);
+    EXPECT_EQ(to_nanoseconds("2026-03-05T25:05:32Z"), 0ULL);
+}
+
 } // namespace coinbase::tests
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <coinbase/top_of_book.hpp>
+
+namespace coinbase::tests {
+
+class TopOfBookTests : public ::testing::Test {
+protected:
+    void SetUp() override {
+        name_ = "coinbase_tob_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed())
+            + "_" + ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        TopOfBookTable::remove(name_.c_str());
+    }
+
+    void TearDown() override {
+        TopOfBookTable::remove(name_.c_str());
+    }
+
+    std::string name_;
+};
+
+TEST_F(TopOfBookTests, WriterAndReader) {
+    TopOfBookReader missing(name_.c_str());
+    EXPECT_FALSE(missing.isOpen());
+
+    TopOfBookWriter writer(name_.c_str(), 4);
+    ASSERT_TRUE(writer.isOpen());
+    EXPECT_EQ(writer.capacity(), 4u);
+    EXPECT_EQ(writer.slot("BTC-USD"), 0u);
+    EXPECT_EQ(writer.slot("ETH-USD"), 1u);
+    EXPECT_EQ(writer.slot("BTC-USD"), 0u);
+
+    writer.updateQuote("BTC-USD", 72575., 0.5, 72575.01, 1.25, 100);
+    writer.updateTrade("BTC-USD", 72575.01, 0.1, Side::BUY, 200);
+
+    TopOfBookReader reader(name_.c_str());
+    ASSERT_TRUE(reader.isOpen());
+    EXPECT_EQ(reader.size(), 2u);
+    EXPECT_EQ(reader.productId(1), "ETH-USD");
+    EXPECT_EQ(reader.find("ETH-USD"), 1u);
+    EXPECT_EQ(reader.find("SOL-USD"), TopOfBookTable::NO_SLOT);
+
+    TopOfBook top;
+    ASSERT_TRUE(reader.read("BTC-USD", top));
+    EXPECT_EQ(top.bid_price, 72575.);
+    EXPECT_EQ(top.bid_quantity, 0.5);
+    EXPECT_EQ(top.ask_price, 72575.01);
+    EXPECT_EQ(top.ask_quantity, 1.25);
+    EXPECT_EQ(top.last_price, 72575.01);
+    EXPECT_EQ(top.last_size, 0.1);
+    EXPECT_EQ(top.last_side, Side::BUY);
+    EXPECT_EQ(top.update_time, 200u);
+    EXPECT_FALSE(reader.read("SOL-USD", top));
+    EXPECT_FALSE(reader.read(7, top));
+}
+
+TEST_F(TopOfBookTests, CapacityAndReattach) {
+    {
+        TopOfBookWriter writer(name_.c_str(), 2);
+        ASSERT_TRUE(writer.isOpen());
+        EXPECT_EQ(writer.slot("BTC-USD"), 0u);
+        EXPECT_EQ(writer.slot("ETH-USD"), 1u);
+        EXPECT_EQ(writer.slot("SOL-USD"), TopOfBookTable::NO_SLOT);
+        writer.updateQuote("ETH-USD", 2000., 1., 2000.5, 2., 1);
+    }
+
+    // a restarted writer keeps the slots and their content
+    TopOfBookWriter writer(name_.c_str(), 2);
+    ASSERT_TRUE(writer.isOpen());
+    EXPECT_EQ(writer.slot("ETH-USD"), 1u);
+    TopOfBookReader reader(name_.c_str());
+    TopOfBook top;
+    ASSERT_TRUE(reader.read("ETH-USD", top));
+    EXPECT_EQ(top.ask_price, 2000.5);
+}
+
+// A writer that dies mid-update leaves an odd sequence behind: readers give
+// up on the slot instead of spinning, until a new writer attaches.
+TEST_F(TopOfBookTests, TornSlot) {
+    struct DeadWriter : public TopOfBookWriter {
+        using TopOfBookWriter::TopOfBookWriter;
+        void die(uint32_t slot) { slots_[slot].sequence.fetch_add(1); }
+    };
+    {
+        DeadWriter writer(name_.c_str());
+        writer.updateQuote("BTC-USD", 72575., 1., 72575.01, 2., 1);
+        writer.updateQuote("ETH-USD", 2000., 1., 2000.5, 2., 1);
+        writer.die(writer.slot("BTC-USD"));
+    }
+
+    TopOfBookReader reader(name_.c_str());
+    TopOfBook top;
+    EXPECT_FALSE(reader.read("BTC-USD", top));
+    ASSERT_TRUE(reader.read("ETH-USD", top));
+    EXPECT_EQ(top.bid_price, 2000.);
+
+    TopOfBookWriter writer(name_.c_str());
+    ASSERT_TRUE(reader.read("BTC-USD", top));
+    EXPECT_EQ(top.ask_price, 72575.01);
+}
+
+TEST_F(TopOfBookTests, TradesKeepLatest) {
+    TopOfBookWriter writer(name_.c_str());
+    MarketTrade newer{"2", "BTC-USD", 200, 101., 1., Side::SELL};
+    MarketTrade older{"1", "BTC-USD", 100, 100., 2., Side::BUY};
+    writer.update(newer);
+    writer.update(older);
+
+    TopOfBookReader reader(name_.c_str());
+    TopOfBook top;
+    ASSERT_TRUE(reader.read("BTC-USD", top));
+    EXPECT_EQ(top.last_price, 101.);
+    EXPECT_EQ(top.last_side, Side::SELL);
+}
+
+// Readers never observe a half-written slot.
+TEST_F(TopOfBookTests, SeqlockConsistency) {
+    TopOfBookWriter writer(name_.c_str());
+    auto slot = writer.slot("BTC-USD");
+    ASSERT_NE(slot, TopOfBookTable::NO_SLOT);
+    TopOfBookReader reader(name_.c_str());
+    ASSERT_TRUE(reader.isOpen());
+
+    std::atomic_bool done = false;
+    std::thread producer([&] {
+        for (uint64_t i = 1; i <= 200000; ++i) {
+            auto v = static_cast<double>(i);
+            writer.updateQuote("BTC-USD", v, v, v, v, i);
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    uint64_t torn = 0;
+    uint64_t last = 0;
+    TopOfBook top;
+    while (!done.load(std::memory_order_acquire)) {
+        ASSERT_TRUE(reader.read(slot, top));
+        auto v = static_cast<double>(top.update_time);
+        if (top.bid_price != v || top.bid_quantity != v || top.ask_price != v || top.ask_quantity != v) {
+            ++torn;
+        }
+        EXPECT_GE(top.update_time, last);
+        last = top.update_time;
+    }
+    producer.join();
+    EXPECT_EQ(torn, 0u);
+    ASSERT_TRUE(reader.read(slot, top));
+    EXPECT_EQ(top.update_time, 200000u);
+}
+
+}
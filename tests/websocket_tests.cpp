@@ -2,11 +2,13 @@
 #include <atomic>
 #include <cstdio>
 #include <filesystem>
+#include <future>
 #include <type_traits>
 
 #include <slick/logger.hpp>
 #include <slick/net/logging.hpp>
 #include <coinbase/websocket.hpp>
+#include <coinbase/static_data_handler.hpp>
 
 namespace coinbase::tests {
     template<typename CallbacksType>
@@ -522,6 +524,36 @@ namespace coinbase::tests {
         EXPECT_EQ(&client1->streamBufferMultiplexer(), &client2->streamBufferMultiplexer());
     }
 
+    // subscribe()/unsubscribe() maintain the set replayed on every reconnect.
+    TEST(WebSocketClientUnitTests, TracksSubscriptions) {
+        ConcreteUserThreadCallbacks callbacks;
+        WebSocketClient client(&callbacks, "wss://advanced-trade-ws.coinbase.com", "");
+        EXPECT_FALSE(client.subscriptionBatchingEnabled());
+        client.enableSubscriptionBatching();
+        EXPECT_TRUE(client.subscriptionBatchingEnabled());
+        client.subscribe({"ETH-USD", "BTC-USD"}, {WebSocketChannel::LEVEL2, WebSocketChannel::TICKER});
+        client.subscribe({}, {WebSocketChannel::HEARTBEATS});
+        client.subscribe({"BTC-USD"}, {WebSocketChannel::USER});   // no user data websocket
+
+        EXPECT_EQ(client.subscriptions(WebSocketChannel::LEVEL2), (std::vector<std::string>{"BTC-USD", "ETH-USD"}));
+        EXPECT_TRUE(client.isSubscribed(WebSocketChannel::HEARTBEATS));
+        EXPECT_TRUE(client.subscriptions(WebSocketChannel::HEARTBEATS).empty());
+        EXPECT_FALSE(client.isSubscribed(WebSocketChannel::USER));
+        EXPECT_FALSE(client.isSubscribed(WebSocketChannel::STATUS));
+
+        client.unsubscribe({"ETH-USD"}, {WebSocketChannel::LEVEL2});
+        EXPECT_EQ(client.subscriptions(WebSocketChannel::LEVEL2), (std::vector<std::string>{"BTC-USD"}));
+        client.unsubscribe({"BTC-USD"}, {WebSocketChannel::LEVEL2});
+        EXPECT_FALSE(client.isSubscribed(WebSocketChannel::LEVEL2));
+        client.unsubscribe({}, {WebSocketChannel::TICKER});
+        EXPECT_FALSE(client.isSubscribed(WebSocketChannel::TICKER));
+        EXPECT_TRUE(client.subscriptions(WebSocketChannel::TICKER).empty());
+        EXPECT_EQ(client.marketDataResubscribeStats().count, 0u);
+
+        client.stop();
+        EXPECT_FALSE(client.isSubscribed(WebSocketChannel::HEARTBEATS));
+    }
+
     // processData() must skip records whose producer_id is beyond the range that
     // UserThreadWebsocketCallbacks registered via addClient() without an OOB access.
     // Regression test for the missing bounds check on producer_types_[record.producer_id].
@@ -569,6 +601,694 @@ namespace coinbase::tests {
         EXPECT_NO_THROW(callbacks.processData(100));
     }
 
+    // Records the span-based Level2 callbacks without copying into a Level2UpdateBatch.
+    struct Level2ViewCallbacks : public ConcreteUserThreadCallbacks {
+        void onLevel2SnapshotView(WebSocketClient*, uint64_t seq_num, std::string_view product_id, std::span<const Level2Update> snapshot) override {
+            ++snapshot_count;
+            record(seq_num, product_id, snapshot);
+        }
+        void onLevel2UpdatesView(WebSocketClient*, uint64_t seq_num, std::string_view product_id, std::span<const Level2Update> updates) override {
+            ++update_count;
+            record(seq_num, product_id, updates);
+        }
+        void record(uint64_t seq_num, std::string_view product_id, std::span<const Level2Update> updates) {
+            last_seq_num = seq_num;
+            last_product_id = product_id;
+            last_data = updates.data();
+            last_updates.assign(updates.begin(), updates.end());
+        }
+        int snapshot_count = 0;
+        int update_count = 0;
+        uint64_t last_seq_num = 0;
+        std::string last_product_id;
+        const Level2Update *last_data = nullptr;
+        std::vector<Level2Update> last_updates;
+    };
+
+    // Records the legacy batch callbacks, fed by the default span-based implementations.
+    struct Level2BatchCallbacks : public ConcreteUserThreadCallbacks {
+        void onLevel2Updates(WebSocketClient*, uint64_t seq_num, const Level2UpdateBatch& updates) override {
+            last_seq_num = seq_num;
+            last_batch = updates;
+        }
+        uint64_t last_seq_num = 0;
+        Level2UpdateBatch last_batch;
+    };
+
+    const std::string L2_UPDATE_FRAME = R"({"channel":"l2_data","client_id":"","timestamp":"2026-03-05T09:05:32.483569449Z","sequence_num":1,"events":[{"type":"update","product_id":"BTC-USD","updates":[{"side":"bid","event_time":"2026-03-05T09:05:32.449176Z","price_level":"72575","new_quantity":"0.5"},{"side":"offer","event_time":"2026-03-05T09:05:32.449176Z","price_level":"72580.01","new_quantity":"0"}]}]})";
+
+    // Both decoders deliver Level2 events through the span-based callbacks, and the
+    // backing scratch buffer is reused from one frame to the next.
+    TEST(DataHandlerUnitTests, Level2ViewCallbacksReuseScratch) {
+        for (auto decoder : {MarketDataDecoder::DOM, MarketDataDecoder::ON_DEMAND}) {
+            Level2ViewCallbacks callbacks;
+            auto client = std::make_unique<WebSocketClient>(&callbacks, "", "");
+            client->setMarketDataDecoder(decoder);
+
+            callbacks.processMarketData(client.get(), L2_UPDATE_FRAME.data(), L2_UPDATE_FRAME.size());
+            ASSERT_EQ(callbacks.update_count, 1);
+            EXPECT_EQ(callbacks.last_seq_num, 1u);
+            EXPECT_EQ(callbacks.last_product_id, "BTC-USD");
+            ASSERT_EQ(callbacks.last_updates.size(), 2u);
+            EXPECT_EQ(callbacks.last_updates[0].side, Side::BUY);
+            EXPECT_DOUBLE_EQ(callbacks.last_updates[0].price_level, 72575.0);
+            EXPECT_DOUBLE_EQ(callbacks.last_updates[0].new_quantity, 0.5);
+            EXPECT_EQ(callbacks.last_updates[1].side, Side::SELL);
+            EXPECT_DOUBLE_EQ(callbacks.last_updates[1].price_level, 72580.01);
+            EXPECT_DOUBLE_EQ(callbacks.last_updates[1].new_quantity, 0.0);
+
+            auto first_data = callbacks.last_data;
+            auto next = L2_UPDATE_FRAME;
+            next.replace(next.find("\"sequence_num\":1"), 16, "\"sequence_num\":2");
+            callbacks.processMarketData(client.get(), next.data(), next.size());
+            ASSERT_EQ(callbacks.update_count, 2);
+            EXPECT_EQ(callbacks.last_seq_num, 2u);
+            EXPECT_EQ(callbacks.last_data, first_data);
+        }
+    }
+
+    // Callbacks that only implement onLevel2Updates keep receiving a full batch.
+    TEST(DataHandlerUnitTests, Level2BatchCallbacksStillInvoked) {
+        for (auto decoder : {MarketDataDecoder::DOM, MarketDataDecoder::ON_DEMAND}) {
+            Level2BatchCallbacks callbacks;
+            auto client = std::make_unique<WebSocketClient>(&callbacks, "", "");
+            client->setMarketDataDecoder(decoder);
+
+            callbacks.processMarketData(client.get(), L2_UPDATE_FRAME.data(), L2_UPDATE_FRAME.size());
+            EXPECT_EQ(callbacks.last_seq_num, 1u);
+            EXPECT_EQ(callbacks.last_batch.product_id, "BTC-USD");
+            ASSERT_EQ(callbacks.last_batch.updates.size(), 2u);
+            EXPECT_DOUBLE_EQ(callbacks.last_batch.updates[1].price_level, 72580.01);
+        }
+    }
+
+    struct OrderBookCallbacks : public ConcreteUserThreadCallbacks {
+        void onOrderBookUpdate(WebSocketClient*, uint64_t seq_num, const OrderBook& book) override {
+            ++book_updates;
+            last_seq_num = seq_num;
+            last_book = &book;
+        }
+        int book_updates = 0;
+        uint64_t last_seq_num = 0;
+        const OrderBook *last_book = nullptr;
+    };
+
+    // Level2 events are applied to the registered book before onOrderBookUpdate fires.
+    TEST(DataHandlerUnitTests, OrderBookFedFromLevel2) {
+        for (auto decoder : {MarketDataDecoder::DOM, MarketDataDecoder::ON_DEMAND}) {
+            OrderBookCallbacks callbacks;
+            auto client = std::make_unique<WebSocketClient>(&callbacks, "", "");
+            client->setMarketDataDecoder(decoder);
+
+            Product product{};
+            product.product_id = "BTC-USD";
+            product.quote_increment = 0.01;
+            auto *book = client->addOrderBook(product);
+            ASSERT_NE(book, nullptr);
+            EXPECT_EQ(client->addOrderBook(product), book);
+            EXPECT_EQ(client->orderBook("BTC-USD"), book);
+            EXPECT_EQ(client->orderBook("ETH-USD"), nullptr);
+
+            callbacks.processMarketData(client.get(), L2_UPDATE_FRAME.data(), L2_UPDATE_FRAME.size());
+            EXPECT_EQ(callbacks.book_updates, 1);
+            EXPECT_EQ(callbacks.last_book, book);
+            EXPECT_EQ(callbacks.last_seq_num, 1u);
+            EXPECT_EQ(book->sequenceNum(), 1u);
+            ASSERT_TRUE(book->bestBid());
+            EXPECT_EQ(book->bestBid()->price, 72575.0);
+            EXPECT_EQ(book->bestBid()->quantity, 0.5);
+            EXPECT_FALSE(book->bestAsk());
+        }
+    }
+
+    struct RecoveryCallbacks : public OrderBookCallbacks {
+        void onMarketDataGap(WebSocketClient*) override {
+            ++gaps;
+        }
+        void onOrderBookRecovered(WebSocketClient*, const OrderBook&, std::chrono::nanoseconds duration) override {
+            ++recovered;
+            recovery_duration = duration;
+        }
+        int gaps = 0;
+        int recovered = 0;
+        std::chrono::nanoseconds recovery_duration{0};
+    };
+
+    std::string l2_frame(uint64_t seq_num, std::string_view type, std::string_view side, std::string_view price, std::string_view quantity, std::string_view event_time) {
+        std::string frame = R"({"channel":"l2_data","client_id":"","timestamp":"2026-03-05T09:05:35Z","sequence_num":)";
+        frame += std::to_string(seq_num);
+        frame += R"(,"events":[{"type":")";
+        frame.append(type).append(R"(","product_id":"BTC-USD","updates":[{"side":")");
+        frame.append(side).append(R"(","event_time":")");
+        frame.append(event_time).append(R"(","price_level":")");
+        frame.append(price).append(R"(","new_quantity":")");
+        frame.append(quantity).append(R"("}]}]})");
+        return frame;
+    }
+
+    // After a gap the book is rebuilt from a REST book plus the deltas received
+    // while it was fetched; older deltas are dropped.
+    TEST(DataHandlerUnitTests, Level2GapRecoveryFromRestBook) {
+        RecoveryCallbacks callbacks;
+        // the market data URL only lets the client track the level2 subscription;
+        // frames are fed to the handler directly
+        WebSocketClient client(&callbacks, "wss://advanced-trade-ws.coinbase.com", "");
+        Product product{};
+        product.product_id = "BTC-USD";
+        product.quote_increment = 0.01;
+        auto *book = client.addOrderBook(product);
+        ASSERT_NE(book, nullptr);
+
+        std::promise<void> release;
+        auto released = release.get_future().share();
+        client.enableLevel2Recovery({Level2Recovery::REST_SNAPSHOT, [released](const std::string &product_id, PriceBook &rest_book) {
+            released.wait();
+            rest_book.product_id = product_id;
+            rest_book.bids = {{72570., 3.}};
+            rest_book.asks = {{72590., 1.}};
+            rest_book.time = to_nanoseconds("2026-03-05T09:05:32.5Z");
+            return true;
+        }});
+        client.subscribe({"BTC-USD"}, {WebSocketChannel::LEVEL2});
+
+        auto feed = [&](const std::string &frame) {
+            callbacks.processMarketData(&client, frame.data(), frame.size());
+        };
+        feed(l2_frame(1, "update", "bid", "72575", "0.5", "2026-03-05T09:05:32.000Z"));
+        EXPECT_EQ(callbacks.book_updates, 1);
+
+        // seq 2 lost; these are held back
+        feed(l2_frame(3, "update", "bid", "72576", "1", "2026-03-05T09:05:33.000Z"));
+        feed(l2_frame(4, "update", "bid", "72574", "2", "2026-03-05T09:05:31.000Z"));
+        EXPECT_EQ(callbacks.gaps, 1);
+        EXPECT_TRUE(callbacks.isRecovering(*book));
+        EXPECT_EQ(callbacks.book_updates, 1);
+        EXPECT_EQ(book->bestBid()->price, 72575.0);
+
+        release.set_value();
+        for (uint64_t seq = 5; seq < 5000 && callbacks.recovered == 0; ++seq) {
+            feed(l2_frame(seq, "update", "bid", "72560", "0.1", "2026-03-05T09:05:34.000Z"));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ASSERT_EQ(callbacks.recovered, 1);
+        EXPECT_EQ(callbacks.gaps, 1);
+        EXPECT_FALSE(callbacks.isRecovering(*book));
+        EXPECT_GT(callbacks.recovery_duration.count(), 0);
+        EXPECT_EQ(callbacks.book_updates, 2);
+        EXPECT_EQ(book->bestBid()->price, 72576.0);
+        EXPECT_EQ(book->quantityAt(Side::BUY, 72575.), 0.);
+        EXPECT_EQ(book->quantityAt(Side::BUY, 72574.), 0.);
+        EXPECT_EQ(book->quantityAt(Side::BUY, 72570.), 3.);
+        EXPECT_EQ(book->quantityAt(Side::BUY, 72560.), 0.1);
+        EXPECT_EQ(book->bestAsk()->price, 72590.0);
+    }
+
+    // A quiet product recovers once its fetch finishes, on any frame; a fetch
+    // that hangs falls back to RESUBSCRIBE after fetch_timeout.
+    TEST(DataHandlerUnitTests, Level2GapRecoveryFetchPolling) {
+        RecoveryCallbacks callbacks;
+        WebSocketClient client(&callbacks, "wss://advanced-trade-ws.coinbase.com", "");
+        Product product{};
+        product.product_id = "BTC-USD";
+        product.quote_increment = 0.01;
+        auto *book = client.addOrderBook(product);
+        ASSERT_NE(book, nullptr);
+
+        std::promise<void> release_first;
+        auto first_released = release_first.get_future().share();
+        std::promise<void> release;
+        auto released = release.get_future().share();
+        std::atomic<int> fetches{0};
+        Level2RecoveryConfig config{Level2Recovery::REST_SNAPSHOT, [first_released, released, &fetches](const std::string &product_id, PriceBook &rest_book) {
+            if (fetches.fetch_add(1) > 0) {
+                released.wait();    // the second fetch hangs
+            }
+            else {
+                first_released.wait();
+            }
+            rest_book.product_id = product_id;
+            rest_book.bids = {{72570., 3.}};
+            rest_book.time = to_nanoseconds("2026-03-05T09:05:32.5Z");
+            return true;
+        }};
+        config.fetch_timeout = std::chrono::milliseconds(50);
+        client.enableLevel2Recovery(config);
+        client.subscribe({"BTC-USD"}, {WebSocketChannel::LEVEL2});
+
+        auto feed = [&](const std::string &frame) {
+            callbacks.processMarketData(&client, frame.data(), frame.size());
+        };
+        auto heartbeat = [&](uint64_t seq_num) {
+            feed(R"({"channel":"heartbeats","client_id":"","timestamp":"2026-03-05T09:05:35Z","sequence_num":)" + std::to_string(seq_num)
+                + R"(,"events":[{"current_time":"2026-03-05 09:05:35.000000000 +0000 UTC m=+1.0","heartbeat_counter":1}]})");
+        };
+        feed(l2_frame(1, "update", "bid", "72575", "0.5", "2026-03-05T09:05:32.000Z"));
+        feed(l2_frame(3, "update", "bid", "72576", "1", "2026-03-05T09:05:33.000Z"));
+        EXPECT_TRUE(callbacks.isRecovering(*book));
+        release_first.set_value();
+
+        // no more deltas for BTC-USD: heartbeats complete the recovery
+        uint64_t seq = 4;
+        for (; seq < 5000 && callbacks.recovered == 0; ++seq) {
+            heartbeat(seq);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ASSERT_EQ(callbacks.recovered, 1);
+        EXPECT_FALSE(callbacks.isRecovering(*book));
+        EXPECT_EQ(book->bestBid()->price, 72576.0);
+        EXPECT_EQ(book->quantityAt(Side::BUY, 72570.), 3.);
+
+        // the next fetch never returns: held back deltas are dropped for a resubscription
+        feed(l2_frame(seq + 1, "update", "bid", "72577", "1", "2026-03-05T09:05:34.000Z"));
+        EXPECT_EQ(callbacks.gaps, 2);
+        EXPECT_TRUE(callbacks.isRecovering(*book));
+        std::this_thread::sleep_for(std::chrono::milliseconds(60));
+        heartbeat(seq + 2);
+        // a late REST book is ignored once the fetch timed out
+        release.set_value();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        feed(l2_frame(seq + 3, "update", "bid", "72578", "1", "2026-03-05T09:05:35.000Z"));
+        EXPECT_EQ(callbacks.recovered, 1);
+        EXPECT_TRUE(callbacks.isRecovering(*book));
+        feed(l2_frame(seq + 4, "snapshot", "offer", "72600", "4", "2026-03-05T09:05:36.000Z"));
+        EXPECT_EQ(callbacks.recovered, 2);
+        EXPECT_FALSE(book->bestBid());
+        EXPECT_EQ(book->bestAsk()->price, 72600.0);
+    }
+
+    // REST book fetches run one at a time on a single thread owned by the data
+    // handler, which waits for the running fetch when it is destroyed.
+    TEST(DataHandlerUnitTests, Level2GapRecoveryFetchWorker) {
+        std::atomic<int> fetches{0};
+        std::atomic<int> running{0};
+        std::atomic<int> max_running{0};
+        std::mutex threads_mutex;
+        std::vector<std::thread::id> threads;
+        {
+            RecoveryCallbacks callbacks;
+            WebSocketClient client(&callbacks, "wss://advanced-trade-ws.coinbase.com", "");
+            for (const char *product_id : {"BTC-USD", "ETH-USD", "SOL-USD"}) {
+                Product product{};
+                product.product_id = product_id;
+                product.quote_increment = 0.01;
+                ASSERT_NE(client.addOrderBook(product), nullptr);
+            }
+            client.enableLevel2Recovery({Level2Recovery::REST_SNAPSHOT, [&](const std::string &, PriceBook &) {
+                fetches.fetch_add(1);
+                auto n = running.fetch_add(1) + 1;
+                for (auto max = max_running.load(); n > max && !max_running.compare_exchange_weak(max, n);) {}
+                {
+                    std::lock_guard lock(threads_mutex);
+                    threads.push_back(std::this_thread::get_id());
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                running.fetch_sub(1);
+                return false;
+            }});
+            client.subscribe({"BTC-USD", "ETH-USD", "SOL-USD"}, {WebSocketChannel::LEVEL2});
+
+            auto feed = [&](const std::string &frame) {
+                callbacks.processMarketData(&client, frame.data(), frame.size());
+            };
+            feed(l2_frame(1, "update", "bid", "72575", "0.5", "2026-03-05T09:05:32.000Z"));
+            feed(l2_frame(3, "update", "bid", "72576", "1", "2026-03-05T09:05:33.000Z"));
+            EXPECT_EQ(callbacks.gaps, 1);
+            while (fetches.load() < 2) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        EXPECT_EQ(running.load(), 0);
+        EXPECT_EQ(max_running.load(), 1);
+        ASSERT_GE(threads.size(), 2u);
+        EXPECT_TRUE(std::all_of(threads.begin(), threads.end(), [&](auto id) { return id == threads.front(); }));
+        EXPECT_NE(threads.front(), std::this_thread::get_id());
+    }
+
+    // In RESUBSCRIBE mode deltas are dropped until the next snapshot replaces the book.
+    TEST(DataHandlerUnitTests, Level2GapRecoveryFromSnapshot) {
+        RecoveryCallbacks callbacks;
+        WebSocketClient client(&callbacks, "wss://advanced-trade-ws.coinbase.com", "");
+        Product product{};
+        product.product_id = "BTC-USD";
+        product.quote_increment = 0.01;
+        auto *book = client.addOrderBook(product);
+        client.enableLevel2Recovery();
+        EXPECT_EQ(client.level2Recovery().mode, Level2Recovery::RESUBSCRIBE);
+
+        auto feed = [&](const std::string &frame) {
+            callbacks.processMarketData(&client, frame.data(), frame.size());
+        };
+        // books outside the client's level2 subscriptions are left alone
+        feed(l2_frame(1, "update", "bid", "72575", "0.5", "2026-03-05T09:05:32.000Z"));
+        feed(l2_frame(3, "update", "bid", "72576", "1", "2026-03-05T09:05:33.000Z"));
+        EXPECT_EQ(callbacks.gaps, 1);
+        EXPECT_FALSE(callbacks.isRecovering(*book));
+        EXPECT_EQ(book->bestBid()->price, 72576.0);
+
+        client.subscribe({"BTC-USD"}, {WebSocketChannel::LEVEL2});
+        feed(l2_frame(5, "update", "bid", "72577", "1", "2026-03-05T09:05:33.000Z"));
+        EXPECT_EQ(callbacks.gaps, 2);
+        EXPECT_TRUE(callbacks.isRecovering(*book));
+        EXPECT_EQ(book->bestBid()->price, 72576.0);
+
+        feed(l2_frame(6, "snapshot", "offer", "72600", "4", "2026-03-05T09:05:34.000Z"));
+        EXPECT_EQ(callbacks.recovered, 1);
+        EXPECT_FALSE(callbacks.isRecovering(*book));
+        EXPECT_FALSE(book->bestBid());
+        EXPECT_EQ(book->bestAsk()->price, 72600.0);
+
+        feed(l2_frame(7, "update", "bid", "72590", "1", "2026-03-05T09:05:35.000Z"));
+        EXPECT_EQ(book->bestBid()->price, 72590.0);
+        EXPECT_EQ(callbacks.gaps, 2);
+    }
+
+    // Implements only a few callbacks; everything else is compiled out.
+    struct StaticHandler : public StaticDataHandler<StaticHandler> {
+        void onLevel2Updates(WebSocketClient*, uint64_t seq_num, std::string_view product_id, std::span<const Level2Update> updates) {
+            ++l2_updates;
+            last_seq_num = seq_num;
+            last_product_id = product_id;
+            last_level_count = updates.size();
+        }
+        void onTickerSnapshot(WebSocketClient*, uint64_t seq_num, uint64_t, const std::vector<Ticker>& tickers) {
+            ++ticker_snapshots;
+            last_seq_num = seq_num;
+            last_price = tickers.at(0).price;
+        }
+        void onMarketDataGap(WebSocketClient*) {
+            ++gaps;
+        }
+        int l2_updates = 0;
+        int ticker_snapshots = 0;
+        int gaps = 0;
+        uint64_t last_seq_num = 0;
+        std::string last_product_id;
+        std::size_t last_level_count = 0;
+        double last_price = 0.;
+    };
+
+    struct StaticOrderBookHandler : public StaticDataHandler<StaticOrderBookHandler> {
+        void onOrderBookUpdate(WebSocketClient*, uint64_t, const OrderBook& book) {
+            last_book = &book;
+        }
+        const OrderBook *last_book = nullptr;
+    };
+
+    const std::string TICKER_SNAPSHOT_FRAME = R"({"channel":"ticker","client_id":"","timestamp":"2026-03-05T09:05:32.483569449Z","sequence_num":2,"events":[{"type":"snapshot","tickers":[{"type":"ticker","product_id":"BTC-USD","price":"72575.01","best_bid":"72575","best_ask":"72575.01"}]}]})";
+    const std::string TRADES_FRAME = R"({"channel":"market_trades","client_id":"","timestamp":"2026-03-05T09:05:32.483569449Z","sequence_num":3,"events":[{"type":"update","trades":[{"trade_id":"1","product_id":"BTC-USD","price":"72575.01","size":"0.1","side":"BUY","time":"2026-03-05T09:05:32.449176Z"}]}]})";
+
+    // Frames are dispatched straight to the handler's non-virtual members;
+    // channels it does not handle are skipped but still sequence checked.
+    TEST(DataHandlerUnitTests, StaticDataHandlerDispatch) {
+        StaticHandler handler;
+        WebSocketClient client(&handler, "", "");
+
+        handler.processMarketData(&client, L2_UPDATE_FRAME.data(), L2_UPDATE_FRAME.size());
+        EXPECT_EQ(handler.l2_updates, 1);
+        EXPECT_EQ(handler.last_seq_num, 1u);
+        EXPECT_EQ(handler.last_product_id, "BTC-USD");
+        EXPECT_EQ(handler.last_level_count, 2u);
+
+        handler.processMarketData(&client, TICKER_SNAPSHOT_FRAME.data(), TICKER_SNAPSHOT_FRAME.size());
+        EXPECT_EQ(handler.ticker_snapshots, 1);
+        EXPECT_EQ(handler.last_seq_num, 2u);
+        EXPECT_DOUBLE_EQ(handler.last_price, 72575.01);
+
+        handler.processMarketData(&client, TRADES_FRAME.data(), TRADES_FRAME.size());
+        EXPECT_EQ(handler.gaps, 0);
+
+        auto next = L2_UPDATE_FRAME;
+        next.replace(next.find("\"sequence_num\":1"), 16, "\"sequence_num\":5");
+        handler.processMarketData(&client, next.data(), next.size());
+        EXPECT_EQ(handler.gaps, 1);
+        EXPECT_EQ(handler.l2_updates, 2);
+        EXPECT_EQ(handler.ticker_snapshots, 1);
+    }
+
+    // l2_data is decoded for registered books even without Level2 callbacks.
+    TEST(DataHandlerUnitTests, StaticDataHandlerOrderBook) {
+        StaticOrderBookHandler handler;
+        WebSocketClient client(&handler, "", "");
+        Product product{};
+        product.product_id = "BTC-USD";
+        product.quote_increment = 0.01;
+        auto *book = client.addOrderBook(product);
+        ASSERT_NE(book, nullptr);
+
+        handler.processMarketData(&client, L2_UPDATE_FRAME.data(), L2_UPDATE_FRAME.size());
+        EXPECT_EQ(handler.last_book, book);
+        ASSERT_TRUE(book->bestBid());
+        EXPECT_EQ(book->bestBid()->price, 72575.0);
+    }
+
+    struct InterestCallbacks : public Level2ViewCallbacks {
+        void onTickerSnapshot(WebSocketClient*, uint64_t, uint64_t, const std::vector<Ticker>& tickers) override {
+            ++ticker_snapshots;
+            last_ticker = tickers.at(0);
+        }
+        void onMarketDataGap(WebSocketClient*) override {
+            ++gaps;
+        }
+        int ticker_snapshots = 0;
+        int gaps = 0;
+        Ticker last_ticker{};
+    };
+
+    const std::string HEARTBEAT_FRAME = R"({"channel":"heartbeats","client_id":"","timestamp":"2026-03-05T09:05:33.483569449Z","sequence_num":3,"events":[{"current_time":"2026-03-05 09:05:33.48 +0000 UTC","heartbeat_counter":42}]})";
+
+    // Channels outside the interest mask are skipped but still sequence checked;
+    // the on-demand decoder only reads the requested ticker fields.
+    TEST(DataHandlerUnitTests, MarketDataInterestSkipsChannelsAndFields) {
+        for (auto decoder : {MarketDataDecoder::DOM, MarketDataDecoder::ON_DEMAND}) {
+            InterestCallbacks callbacks;
+            auto client = std::make_unique<WebSocketClient>(&callbacks, "", "");
+            client->setMarketDataDecoder(decoder);
+            client->setMarketDataInterest({channel_mask({TICKER}), TickerField::BEST_BID | TickerField::BEST_ASK});
+            EXPECT_TRUE(client->marketDataInterest().wants(TICKER));
+            EXPECT_FALSE(client->marketDataInterest().wants(LEVEL2));
+
+            callbacks.processMarketData(client.get(), L2_UPDATE_FRAME.data(), L2_UPDATE_FRAME.size());
+            EXPECT_EQ(callbacks.update_count, 0);
+
+            callbacks.processMarketData(client.get(), TICKER_SNAPSHOT_FRAME.data(), TICKER_SNAPSHOT_FRAME.size());
+            ASSERT_EQ(callbacks.ticker_snapshots, 1);
+            EXPECT_EQ(callbacks.last_ticker.product_id, "BTC-USD");
+            EXPECT_DOUBLE_EQ(callbacks.last_ticker.best_bid, 72575.0);
+            EXPECT_DOUBLE_EQ(callbacks.last_ticker.best_ask, 72575.01);
+            if (decoder == MarketDataDecoder::ON_DEMAND) {
+                EXPECT_EQ(callbacks.last_ticker.price, 0.);
+            }
+
+            callbacks.processMarketData(client.get(), HEARTBEAT_FRAME.data(), HEARTBEAT_FRAME.size());
+            EXPECT_EQ(callbacks.gaps, 0);
+
+            auto next = L2_UPDATE_FRAME;
+            next.replace(next.find("\"sequence_num\":1"), 16, "\"sequence_num\":5");
+            callbacks.processMarketData(client.get(), next.data(), next.size());
+            EXPECT_EQ(callbacks.gaps, 1);
+            EXPECT_EQ(callbacks.update_count, 0);
+        }
+    }
+
+    // With every data channel wanted the header is not peeked; the decoders
+    // still sequence check heartbeats themselves.
+    TEST(DataHandlerUnitTests, MarketDataInterestAllDecodesInOnePass) {
+        for (auto decoder : {MarketDataDecoder::DOM, MarketDataDecoder::ON_DEMAND}) {
+            InterestCallbacks callbacks;
+            auto client = std::make_unique<WebSocketClient>(&callbacks, "", "");
+            client->setMarketDataDecoder(decoder);
+            EXPECT_TRUE(MarketDataInterest::containsAll(client->marketDataInterest().channels));
+            EXPECT_FALSE(MarketDataInterest::containsAll(channel_mask({LEVEL2, TICKER})));
+
+            callbacks.processMarketData(client.get(), L2_UPDATE_FRAME.data(), L2_UPDATE_FRAME.size());
+            EXPECT_EQ(callbacks.update_count, 1);
+            callbacks.processMarketData(client.get(), HEARTBEAT_FRAME.data(), HEARTBEAT_FRAME.size());
+            EXPECT_EQ(callbacks.gaps, 1);
+        }
+    }
+
+    // Decoded events are republished as fixed-layout records on the dedicated
+    // producer, alongside the regular callbacks.
+    TEST(DataHandlerUnitTests, NormalizedRecords) {
+        for (auto decoder : {MarketDataDecoder::DOM, MarketDataDecoder::ON_DEMAND}) {
+            InterestCallbacks callbacks;
+            auto client = std::make_unique<WebSocketClient>(&callbacks, "", "");
+            client->setMarketDataDecoder(decoder);
+            EXPECT_FALSE(client->enableNormalizedRecords(ProducerType::MD_DATA));
+            ASSERT_TRUE(client->enableNormalizedRecords(100));
+            ASSERT_NE(client->marketDataRecordWriter(), nullptr);
+            EXPECT_EQ(client->userDataRecordWriter(), nullptr);
+
+            callbacks.processMarketData(client.get(), L2_UPDATE_FRAME.data(), L2_UPDATE_FRAME.size());
+            callbacks.processMarketData(client.get(), TICKER_SNAPSHOT_FRAME.data(), TICKER_SNAPSHOT_FRAME.size());
+            callbacks.processMarketData(client.get(), TRADES_FRAME.data(), TRADES_FRAME.size());
+            EXPECT_EQ(callbacks.update_count, 1);
+            EXPECT_EQ(callbacks.ticker_snapshots, 1);
+
+            auto &mux = client->streamBufferMultiplexer();
+            auto cursor = mux.initial_reading_index();
+            std::vector<std::vector<uint8_t>> records;
+            while (auto record = mux.read(cursor)) {
+                if (record.producer_id == 100) {
+                    records.emplace_back(record.data, record.data + record.length);
+                }
+            }
+            ASSERT_EQ(records.size(), 3u);
+
+            auto *l2 = record_header(records[0].data(), static_cast<uint32_t>(records[0].size()));
+            ASSERT_NE(l2, nullptr);
+            EXPECT_EQ(l2->type, RecordType::LEVEL2);
+            EXPECT_EQ(l2->flags, RecordFlags::FIRST | RecordFlags::LAST);
+            EXPECT_EQ(l2->seq_num, 1u);
+            EXPECT_EQ(l2->timestamp, to_nanoseconds("2026-03-05T09:05:32.483569449Z"));
+            EXPECT_EQ(record_string(reinterpret_cast<const Level2Record*>(l2)->product_id), "BTC-USD");
+            auto updates = record_entries<Level2Entry>(*l2);
+            ASSERT_EQ(updates.size(), 2u);
+            EXPECT_EQ(updates[0].side, Side::BUY);
+            EXPECT_DOUBLE_EQ(updates[0].price_level, 72575.0);
+            EXPECT_DOUBLE_EQ(updates[0].new_quantity, 0.5);
+            EXPECT_EQ(updates[1].side, Side::SELL);
+            EXPECT_DOUBLE_EQ(updates[1].new_quantity, 0.);
+            EXPECT_TRUE(record_entries<TradeEntry>(*l2).empty());
+
+            auto *ticker = record_header(records[1].data(), static_cast<uint32_t>(records[1].size()));
+            ASSERT_NE(ticker, nullptr);
+            EXPECT_TRUE(ticker->flags & RecordFlags::SNAPSHOT);
+            auto tickers = record_entries<TickerEntry>(*ticker);
+            ASSERT_EQ(tickers.size(), 1u);
+            EXPECT_EQ(record_string(tickers[0].product_id), "BTC-USD");
+            EXPECT_DOUBLE_EQ(tickers[0].best_ask, 72575.01);
+
+            auto *trade = record_header(records[2].data(), static_cast<uint32_t>(records[2].size()));
+            ASSERT_NE(trade, nullptr);
+            EXPECT_FALSE(trade->flags & RecordFlags::SNAPSHOT);
+            auto trades = record_entries<TradeEntry>(*trade);
+            ASSERT_EQ(trades.size(), 1u);
+            EXPECT_EQ(record_string(trades[0].trade_id), "1");
+            EXPECT_DOUBLE_EQ(trades[0].size, 0.1);
+            EXPECT_EQ(trades[0].side, Side::BUY);
+        }
+    }
+
+    TEST(DataHandlerUnitTests, TopOfBookTable) {
+        const char *name = "coinbase_websocket_tests_tob";
+        for (auto decoder : {MarketDataDecoder::DOM, MarketDataDecoder::ON_DEMAND}) {
+            TopOfBookTable::remove(name);
+            InterestCallbacks callbacks;
+            auto client = std::make_unique<WebSocketClient>(&callbacks, "", "");
+            client->setMarketDataDecoder(decoder);
+            ASSERT_TRUE(client->enableTopOfBook(name));
+
+            callbacks.processMarketData(client.get(), TICKER_SNAPSHOT_FRAME.data(), TICKER_SNAPSHOT_FRAME.size());
+            callbacks.processMarketData(client.get(), TRADES_FRAME.data(), TRADES_FRAME.size());
+
+            TopOfBookReader reader(name);
+            ASSERT_TRUE(reader.isOpen());
+            TopOfBook top;
+            ASSERT_TRUE(reader.read("BTC-USD", top));
+            EXPECT_DOUBLE_EQ(top.bid_price, 72575.0);
+            EXPECT_DOUBLE_EQ(top.ask_price, 72575.01);
+            EXPECT_DOUBLE_EQ(top.last_price, 72575.01);
+            EXPECT_DOUBLE_EQ(top.last_size, 0.1);
+            EXPECT_EQ(top.update_time, to_nanoseconds("2026-03-05T09:05:32.449176Z"));
+        }
+        TopOfBookTable::remove(name);
+    }
+
+    struct ActivityCallbacks : public InterestCallbacks {
+        void onProductStale(WebSocketClient*, ProductHandle product_handle, std::chrono::nanoseconds) override {
+            stale.push_back(product_handle);
+        }
+        void onProductActive(WebSocketClient*, ProductHandle product_handle) override {
+            active.push_back(product_handle);
+        }
+        std::vector<ProductHandle> stale;
+        std::vector<ProductHandle> active;
+    };
+
+    // Every decoded event is recorded under its product handle; a product that
+    // stays quiet is reported stale once by the client's timer, even with no
+    // frames at all, then active on its next event.
+    TEST(DataHandlerUnitTests, ProductActivity) {
+        auto with_seq_num = [](std::string frame, uint64_t seq_num) {
+            auto pos = frame.find("\"sequence_num\":");
+            frame.replace(pos, frame.find(',', pos) - pos, "\"sequence_num\":" + std::to_string(seq_num));
+            return frame;
+        };
+        auto btc = intern_product_id("BTC-USD");
+        for (auto decoder : {MarketDataDecoder::DOM, MarketDataDecoder::ON_DEMAND}) {
+            ActivityCallbacks callbacks;
+            auto client = std::make_unique<WebSocketClient>(&callbacks, "wss://advanced-trade-ws.coinbase.com", "");
+            client->setMarketDataDecoder(decoder);
+            client->enableProductActivity(std::chrono::milliseconds(100));
+            auto *activity = client->productActivity();
+            ASSERT_NE(activity, nullptr);
+            EXPECT_TRUE(activity->isStale(btc));
+
+            callbacks.processMarketData(client.get(), L2_UPDATE_FRAME.data(), L2_UPDATE_FRAME.size());
+            callbacks.processMarketData(client.get(), TICKER_SNAPSHOT_FRAME.data(), TICKER_SNAPSHOT_FRAME.size());
+            callbacks.processMarketData(client.get(), TRADES_FRAME.data(), TRADES_FRAME.size());
+            ProductActivity product;
+            ASSERT_TRUE(activity->get(btc, product));
+            EXPECT_EQ(product.event_count, 3u);
+            EXPECT_EQ(product.last_seq_num, 3u);
+            EXPECT_EQ(product.last_event_time, to_nanoseconds("2026-03-05T09:05:32.483569449Z"));
+            EXPECT_FALSE(activity->isStale(btc));
+            EXPECT_TRUE(callbacks.stale.empty());
+
+            // no frames: the timer reports it through the user thread
+            for (int i = 0; i < 200 && callbacks.stale.empty(); ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                callbacks.processData();
+            }
+            EXPECT_TRUE(activity->isStale(btc));
+            ASSERT_EQ(callbacks.stale, std::vector<ProductHandle>{btc});
+            std::this_thread::sleep_for(std::chrono::milliseconds(60));
+            callbacks.processData();
+            EXPECT_EQ(callbacks.stale.size(), 1u);
+
+            auto ticker = with_seq_num(TICKER_SNAPSHOT_FRAME, 4);
+            callbacks.processMarketData(client.get(), ticker.data(), ticker.size());
+            EXPECT_EQ(callbacks.active, std::vector<ProductHandle>{btc});
+            EXPECT_FALSE(activity->isStale(btc));
+            ASSERT_TRUE(activity->get(btc, product));
+            EXPECT_EQ(product.last_seq_num, 4u);
+            EXPECT_EQ(callbacks.gaps, 0);
+        }
+    }
+
+    // Standby connections share the tracked subscriptions. Sequence numbers
+    // differ per connection, so the arbiter checks them instead of the handler.
+    TEST(WebSocketClientUnitTests, MarketDataRedundancy) {
+        InterestCallbacks no_market_data_callbacks;
+        WebSocketClient no_market_data(&no_market_data_callbacks, "", "");
+        EXPECT_FALSE(no_market_data.enableMarketDataRedundancy(200));
+
+        InterestCallbacks callbacks;
+        WebSocketClient client(&callbacks, "wss://advanced-trade-ws.coinbase.com", "");
+        EXPECT_FALSE(client.marketDataRedundancyEnabled());
+        EXPECT_TRUE(client.marketDataConnectionStats().empty());
+        EXPECT_FALSE(client.enableMarketDataRedundancy(ProducerType::MD_DATA));
+        ASSERT_TRUE(client.enableMarketDataRedundancy(200, {2}));
+        EXPECT_TRUE(client.marketDataRedundancyEnabled());
+        EXPECT_FALSE(client.enableMarketDataRedundancy(300));
+        auto stats = client.marketDataConnectionStats();
+        ASSERT_EQ(stats.size(), 3u);
+        EXPECT_FALSE(stats[2].connected);
+        EXPECT_EQ(stats[2].frames, 0u);
+
+        client.subscribe({"BTC-USD"}, {WebSocketChannel::TICKER});
+        EXPECT_EQ(client.subscriptions(WebSocketChannel::TICKER), std::vector<std::string>{"BTC-USD"});
+
+        callbacks.processMarketData(&client, TICKER_SNAPSHOT_FRAME.data(), TICKER_SNAPSHOT_FRAME.size());
+        auto next = TICKER_SNAPSHOT_FRAME;
+        next.replace(next.find("\"sequence_num\":2"), 16, "\"sequence_num\":9");
+        callbacks.processMarketData(&client, next.data(), next.size());
+        EXPECT_EQ(callbacks.ticker_snapshots, 2);
+        EXPECT_EQ(callbacks.gaps, 0);
+        client.stop();
+    }
+
     TEST_F(WebSocketTests, RepeatedConnectDisconnect) {
         constexpr int kIterations = 5;
         WebSocketClient client_(this);